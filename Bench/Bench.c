@@ -0,0 +1,569 @@
+/* Load generator for the agent. The agent and the tick run in-process on the
+ * loopback interface while this thread keeps a window of requests in flight,
+ * drawn at random from a weighted mix of operations. The results are printed
+ * as a single JSON object so that runs can be compared by scripts.
+ *
+ * The other benches are subcommands, named by the first argument.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Access.h>
+#include <Agent.h>
+#include <Change.h>
+#include <Database.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Registry.h>
+#include <Sync.h>
+#include <Tick.h>
+#include <Transaction.h>
+
+enum
+{
+	OPERATION_GET,
+	OPERATION_NEXT,
+	OPERATION_BULK,
+	OPERATION_SET,
+	OPERATION_STMP,
+	OPERATION_COUNT
+};
+
+static const char *const operationNames[OPERATION_COUNT] =
+{
+	"get", "next", "bulk", "set", "stmp"
+};
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+/* Columns of phaseEntry read by GET and GETNEXT, and the one written by SET
+ * (phaseMinimumGreen).
+ */
+static const uint32_t readColumns[] = { 2, 3, 4, 5, 6, 7, 8, 11, 12, 21 };
+static const uint32_t writeColumn   = 4;
+
+#define MAX_TICK_SAMPLES 65536
+
+static uint64_t    tickLateness[MAX_TICK_SAMPLES];
+static size_t      tickCount;
+static Agent       agent;
+static atomic_bool serving;
+
+typedef struct Options
+{
+	size_t   requests;
+	size_t   window;
+	uint32_t repetitions;
+	uint32_t weights[OPERATION_COUNT];
+	uint64_t seed;
+
+	TickConfig tick;
+} Options;
+
+static void recordTick (const uint64_t deadline, const uint64_t now)
+{
+	if (tickCount < MAX_TICK_SAMPLES)
+	{
+		tickLateness[tickCount] = now > deadline ? now - deadline : 0;
+	}
+
+	tickCount++;
+}
+
+static int serve (void *const argument)
+{
+	(void) argument;
+
+	while (atomic_load_explicit(&serving, memory_order_relaxed))
+	{
+		if (!agentServe(&agent, 50))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static uint64_t xorshift (uint64_t *const state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static void usage (const char *const program)
+{
+	fprintf(stderr,
+	        "usage: %s [-n requests] [-w window] [-r max-repetitions]\n"
+	        "          [-m get=70,next=10,bulk=10,set=10,stmp=0] [-s seed]\n"
+	        "          [-R tick-priority] [-c tick-cpu]\n"
+	        "       %s preempt [-n samples] [-T] [-R tick-priority]"
+	        " [-c tick-cpu]\n"
+	        "       %s snapshot [-n rounds] [-r max-repetitions]\n"
+	        "       %s sign [-n rounds]\n"
+	        "       %s zones [-n samples] [-b batch] [-z zones]\n"
+	        "       %s forward [-s seconds] [-p producers] [-r rate]"
+	        " [-d radio-us]\n"
+	        "                  [-R tick-priority] [-c tick-cpu]\n"
+	        "       %s usm [-n requests] [-v varbinds]\n",
+	        program, program, program, program, program, program, program);
+	exit(EXIT_FAILURE);
+}
+
+static bool parseMix (char *const text, uint32_t weights[const OPERATION_COUNT])
+{
+	memset(weights, 0, OPERATION_COUNT * sizeof(uint32_t));
+
+	for (char *save, *item = strtok_r(text, ",", &save); item;
+	     item = strtok_r(NULL, ",", &save))
+	{
+		char *const separator = strchr(item, '=');
+		size_t      operation = 0;
+
+		if (!separator)
+		{
+			return false;
+		}
+
+		*separator = '\0';
+
+		while (operation < OPERATION_COUNT
+		    && strcmp(item, operationNames[operation]) != 0)
+		{
+			operation++;
+		}
+
+		if (operation == OPERATION_COUNT)
+		{
+			return false;
+		}
+
+		weights[operation] = (uint32_t) strtoul(separator + 1, NULL, 10);
+	}
+
+	return true;
+}
+
+static Options parseOptions (const int32_t argc,
+                             const char *const argv[static argc])
+{
+	Options options =
+	{
+		.requests    = 100000,
+		.window      = 16,
+		.repetitions = 10,
+		.weights     = { 70, 10, 10, 10, 0 },
+		.seed        = 0x9E3779B97F4A7C15,
+		.tick        = { .realTime = false, .cpu = -1 }
+	};
+
+	int option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:w:r:m:s:R:c:"))
+	       != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.requests = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'w':
+				options.window = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'r':
+				options.repetitions = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'm':
+				if (!parseMix(optarg, options.weights))
+				{
+					usage(argv[0]);
+				}
+
+				break;
+
+			case 's':
+				options.seed = strtoull(optarg, NULL, 0) | 1;
+				break;
+
+			case 'R':
+				options.tick.realTime = true;
+				options.tick.priority = atoi(optarg);
+				break;
+
+			case 'c':
+				options.tick.cpu = atoi(optarg);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	/* STMP (NTCIP 1103 dynamic objects) is not served by the agent, so the
+	 * operation is accepted in the mix only with a zero weight.
+	 */
+	if (options.weights[OPERATION_STMP] != 0)
+	{
+		fputs("STMP is not supported by the agent.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	uint32_t total = 0;
+
+	for (size_t operation = 0; operation < OPERATION_COUNT; operation++)
+	{
+		total += options.weights[operation];
+	}
+
+	if (total == 0 || options.requests == 0 || options.window == 0)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+static size_t pickOperation (const Options *const options,
+                             uint64_t *const state)
+{
+	uint32_t total = 0;
+
+	for (size_t operation = 0; operation < OPERATION_COUNT; operation++)
+	{
+		total += options->weights[operation];
+	}
+
+	uint32_t draw = (uint32_t) (xorshift(state) % total);
+
+	for (size_t operation = 0; operation < OPERATION_COUNT; operation++)
+	{
+		if (draw < options->weights[operation])
+		{
+			return operation;
+		}
+
+		draw -= options->weights[operation];
+	}
+
+	return OPERATION_GET;
+}
+
+/* Encodes one request of the given operation and returns its length. */
+static size_t buildRequest (SNMPMessage *const message,
+                            const Options *const options,
+                            const size_t operation, const int32_t requestID,
+                            uint64_t *const state, uint8_t *const buffer,
+                            const size_t capacity)
+{
+	const uint32_t phase  = (uint32_t) (xorshift(state) % limits.maxPhases) + 1;
+	const uint32_t column =
+		readColumns[xorshift(state) % (sizeof(readColumns) / sizeof(uint32_t))];
+	const char *const community =
+		operation == OPERATION_SET ? "administrator" : "public";
+
+	VarBind *const varbind = &message->pdu.varbinds[0];
+
+	message->version         = SNMP_VERSION_2C;
+	message->community       = (const uint8_t *) community;
+	message->communityLength = strlen(community);
+	message->pdu.requestID   = requestID;
+	message->pdu.errorStatus = 0;
+	message->pdu.errorIndex  = 0;
+	message->pdu.count       = 1;
+
+	*varbind = (VarBind) { .name = ASC_OID(1, 2, 1, column, phase) };
+	varbind->type = BER_NULL;
+
+	switch (operation)
+	{
+		case OPERATION_GET:
+			message->pdu.type = SNMP_GET_REQUEST;
+			break;
+
+		case OPERATION_NEXT:
+			message->pdu.type = SNMP_GET_NEXT_REQUEST;
+			break;
+
+		case OPERATION_BULK:
+			message->pdu.type       = SNMP_GET_BULK_REQUEST;
+			message->pdu.errorIndex = (int32_t) options->repetitions;
+			break;
+
+		case OPERATION_SET:
+			message->pdu.type      = SNMP_SET_REQUEST;
+			varbind->name          = (OID) ASC_OID(1, 2, 1, writeColumn, phase);
+			varbind->type          = BER_INTEGER;
+			varbind->value.integer = (int64_t) (xorshift(state) % 30) + 5;
+			break;
+	}
+
+	return snmpEncode(message, buffer, capacity);
+}
+
+static int compareUnsigned (const void *const left, const void *const right)
+{
+	const uint64_t a = *(const uint64_t *) left;
+	const uint64_t b = *(const uint64_t *) right;
+
+	return (a > b) - (a < b);
+}
+
+/* Nearest-rank percentile of sorted samples, in microseconds. */
+static double percentile (const uint64_t *const samples, const size_t count,
+                          const double fraction)
+{
+	if (count == 0)
+	{
+		return 0.0;
+	}
+
+	size_t rank = (size_t) (fraction * (double) count + 0.5);
+
+	rank = MIN(MAX(rank, 1), count);
+
+	return (double) samples[rank - 1] / 1000.0;
+}
+
+int32_t main (const int32_t argc, const char *const argv[const static argc])
+{
+	if (argc > 1 && strcmp(argv[1], "preempt") == 0)
+	{
+		return benchPreempt(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "snapshot") == 0)
+	{
+		return benchSnapshot(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "sign") == 0)
+	{
+		return benchSign(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "zones") == 0)
+	{
+		return benchZone(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "forward") == 0)
+	{
+		return benchForward(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "usm") == 0)
+	{
+		return benchUSM(argc - 1, argv + 1);
+	}
+
+	const Options options = parseOptions(argc, argv);
+
+	static SNMPMessage message;
+	static uint8_t     buffer[SNMP_MAX_MESSAGE];
+
+	const AgentConfig config =
+	{
+		.address =
+		{
+			.sin_family      = AF_INET,
+			.sin_port        = 0,
+			.sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+		}
+	};
+
+	static const Device *const devices[] =
+	{
+		&ascDevice, &dmsDevice, &essDevice, &tssDevice, &rsuDevice,
+		&rmcDevice
+	};
+
+	for (size_t index = 0; index < sizeof(devices) / sizeof(devices[0]);
+	     index++)
+	{
+		deviceRegister(devices[index]);
+	}
+
+	if (!databaseInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	registryInit();
+
+	(void) accessGroup(ACCESS_COMMUNITY, "public", "all", NULL, false);
+	(void) accessGroup(ACCESS_COMMUNITY, "administrator", "all", "all", true);
+	accessCompile();
+	changeInit(&limits);
+
+	if (!transactionInit(&limits) || !syncInit(&limits))
+	{
+		fputs("Unable to allocate the transaction buffer.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	struct sockaddr_in address;
+	socklen_t          addressLength = sizeof(address);
+	thrd_t             server;
+
+	if (!agentInit(&agent, &config)
+	 || getsockname(agent.socket, (struct sockaddr *) &address,
+	                &addressLength) < 0)
+	{
+		perror("Unable to open the agent socket");
+		return EXIT_FAILURE;
+	}
+
+	const int client = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if (client < 0
+	 || connect(client, (const struct sockaddr *) &address,
+	            addressLength) < 0)
+	{
+		perror("Unable to open the client socket");
+		return EXIT_FAILURE;
+	}
+
+	uint64_t *const sent      = calloc(options.requests, sizeof(uint64_t));
+	uint64_t *const latencies = calloc(options.requests, sizeof(uint64_t));
+
+	if (!sent || !latencies)
+	{
+		fputs("Unable to allocate the samples.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	atomic_store(&serving, true);
+	tickRegister(recordTick);
+
+	if (thrd_create(&server, serve, NULL) != thrd_success
+	 || !tickStart(&options.tick))
+	{
+		fputs("Unable to start the agent.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	uint64_t state       = options.seed;
+	size_t   issued      = 0;
+	size_t   completed   = 0;
+	size_t   outstanding = 0;
+	size_t   timeouts    = 0;
+	size_t   errors      = 0;
+
+	const uint64_t start = clockMonotonic();
+
+	while (issued < options.requests || outstanding > 0)
+	{
+		while (outstanding < options.window && issued < options.requests)
+		{
+			const size_t operation = pickOperation(&options, &state);
+			const size_t length    =
+				buildRequest(&message, &options, operation, (int32_t) issued,
+				             &state, buffer, sizeof(buffer));
+
+			sent[issued] = clockMonotonic();
+
+			if (length == 0 || send(client, buffer, length, 0) < 0)
+			{
+				perror("Unable to send a request");
+				return EXIT_FAILURE;
+			}
+
+			issued++;
+			outstanding++;
+		}
+
+		struct pollfd descriptor = { .fd = client, .events = POLLIN };
+
+		if (poll(&descriptor, 1, 1000) <= 0)
+		{
+			/* Whatever is still in flight after a second is taken as lost;
+			 * a late answer to it is ignored below.
+			 */
+			timeouts   += outstanding;
+			outstanding = 0;
+			continue;
+		}
+
+		const ssize_t length = recv(client, buffer, sizeof(buffer), 0);
+		const uint64_t now   = clockMonotonic();
+
+		if (length <= 0 || !snmpDecode(buffer, (size_t) length, &message))
+		{
+			continue;
+		}
+
+		const int32_t requestID = message.pdu.requestID;
+
+		if (requestID < 0 || (size_t) requestID >= issued
+		 || sent[requestID] == 0)
+		{
+			continue;
+		}
+
+		latencies[completed++] = now - sent[requestID];
+		sent[requestID]        = 0;
+		errors                += message.pdu.errorStatus != SNMP_NO_ERROR;
+
+		if (outstanding > 0)
+		{
+			outstanding--;
+		}
+	}
+
+	const double seconds = (double) (clockMonotonic() - start)
+	                     / (double) NANOSECONDS_PER_SECOND;
+
+	tickStop();
+	atomic_store(&serving, false);
+	thrd_join(server, NULL);
+
+	const size_t ticks = MIN(tickCount, (size_t) MAX_TICK_SAMPLES);
+
+	qsort(latencies, completed, sizeof(uint64_t), compareUnsigned);
+	qsort(tickLateness, ticks, sizeof(uint64_t), compareUnsigned);
+
+	printf("{\"requests\":%zu,\"completed\":%zu,\"timeouts\":%zu,"
+	       "\"errors\":%zu,\"window\":%zu,\"max_repetitions\":%u,"
+	       "\"mix\":{",
+	       options.requests, completed, timeouts, errors, options.window,
+	       (unsigned) options.repetitions);
+
+	for (size_t operation = 0; operation < OPERATION_COUNT; operation++)
+	{
+		printf("%s\"%s\":%u", operation != 0 ? "," : "",
+		       operationNames[operation],
+		       (unsigned) options.weights[operation]);
+	}
+
+	printf("},\"seconds\":%.3f,\"throughput\":%.1f,"
+	       "\"latency_us\":{\"p50\":%.1f,\"p99\":%.1f,\"p999\":%.1f,"
+	       "\"max\":%.1f},"
+	       "\"tick\":{\"count\":%zu,\"real_time\":%s,\"overruns\":%u,"
+	       "\"jitter_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f}}}\n",
+	       seconds, (double) completed / seconds,
+	       percentile(latencies, completed, 0.50),
+	       percentile(latencies, completed, 0.99),
+	       percentile(latencies, completed, 0.999),
+	       percentile(latencies, completed, 1.0),
+	       tickCount, tickStatus.tickRealTime == 1 ? "true" : "false",
+	       (unsigned) tickStatus.tickOverruns,
+	       percentile(tickLateness, ticks, 0.50),
+	       percentile(tickLateness, ticks, 0.99),
+	       percentile(tickLateness, ticks, 1.0));
+
+	free(sent);
+	free(latencies);
+	close(client);
+	agentClose(&agent);
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Common.h>
+
+/* Subcommands of the bench, selected by the first argument. Each takes the
+ * arguments that follow it and prints its results as one JSON object.
+ */
+
+/* Latency from a preempt input to the masks it drives. */
+int32_t benchPreempt (int32_t argc, const char *const argv[]);
+
+/* Size and speed of a snapshot against a GETBULK walk. */
+int32_t benchSnapshot (int32_t argc, const char *const argv[]);
+
+/* Rendering of a MULTI message against its cached rendering. */
+int32_t benchSign (int32_t argc, const char *const argv[]);
+
+/* Batches of vehicles counted into the zone accumulators. */
+int32_t benchZone (int32_t argc, const char *const argv[]);
+
+/* Jitter of the SPaT forwarded on every tick under load. */
+int32_t benchForward (int32_t argc, const char *const argv[]);
+
+/* Cost of SNMPv3 with authentication and privacy over SNMPv2c. */
+int32_t benchUSM (int32_t argc, const char *const argv[]);
+
+#endif /* BENCH_H */
@@ -0,0 +1,399 @@
+/* Jitter of the SPaT forwarded at the rate of the tick. An intersection of
+ * 64 phases, eight dual rings cycling through their phases, is predicted
+ * and built into the queue on every tick while producer threads flood it
+ * with immediate forward messages, and a simulated radio taking a fixed
+ * time per message timestamps the arrivals of the SPaT. The jitter is how
+ * far an interval between two arrivals strays from the tick period; the
+ * latency runs from the commit of a SPaT to its arrival.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Calendar.h>
+#include <Clock.h>
+#include <Database.h>
+#include <Forward.h>
+#include <Spat.h>
+#include <Tick.h>
+
+#define BENCH_PHASES 64
+
+/* Ticks of the green, yellow and all red of each pair of phases. */
+#define GREEN_TICKS  40
+#define YELLOW_TICKS 4
+#define RED_TICKS    2
+#define PAIR_TICKS   (GREEN_TICKS + YELLOW_TICKS + RED_TICKS)
+
+/* Service identifier of the messages of the producers. */
+#define PRODUCER_PSID UINT32_C(0x20)
+
+typedef struct Options
+{
+	uint64_t   seconds;
+	size_t     producers;
+	uint64_t   rate;      /* Messages per second of each producer. */
+	uint64_t   cost;      /* Nanoseconds the radio takes per message. */
+	TickConfig tick;
+} Options;
+
+/* Owned by the thread of the queue until it is stopped. */
+static struct
+{
+	uint64_t cost;
+	uint64_t *arrivals;
+	uint64_t *latencies;
+	size_t    capacity;
+	size_t    spats;
+	size_t    others;
+} radio;
+
+static atomic_bool producing;
+
+/* Cost of the predictor, owned by the tick thread. */
+static struct
+{
+	uint64_t ticks;
+	uint64_t total;
+	uint64_t maximum;
+} prediction;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr,
+	        "usage: bench %s [-s seconds] [-p producers] [-r rate]"
+	        " [-d radio-us] [-R tick-priority] [-c tick-cpu]\n",
+	        command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options =
+	{
+		.seconds   = 20,
+		.producers = 4,
+		.rate      = 1000,
+		.cost      = 20 * 1000,
+		.tick      = { .realTime = false, .cpu = -1 }
+	};
+
+	int option;
+
+	while ((option = getopt(argc, (char *const *) argv, "s:p:r:d:R:c:")) != -1)
+	{
+		switch (option)
+		{
+			case 's':
+				options.seconds = strtoull(optarg, NULL, 10);
+				break;
+
+			case 'p':
+				options.producers = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'r':
+				options.rate = strtoull(optarg, NULL, 10);
+				break;
+
+			case 'd':
+				options.cost = strtoull(optarg, NULL, 10) * 1000;
+				break;
+
+			case 'R':
+				options.tick.realTime = true;
+				options.tick.priority = atoi(optarg);
+				break;
+
+			case 'c':
+				options.tick.cpu = atoi(optarg);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.seconds == 0 || options.rate == 0)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+/* Every phase enabled, each group of eight an intersection of its own
+ * concurrent with the others: a dual ring of phases 1 to 4 and 5 to 8, with
+ * a barrier after phases 2 and 6.
+ */
+static void configure (void)
+{
+	static const uint8_t pairs[8][2] =
+	{
+		{ 5, 6 }, { 5, 6 }, { 7, 8 }, { 7, 8 },
+		{ 1, 2 }, { 1, 2 }, { 3, 4 }, { 3, 4 }
+	};
+
+	for (size_t phase = 0; phase < asc.phase.maxPhases; phase++)
+	{
+		PhaseEntry *const entry = &asc.phase.phaseTable[phase];
+		const size_t      base  = phase / 8 * 8;
+		uint8_t           concurrent[BENCH_PHASES];
+		size_t            count = 0;
+
+		for (size_t other = 0; other < asc.phase.maxPhases; other++)
+		{
+			if (other / 8 != phase / 8)
+			{
+				concurrent[count++] = (uint8_t) (other + 1);
+			}
+		}
+
+		concurrent[count++] = (uint8_t) (base + pairs[phase % 8][0]);
+		concurrent[count++] = (uint8_t) (base + pairs[phase % 8][1]);
+
+		entry->phaseOptions     |= 1;
+		entry->phaseRing         = (uint8_t) (phase / 4 + 1);
+		entry->phaseMinimumGreen = 2;
+		entry->phaseMaximum1     = 6;
+		entry->phasePassage      = 20;
+		entry->phaseYellowChange = YELLOW_TICKS;
+		entry->phaseRedClear     = RED_TICKS;
+		OCTET_BUFFER_SET(entry->phaseConcurrency, concurrent, count);
+	}
+
+	spatInvalidate();
+}
+
+/* Tick hook: times the pairs of phases of every group in turn, with calls
+ * on all of them.
+ */
+static void cycle (const uint64_t deadline, const uint64_t now)
+{
+	(void) now;
+
+	const uint64_t tick = deadline / TICK_PERIOD;
+	const uint64_t into = tick % PAIR_TICKS;
+	const uint8_t  pair = (uint8_t) (0x11 << (tick / PAIR_TICKS % 4));
+
+	const uint8_t  greens  = into < GREEN_TICKS ? pair : 0;
+	const uint8_t  yellows = into >= GREEN_TICKS
+	                      && into < GREEN_TICKS + YELLOW_TICKS ? pair : 0;
+
+	for (size_t group = 0; group < asc.phase.maxPhaseGroups; group++)
+	{
+		PhaseStatusGroupEntry *const entry =
+			&asc.phase.phaseStatusGroupTable[group];
+
+		entry->phaseStatusGroupGreens   = greens;
+		entry->phaseStatusGroupYellows  = yellows;
+		entry->phaseStatusGroupReds     = (uint8_t) ~(greens | yellows);
+		entry->phaseStatusGroupVehCalls = UINT8_MAX;
+	}
+}
+
+static void predict (const uint64_t deadline, const uint64_t now)
+{
+	const uint64_t start = clockMonotonic();
+
+	spatTick(deadline, now);
+
+	const uint64_t elapsed = clockMonotonic() - start;
+
+	prediction.ticks++;
+	prediction.total  += elapsed;
+	prediction.maximum = MAX(prediction.maximum, elapsed);
+}
+
+static bool transmit (void *const context, const ForwardMessage *const message)
+{
+	(void) context;
+
+	const uint64_t arrival = clockMonotonic();
+
+	if (message->psid == FORWARD_PSID_SPAT && radio.spats < radio.capacity)
+	{
+		radio.arrivals[radio.spats]  = arrival;
+		radio.latencies[radio.spats] = arrival - message->committed;
+		radio.spats++;
+	}
+	else
+	{
+		radio.others++;
+	}
+
+	while (clockMonotonic() - arrival < radio.cost)
+	{
+	}
+
+	return true;
+}
+
+static void sleepFor (const uint64_t nanoseconds)
+{
+	const struct timespec interval =
+	{
+		.tv_sec  = (time_t) (nanoseconds / NANOSECONDS_PER_SECOND),
+		.tv_nsec = (long) (nanoseconds % NANOSECONDS_PER_SECOND)
+	};
+
+	nanosleep(&interval, NULL);
+}
+
+static int produce (void *const argument)
+{
+	const uint64_t interval = *(const uint64_t *) argument;
+	uint8_t        payload[200];
+
+	memset(payload, 0xA5, sizeof(payload));
+
+	while (atomic_load_explicit(&producing, memory_order_relaxed))
+	{
+		forwardSubmit(PRODUCER_PSID, 172, 10, payload, sizeof(payload));
+		sleepFor(interval);
+	}
+
+	return 0;
+}
+
+static int compareUnsigned (const void *const left, const void *const right)
+{
+	const uint64_t a = *(const uint64_t *) left;
+	const uint64_t b = *(const uint64_t *) right;
+
+	return (a > b) - (a < b);
+}
+
+/* Nearest-rank percentile of sorted samples, in microseconds. */
+static double percentile (const uint64_t *const samples, const size_t count,
+                          const double fraction)
+{
+	size_t rank = (size_t) (fraction * (double) count + 0.5);
+
+	rank = MIN(MAX(rank, 1), count);
+
+	return (double) samples[rank - 1] / 1000.0;
+}
+
+/* Average time to build the SPaT of the intersection, in nanoseconds. */
+static double buildTime (void)
+{
+	uint8_t        buffer[SPAT_MAX_OCTETS];
+	const size_t   rounds = 100000;
+	const uint64_t start  = clockMonotonic();
+
+	for (size_t round = 0; round < rounds; round++)
+	{
+		spatEncode(buffer, sizeof(buffer), calendarNow());
+	}
+
+	return (double) (clockMonotonic() - start) / (double) rounds;
+}
+
+int32_t benchForward (const int32_t argc, const char *const argv[])
+{
+	const Options  options = parseOptions(argc, argv);
+	DatabaseLimits limits  = DATABASE_LIMITS;
+
+	limits.maxPhases = BENCH_PHASES;
+
+	if (!databaseInit(&limits) || !forwardInit() || !spatInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	calendarInit();
+	configure();
+
+	radio.cost      = options.cost;
+	radio.capacity  = (size_t) (options.seconds * NANOSECONDS_PER_SECOND
+	                            / TICK_PERIOD) + 16;
+	radio.arrivals  = calloc(radio.capacity, sizeof(uint64_t));
+	radio.latencies = calloc(radio.capacity, sizeof(uint64_t));
+
+	thrd_t *const producers = calloc(options.producers + 1, sizeof(thrd_t));
+
+	if (!radio.arrivals || !radio.latencies || !producers)
+	{
+		fputs("Unable to allocate the samples.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const double         build   = buildTime();
+	const uint64_t       spacing = NANOSECONDS_PER_SECOND / options.rate;
+	const ForwardBackend backend = { .transmit = transmit };
+
+	tickRegister(calendarTick);
+	tickRegister(cycle);
+	tickRegister(predict);
+	tickRegister(forwardTick);
+	atomic_store(&producing, true);
+
+	if (!forwardStart(&backend) || !tickStart(&options.tick))
+	{
+		fputs("Unable to start the tick.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	for (size_t producer = 0; producer < options.producers; producer++)
+	{
+		thrd_create(&producers[producer], produce, (void *) &spacing);
+	}
+
+	sleepFor(options.seconds * NANOSECONDS_PER_SECOND);
+
+	atomic_store(&producing, false);
+
+	for (size_t producer = 0; producer < options.producers; producer++)
+	{
+		thrd_join(producers[producer], NULL);
+	}
+
+	tickStop();
+	forwardStop();
+
+	/* Intervals between arrivals, as distances from the tick period. */
+	const size_t intervals = radio.spats > 1 ? radio.spats - 1 : 0;
+
+	for (size_t index = 0; index < intervals; index++)
+	{
+		const uint64_t interval =
+			radio.arrivals[index + 1] - radio.arrivals[index];
+
+		radio.arrivals[index] = interval > TICK_PERIOD
+		                      ? interval - TICK_PERIOD
+		                      : TICK_PERIOD - interval;
+	}
+
+	qsort(radio.arrivals, intervals, sizeof(uint64_t), compareUnsigned);
+	qsort(radio.latencies, radio.spats, sizeof(uint64_t), compareUnsigned);
+
+	printf("{\"phases\":%u,\"spats\":%zu,\"messages\":%zu,"
+	       "\"producers\":%zu,\"overflows\":%u,"
+	       "\"build_ns\":%.1f,\"spat_octets\":%zu,"
+	       "\"predict_ns\":{\"mean\":%.1f,\"max\":%.1f},"
+	       "\"jitter_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f},"
+	       "\"latency_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f}}\n",
+	       asc.phase.maxPhases, radio.spats, radio.others,
+	       options.producers, (unsigned) forwardStatus.forwardOverflows, build,
+	       (size_t) SPAT_HEADER_OCTETS
+	       + BENCH_PHASES * SPAT_MOVEMENT_OCTETS,
+	       (double) prediction.total / (double) MAX(prediction.ticks, 1),
+	       (double) prediction.maximum,
+	       percentile(radio.arrivals, intervals, 0.50),
+	       percentile(radio.arrivals, intervals, 0.99),
+	       percentile(radio.arrivals, intervals, 1.0),
+	       percentile(radio.latencies, radio.spats, 0.50),
+	       percentile(radio.latencies, radio.spats, 0.99),
+	       percentile(radio.latencies, radio.spats, 1.0));
+
+	free(producers);
+	free(radio.arrivals);
+	free(radio.latencies);
+	spatFree();
+	forwardFree();
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
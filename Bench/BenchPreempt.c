@@ -0,0 +1,225 @@
+/* Latency of preemption. A preempt is called at random instants while the
+ * tick runs, and this thread spins until the force-off mask it drives
+ * changes; the interval is the input-to-output latency of the preempt.
+ * With -T the input thread is not started, so that the latency of picking
+ * the call up on the next tick can be compared.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Database.h>
+#include <Device.h>
+#include <Metrics.h>
+#include <Preempt.h>
+#include <Registry.h>
+#include <Tick.h>
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+typedef struct Options
+{
+	size_t     samples;
+	bool       tickOnly;
+	TickConfig tick;
+} Options;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr,
+	        "usage: bench %s [-n samples] [-T] [-R tick-priority]"
+	        " [-c tick-cpu]\n",
+	        command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options =
+	{
+		.samples = 200,
+		.tick    = { .realTime = false, .cpu = -1 }
+	};
+
+	int option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:TR:c:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.samples = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'T':
+				options.tickOnly = true;
+				break;
+
+			case 'R':
+				options.tick.realTime = true;
+				options.tick.priority = atoi(optarg);
+				break;
+
+			case 'c':
+				options.tick.cpu = atoi(optarg);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.samples == 0)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+/* Every phase enabled with no clearance, and preempt 1 dwelling in phase 1,
+ * so that a call forces the other phases off at once and ends as soon as it
+ * is withdrawn.
+ */
+static void configure (void)
+{
+	for (size_t phase = 0; phase < asc.phase.maxPhases; phase++)
+	{
+		PhaseEntry *const entry = &asc.phase.phaseTable[phase];
+
+		entry->phaseOptions     |= 1;
+		entry->phaseYellowChange = 0;
+		entry->phaseRedClear     = 0;
+	}
+
+	PreemptEntry *const preempt = &asc.preempt.preemptTable[0];
+
+	preempt->preemptDelay           = 0;
+	preempt->preemptMinimumDuration = 0;
+	preempt->preemptDwellGreen      = 0;
+	OCTET_BUFFER_SET(preempt->preemptDwellPhase, (const uint8_t []) { 1 }, 1);
+
+	preemptInvalidate();
+}
+
+static uint8_t forceOff (void)
+{
+	preemptLock();
+
+	const uint8_t mask =
+		asc.phase.phaseControlGroupTable[0].phaseControlGroupForceOff;
+
+	preemptUnlock();
+
+	return mask;
+}
+
+static void sleepFor (const uint64_t nanoseconds)
+{
+	const struct timespec interval =
+	{
+		.tv_sec  = (time_t) (nanoseconds / NANOSECONDS_PER_SECOND),
+		.tv_nsec = (long) (nanoseconds % NANOSECONDS_PER_SECOND)
+	};
+
+	nanosleep(&interval, NULL);
+}
+
+static int compareUnsigned (const void *const left, const void *const right)
+{
+	const uint64_t a = *(const uint64_t *) left;
+	const uint64_t b = *(const uint64_t *) right;
+
+	return (a > b) - (a < b);
+}
+
+/* Nearest-rank percentile of sorted samples, in microseconds. */
+static double percentile (const uint64_t *const samples, const size_t count,
+                          const double fraction)
+{
+	size_t rank = (size_t) (fraction * (double) count + 0.5);
+
+	rank = MIN(MAX(rank, 1), count);
+
+	return (double) samples[rank - 1] / 1000.0;
+}
+
+int32_t benchPreempt (const int32_t argc, const char *const argv[])
+{
+	const Options options = parseOptions(argc, argv);
+	uint64_t      state   = 0x9E3779B97F4A7C15;
+
+	deviceRegister(&ascDevice);
+
+	if (!databaseInit(&limits) || !preemptInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	registryInit();
+	configure();
+
+	uint64_t *const latencies = calloc(options.samples, sizeof(uint64_t));
+
+	if (!latencies)
+	{
+		fputs("Unable to allocate the samples.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	tickRegister(preemptTick);
+
+	if (!tickStart(&options.tick)
+	 || (!options.tickOnly && !preemptStart(&options.tick)))
+	{
+		fputs("Unable to start the tick.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	for (size_t sample = 0; sample < options.samples; sample++)
+	{
+		/* Calls fall anywhere within the tick period. */
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		sleepFor(state % TICK_PERIOD + NANOSECONDS_PER_MILLISECOND);
+
+		const uint8_t  before = forceOff();
+		const uint64_t start  = clockMonotonic();
+
+		preemptInput(1, true);
+
+		while (forceOff() == before)
+		{
+		}
+
+		latencies[sample] = clockMonotonic() - start;
+
+		preemptInput(1, false);
+
+		while (preemptActive())
+		{
+			sleepFor(NANOSECONDS_PER_MILLISECOND);
+		}
+	}
+
+	preemptStop();
+	tickStop();
+
+	qsort(latencies, options.samples, sizeof(uint64_t), compareUnsigned);
+
+	printf("{\"samples\":%zu,\"path\":\"%s\",\"real_time\":%s,"
+	       "\"latency_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f}}\n",
+	       options.samples, options.tickOnly ? "tick" : "input",
+	       options.tick.realTime ? "true" : "false",
+	       percentile(latencies, options.samples, 0.50),
+	       percentile(latencies, options.samples, 0.99),
+	       percentile(latencies, options.samples, 1.0));
+
+	free(latencies);
+	preemptFree();
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/* Cost of rendering a MULTI message against finding it in the cache. A font
+ * of printable ASCII with made-up glyphs is loaded into the database and a
+ * three page message is rendered from scratch, emptying the cache before
+ * every round, and then from the cache.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Clock.h>
+#include <Database.h>
+#include <Sign.h>
+
+#define FONT_HEIGHT 7
+#define FONT_WIDTH  5
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+static const char message[] =
+	"[jp3][pt25o5]ROAD WORK[nl]NEXT 2 MILES[nl]EXPECT DELAYS"
+	"[np][jl2]LEFT LANE[nl][jl3]CLOSED[nl][jl4]MERGE RIGHT"
+	"[np][fo1][sc2]USE CAUTION[/sc][nl]SLOW DOWN[nl]FINES DOUBLED";
+
+typedef struct Options
+{
+	size_t rounds;
+} Options;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr, "usage: bench %s [-n rounds]\n", command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options = { .rounds = 10000 };
+	int     option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.rounds = strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.rounds == 0)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+/* Font 1: printable ASCII, each glyph a pattern drawn from its code. */
+static bool loadFont (void)
+{
+	FontDefinition *const fonts = &dms.fontDefinition;
+	FontEntry *const      font  = &fonts->fontTable[0];
+	uint8_t               bitmap[(FONT_HEIGHT * FONT_WIDTH + 7) / 8];
+
+	font->fontHeight      = FONT_HEIGHT;
+	font->fontCharSpacing = 1;
+	font->fontLineSpacing = 2;
+	font->fontStatus      = FONT_STATUS_READY_FOR_USE;
+
+	for (uint16_t code = ' '; code <= '~'; code++)
+	{
+		CharacterEntry *const character =
+			&fonts->characterTable[code - 1];
+
+		for (size_t index = 0; index < sizeof(bitmap); index++)
+		{
+			bitmap[index] = (uint8_t) (code * 37 + index * 101);
+		}
+
+		character->characterWidth = code == ' ' ? 3 : FONT_WIDTH;
+
+		if (!OCTET_BUFFER_SET(character->characterBitmap, bitmap,
+		                      sizeof(bitmap)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32_t benchSign (const int32_t argc, const char *const argv[])
+{
+	const Options options = parseOptions(argc, argv);
+
+	if (!databaseInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	MultiText multi;
+
+	if (!loadFont() || !signInit()
+	 || !OCTET_BUFFER_SET(multi, message, strlen(message)))
+	{
+		fputs("Unable to load the font.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const MultiMessage   *rendered = NULL;
+	enum MultiSyntaxError error    = MULTI_SYNTAX_NONE;
+	size_t                position = 0;
+	uint64_t              cold     = 0;
+	uint64_t              cached   = 0;
+
+	for (size_t round = 0; round < options.rounds; round++)
+	{
+		signInvalidate();
+
+		uint64_t start = clockMonotonic();
+
+		rendered = signRender(&multi, 1, &error, &position);
+		cold    += clockMonotonic() - start;
+
+		start     = clockMonotonic();
+		rendered  = rendered ? signRender(&multi, 1, &error, &position)
+		                     : NULL;
+		cached   += clockMonotonic() - start;
+
+		if (!rendered)
+		{
+			fprintf(stderr, "The message does not render: error %d at %zu.\n",
+			        (int) error, position);
+			return EXIT_FAILURE;
+		}
+	}
+
+	const double rounds = (double) options.rounds * 1000.0;
+
+	printf("{\"rounds\":%zu,\"octets\":%zu,\"pages\":%u,"
+	       "\"render_us\":%.2f,\"cached_us\":%.3f,\"speedup\":%.1f}\n",
+	       options.rounds, sizeof(message) - 1,
+	       (unsigned) rendered->pageCount, (double) cold / rounds,
+	       (double) cached / rounds, (double) cold / (double) cached);
+
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
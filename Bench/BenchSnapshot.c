@@ -0,0 +1,347 @@
+/* Size and speed of a snapshot against a walk. The agent runs in-process on
+ * the loopback interface and every object below devices is walked with
+ * GETBULK, the way a manager would back up a controller; the same state is
+ * then written as a snapshot and read back into a second tree.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Access.h>
+#include <Agent.h>
+#include <Change.h>
+#include <Database.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Registry.h>
+#include <Snapshot.h>
+#include <Sync.h>
+#include <Transaction.h>
+
+/* Room for the snapshot of the largest tree. */
+#define SNAPSHOT_CAPACITY (4 * 1024 * 1024)
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+static const OID devices = DEVICES_NODE_OID;
+
+static Agent       agent;
+static atomic_bool serving;
+static Global      copyGlobal;
+static ASC         copyASC;
+static DMS         copyDMS;
+static ESS         copyESS;
+static TSS         copyTSS;
+static RSU         copyRSU;
+static RMC         copyRMC;
+
+static const ObjectTree copy =
+{
+	.global = &copyGlobal, .asc = &copyASC, .dms = &copyDMS, .ess = &copyESS,
+	.tss    = &copyTSS,    .rsu = &copyRSU, .rmc = &copyRMC
+};
+
+typedef struct Options
+{
+	size_t   rounds;
+	uint32_t repetitions;
+} Options;
+
+typedef struct Image
+{
+	uint8_t *data;
+	size_t   length;
+	size_t   position;
+} Image;
+
+typedef struct Walk
+{
+	size_t requests;
+	size_t octets;
+	size_t instances;
+} Walk;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr, "usage: bench %s [-n rounds] [-r max-repetitions]\n",
+	        command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options = { .rounds = 20, .repetitions = 32 };
+	int     option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:r:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.rounds = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'r':
+				options.repetitions = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.rounds == 0 || options.repetitions == 0)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+static int serve (void *const argument)
+{
+	(void) argument;
+
+	while (atomic_load_explicit(&serving, memory_order_relaxed))
+	{
+		if (!agentServe(&agent, 50))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static bool sink (void *const context, const uint8_t *const data,
+                  const size_t length)
+{
+	Image *const image = context;
+
+	if (length > SNAPSHOT_CAPACITY - image->length)
+	{
+		return false;
+	}
+
+	memcpy(image->data + image->length, data, length);
+	image->length += length;
+
+	return true;
+}
+
+static size_t source (void *const context, uint8_t *const data,
+                      const size_t capacity)
+{
+	Image *const image = context;
+	const size_t part  = MIN(capacity, image->length - image->position);
+
+	memcpy(data, image->data + image->position, part);
+	image->position += part;
+
+	return part;
+}
+
+/* Walks every instance below devices, counting the octets received. */
+static bool walk (const int client, const uint32_t repetitions,
+                  Walk *const result)
+{
+	static SNMPMessage message;
+	static uint8_t     buffer[SNMP_MAX_MESSAGE];
+
+	OID  name = devices;
+	bool done = false;
+
+	*result = (Walk) { 0 };
+
+	while (!done)
+	{
+		message = (SNMPMessage)
+		{
+			.version         = SNMP_VERSION_2C,
+			.community       = (const uint8_t *) "public",
+			.communityLength = strlen("public"),
+			.pdu             =
+			{
+				.type       = SNMP_GET_BULK_REQUEST,
+				.requestID  = (int32_t) result->requests,
+				.errorIndex = (int32_t) repetitions,
+				.count      = 1
+			}
+		};
+
+		message.pdu.varbinds[0] = (VarBind) { .name = name, .type = BER_NULL };
+
+		const size_t length = snmpEncode(&message, buffer, sizeof(buffer));
+
+		if (length == 0 || send(client, buffer, length, 0) < 0)
+		{
+			return false;
+		}
+
+		const ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+
+		if (received <= 0
+		 || !snmpDecode(buffer, (size_t) received, &message)
+		 || message.pdu.errorStatus != SNMP_NO_ERROR
+		 || message.pdu.count == 0)
+		{
+			return false;
+		}
+
+		result->requests++;
+		result->octets += (size_t) received;
+
+		for (size_t index = 0; index < message.pdu.count && !done; index++)
+		{
+			const VarBind *const varbind = &message.pdu.varbinds[index];
+
+			done = varbind->type == BER_END_OF_MIB_VIEW
+			    || !oidIsPrefix(&devices, &varbind->name);
+
+			if (!done)
+			{
+				name = varbind->name;
+				result->instances++;
+			}
+		}
+	}
+
+	return true;
+}
+
+int32_t benchSnapshot (const int32_t argc, const char *const argv[])
+{
+	const Options options = parseOptions(argc, argv);
+
+	const AgentConfig config =
+	{
+		.address =
+		{
+			.sin_family      = AF_INET,
+			.sin_port        = 0,
+			.sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+		}
+	};
+
+	static const Device *const devices[] =
+	{
+		&ascDevice, &dmsDevice, &essDevice, &tssDevice, &rsuDevice,
+		&rmcDevice
+	};
+
+	for (size_t index = 0; index < sizeof(devices) / sizeof(devices[0]);
+	     index++)
+	{
+		deviceRegister(devices[index]);
+	}
+
+	if (!databaseInit(&limits) || !databaseInitTree(&copy, &limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	registryInit();
+
+	(void) accessGroup(ACCESS_COMMUNITY, "public", "all", NULL, false);
+	accessCompile();
+	changeInit(&limits);
+
+	if (!transactionInit(&limits) || !syncInit(&limits))
+	{
+		fputs("Unable to allocate the transaction buffer.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	struct sockaddr_in address;
+	socklen_t          addressLength = sizeof(address);
+	thrd_t             server;
+
+	if (!agentInit(&agent, &config)
+	 || getsockname(agent.socket, (struct sockaddr *) &address,
+	                &addressLength) < 0)
+	{
+		perror("Unable to open the agent socket");
+		return EXIT_FAILURE;
+	}
+
+	const int client = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if (client < 0
+	 || connect(client, (const struct sockaddr *) &address,
+	            addressLength) < 0)
+	{
+		perror("Unable to open the client socket");
+		return EXIT_FAILURE;
+	}
+
+	Image image = { .data = malloc(SNAPSHOT_CAPACITY) };
+
+	if (!image.data)
+	{
+		fputs("Unable to allocate the snapshot.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	atomic_store(&serving, true);
+
+	if (thrd_create(&server, serve, NULL) != thrd_success)
+	{
+		fputs("Unable to start the agent.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	Walk     result    = { 0 };
+	uint64_t walkTime  = 0;
+	uint64_t writeTime = 0;
+	uint64_t readTime  = 0;
+	bool     ok        = true;
+
+	for (size_t round = 0; round < options.rounds && ok; round++)
+	{
+		uint64_t start = clockMonotonic();
+
+		ok = walk(client, options.repetitions, &result);
+		walkTime += clockMonotonic() - start;
+
+		image.length = 0;
+		start        = clockMonotonic();
+		ok           = ok && snapshotWrite(&database, sink, &image);
+		writeTime   += clockMonotonic() - start;
+
+		image.position = 0;
+		start          = clockMonotonic();
+		ok             = ok && snapshotRead(&copy, source, &image);
+		readTime      += clockMonotonic() - start;
+	}
+
+	atomic_store(&serving, false);
+	thrd_join(server, NULL);
+
+	if (!ok)
+	{
+		fputs("The walk or the snapshot failed.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const double rounds = (double) options.rounds * 1000.0;
+
+	printf("{\"rounds\":%zu,\"max_repetitions\":%u,"
+	       "\"walk\":{\"instances\":%zu,\"requests\":%zu,\"octets\":%zu,"
+	       "\"us\":%.1f},"
+	       "\"snapshot\":{\"octets\":%zu,\"write_us\":%.1f,\"read_us\":%.1f},"
+	       "\"ratio\":%.2f}\n",
+	       options.rounds, (unsigned) options.repetitions, result.instances,
+	       result.requests, result.octets, (double) walkTime / rounds,
+	       image.length, (double) writeTime / rounds,
+	       (double) readTime / rounds,
+	       (double) result.octets / (double) image.length);
+
+	free(image.data);
+	close(client);
+	agentClose(&agent);
+	databaseFreeTree(&copy);
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
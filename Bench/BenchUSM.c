@@ -0,0 +1,315 @@
+/* Cost of SNMPv3 over SNMPv2c. The same GET of phaseTable columns is
+ * answered by agentProcess() in-process, as SNMPv2c, as SNMPv3 with
+ * authentication and as SNMPv3 with authentication and privacy, so that
+ * the difference is what the security model costs per request. Every
+ * request is encoded anew, with a fresh salt, outside the time taken. The
+ * one-off costs, turning a password into a key and localizing a key to an
+ * engine, are timed on their own.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Access.h>
+#include <Agent.h>
+#include <Clock.h>
+#include <Database.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Registry.h>
+#include <USM.h>
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+/* Engines the keys are localized to in turn, one more than the cache holds
+ * so that every localization misses.
+ */
+#define ENGINES (USM_KEY_CACHE + 1)
+
+enum
+{
+	MODE_V2C,
+	MODE_AUTH,
+	MODE_PRIV,
+	MODE_COUNT
+};
+
+static const char *const modeNames[MODE_COUNT] = { "v2c", "auth", "priv" };
+
+static Agent agent;
+
+typedef struct Options
+{
+	size_t requests;
+	size_t varbinds;
+} Options;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr, "usage: bench %s [-n requests] [-v varbinds]\n",
+	        command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options = { .requests = 200000, .varbinds = 8 };
+	int     option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:v:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.requests = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'v':
+				options.varbinds = strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.requests == 0 || options.varbinds == 0
+	 || options.varbinds > limits.maxPhases)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+/* Encodes a GET of phaseMinimumGreen of the first phases the way a manager
+ * that has discovered the engine would.
+ */
+static size_t buildRequest (SNMPMessage *const message, const size_t mode,
+                            const Options *const options,
+                            const int32_t requestID, uint8_t *const buffer)
+{
+	static const char *const users[MODE_COUNT] =
+	{
+		[MODE_AUTH] = "bench-auth", [MODE_PRIV] = "bench-priv"
+	};
+
+	const USMEngine *const engine = usmEngine();
+
+	message->pdu.type        = SNMP_GET_REQUEST;
+	message->pdu.requestID   = requestID;
+	message->pdu.errorStatus = 0;
+	message->pdu.errorIndex  = 0;
+	message->pdu.count       = options->varbinds;
+
+	for (size_t index = 0; index < options->varbinds; index++)
+	{
+		message->pdu.varbinds[index] = (VarBind)
+		{
+			.name = ASC_OID(1, 2, 1, 4, (uint32_t) index + 1),
+			.type = BER_NULL
+		};
+	}
+
+	if (mode == MODE_V2C)
+	{
+		message->version         = SNMP_VERSION_2C;
+		message->community       = (const uint8_t *) "public";
+		message->communityLength = strlen("public");
+
+		return snmpEncode(message, buffer, SNMP_MAX_MESSAGE);
+	}
+
+	SNMPSecurity *const security = &message->security;
+
+	message->version = SNMP_VERSION_3;
+
+	*security = (SNMPSecurity)
+	{
+		.msgID          = requestID,
+		.maxSize        = SNMP_MAX_MESSAGE,
+		.flags          = SNMP_FLAG_AUTH | SNMP_FLAG_REPORTABLE
+		                | (mode == MODE_PRIV ? SNMP_FLAG_PRIV : 0),
+		.engineBoots    = engine->snmpEngineBoots,
+		.engineTime     = engine->snmpEngineTime,
+		.userName       = (const uint8_t *) users[mode],
+		.userNameLength = strlen(users[mode])
+	};
+
+	security->engineID = octetStringData(&engine->snmpEngineID,
+	                                     &security->engineIDLength);
+	security->contextEngineID       = security->engineID;
+	security->contextEngineIDLength = security->engineIDLength;
+	security->contextName           = security->engineID;
+	security->contextNameLength     = 0;
+
+	return usmEncode(message, usmFind(security->userName,
+	                                  security->userNameLength),
+	                 buffer, SNMP_MAX_MESSAGE);
+}
+
+/* Answers options->requests GETs in a mode and returns the nanoseconds they
+ * took, or zero if one was not answered with the values asked for.
+ */
+static uint64_t run (const size_t mode, const Options *const options,
+                     size_t *const octets)
+{
+	static SNMPMessage message;
+	static uint8_t     request[SNMP_MAX_MESSAGE];
+	static uint8_t     response[SNMP_MAX_MESSAGE];
+	static uint8_t     plain[SNMP_MAX_MESSAGE];
+
+	uint64_t elapsed = 0;
+
+	for (size_t done = 0; done < options->requests; done++)
+	{
+		const int32_t requestID = (int32_t) (done & INT32_MAX);
+		const size_t  length    = buildRequest(&message, mode, options,
+		                                       requestID, request);
+
+		const uint64_t start   = clockMonotonic();
+		const size_t   encoded = agentProcess(&agent, request, length,
+		                                      response, sizeof(response));
+
+		elapsed += clockMonotonic() - start;
+
+		if (length == 0 || encoded == 0)
+		{
+			return 0;
+		}
+
+		*octets = encoded;
+
+		/* Check the first response the way the manager would. The engine
+		 * is the same, so it decodes as a request to it would.
+		 */
+		if (done == 0)
+		{
+			USMUser *user;
+			const bool decoded = mode == MODE_V2C
+				? snmpDecode(response, encoded, &message)
+				: usmDecode(response, encoded, plain, &message, &user)
+				      == USM_OK;
+
+			if (!decoded || message.pdu.type != SNMP_RESPONSE
+			 || message.pdu.requestID != requestID
+			 || message.pdu.errorStatus != SNMP_NO_ERROR
+			 || message.pdu.count != options->varbinds
+			 || message.pdu.varbinds[0].type != BER_INTEGER)
+			{
+				return 0;
+			}
+		}
+	}
+
+	return elapsed;
+}
+
+int32_t benchUSM (const int32_t argc, const char *const argv[])
+{
+	const Options options = parseOptions(argc, argv);
+
+	deviceRegister(&ascDevice);
+
+	if (!databaseInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	registryInit();
+	usmInit();
+
+	(void) accessGroup(ACCESS_COMMUNITY, "public", "all", NULL, false);
+	(void) accessGroup(ACCESS_USER, "bench-auth", "all", NULL, false);
+	(void) accessGroup(ACCESS_USER, "bench-priv", "all", NULL, false);
+	accessCompile();
+
+	agent.socket = -1;
+
+	uint64_t start = clockMonotonic();
+
+	if (!usmAddUser("bench-auth", "authentication", NULL)
+	 || !usmAddUser("bench-priv", "authentication", "privacy-key"))
+	{
+		fputs("Unable to add the users.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	/* Three passwords, each hashed over a megabyte. */
+	const double passwordTime = (double) (clockMonotonic() - start) / 3.0;
+
+	static const uint8_t prefix[] = { 0x80, 0x00, 0x7E, 0xD9, 4 };
+
+	USMUser *const user = usmFind((const uint8_t *) "bench-priv",
+	                              strlen("bench-priv"));
+	uint8_t        engineID[ENGINES][12];
+	const size_t   localizations = 10000;
+
+	for (size_t engine = 0; engine < ENGINES; engine++)
+	{
+		memcpy(engineID[engine], prefix, sizeof(prefix));
+		snprintf((char *) engineID[engine] + sizeof(prefix), 7, "bench%zu",
+		         engine);
+	}
+
+	start = clockMonotonic();
+
+	for (size_t index = 0; index < localizations; index++)
+	{
+		(void) usmLocalize(user, engineID[index % ENGINES], 11);
+	}
+
+	const double localizeTime =
+		(double) (clockMonotonic() - start) / (double) localizations;
+
+	/* Bring the keys of the agent back into the cache. */
+	const USMEngine *const engine = usmEngine();
+	size_t                 engineIDLength;
+	const uint8_t *const   agentEngineID =
+		octetStringData(&engine->snmpEngineID, &engineIDLength);
+
+	(void) usmLocalize(user, agentEngineID, engineIDLength);
+
+	uint64_t elapsed[MODE_COUNT];
+	size_t   octets[MODE_COUNT];
+
+	for (size_t mode = 0; mode < MODE_COUNT; mode++)
+	{
+		elapsed[mode] = run(mode, &options, &octets[mode]);
+
+		if (elapsed[mode] == 0)
+		{
+			fprintf(stderr, "The %s request was not answered.\n",
+			        modeNames[mode]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	double perRequest[MODE_COUNT];
+
+	for (size_t mode = 0; mode < MODE_COUNT; mode++)
+	{
+		perRequest[mode] = (double) elapsed[mode] / (double) options.requests;
+	}
+
+	printf("{\"requests\":%zu,\"varbinds\":%zu,", options.requests,
+	       options.varbinds);
+
+	for (size_t mode = 0; mode < MODE_COUNT; mode++)
+	{
+		printf("\"%s\":{\"ns_per_request\":%.1f,\"response_octets\":%zu,"
+		       "\"overhead_ns\":%.1f,\"overhead_percent\":%.1f},",
+		       modeNames[mode], perRequest[mode], octets[mode],
+		       perRequest[mode] - perRequest[MODE_V2C],
+		       100.0 * (perRequest[mode] - perRequest[MODE_V2C])
+		             / perRequest[MODE_V2C]);
+	}
+
+	printf("\"password_to_key_us\":%.1f,\"localize_ns\":%.1f}\n",
+	       passwordTime / 1000.0, localizeTime);
+
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
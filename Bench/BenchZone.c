@@ -0,0 +1,132 @@
+/* Cost of counting vehicles into the zone accumulators. Batches of vehicles
+ * spread at random over the zones of the sensor, with speeds and classes,
+ * are handed to zoneIngest() the way a radar driver would.
+ */
+
+#include "Bench.h"
+
+#include <NTCIP.h>
+#include <Calendar.h>
+#include <Clock.h>
+#include <Database.h>
+#include <Zone.h>
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+typedef struct Options
+{
+	size_t samples;
+	size_t batch;
+	size_t zones;
+} Options;
+
+static void usage (const char *const command)
+{
+	fprintf(stderr, "usage: bench %s [-n samples] [-b batch] [-z zones]\n",
+	        command);
+	exit(EXIT_FAILURE);
+}
+
+static Options parseOptions (const int32_t argc, const char *const argv[])
+{
+	Options options =
+	{
+		.samples = 10000000,
+		.batch   = 256,
+		.zones   = limits.numSensorZones
+	};
+	int option;
+
+	while ((option = getopt(argc, (char *const *) argv, "n:b:z:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				options.samples = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'b':
+				options.batch = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'z':
+				options.zones = strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	if (options.samples == 0 || options.batch == 0 || options.zones == 0
+	 || options.zones > limits.numSensorZones)
+	{
+		usage(argv[0]);
+	}
+
+	return options;
+}
+
+int32_t benchZone (const int32_t argc, const char *const argv[])
+{
+	const Options options = parseOptions(argc, argv);
+
+	if (!databaseInit(&limits) || !zoneInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	ZoneSample *const batch = calloc(options.batch, sizeof(batch[0]));
+
+	if (!batch)
+	{
+		fputs("Unable to allocate the batch.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	calendarInit();
+	tss.sampleData.samplePeriod = 60;
+	zoneTick(0, clockMonotonic());
+
+	uint64_t state   = 0x9E3779B97F4A7C15;
+	uint64_t elapsed = 0;
+	size_t   taken   = 0;
+
+	for (size_t done = 0; done < options.samples; done += options.batch)
+	{
+		for (size_t index = 0; index < options.batch; index++)
+		{
+			/* xorshift64 */
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+
+			batch[index] = (ZoneSample)
+			{
+				.zone         = (uint16_t) (state % options.zones + 1),
+				.vehicleClass = (uint8_t) ((state >> 16) % 5),
+				.speed        = (uint8_t) (40 + (state >> 24) % 80),
+				.occupancy    = (uint32_t) (150000 + (state >> 32) % 300000)
+			};
+		}
+
+		const uint64_t start = clockMonotonic();
+
+		taken   += zoneIngest(batch, options.batch);
+		elapsed += clockMonotonic() - start;
+	}
+
+	const double samples = (double) taken;
+
+	printf("{\"samples\":%zu,\"batch\":%zu,\"zones\":%zu,"
+	       "\"ns_per_sample\":%.2f,\"samples_per_second\":%.0f}\n",
+	       taken, options.batch, options.zones, (double) elapsed / samples,
+	       samples * 1e9 / (double) elapsed);
+
+	free(batch);
+	zoneFree();
+	databaseFree();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#ifndef ACCESS_H
+#define ACCESS_H
+
+#include <Common.h>
+#include <Registry.h>
+
+/* View-based access control, after the VACM of RFC 3415. A view is a
+ * family of subtrees, each included or excluded, in which the longest
+ * subtree holding an object decides whether the view has it. A group is a
+ * principal, a community of SNMPv1/v2c or a user of SNMPv3, with the view
+ * it may read and the view it may write.
+ *
+ * accessCompile() turns every view into a RegistryView once the registry
+ * is sorted, so the agent checks a varbind against the view of its group
+ * with one bit test, and a GETNEXT skips what the group may not read the
+ * same way.
+ *
+ * NTCIP 1201 gives the administrator community a right of its own: while a
+ * transaction is open, only the group that opened it and an administrator
+ * may SET dbCreateTransaction (see Transaction.h).
+ *
+ * The views built in are "all", "devices" (the device MIBs of NTCIP),
+ * "agent" (the SNMP engine, usmStats and the private objects of the agent)
+ * and "none".
+ */
+
+#define ACCESS_MAX_VIEWS    8
+#define ACCESS_MAX_FAMILIES 8 /* Subtrees of a view. */
+#define ACCESS_MAX_GROUPS   16
+#define ACCESS_MAX_NAME     32
+
+typedef enum AccessModel
+{
+	ACCESS_COMMUNITY = 1, /* SNMPv1 and SNMPv2c, by community. */
+	ACCESS_USER      = 2  /* SNMPv3, by USM user name. */
+} AccessModel;
+
+typedef struct AccessGroup
+{
+	AccessModel         model;
+	uint8_t             name[ACCESS_MAX_NAME];
+	uint8_t             nameLength;
+	bool                administrator;
+	const RegistryView *read;
+	const RegistryView *write;
+} AccessGroup;
+
+/* Adds a subtree to a view, creating the view if it is new. Returns false
+ * if there is no room or the name is too long.
+ */
+bool accessView (const char *view, const OID *subtree, bool included);
+
+/* Adds a group that reads readView and writes writeView, either of which
+ * may be NULL for none. Returns false if a view is unknown, the group
+ * exists already, its name is too long or there is no room.
+ */
+bool accessGroup (AccessModel model, const char *name, const char *readView,
+                  const char *writeView, bool administrator);
+
+/* Builds the views over the registry. Must run after registryInit() and
+ * the last accessView(), and before the first request; until it has, every
+ * view is empty.
+ */
+void accessCompile (void);
+
+const AccessGroup *accessFind (AccessModel model, const uint8_t *name,
+                               size_t length);
+
+#endif /* ACCESS_H */
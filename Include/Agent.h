@@ -0,0 +1,63 @@
+#ifndef AGENT_H
+#define AGENT_H
+
+#include <Common.h>
+#include <Access.h>
+#include <SNMP.h>
+#include <USM.h>
+
+typedef struct AgentConfig
+{
+	/* Address and port to serve, normally port 161 on all interfaces. */
+	struct sockaddr_in address;
+} AgentConfig;
+
+typedef struct AgentStatistics
+{
+	uint32_t inPackets;
+	uint32_t outPackets;
+	uint32_t inASNParseErrors;
+	uint32_t inBadCommunityNames;
+	uint32_t outTooBigs;
+} AgentStatistics;
+
+/* SNMP command responder over the registry. Requests are processed one at
+ * a time by the thread calling agentServe(); the decoded request and the
+ * response under construction live here rather than on that thread's stack.
+ *
+ * SNMPv1 and SNMPv2c requests are authorized by the access group of their
+ * community. SNMPv3 requests go through the user-based security model (see
+ * USM.h) and must be authenticated; the access group of their user decides
+ * what they may read and write, and the response goes back at the security
+ * level of the request. Objects outside the read view of a group do not
+ * exist for it, and a SET of one outside its write view is noAccess.
+ */
+typedef struct Agent
+{
+	AgentConfig        config;
+	int                socket;
+	AgentStatistics    statistics;
+	SNMPMessage        request;
+	SNMPMessage        response;
+	USMUser           *user;  /* Of an SNMPv3 request. */
+	const AccessGroup *group; /* Of the request. */
+	uint8_t            plain[SNMP_MAX_MESSAGE]; /* Deciphered scoped PDU. */
+	uint8_t            input[SNMP_MAX_MESSAGE];
+	uint8_t            output[SNMP_MAX_MESSAGE];
+} Agent;
+
+bool agentInit (Agent *agent, const AgentConfig *config);
+void agentClose (Agent *agent);
+
+/* Answers one request. Returns the length of the response written to
+ * response, or zero if the request is to be dropped silently.
+ */
+size_t agentProcess (Agent *agent, const uint8_t *request, size_t length,
+                     uint8_t *response, size_t capacity);
+
+/* Waits up to timeout milliseconds (-1 for ever) for requests and answers
+ * every request queued on the socket. Returns false on a socket error.
+ */
+bool agentServe (Agent *agent, int timeout);
+
+#endif /* AGENT_H */
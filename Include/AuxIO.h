@@ -0,0 +1,175 @@
+#ifndef AUX_IO_H
+#define AUX_IO_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Registry.h>
+
+/* Digital ports are numbered up to 255, one bit each in a bitmap of this
+ * many words. Bit n of a bitmap is digital port n + 1.
+ */
+#define AUX_IO_WORDS ((UINT8_MAX + 63) / 64)
+
+/* Longest moving average of an analog port, in samples. */
+#define AUX_IO_MAX_WINDOW 16
+
+/* Where the ports are read and written. sample() latches every input of the
+ * device at once, after which the read functions return the latched levels,
+ * so that the ports of one scan are read at the same instant. Each function
+ * returns false on an error of the device.
+ */
+typedef struct AuxIOBackend
+{
+	void *context;
+
+	bool (*sample) (void *context);
+
+	/* Levels of every digital port, inputs and outputs alike. */
+	bool (*readDigital) (void *context, uint64_t levels[AUX_IO_WORDS]);
+
+	/* Raw samples of the first count analog ports. */
+	bool (*readAnalog) (void *context, uint32_t samples[], size_t count);
+
+	/* Drives the digital outputs whose bit is set in changed to the level
+	 * given in levels.
+	 */
+	bool (*writeDigital) (void *context, const uint64_t levels[AUX_IO_WORDS],
+	                      const uint64_t changed[AUX_IO_WORDS]);
+
+	/* Drives analog port, counted from zero, to value. */
+	bool (*writeAnalog) (void *context, size_t port, uint32_t value);
+} AuxIOBackend;
+
+typedef struct AuxIOConfig
+{
+	/* Scans a digital input must hold a new level before the level is
+	 * taken; zero or one takes it at once.
+	 */
+	uint8_t debounce;
+
+	/* Samples averaged for the value of an analog input, one up to
+	 * AUX_IO_MAX_WINDOW.
+	 */
+	uint8_t window;
+
+	/* Bits of the analog converter, reported as auxIOv2PortResolution.
+	 * Samples are clipped to this many bits.
+	 */
+	uint8_t resolution;
+} AuxIOConfig;
+
+/* Moving average of one analog input over the last window samples. */
+typedef struct AuxIOAverage
+{
+	uint32_t samples[AUX_IO_MAX_WINDOW];
+	uint64_t sum;
+	uint8_t  next;  /* Slot the next sample replaces. */
+	uint8_t  count; /* Samples held, up to the window. */
+} AuxIOAverage;
+
+/* Port engine over the auxIOv2Table of the database. The direction of each
+ * port is fixed by the hardware, so it is taken from the table once, when
+ * the engine starts. A scan reads inputs into auxIOv2PortValue and drives
+ * outputs from auxIOv2PortLastCommandedState, the last command of a
+ * manager, which an output port also reports as its value. Fields are
+ * written only when their value changes.
+ */
+typedef struct AuxIO
+{
+	AuxIOBackend backend;
+	AuxIOConfig  config;
+
+	size_t   digitalPorts;
+	size_t   analogPorts;
+	uint32_t analogMaximum;
+
+	/* Digital ports read into the table, and those driven from it. A
+	 * bidirectional port is both.
+	 */
+	uint64_t inputs[AUX_IO_WORDS];
+	uint64_t drives[AUX_IO_WORDS];
+
+	/* Debounced levels of the inputs, the inputs whose raw level differs
+	 * from it and, for each of those, the scans it has done so for.
+	 */
+	uint64_t stable[AUX_IO_WORDS];
+	uint64_t pending[AUX_IO_WORDS];
+	uint8_t  held[UINT8_MAX];
+
+	/* Levels last driven; valid once driven is set. */
+	uint64_t commanded[AUX_IO_WORDS];
+	bool     driven;
+
+	OBJECT_TABLE(AuxIOAverage, averages, CONFIG_MAX_AUX_ANALOG_PORTS);
+	OBJECT_TABLE(uint32_t,     samples,  CONFIG_MAX_AUX_ANALOG_PORTS);
+	OBJECT_TABLE(uint32_t,     driving,  CONFIG_MAX_AUX_ANALOG_PORTS);
+
+	uint64_t scans;
+	uint32_t errors; /* Scans the backend failed. */
+} AuxIO;
+
+/* Starts an engine over the ports of the database. Requires
+ * databaseInit().
+ */
+bool auxIOInit (AuxIO *engine, const AuxIOBackend *backend,
+                const AuxIOConfig *config);
+void auxIOFree (AuxIO *engine);
+
+/* Samples every input and drives every output that changed. Returns false
+ * if the backend failed, in which case the table is left as it was.
+ */
+bool auxIOScan (AuxIO *engine);
+
+/* Makes outputs of the ports of list, which names them by type and number
+ * as d<port> or a<port>, separated by commas. A port followed by b is made
+ * bidirectional. Returns false, leaving the rest of the list alone, at the
+ * first port not in the table. Called before auxIOInit(), the other ports
+ * remaining inputs.
+ */
+bool auxIODirections (const char *list);
+
+/* Checks a SET of auxIOv2PortValue or auxIOv2PortLastCommandedState before
+ * anything of the PDU is stored: a command of an input port, or beyond the
+ * resolution of the port, is genErr.
+ */
+SNMPError auxIOCheck (const RegistryObject *object, size_t row,
+                      const VarBind *varbind);
+
+/* Records a command once it has been stored, as the last commanded state
+ * of the port and as the value of an output port, for the next scan to
+ * drive.
+ */
+void auxIOStore (const RegistryObject *object, size_t row);
+
+/* Backend that simulates the ports over a file, a FIFO or a pseudo-terminal
+ * carrying one line per port level:
+ *
+ *   d<port> <level>   digital port (from the peer, or D to the peer)
+ *   a<port> <value>   analog port  (from the peer, or A to the peer)
+ *
+ * with ports numbered from one. Every line available is taken on each
+ * sample, except that an empty line ends the lines of one sample, so that a
+ * recorded file replays a sample per scan. Outputs are written back to a
+ * FIFO or terminal; a regular file is only read.
+ */
+typedef struct AuxIOSimulation
+{
+	int  fd;
+	int  peer;     /* Held open slave of a pseudo-terminal, or -1. */
+	bool writable;
+
+	char   line[64]; /* Partial line carried over between reads. */
+	size_t length;
+
+	uint64_t levels[AUX_IO_WORDS];
+	uint32_t values[UINT8_MAX];
+} AuxIOSimulation;
+
+/* Opens path, or a new pseudo-terminal if path is "pty", whose slave is then
+ * stored in name, and fills backend with the simulation.
+ */
+bool auxIOSimulationOpen (AuxIOSimulation *simulation, const char *path,
+                          char *name, size_t capacity, AuxIOBackend *backend);
+void auxIOSimulationClose (AuxIOSimulation *simulation);
+
+#endif /* AUX_IO_H */
@@ -0,0 +1,107 @@
+#ifndef BER_H
+#define BER_H
+
+#include <Common.h>
+
+/* Universal, application and context tags used by SNMP (RFC 3416). */
+enum
+{
+	BER_INTEGER          = 0x02,
+	BER_OCTET_STRING     = 0x04,
+	BER_NULL             = 0x05,
+	BER_OID              = 0x06,
+	BER_SEQUENCE         = 0x30,
+	BER_IP_ADDRESS       = 0x40,
+	BER_COUNTER32        = 0x41,
+	BER_GAUGE32          = 0x42,
+	BER_TIMETICKS        = 0x43,
+	BER_OPAQUE           = 0x44,
+	BER_COUNTER64        = 0x46,
+	BER_NO_SUCH_OBJECT   = 0x80,
+	BER_NO_SUCH_INSTANCE = 0x81,
+	BER_END_OF_MIB_VIEW  = 0x82
+};
+
+/* SNMP limits an object identifier to 128 sub-identifiers, but no object
+ * defined by the NTCIP device MIBs comes close to that. Keeping the arcs
+ * inline lets an OID be copied and compared without touching the heap.
+ */
+#define OID_MAX_ARCS 32
+
+typedef struct OID
+{
+	uint8_t  length;
+	uint32_t arcs[OID_MAX_ARCS];
+} OID;
+
+/* Initializer for an OID from a literal list of arcs, usable in static
+ * storage: OID sysUpTime = OID_INIT(1, 3, 6, 1, 2, 1, 1, 3, 0);
+ */
+#define OID_INIT(...)                                                          \
+	{                                                                          \
+		.length = sizeof((uint32_t[]) { __VA_ARGS__ }) / sizeof(uint32_t),     \
+		.arcs   = { __VA_ARGS__ }                                              \
+	}
+
+/* Encoder state. BER lengths precede their contents, so values are written
+ * back to front: the innermost value is written first and every constructed
+ * header is prepended once its contents (and therefore its length) are known.
+ * This avoids both a sizing pass and moving data around.
+ */
+typedef struct BERWriter
+{
+	uint8_t *buffer;
+	size_t   capacity;
+	size_t   cursor;   /* Index of the first encoded byte. */
+	bool     overflow; /* Set once any write did not fit. */
+} BERWriter;
+
+/* Decoder state over a borrowed buffer. Strings are returned as pointers into
+ * that buffer and are only valid as long as it is.
+ */
+typedef struct BERReader
+{
+	const uint8_t *data;
+	size_t         length;
+	size_t         offset;
+} BERReader;
+
+void   berWriterInit (BERWriter *writer, uint8_t *buffer, size_t capacity);
+size_t berWriterLength (const BERWriter *writer);
+const uint8_t *berWriterData (const BERWriter *writer);
+
+void berWriteBytes (BERWriter *writer, const void *data, size_t length);
+void berWriteHeader (BERWriter *writer, uint8_t tag, size_t length);
+void berWriteInteger (BERWriter *writer, uint8_t tag, int64_t value);
+void berWriteUnsigned (BERWriter *writer, uint8_t tag, uint64_t value);
+void berWriteOctetString (BERWriter *writer, const void *data, size_t length);
+void berWriteNull (BERWriter *writer, uint8_t tag);
+void berWriteOID (BERWriter *writer, const OID *oid);
+
+/* Prepends the header of a constructed value whose contents are everything
+ * written since mark was taken with berWriterLength().
+ */
+void berWriteConstructed (BERWriter *writer, uint8_t tag, size_t mark);
+
+void berReaderInit (BERReader *reader, const uint8_t *data, size_t length);
+bool berReadHeader (BERReader *reader, uint8_t *tag, size_t *length);
+bool berEnter (BERReader *reader, uint8_t tag, BERReader *contents);
+bool berReadInteger (BERReader *reader, uint8_t tag, int64_t *value);
+bool berReadUnsigned (BERReader *reader, uint8_t tag, uint64_t *value);
+bool berReadOctetString (BERReader *reader, const uint8_t **data,
+                         size_t *length);
+bool berReadOID (BERReader *reader, OID *oid);
+bool berReaderAtEnd (const BERReader *reader);
+
+bool berDecodeInteger (const uint8_t *data, size_t length, int64_t *value);
+bool berDecodeUnsigned (const uint8_t *data, size_t length, uint64_t *value);
+bool berDecodeOID (const uint8_t *data, size_t length, OID *oid);
+
+/* Parses dotted decimal notation, e.g. "1.3.6.1.4.1.1206". */
+bool oidParse (const char *text, OID *oid);
+
+int  oidCompare (const OID *left, const OID *right);
+bool oidIsPrefix (const OID *prefix, const OID *oid);
+bool oidAppend (OID *oid, uint32_t arc);
+
+#endif /* BER_H */
@@ -0,0 +1,99 @@
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+#include <Common.h>
+#include <Clock.h>
+#include <Database.h>
+#include <Registry.h>
+
+/* Local time and calendar of the controller. The wall clock is read once,
+ * as an anchor against the monotonic clock; every tick derives the time
+ * from clockMonotonic() and the anchor alone, which costs no system call.
+ * The broken-down local time is cached and only worked out again when the
+ * second changes, by arithmetic within the day; the date, the daylight
+ * saving offset and the next DST transition are worked out when the local
+ * day changes, when a transition is reached, or after a SET. The anchor is
+ * taken again at the same points, which keeps the cache on the wall clock.
+ *
+ * Daylight saving follows globalDaylightSaving: the rows of the dstTable
+ * for enableDaylightSavingNode, or the rule of the region named by the
+ * retired values. The row with the latest begin that has not ended sets the
+ * offset.
+ *
+ * globalTime and controllerLocalTime are published on every new second.
+ *
+ * A SET of globalTime disciplines the clock of the controller rather than
+ * the system clock. An error within CALENDAR_STEP_THRESHOLD is slewed out:
+ * the clock runs CALENDAR_SLEW_RATE parts per million fast or slow until it
+ * is made up, so the time never jumps and the seconds keep their order.
+ * Larger errors are stepped at once, and every hook registered with
+ * calendarRegister() is told of the step, once, to bring its own state
+ * along. Intervals are timed on the monotonic clock and see neither.
+ */
+
+/* Errors slewed rather than stepped, and the rate they are slewed at. */
+#define CALENDAR_STEP_THRESHOLD (2 * NANOSECONDS_PER_SECOND)
+#define CALENDAR_SLEW_RATE      5000
+
+/* Upper bound on the hooks that can be registered. */
+#define CALENDAR_MAX_HOOKS 8
+
+typedef struct CalendarTime
+{
+	int64_t  utc;         /* Seconds since the epoch, UTC. */
+	int64_t  local;       /* Seconds since the epoch, local time. */
+	uint32_t nanoseconds; /* Into the second, updated every tick. */
+	int32_t  offset;      /* Local less UTC, in seconds. */
+	bool     daylightSaving;
+
+	uint16_t year;
+	uint8_t  month;       /* 1 (January) to 12. */
+	uint8_t  dayOfMonth;  /* 1 to 31. */
+	uint8_t  dayOfWeek;   /* enum Day: 1 (Sunday) to 7. */
+	uint16_t dayOfYear;   /* 1 to 366. */
+	uint8_t  hour;
+	uint8_t  minute;
+	uint8_t  second;
+	uint32_t secondOfDay;
+} CalendarTime;
+
+/* Called on the tick thread with the step in nanoseconds, once the
+ * calendar has been worked out again at the new time.
+ */
+typedef void (*CalendarStepHook) (int64_t step);
+
+/* Works out the calendar from the wall clock and the database. */
+void calendarInit (void);
+
+/* Registers a hook to run on every step of the clock. Hooks must be
+ * registered before tickStart().
+ */
+bool calendarRegister (CalendarStepHook hook);
+
+/* True for globalTime, which is stored through calendarSet(). */
+bool calendarIsClock (const RegistryObject *object);
+
+/* Sets the clock to seconds since the epoch, UTC. The correction is taken
+ * up on the next tick. Safe to call from any thread.
+ */
+void calendarSet (uint64_t seconds);
+
+/* Marks the calendar stale after a SET of the time zone or of daylight
+ * saving. Safe to call from any thread.
+ */
+void calendarInvalidate (void);
+
+/* Tick hook: advances the cached calendar to now. Registered before every
+ * hook that reads it.
+ */
+void calendarTick (uint64_t deadline, uint64_t now);
+
+/* The calendar as of the last tick. Called from the tick thread only. */
+const CalendarTime *calendarNow (void);
+
+/* Day of the year, from 1, of the day that starts days days after the
+ * epoch.
+ */
+uint16_t calendarDayOfYear (int64_t days);
+
+#endif /* CALENDAR_H */
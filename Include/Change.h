@@ -0,0 +1,119 @@
+#ifndef CHANGE_H
+#define CHANGE_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Registry.h>
+
+/* Change tracking over the configuration tables. The agent records every
+ * instance of a tracked table it stores in a log of CHANGE_LOG_SIZE
+ * entries, and each consumer subscribes with a cursor into it. Draining a
+ * subscriber folds the entries since its cursor into its dirty rows, each
+ * with a bitmap of its dirty columns, so that a row changed many times is
+ * taken once; the consumer then takes the dirty rows one by one and does
+ * work in proportion to what changed rather than rescanning its tables.
+ *
+ * The log has one writer, the agent thread, and any number of readers,
+ * each owning its subscriber. An entry carries its sequence number, so a
+ * subscriber that falls more than a log behind finds out when it drains,
+ * and then has to take every row of every table as changed. The same
+ * happens to every subscriber after changeReset(), for stores the log
+ * cannot describe, such as a database loaded whole.
+ *
+ * SETs of database objects buffered by a transaction are staged rather
+ * than logged, and logged together when the transaction is applied.
+ */
+
+typedef enum ChangeTable
+{
+	CHANGE_PHASE               = 0, /* phaseTable */
+	CHANGE_VEHICLE_DETECTOR    = 1, /* vehicleDetectorTable */
+	CHANGE_PEDESTRIAN_DETECTOR = 2, /* pedestrianDetectorTable */
+	CHANGE_TIME_BASE_SCHEDULE  = 3, /* timeBaseScheduleTable */
+	CHANGE_DAY_PLAN            = 4, /* timeBaseDayPlanTable */
+	CHANGE_DST                 = 5, /* dstTable */
+	CHANGE_TIMEBASE_ACTION     = 6, /* timebaseAscActionTable */
+	CHANGE_MODULE              = 7, /* globalModuleTable */
+	CHANGE_TABLE_COUNT
+} ChangeTable;
+
+/* Entries of the log, a power of two. */
+#define CHANGE_LOG_SIZE 1024
+
+/* Rows of the tracked tables at the capacities of Config.h. */
+#define CHANGE_MAX_ROWS                                                        \
+	(CONFIG_MAX_PHASES + CONFIG_MAX_VEHICLE_DETECTORS                          \
+	 + CONFIG_MAX_PEDESTRIAN_DETECTORS                                         \
+	 + CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES                                   \
+	 + CONFIG_MAX_DAY_PLANS * CONFIG_MAX_DAY_PLAN_EVENTS                       \
+	 + CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES + CONFIG_MAX_TIMEBASE_ASC_ACTIONS    \
+	 + CONFIG_MAX_MODULES)
+
+/* The bit of a column, by its arc under the table entry, in the columns of
+ * a ChangeRow. Columns past 63 share the last bit.
+ */
+#define CHANGE_COLUMN(column) (UINT64_C(1) << MIN((column), 63))
+
+/* A dirty row, as changeNext() takes it. */
+typedef struct ChangeRow
+{
+	ChangeTable table;
+	size_t      row;     /* As the registry counts the rows of table. */
+	uint64_t    columns; /* Of CHANGE_COLUMN() bits. */
+} ChangeRow;
+
+/* The rows of every tracked table are numbered together, table after
+ * table. A row is dirty while its columns are not zero, and its number is
+ * then in pending once.
+ */
+typedef struct ChangeSubscriber
+{
+	uint64_t cursor; /* Sequence of the next entry of the log to drain. */
+	size_t   count;  /* Of pending. */
+	size_t   next;   /* Of pending, the next to take. */
+
+	OBJECT_TABLE(uint64_t, columns, CHANGE_MAX_ROWS);
+	OBJECT_TABLE(uint32_t, pending, CHANGE_MAX_ROWS);
+} ChangeSubscriber;
+
+/* Lays the tracked tables out for the limits of the database and empties
+ * the log. Requires registryInit(), and comes before the first subscriber.
+ */
+void changeInit (const DatabaseLimits *limits);
+
+/* Allocates a subscriber, which starts at the end of the log with no dirty
+ * row.
+ */
+bool changeSubscribe (ChangeSubscriber *subscriber);
+void changeUnsubscribe (ChangeSubscriber *subscriber);
+
+/* Called by the agent thread only: logs a store of an instance, or stages
+ * one made in the transaction buffer. Objects outside the tracked tables
+ * are ignored.
+ */
+void changeRecord (const RegistryObject *object, size_t row);
+void changeStage (const RegistryObject *object, size_t row);
+
+/* Called by the agent thread only: logs what was staged, once the buffer
+ * has been copied to the database, or forgets it.
+ */
+void changeCommit (void);
+void changeDiscard (void);
+
+/* Called by the agent thread only: makes every subscriber take every row
+ * as changed.
+ */
+void changeReset (void);
+
+/* Folds the log since the cursor of subscriber into its dirty rows.
+ * Returns false, with no row dirty, if entries were lost to the subscriber
+ * and every row is to be taken as changed.
+ */
+bool changeDrain (ChangeSubscriber *subscriber);
+
+/* Takes the next dirty row of subscriber, which is clean after. Returns
+ * false once none is left.
+ */
+bool changeNext (ChangeSubscriber *subscriber, ChangeRow *change);
+
+#endif /* CHANGE_H */
@@ -0,0 +1,23 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <Common.h>
+
+#define NANOSECONDS_PER_MILLISECOND UINT64_C(1000000)
+#define NANOSECONDS_PER_SECOND      UINT64_C(1000000000)
+
+/* Nanoseconds on the monotonic clock. Every interval the agent times (ticks,
+ * retries, coalescing windows) is measured on this clock so that a SET of
+ * globalTime can never stretch or shrink one.
+ */
+static inline uint64_t clockMonotonic (void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * NANOSECONDS_PER_SECOND
+	     + (uint64_t) now.tv_nsec;
+}
+
+#endif /* CLOCK_H */
@@ -14,10 +14,13 @@
  #include <locale.h>
  #include <signal.h>
  #include <stdarg.h>
+ #include <stdbool.h>
+ #include <stddef.h>
  #include <stdint.h>
  #include <stdio.h>
  #include <stdlib.h>
  #include <string.h>
+ #include <time.h>
 
  /* Standard parallel execution model with memory order and atomic types. */
  #if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
@@ -37,11 +40,19 @@
  #include <sys/un.h>
  #include <unistd.h>      /* POSIX.1‐2017 */
  #include <pthread.h>     /* POSIX.1‐2017 */
+ #include <semaphore.h>   /* POSIX.1‐2017 */
  #include <sys/time.h>    /* POSIX.1‐2017 */
  #include <sys/stat.h>    /* POSIX.1‐2017 */
  #include <sys/types.h>
  #include <sys/param.h>
  #include <sys/random.h>
+ #include <poll.h>        /* POSIX.1‐2017 */
+ #include <sys/socket.h>  /* POSIX.1‐2017 */
+ #include <netinet/in.h>  /* POSIX.1‐2017 */
+ #include <arpa/inet.h>   /* POSIX.1‐2017 */
+ #include <sched.h>       /* POSIX.1‐2017 */
+ #include <sys/mman.h>    /* POSIX.1‐2017 */
+ #include <termios.h>     /* POSIX.1‐2017 */
 
 #endif
 
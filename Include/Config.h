@@ -0,0 +1,168 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* Table sizes of the device: the values of the max* objects the agent
+ * reports. Each may be overridden on the compiler command line.
+ *
+ * In a STATIC_STORAGE build they are also compile-time capacities: every
+ * table is an array of this many rows inside the object tree, so the agent
+ * makes no heap allocation and its footprint is known at link time.
+ * Otherwise the tables are allocated when the database is initialized.
+ */
+#ifndef CONFIG_MAX_MODULES
+ #define CONFIG_MAX_MODULES 1
+#endif
+
+#ifndef CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES
+ #define CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES 32
+#endif
+
+#ifndef CONFIG_MAX_DAY_PLANS
+ #define CONFIG_MAX_DAY_PLANS 16
+#endif
+
+#ifndef CONFIG_MAX_DAY_PLAN_EVENTS
+ #define CONFIG_MAX_DAY_PLAN_EVENTS 16
+#endif
+
+#ifndef CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES
+ #define CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES 2
+#endif
+
+#ifndef CONFIG_MAX_AUX_DIGITAL_PORTS
+ #define CONFIG_MAX_AUX_DIGITAL_PORTS 8
+#endif
+
+#ifndef CONFIG_MAX_AUX_ANALOG_PORTS
+ #define CONFIG_MAX_AUX_ANALOG_PORTS 4
+#endif
+
+#ifndef CONFIG_MAX_PHASES
+ #define CONFIG_MAX_PHASES 16
+#endif
+
+#ifndef CONFIG_MAX_VEHICLE_DETECTORS
+ #define CONFIG_MAX_VEHICLE_DETECTORS 64
+#endif
+
+#ifndef CONFIG_MAX_PEDESTRIAN_DETECTORS
+ #define CONFIG_MAX_PEDESTRIAN_DETECTORS 8
+#endif
+
+#ifndef CONFIG_MAX_PATTERNS
+ #define CONFIG_MAX_PATTERNS 16
+#endif
+
+#ifndef CONFIG_MAX_SPLITS
+ #define CONFIG_MAX_SPLITS 16
+#endif
+
+#ifndef CONFIG_MAX_TIMEBASE_ASC_ACTIONS
+ #define CONFIG_MAX_TIMEBASE_ASC_ACTIONS 16
+#endif
+
+#ifndef CONFIG_MAX_PREEMPTS
+ #define CONFIG_MAX_PREEMPTS 4
+#endif
+
+#ifndef CONFIG_MAX_FONTS
+ #define CONFIG_MAX_FONTS 4
+#endif
+
+#ifndef CONFIG_MAX_FONT_CHARACTERS
+ #define CONFIG_MAX_FONT_CHARACTERS 128
+#endif
+
+#ifndef CONFIG_MAX_CHANGEABLE_MESSAGES
+ #define CONFIG_MAX_CHANGEABLE_MESSAGES 32
+#endif
+
+/* Pixels of the face of the sign, reported in vmsCfg. Rendered pages are
+ * bitmaps of this size whatever the build.
+ */
+#ifndef CONFIG_SIGN_WIDTH_PIXELS
+ #define CONFIG_SIGN_WIDTH_PIXELS 144
+#endif
+
+#ifndef CONFIG_SIGN_HEIGHT_PIXELS
+ #define CONFIG_SIGN_HEIGHT_PIXELS 48
+#endif
+
+#ifndef CONFIG_MAX_TEMPERATURE_SENSORS
+ #define CONFIG_MAX_TEMPERATURE_SENSORS 4
+#endif
+
+#ifndef CONFIG_MAX_PAVEMENT_SENSORS
+ #define CONFIG_MAX_PAVEMENT_SENSORS 4
+#endif
+
+#ifndef CONFIG_MAX_SENSOR_ZONES
+ #define CONFIG_MAX_SENSOR_ZONES 256
+#endif
+
+#ifndef CONFIG_MAX_VEHICLE_CLASSES
+ #define CONFIG_MAX_VEHICLE_CLASSES 8
+#endif
+
+#ifndef CONFIG_MAX_RSU_IFMS
+ #define CONFIG_MAX_RSU_IFMS 16
+#endif
+
+#ifndef CONFIG_MAX_MAINLINE_LANES
+ #define CONFIG_MAX_MAINLINE_LANES 8
+#endif
+
+#ifndef CONFIG_MAX_METERED_LANES
+ #define CONFIG_MAX_METERED_LANES 4
+#endif
+
+#ifndef CONFIG_MAX_TR_LEVELS
+ #define CONFIG_MAX_TR_LEVELS 12
+#endif
+
+/* The intersection the SPaT of the controller is for (SAE J2735
+ * IntersectionID).
+ */
+#ifndef CONFIG_INTERSECTION_ID
+ #define CONFIG_INTERSECTION_ID 1
+#endif
+
+/* Octets of the arena holding the OCTET STRINGs too long to be stored in
+ * place, and the number of distinct such strings it indexes. Equal strings
+ * are stored once, however many objects or trees hold them. The number of
+ * slots must be a power of two.
+ */
+#ifndef CONFIG_STRING_ARENA_SIZE
+ #define CONFIG_STRING_ARENA_SIZE 65536
+#endif
+
+#ifndef CONFIG_STRING_SLOTS
+ #define CONFIG_STRING_SLOTS 2048
+#endif
+
+/* Rows of eight phases or detectors. */
+#define CONFIG_GROUPS(count) (((count) + 7) / 8)
+
+/* Declares the storage of a table of the object tree. */
+#ifdef STATIC_STORAGE
+ #define OBJECT_TABLE(Type, name, rows) Type name[rows]
+#else
+ #define OBJECT_TABLE(Type, name, rows) Type *name
+#endif
+
+/* Provides storage for count rows of a table declared by OBJECT_TABLE,
+ * evaluating to false if there is none. A static table is an array of its
+ * configured capacity, so only the count needs checking; an allocated one
+ * has at least one row, to keep a zero-row table distinguishable from a
+ * failed allocation.
+ */
+#ifdef STATIC_STORAGE
+ #define PROVIDE(table, count)                                                 \
+	((size_t) (count) <= sizeof(table) / sizeof((table)[0]))
+#else
+ #define PROVIDE(table, count)                                                 \
+	(((table) = calloc((count) != 0 ? (count) : 1, sizeof((table)[0])))       \
+	 != NULL)
+#endif
+
+#endif /* CONFIG_H */
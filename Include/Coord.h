@@ -0,0 +1,65 @@
+#ifndef COORD_H
+#define COORD_H
+
+#include <Common.h>
+#include <Database.h>
+
+/* Coordination (NTCIP 1202 coord and timebaseAsc). Once a minute, or
+ * whenever a SET may have changed its inputs, the engine selects the day
+ * plan of the time base schedule, the event of that plan in effect and the
+ * pattern its action names, with systemPatternControl and
+ * coordOperationalMode taking precedence. When the pattern or the database
+ * changes, the windows of every phase are laid out over the cycle once, as
+ * a list of mask changes sorted by cycle position; each tick then applies
+ * the changes passed since the last one to the phaseControlGroupTable.
+ *
+ * Within a ring, phases run in phase number order starting from the
+ * coordinated phase. The layout of each phase, in tenths of a second from
+ * the start of the coordinated phase green:
+ *
+ *   start          where the previous split ends
+ *   force off      start + split - yellow change - red clearance
+ *   yield          force off of the coordinated phase
+ *   permissive     yield up to force off - minimum green
+ *
+ * The coordinated phase is held until its yield point and whenever the ring
+ * has run its other phases; every other phase is forced off outside
+ * [yield, force off) and omitted outside its permissive window, so that it
+ * is served only when it can still time its minimum green.
+ */
+
+/* Position of a phase in the cycle of the pattern running. */
+typedef struct CoordWindow
+{
+	uint8_t  phase;      /* Phase number. */
+	bool     coordinated;
+	uint16_t start;      /* Tenths of a second into the cycle. */
+	uint16_t forceOff;
+	uint16_t permissive; /* End of the permissive window. */
+} CoordWindow;
+
+/* Allocates the plan for the limits of the database. */
+bool coordInit (const DatabaseLimits *limits);
+void coordFree (void);
+
+/* Marks the selected pattern and its plan stale after a SET. Safe to call
+ * from any thread.
+ */
+void coordInvalidate (void);
+
+/* Calendar step hook: evaluates the time base again on the next tick. The
+ * plan is kept; the cycle position simply moves with the clock.
+ */
+void coordStep (int64_t step);
+
+/* Tick hook: evaluates the time base when due and drives the masks. */
+void coordTick (uint64_t deadline, uint64_t now);
+
+/* Copies up to capacity windows of the plan running into windows, in phase
+ * number order, and stores the cycle length in tenths of a second in cycle,
+ * zero when no pattern is running. Returns how many there are. Called from
+ * the tick thread only.
+ */
+size_t coordPlan (CoordWindow windows[], size_t capacity, uint16_t *cycle);
+
+#endif /* COORD_H */
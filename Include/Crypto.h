@@ -0,0 +1,66 @@
+#ifndef CRYPTO_H
+#define CRYPTO_H
+
+#include <Common.h>
+
+/* The primitives of the user-based security model: SHA-1 (FIPS 180-4),
+ * HMAC (RFC 2104) and AES-128 (FIPS 197) in 128-bit cipher feedback mode.
+ * They are in tree so that the agent links against nothing but the C
+ * library, and written for the sizes of SNMP messages: a whole message is
+ * hashed or enciphered in one call.
+ */
+
+#define SHA1_DIGEST_OCTETS 20
+#define SHA1_BLOCK_OCTETS  64
+#define AES_BLOCK_OCTETS   16
+#define AES_KEY_OCTETS     16
+
+typedef struct SHA1
+{
+	uint32_t state[5];
+	uint64_t length; /* Octets hashed. */
+	uint8_t  block[SHA1_BLOCK_OCTETS];
+} SHA1;
+
+/* A key made ready for HMAC: the states of the inner and outer hashes once
+ * they have taken the padded key. Keying costs two compressions, which a
+ * message then no longer pays for.
+ */
+typedef struct HMAC
+{
+	SHA1 inner;
+	SHA1 outer;
+} HMAC;
+
+/* The round keys of an AES-128 key. */
+typedef struct AES
+{
+	uint32_t keys[44];
+} AES;
+
+void sha1Init (SHA1 *sha);
+void sha1Update (SHA1 *sha, const void *data, size_t length);
+void sha1Final (SHA1 *sha, uint8_t digest[SHA1_DIGEST_OCTETS]);
+
+/* Keys hmac with a key of any length. */
+void hmacKey (HMAC *hmac, const uint8_t *key, size_t length);
+
+/* A message is authenticated by copying hmac->inner, updating the copy with
+ * the message, in as many pieces as it takes, and finishing it here.
+ */
+void hmacFinal (const HMAC *hmac, SHA1 *inner,
+                uint8_t digest[SHA1_DIGEST_OCTETS]);
+
+void aesKey (AES *aes, const uint8_t key[AES_KEY_OCTETS]);
+void aesEncrypt (const AES *aes, const uint8_t input[AES_BLOCK_OCTETS],
+                 uint8_t output[AES_BLOCK_OCTETS]);
+
+/* Enciphers or deciphers length octets of data in place in CFB-128 mode.
+ * The last block may be partial, so the length of data is kept.
+ */
+void aesEncryptCFB (const AES *aes, const uint8_t iv[AES_BLOCK_OCTETS],
+                    uint8_t *data, size_t length);
+void aesDecryptCFB (const AES *aes, const uint8_t iv[AES_BLOCK_OCTETS],
+                    uint8_t *data, size_t length);
+
+#endif /* CRYPTO_H */
@@ -0,0 +1,119 @@
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <NTCIP.h>
+
+/* Table sizes of the device, i.e. the values of the max* objects. */
+typedef struct DatabaseLimits
+{
+	uint8_t  globalMaxModules;
+	uint16_t maxTimeBaseScheduleEntries;
+	uint8_t  maxDayPlans;
+	uint8_t  maxDayPlanEvents;
+	uint8_t  maxDaylightSavingEntries;
+	uint8_t  maxAuxIOv2TableNumDigitalPorts;
+	uint8_t  maxAuxIOv2TableNumAnalogPorts;
+	uint8_t  maxPhases;
+	uint8_t  maxVehicleDetectors;
+	uint8_t  maxPedestrianDetectors;
+	uint8_t  maxPatterns;
+	uint8_t  maxSplits;
+	uint8_t  maxTimebaseAscActions;
+	uint8_t  maxPreempts;
+	uint8_t  numFonts;
+	uint16_t maxFontCharacters;
+	uint16_t dmsMaxChangeableMsg;
+	uint8_t  essNumTemperatureSensors;
+	uint8_t  numEssPavementSensors;
+	uint16_t numSensorZones;
+	uint8_t  numVehicleClasses;
+	uint16_t maxRsuIFMs;
+	uint8_t  rmcMaxNumMainlineLanes;
+	uint8_t  rmcMaxNumMeteredLanes;
+	uint8_t  rmcMaxNumTRLevels;
+} DatabaseLimits;
+
+/* The limits given in Config.h. */
+#define DATABASE_LIMITS                                                        \
+	{                                                                          \
+		.globalMaxModules               = CONFIG_MAX_MODULES,                  \
+		.maxTimeBaseScheduleEntries     =                                      \
+			CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES,                             \
+		.maxDayPlans                    = CONFIG_MAX_DAY_PLANS,                \
+		.maxDayPlanEvents               = CONFIG_MAX_DAY_PLAN_EVENTS,          \
+		.maxDaylightSavingEntries       = CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES,  \
+		.maxAuxIOv2TableNumDigitalPorts = CONFIG_MAX_AUX_DIGITAL_PORTS,        \
+		.maxAuxIOv2TableNumAnalogPorts  = CONFIG_MAX_AUX_ANALOG_PORTS,         \
+		.maxPhases                      = CONFIG_MAX_PHASES,                   \
+		.maxVehicleDetectors            = CONFIG_MAX_VEHICLE_DETECTORS,        \
+		.maxPedestrianDetectors         = CONFIG_MAX_PEDESTRIAN_DETECTORS,     \
+		.maxPatterns                    = CONFIG_MAX_PATTERNS,                 \
+		.maxSplits                      = CONFIG_MAX_SPLITS,                   \
+		.maxTimebaseAscActions          = CONFIG_MAX_TIMEBASE_ASC_ACTIONS,     \
+		.maxPreempts                    = CONFIG_MAX_PREEMPTS,                 \
+		.numFonts                       = CONFIG_MAX_FONTS,                    \
+		.maxFontCharacters              = CONFIG_MAX_FONT_CHARACTERS,          \
+		.dmsMaxChangeableMsg            = CONFIG_MAX_CHANGEABLE_MESSAGES,      \
+		.essNumTemperatureSensors       = CONFIG_MAX_TEMPERATURE_SENSORS,      \
+		.numEssPavementSensors          = CONFIG_MAX_PAVEMENT_SENSORS,         \
+		.numSensorZones                 = CONFIG_MAX_SENSOR_ZONES,             \
+		.numVehicleClasses              = CONFIG_MAX_VEHICLE_CLASSES,          \
+		.maxRsuIFMs                     = CONFIG_MAX_RSU_IFMS,                 \
+		.rmcMaxNumMainlineLanes         = CONFIG_MAX_MAINLINE_LANES,           \
+		.rmcMaxNumMeteredLanes          = CONFIG_MAX_METERED_LANES,            \
+		.rmcMaxNumTRLevels              = CONFIG_MAX_TR_LEVELS                 \
+	}
+
+/* The object tree of the device. Every object has a single writer: status
+ * objects are written by the tick, database and control objects by the
+ * agent. The agent stores under the database lock, which the threads that
+ * time the controller hold while they read, so they see each SET and each
+ * applied transaction whole. The agent reads status objects without it and
+ * sees either the old or the new value of each integer.
+ */
+extern Global global;
+extern ASC    asc;
+extern DMS    dms;
+extern ESS    ess;
+extern TSS    tss;
+extern RSU    rsu;
+extern RMC    rmc;
+
+/* The object tree of one device, i.e. the database of the agent or the
+ * image of a polled controller kept by a manager.
+ */
+typedef struct ObjectTree
+{
+	Global *global;
+	ASC    *asc;
+	DMS    *dms;
+	ESS    *ess;
+	TSS    *tss;
+	RSU    *rsu;
+	RMC    *rmc;
+} ObjectTree;
+
+/* The tree of every device MIB the agent serves. */
+extern const ObjectTree database;
+
+/* Allocates every table to the given limits and numbers its rows. In a
+ * STATIC_STORAGE build nothing is allocated and this fails if a limit
+ * exceeds its capacity in Config.h.
+ */
+bool databaseInit (const DatabaseLimits *limits);
+void databaseFree (void);
+
+/* Held by the agent while it stores the varbinds of a SET, a transaction
+ * applied among them, and the state the modules work out from them, and by
+ * the tick thread while its hooks run. Lock it before the locks of any
+ * module. The lock inherits priority, so a real-time reader waits no longer
+ * than the agent takes to store a SET, whatever else the agent CPU runs.
+ */
+void databaseLock (void);
+void databaseUnlock (void);
+
+/* As databaseInit() and databaseFree(), for any tree. */
+bool databaseInitTree (const ObjectTree *tree, const DatabaseLimits *limits);
+void databaseFreeTree (const ObjectTree *tree);
+
+#endif /* DATABASE_H */
@@ -0,0 +1,61 @@
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include <Common.h>
+#include <Database.h>
+
+/* Upper bound on the hooks that can be registered. */
+#define DETECTOR_MAX_HOOKS 4
+
+/* Volume and occupancy (NTCIP 1202 volumeOccupancyReport). Every tick the
+ * aggregator reads the vehicleDetectorStatusGroupActive bitmaps: a rising
+ * bit counts a vehicle, a set bit an occupied tick. Periods of
+ * volumeOccupancyPeriod seconds end on multiples of the period into the
+ * local day; at the end of one the volumes and occupancies are published
+ * to the volumeOccupancyTable and volumeOccupancySequence is advanced. A
+ * period of zero stops the collection.
+ *
+ * Occupancy is the share of the ticks of the period a detector was active
+ * on, so it is counted on the monotonic clock and a step of the clock only
+ * moves where the period ends.
+ *
+ * Whatever else consumes the detectors, such as ramp metering, registers a
+ * hook that detectorTick() calls on the ticks a detector came on or went
+ * off. It works from the same samples as the volumes and occupancies, in
+ * the same tick, and only when they changed.
+ */
+
+/* The detectors on one tick. The bitmaps are laid out like the
+ * vehicleDetectorStatusGroupActive objects: detector n is bit (n - 1) % 8
+ * of group (n - 1) / 8.
+ */
+typedef struct DetectorEdges
+{
+	const uint8_t *active;  /* Occupied on this tick. */
+	const uint8_t *changed; /* Occupied on this tick or the last only. */
+	size_t         groups;
+	uint64_t       now;
+} DetectorEdges;
+
+typedef void (*DetectorHook) (const DetectorEdges *edges);
+
+/* Allocates the counters for the limits of the database. */
+bool detectorInit (const DatabaseLimits *limits);
+void detectorFree (void);
+
+/* Registers a hook to run on the ticks a detector changed, in registration
+ * order. Hooks must be registered before tickStart().
+ */
+bool detectorRegister (DetectorHook hook);
+
+/* Calendar step hook: ends the period at once if the step went past its
+ * end, and aligns the next end to the new time.
+ */
+void detectorStep (int64_t step);
+
+/* Tick hook: counts the tick, runs the hooks if a detector changed and
+ * publishes the period when it ends.
+ */
+void detectorTick (uint64_t deadline, uint64_t now);
+
+#endif /* DETECTOR_H */
@@ -0,0 +1,106 @@
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <Common.h>
+#include <Calendar.h>
+#include <Database.h>
+#include <Registry.h>
+#include <Tick.h>
+
+/* Device types served by the agent. A cabinet often combines several, an
+ * actuated controller with ramp metering and detection for one, and each
+ * is a module that describes itself with a Device: the subtree of the MIB
+ * it owns, what to allocate, the hooks that carry out SETs below its
+ * subtree, and the hooks it runs on the tick and on steps of the clock.
+ *
+ * The devices of the cabinet are registered before registryInit(), which
+ * keeps the objects of the registered subtrees only and resolves each to
+ * its device once, through a table of the subtrees sorted by OID. A lookup
+ * remains one binary search over a single object table however many
+ * devices there are, and a SET goes straight to the hooks of the device of
+ * its object. The objects of NTCIP 1201 and of the agent belong to no
+ * device and are always served, but for the auxiliary I/O, which is one. A
+ * manager registers the device types it polls, as registryFind() knows the
+ * objects of those only.
+ */
+
+/* Upper bounds on the devices, and on the hooks of each. */
+#define DEVICE_MAX       8
+#define DEVICE_MAX_HOOKS 4
+
+/* Device of an object of no device, and of an object of a device not
+ * registered.
+ */
+#define DEVICE_NONE   UINT8_MAX
+#define DEVICE_ABSENT (UINT8_MAX - 1)
+
+typedef struct Device
+{
+	const char *name;
+	OID         subtree;
+
+	/* Any of these may be NULL. */
+	bool      (*init) (const DatabaseLimits *limits);
+	void      (*free) (void);
+
+	/* Checks a SET of an object of the device before anything of the PDU
+	 * is stored, and carries it out once it has been, for status and
+	 * control objects.
+	 */
+	SNMPError (*check) (const RegistryObject *object, size_t row,
+	                    const VarBind *varbind);
+	void      (*store) (const RegistryObject *object, size_t row);
+
+	/* Called after every SET, with database true if it changed the
+	 * database.
+	 */
+	void      (*invalidate) (bool database);
+
+	/* Run in order, up to the first NULL. */
+	TickHook         ticks[DEVICE_MAX_HOOKS];
+	CalendarStepHook steps[DEVICE_MAX_HOOKS];
+} Device;
+
+/* Devices built into the agent. */
+extern const Device ascDevice; /* NTCIP 1202 */
+extern const Device rmcDevice; /* NTCIP 1207 */
+extern const Device dmsDevice; /* NTCIP 1203 */
+extern const Device essDevice; /* NTCIP 1204 */
+extern const Device tssDevice; /* NTCIP 1209 */
+extern const Device rsuDevice; /* NTCIP 1218 */
+
+/* The auxiliary I/O of NTCIP 1201, registered whatever the devices so that
+ * its commands go through its hooks.
+ */
+extern const Device auxDevice;
+
+/* The built-in device of the given name, NULL if there is none. */
+const Device *deviceFind (const char *name);
+
+/* Registers a device. Fails if there are DEVICE_MAX already, or if its
+ * subtree is that of a device registered before. Devices are registered
+ * before registryInit().
+ */
+bool deviceRegister (const Device *device);
+
+/* The device whose subtree holds name: its index in registration order,
+ * DEVICE_NONE outside every device MIB, or DEVICE_ABSENT in the MIB of a
+ * device not registered.
+ */
+uint8_t deviceResolve (const OID *name);
+
+/* Allocates every device registered, then registers their tick and step
+ * hooks in registration order.
+ */
+bool deviceInit (const DatabaseLimits *limits);
+void deviceFree (void);
+
+/* The check and store hooks of the device of object. */
+SNMPError deviceCheck (const RegistryObject *object, size_t row,
+                       const VarBind *varbind);
+void deviceStore (const RegistryObject *object, size_t row);
+
+/* Calls the invalidate hooks of every device after a SET. */
+void deviceInvalidate (bool database);
+
+#endif /* DEVICE_H */
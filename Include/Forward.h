@@ -0,0 +1,92 @@
+#ifndef FORWARD_H
+#define FORWARD_H
+
+#include <Common.h>
+#include <Registry.h>
+#include <Database.h>
+
+/* Messages sent over the air by the roadside unit (NTCIP 1218). The SPaT of
+ * the controller is built into the queue on every tick, and every immediate
+ * forward message of the rsuIFMTable is queued once when its row is made
+ * active and enabled, or its payload changes while it is. A thread of its
+ * own hands them to the radio in the order they were committed.
+ *
+ * The queue is a bounded ring of FORWARD_SLOTS messages any number of
+ * threads may produce into without a lock: a producer claims a slot with
+ * one compare-and-swap on the head and writes its message in place, and
+ * the sequence number of every slot tells the consumer when it is ready and
+ * the producers when it is free again. A producer never waits; when the
+ * radio falls so far behind that the ring is full, the message is dropped
+ * and counted. The interval from committing a message to handing it to the
+ * radio is recorded as METRIC_FORWARD.
+ */
+
+/* Slots of the queue, a power of two. */
+#define FORWARD_SLOTS 64
+
+/* Service identifier and channel of the SPaT. */
+#define FORWARD_PSID_SPAT    UINT32_C(0x8002)
+#define FORWARD_CHANNEL_SPAT 183
+
+typedef struct ForwardMessage
+{
+	uint32_t psid;
+	uint8_t  channel;
+	uint8_t  priority;
+	uint16_t length;
+	uint64_t committed; /* Monotonic, set by forwardCommit(). */
+	uint8_t  payload[RSU_MAX_PAYLOAD];
+} ForwardMessage;
+
+/* The radio. transmit is called on the thread of the queue, one message at
+ * a time, and returns false if the radio did not take it.
+ */
+typedef struct ForwardBackend
+{
+	bool  (*transmit) (void *context, const ForwardMessage *message);
+	void *context;
+} ForwardBackend;
+
+/* Counters of the queue, written by the thread of the queue only. */
+typedef struct ForwardStatus
+{
+	uint32_t forwardMessages;  /* Counter32 */
+	uint32_t forwardSpats;     /* Counter32 */
+	uint32_t forwardOverflows; /* Counter32 */
+	uint32_t forwardErrors;    /* Counter32 */
+} ForwardStatus;
+
+extern ForwardStatus forwardStatus;
+
+/* Empties the queue. */
+bool forwardInit (void);
+void forwardFree (void);
+
+/* Claims a slot to build a message in, NULL if the queue is full. The slot
+ * must then be committed, and nothing else may be claimed by the thread
+ * before it is.
+ */
+ForwardMessage *forwardClaim (void);
+void forwardCommit (ForwardMessage *message);
+
+/* Claims a slot, copies a message into it and commits it. Returns false if
+ * the queue was full.
+ */
+bool forwardSubmit (uint32_t psid, uint8_t channel, uint8_t priority,
+                    const uint8_t payload[], size_t length);
+
+/* Starts the thread that hands the messages to backend. */
+bool forwardStart (const ForwardBackend *backend);
+void forwardStop (void);
+
+/* Checks a SET of the rsuIFMTable before anything of the PDU is stored. */
+SNMPError forwardCheck (const RegistryObject *object, size_t row,
+                        const VarBind *varbind);
+
+/* Carries out a SET of the rsuIFMTable once it has been stored. */
+void forwardStore (const RegistryObject *object, size_t row);
+
+/* Tick hook: queues the SPaT as of this tick. */
+void forwardTick (uint64_t deadline, uint64_t now);
+
+#endif /* FORWARD_H */
@@ -0,0 +1,41 @@
+#ifndef MIB_H
+#define MIB_H
+
+#include <Common.h>
+#include <BER.h>
+
+/* Object identifier prefixes of the device MIBs under the NEMA enterprise
+ * node: iso.org.dod.internet.private.enterprises.nema.transportation.devices
+ */
+#define DEVICES_OID(...) OID_INIT(1, 3, 6, 1, 4, 1, 1206, 4, 2, __VA_ARGS__)
+#define DEVICES_NODE_OID OID_INIT(1, 3, 6, 1, 4, 1, 1206, 4, 2)
+#define ASC_OID(...)     DEVICES_OID(1, __VA_ARGS__) /* NTCIP 1202 */
+#define RMC_OID(...)     DEVICES_OID(2, __VA_ARGS__) /* NTCIP 1207 */
+#define DMS_OID(...)     DEVICES_OID(3, __VA_ARGS__) /* NTCIP 1203 */
+#define ESS_OID(...)     DEVICES_OID(5, __VA_ARGS__) /* NTCIP 1204 */
+#define TSS_OID(...)     DEVICES_OID(8, __VA_ARGS__) /* NTCIP 1209 */
+#define GLOBAL_OID(...)  DEVICES_OID(6, __VA_ARGS__) /* NTCIP 1201 */
+#define RSU_OID(...)     DEVICES_OID(18, __VA_ARGS__) /* NTCIP 1218 */
+
+/* Objects specific to this agent rather than to a device MIB live under a
+ * private enterprise node beside NEMA's. 32473 is the number reserved for
+ * documentation (RFC 5612); a vendor build substitutes its own.
+ */
+#ifndef PRIVATE_ENTERPRISE
+ #define PRIVATE_ENTERPRISE 32473
+#endif
+
+#define PRIVATE_OID(...)                                                       \
+	OID_INIT(1, 3, 6, 1, 4, 1, PRIVATE_ENTERPRISE, __VA_ARGS__)
+
+/* Objects from the SNMPv2-MIB used in notifications. */
+#define SYS_UP_TIME_OID   OID_INIT(1, 3, 6, 1, 2, 1, 1, 3, 0)
+#define SNMP_TRAP_OID_OID OID_INIT(1, 3, 6, 1, 6, 3, 1, 1, 4, 1, 0)
+
+/* Objects of the SNMP-FRAMEWORK-MIB and SNMP-USER-BASED-SM-MIB served for
+ * SNMPv3: snmpEngine and usmStats.
+ */
+#define SNMP_ENGINE_OID(...) OID_INIT(1, 3, 6, 1, 6, 3, 10, 2, 1, __VA_ARGS__)
+#define USM_STATS_OID(...)   OID_INIT(1, 3, 6, 1, 6, 3, 15, 1, 1, __VA_ARGS__)
+
+#endif /* MIB_H */
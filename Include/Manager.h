@@ -0,0 +1,163 @@
+#ifndef MANAGER_H
+#define MANAGER_H
+
+#include <Common.h>
+#include <Clock.h>
+#include <Database.h>
+#include <SNMP.h>
+
+/* Requests that may be outstanding across all devices at the same time. A
+ * request identifier carries the index of its slot, so this is also the
+ * size of the demultiplexing table.
+ */
+#ifndef MANAGER_MAX_REQUESTS
+ #define MANAGER_MAX_REQUESTS 1024
+#endif
+
+/* Timer wheel: MANAGER_WHEEL_SLOTS buckets of MANAGER_WHEEL_RESOLUTION
+ * each. Deadlines beyond one turn of the wheel stay in their bucket and are
+ * looked at again on every turn.
+ */
+#define MANAGER_WHEEL_SLOTS      256
+#define MANAGER_WHEEL_RESOLUTION (10 * NANOSECONDS_PER_MILLISECOND)
+
+/* Marks the end of a list of request slots. */
+#define MANAGER_NONE UINT16_MAX
+
+typedef struct ManagerConfig
+{
+	/* Milliseconds to wait for the first response. The wait is doubled
+	 * after every retransmission.
+	 */
+	uint32_t timeout;
+
+	/* Retransmissions of a request before it times out. */
+	uint8_t retries;
+} ManagerConfig;
+
+typedef struct ManagerDeviceStatistics
+{
+	uint32_t requests;
+	uint32_t responses;
+	uint32_t retransmissions;
+	uint32_t timeouts;
+	uint32_t errors;    /* Responses with a non-zero error-status. */
+	uint32_t varbinds;  /* Values stored in the object tree. */
+} ManagerDeviceStatistics;
+
+/* A polled controller and the image of its objects. Every response from the
+ * device is decoded straight into global and asc, whose tables are sized by
+ * the limits the device was added with. tree points into the structure, so
+ * a device must stay in place once initialized.
+ */
+typedef struct ManagerDevice
+{
+	struct sockaddr_in address;
+	const char        *community;
+
+	/* Requests that may be in flight to this device at once. */
+	uint16_t window;
+	uint16_t outstanding;
+
+	Global     global;
+	ASC        asc;
+	DMS        dms;
+	ESS        ess;
+	TSS        tss;
+	RSU        rsu;
+	RMC        rmc;
+	ObjectTree tree;
+
+	ManagerDeviceStatistics statistics;
+} ManagerDevice;
+
+/* Called once per request: with the response after its values have been
+ * stored in the device, or with NULL once the request has timed out.
+ */
+typedef void (*ManagerCallback) (ManagerDevice *device,
+                                 const SNMPPDU *response, void *context);
+
+typedef struct ManagerRequest
+{
+	ManagerDevice  *device;
+	ManagerCallback callback;
+	void           *context;
+	int32_t         requestID;
+	uint8_t         retries;
+	uint64_t        timeout;  /* Nanoseconds. */
+	uint64_t        deadline; /* Monotonic nanoseconds. */
+
+	/* Links of the wheel bucket while in flight, of the free list
+	 * otherwise.
+	 */
+	uint16_t next;
+	uint16_t previous;
+	bool     active;
+
+	size_t  length;
+	uint8_t message[SNMP_MAX_MESSAGE];
+} ManagerRequest;
+
+typedef struct ManagerStatistics
+{
+	uint32_t inPackets;
+	uint32_t inASNParseErrors;
+	uint32_t unmatchedResponses; /* Late, duplicate or spoofed responses. */
+	uint32_t outPackets;
+} ManagerStatistics;
+
+/* Asynchronous SNMP manager. A single thread drives any number of devices
+ * over one UDP socket by calling managerService(); requests to the same or
+ * different devices are pipelined up to the window of each device.
+ */
+typedef struct Manager
+{
+	ManagerConfig     config;
+	int               socket;
+	uint16_t          sequence;
+	uint16_t          freeList;
+	size_t            active;
+	uint64_t          wheelTime; /* Start of the bucket under the cursor. */
+	uint16_t          wheel[MANAGER_WHEEL_SLOTS];
+	ManagerStatistics statistics;
+	SNMPMessage       message;
+	uint8_t           buffer[SNMP_MAX_MESSAGE];
+	ManagerRequest    requests[MANAGER_MAX_REQUESTS];
+} Manager;
+
+bool managerInit (Manager *manager, const ManagerConfig *config);
+void managerClose (Manager *manager);
+
+/* Prepares a device and allocates the tables of its object tree. */
+bool managerDeviceInit (ManagerDevice *device,
+                        const struct sockaddr_in *address,
+                        const char *community, uint16_t window,
+                        const DatabaseLimits *limits);
+void managerDeviceFree (ManagerDevice *device);
+
+/* Sends a GetRequest, or a GetBulkRequest, for count names. Returns false
+ * without sending if the window of the device or the request table is full,
+ * or if the request does not fit in a datagram.
+ */
+bool managerGet (Manager *manager, ManagerDevice *device,
+                 const OID names[], size_t count, ManagerCallback callback,
+                 void *context);
+bool managerGetBulk (Manager *manager, ManagerDevice *device,
+                     const OID names[], size_t count, uint32_t nonRepeaters,
+                     uint32_t maxRepetitions, ManagerCallback callback,
+                     void *context);
+
+/* Sends a SetRequest. The values stored in the device image on success are
+ * those of the response, i.e. the ones the device accepted.
+ */
+bool managerSet (Manager *manager, ManagerDevice *device,
+                 const VarBind varbinds[], size_t count,
+                 ManagerCallback callback, void *context);
+
+/* Waits up to timeout milliseconds (-1 for ever) for responses, processes
+ * every response queued on the socket and retransmits or expires requests
+ * whose timer has run out. Returns false on a socket error.
+ */
+bool managerService (Manager *manager, int timeout);
+
+#endif /* MANAGER_H */
@@ -0,0 +1,50 @@
+#ifndef METER_H
+#define METER_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Detector.h>
+
+/* Ramp metering (NTCIP 1207). The meter shares the loops of the controller:
+ * mainline lanes and queue detectors are vehicle detectors of the asc node,
+ * and their edges reach the meter through a detector hook, on the tick the
+ * detector pipeline takes them. A rising edge of a mainline detector counts
+ * a vehicle and a falling edge adds the time it was occupied for, so the
+ * work done is by edge rather than by tick.
+ *
+ * The counts go into one second buckets summed over a window of
+ * rmcCalcInterval seconds. Every second the oldest bucket is replaced, and
+ * when the mainline occupancy or flow rate of the window differs from what
+ * was published the traffic responsive level is selected again. The rate
+ * of a lane is worked out again only when its level, its queue or the
+ * database changed:
+ *
+ *   dark                 0
+ *   fixed                rmcCmdRate
+ *   traffic responsive   rmcTRLevelRate of the level reached, or
+ *                        rmcMaxMeterRate below the first
+ *   queue flushed        rmcMaxMeterRate
+ *
+ * bounded by rmcMinMeterRate and rmcMaxMeterRate unless dark. A queue is
+ * flushed from when its detector has been occupied for
+ * rmcQueueOccupiedTime until it clears.
+ */
+
+/* Allocates the state of the lanes and registers the detector hook. */
+bool meterInit (const DatabaseLimits *limits);
+void meterFree (void);
+
+/* Has the tick take the lanes and levels again after a change of the
+ * database.
+ */
+void meterInvalidate (void);
+
+/* Detector hook: counts the edges of the mainline and queue detectors. */
+void meterDetect (const DetectorEdges *edges);
+
+/* Tick hook: slides the window, times the queues and settles the rates
+ * that changed.
+ */
+void meterTick (uint64_t deadline, uint64_t now);
+
+#endif /* METER_H */
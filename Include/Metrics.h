@@ -0,0 +1,81 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Common.h>
+#include <Clock.h>
+
+/* Timed sections of the agent. */
+typedef enum Metric
+{
+	METRIC_DECODE   = 0, /* Decoding a request message. */
+	METRIC_LOOKUP   = 1, /* Resolving a name in the registry. */
+	METRIC_ENCODE   = 2, /* Encoding a response message. */
+	METRIC_TICK     = 3, /* Running the hooks of one tick. */
+	METRIC_VERIFY   = 4, /* Verifying a database transaction. */
+	METRIC_FSYNC    = 5, /* Flushing the journal to storage. */
+	METRIC_LATENESS = 6, /* Start of a tick after its deadline. */
+	METRIC_PREEMPT  = 7, /* From a preempt input to the masks it drives. */
+	METRIC_FORWARD  = 8, /* From queueing a message to the radio. */
+	METRIC_COUNT
+} Metric;
+
+/* Durations are kept in a log-linear histogram: every power of two is split
+ * into METRICS_SUB_BUCKETS buckets, so a bucket is never wider than an
+ * eighth of its lower bound. Durations of 2^32 ns (4.3 s) and more fall in
+ * the last bucket.
+ */
+#define METRICS_SUB_BITS    3
+#define METRICS_SUB_BUCKETS (1u << METRICS_SUB_BITS)
+#define METRICS_BUCKETS     ((32 - METRICS_SUB_BITS + 1) * METRICS_SUB_BUCKETS)
+
+/* Threads that get a shard of their own. Further threads share one shard
+ * that is updated with atomic read-modify-write operations.
+ */
+#define METRICS_MAX_THREADS 8
+
+/* Age at which the aggregated view is rebuilt on the next read. */
+#define METRICS_SNAPSHOT_AGE (1000 * NANOSECONDS_PER_MILLISECOND)
+
+/* metricEntry: one row per Metric. Durations are in nanoseconds. */
+typedef struct MetricEntry
+{
+	uint32_t    metricIndex;
+	const char *metricName;
+	uint64_t    metricCount;   /* Counter64 */
+	uint64_t    metricTotal;   /* Counter64 */
+	uint32_t    metricMaximum; /* Gauge32 */
+	uint32_t    metricP50;     /* Gauge32 */
+	uint32_t    metricP99;     /* Gauge32 */
+	uint32_t    metricP999;    /* Gauge32 */
+} MetricEntry;
+
+/* metricBucketEntry, indexed by metricIndex.metricBucketIndex. */
+typedef struct MetricBucketEntry
+{
+	uint32_t metricBucketIndex;
+	uint32_t metricBucketLowerBound; /* Gauge32 */
+	uint64_t metricBucketCount;      /* Counter64 */
+} MetricBucketEntry;
+
+typedef struct MetricsSnapshot
+{
+	uint64_t          taken; /* Monotonic nanoseconds, zero before the first. */
+	MetricEntry       metricTable[METRIC_COUNT];
+	MetricBucketEntry metricBucketTable[METRIC_COUNT * METRICS_BUCKETS];
+} MetricsSnapshot;
+
+/* Adds one duration to a metric. Safe to call from any thread; no locks are
+ * taken and the calling thread only writes to its own shard.
+ */
+void metricsRecord (Metric metric, uint64_t nanoseconds);
+
+/* Sums the shards of every thread into the snapshot unless it is younger
+ * than METRICS_SNAPSHOT_AGE. Called by the agent only, when the metric
+ * objects are read.
+ */
+const MetricsSnapshot *metricsSnapshot (void);
+
+/* Lowest duration counted in a bucket. */
+uint32_t metricsBucketLowerBound (size_t bucket);
+
+#endif /* METRICS_H */
@@ -0,0 +1,59 @@
+#ifndef MULTI_H
+#define MULTI_H
+
+#include <Common.h>
+#include <NTCIP.h>
+
+/* MULTI, the markup of DMS messages (NTCIP 1203 section 6), rendered into
+ * the pages of a monochrome sign. Text is set in the fonts of the
+ * fontDefinition node, starting with the defaults of multiCfg, and these
+ * tags are understood:
+ *
+ *   [nl] [nlN]        new line, N pixels below the one before
+ *   [np]              new page
+ *   [foN] [foN,XXXX]  font number N, of version ID XXXX in hexadecimal
+ *   [jlN]             line justification: left, center or right
+ *   [jpN]             page justification: top, middle or bottom
+ *   [ptNoM]           page on and off times in tenths of a second
+ *   [scN] [/sc]       N pixels between characters, and back to the font's
+ *   [hcN]             the character of hexadecimal code N
+ *   [[ ]]             the brackets themselves
+ *
+ * Text of one line may be left, centered and right justified in that
+ * order; a page takes the page justification in effect at its first
+ * character. Any other tag, flashing and color among them, is refused as
+ * unsupported.
+ */
+
+/* Pages of a message, and lines of a page. */
+#define MULTI_MAX_PAGES 6
+#define MULTI_MAX_LINES 16
+
+/* A page is one bit per pixel, lit when set, in rows of the sign width with
+ * the most significant bit first and no padding between rows.
+ */
+#define MULTI_PAGE_OCTETS                                                      \
+	((CONFIG_SIGN_WIDTH_PIXELS * CONFIG_SIGN_HEIGHT_PIXELS + 7) / 8)
+
+typedef struct MultiPage
+{
+	uint8_t onTime;  /* Tenths of a second. */
+	uint8_t offTime;
+	uint8_t bitmap[MULTI_PAGE_OCTETS];
+} MultiPage;
+
+typedef struct MultiMessage
+{
+	uint8_t   pageCount;
+	MultiPage pages[MULTI_MAX_PAGES];
+} MultiMessage;
+
+/* Renders length octets of MULTI text with the fonts and defaults of sign.
+ * Returns MULTI_SYNTAX_NONE, or the error and the offset of the octet it
+ * was found at in position; message is undefined after an error.
+ */
+enum MultiSyntaxError multiRender (const DMS *sign, const uint8_t *multi,
+                                   size_t length, MultiMessage *message,
+                                   size_t *position);
+
+#endif /* MULTI_H */
@@ -5,15 +5,15 @@
 
 #include <Objects/Common.h> /* NTCIP 1201 */
 #include <Objects/ASC.h>    /* NTCIP 1202 */
-//#include <Objects/DMS.h>    /* NTCIP 1203 */
-//#include <Objects/ESS.h>    /* NTCIP 1204 */
+#include <Objects/DMS.h>    /* NTCIP 1203 */
+#include <Objects/ESS.h>    /* NTCIP 1204 */
 //#include <Objects/CCTV.h>   /* NTCIP 1205 + NTCIP 1208 */
 //#include <Objects/DCM.h>    /* NTCIP 1206 */
-//#include <Objects/RMC.h>    /* NTCIP 1207 */
-//#include <Objects/TSS.h>    /* NTCIP 1209 */
+#include <Objects/RMC.h>    /* NTCIP 1207 */
+#include <Objects/TSS.h>    /* NTCIP 1209 */
 //#include <Objects/SSM.h>    /* NTCIP 1210 */
 //#include <Objects/SCP.h>    /* NTCIP 1211 */
 //#include <Objects/ELMS.h>   /* NTCIP 1213 */
-//#include <Objects/RSU.h>    /* NTCIP 1218 */
+#include <Objects/RSU.h>    /* NTCIP 1218 */
 
 #endif /* NTCIP_H */
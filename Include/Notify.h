@@ -0,0 +1,96 @@
+#ifndef NOTIFY_H
+#define NOTIFY_H
+
+#include <Common.h>
+#include <SNMP.h>
+#include <Objects/ASC.h>
+
+/* Changes collected into one notification before it is sent early. This
+ * keeps an encoded notification well inside SNMP_MAX_MESSAGE.
+ */
+#define NOTIFY_MAX_BATCH 48
+
+/* Informs that may await acknowledgement at the same time. */
+#define NOTIFY_MAX_INFORMS 8
+
+typedef struct NotifyConfig
+{
+	/* Manager that receives the notifications. */
+	struct sockaddr_in destination;
+
+	const char *community;
+
+	/* Send InformRequest PDUs, which the manager acknowledges, instead of
+	 * unacknowledged SNMPv2-Trap PDUs.
+	 */
+	bool inform;
+
+	/* Milliseconds after the first change during which further changes are
+	 * merged into the same notification.
+	 */
+	uint32_t coalesceWindow;
+
+	/* Milliseconds to wait for the first inform acknowledgement. The wait is
+	 * doubled after every retransmission.
+	 */
+	uint32_t informTimeout;
+
+	/* Retransmissions of an unacknowledged inform before it is dropped. */
+	uint8_t informRetries;
+} NotifyConfig;
+
+typedef struct NotifyInform
+{
+	bool     active;
+	int32_t  requestID;
+	uint8_t  retries;
+	uint64_t timeout;  /* Nanoseconds. */
+	uint64_t deadline; /* Monotonic nanoseconds. */
+	size_t   length;
+	uint8_t  message[SNMP_MAX_MESSAGE];
+} NotifyInform;
+
+/* Report-by-exception state. The notifier keeps the last reported value of
+ * every watched object and emits only the objects whose value has changed
+ * since, instead of managers polling them every second.
+ */
+typedef struct Notify
+{
+	NotifyConfig config;
+	int          socket;
+	uint64_t     epoch;
+	int32_t      requestID;
+	bool         primed;
+
+	uint8_t               vehicleDetectorAlarms[UINT8_MAX];
+	uint8_t               pedestrianDetectorAlarms[UINT8_MAX];
+	PhaseStatusGroupEntry phaseStatusGroups[UINT8_MAX];
+
+	size_t   pending;
+	uint64_t windowDeadline;
+	VarBind  batch[NOTIFY_MAX_BATCH];
+
+	NotifyInform informs[NOTIFY_MAX_INFORMS];
+
+	uint32_t notificationsSent;
+	uint32_t changesCoalesced;
+	uint32_t informsRetransmitted;
+	uint32_t informsAcknowledged;
+	uint32_t informsDropped;
+} Notify;
+
+bool notifyInit (Notify *notify, const NotifyConfig *config);
+void notifyClose (Notify *notify);
+
+/* Compares the watched objects of asc with the last reported values and
+ * queues every edge. Intended to run once per tick, after the tick has
+ * updated the status objects.
+ */
+void notifyScan (Notify *notify, const ASC *asc, uint64_t now);
+
+/* Sends the queued changes once the coalescing window has closed, processes
+ * inform acknowledgements and retransmits informs whose timer expired.
+ */
+void notifyService (Notify *notify, uint64_t now);
+
+#endif /* NOTIFY_H */
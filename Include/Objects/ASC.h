@@ -2,6 +2,8 @@
 #define ASC_H
 
 #include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
 
 /* Parameters for a specific Actuated Controller Unit phase. */
 typedef struct PhaseEntry
@@ -293,7 +295,7 @@ typedef struct PhaseEntry
 	 * concurrently with the associated phase. Phases that are contained in the
 	 * same ring may NOT run concurrently.
 	 */
-	const char *const phaseConcurrency
+	OctetText phaseConcurrency;
 } PhaseEntry;
 
 /* Red, Yellow, & Green Output Status and Vehicle and Pedestrian Call for eight
@@ -850,7 +852,8 @@ typedef struct VolumeOccupancyReport
 	uint8_t               volumeOccupancySequence;
 	uint8_t               volumeOccupancyPeriod;
 	uint8_t               activeVolumeOccupancyDetectors;
-	VolumeOccupancyEntry *volumeOccupancyTable;
+	OBJECT_TABLE(VolumeOccupancyEntry, volumeOccupancyTable,
+	             CONFIG_MAX_VEHICLE_DETECTORS);
 
 } VolumeOccupancyReport;
 
@@ -937,7 +940,7 @@ typedef struct Phase
 	 */
 	uint8_t maxPhases;
 
-	PhaseEntry *phaseTable;
+	OBJECT_TABLE(PhaseEntry, phaseTable, CONFIG_MAX_PHASES);
 
 	/* The Maximum Number of Phase Groups (8 Phases per group) this Actuated
 	 * Controller Unit supports. This value is equal to TRUNCATE
@@ -950,7 +953,8 @@ typedef struct Phase
 	 * Green) and Call (vehicle & pedestrian) status in groups of eight Phases.
 	 * The number of rows in this table is equal to the maxPhaseGroups object.
 	 */
-	PhaseStatusGroupEntry *phaseStatusGroupTable;
+	OBJECT_TABLE(PhaseStatusGroupEntry, phaseStatusGroupTable,
+	             CONFIG_GROUPS(CONFIG_MAX_PHASES));
 
 	/* A table containing Actuated Controller Unit Phase Control in groups of
 	 * eight phases. The number of rows in this table is equal to the
@@ -958,7 +962,8 @@ typedef struct Phase
 	 * Units conforming to this specification. If implemented then all objects
 	 * in this table shall be implemented.
 	 */
-	PhaseControlGroupEntry *phaseControlGroupTable;
+	OBJECT_TABLE(PhaseControlGroupEntry, phaseControlGroupTable,
+	             CONFIG_GROUPS(CONFIG_MAX_PHASES));
 } Phase;
 
 /* This defines a node for supporting detector objects. */
@@ -974,7 +979,8 @@ typedef struct Detector
 	 * The number of rows in this table is equal to the maxVehicleDetectors
 	 * object.
 	 */
-	VehicleDetectorEntry *vehicleDetectorTable;
+	OBJECT_TABLE(VehicleDetectorEntry, vehicleDetectorTable,
+	             CONFIG_MAX_VEHICLE_DETECTORS);
 
 	/* The maximum number of detector status groups (8 detectors per group) this
 	 * device supports. This value is equal to TRUNCATE
@@ -988,7 +994,9 @@ typedef struct Detector
 	 * number of rows in this table is equal to the
 	 * maxVehicleDetectorStatusGroups object.
 	 */
-	VehicleDetectorStatusGroupEntry *vehicleDetectorStatusGroupTable;
+	OBJECT_TABLE(VehicleDetectorStatusGroupEntry,
+	             vehicleDetectorStatusGroupTable,
+	             CONFIG_GROUPS(CONFIG_MAX_VEHICLE_DETECTORS));
 
 	/* This node contains the objects necessary to support volume / occupancy
 	 * reporting.
@@ -1005,7 +1013,8 @@ typedef struct Detector
 	 * parameters. The number of rows in this table is equal to the
 	 * maxPedestrianDetectors object.
 	 */
-	PedestrianDetectorEntry *pedestrianDetectorTable;
+	OBJECT_TABLE(PedestrianDetectorEntry, pedestrianDetectorTable,
+	             CONFIG_MAX_PEDESTRIAN_DETECTORS);
 } Detector;
 
 typedef struct Unit
@@ -1018,11 +1027,348 @@ typedef struct Unit
 	uint8_t unitStartUpFlash;
 } Unit;
 
+/* Values of the pattern objects that do not name a pattern. */
+enum
+{
+	PATTERN_NONE  = 0,
+	PATTERN_FREE  = 254,
+	PATTERN_FLASH = 255
+};
+
+/* Parameters of one coordination pattern. */
+typedef struct PatternEntry
+{
+	/* The pattern number for objects in this row. This value shall not exceed
+	 * the maxPatterns object value.
+	 */
+	uint8_t patternNumber;
+
+	/* The Cycle Length in seconds for this pattern. A value of zero shall
+	 * cause the pattern to run free.
+	 */
+	uint8_t patternCycleTime;
+
+	/* The Offset in seconds for this pattern: the time from the system
+	 * reference point to the start of the coordinated phase green. The value
+	 * shall be less than patternCycleTime.
+	 */
+	uint8_t patternOffsetTime;
+
+	/* The Split Number (splitNumber) of the splits this pattern uses. */
+	uint8_t patternSplitNumber;
+
+	/* The Sequence Number of the phase order this pattern uses. */
+	uint8_t patternSequenceNumber;
+} PatternEntry;
+
+/* The time one phase receives within a cycle under one split plan. */
+typedef struct SplitEntry
+{
+	/* The split number for objects in this row. This value shall not exceed
+	 * the maxSplits object value.
+	 */
+	uint8_t splitNumber;
+
+	/* The phase number for objects in this row. This value shall not exceed
+	 * the maxPhases object value.
+	 */
+	uint8_t splitPhase;
+
+	/* The time in seconds the phase may be serviced within the cycle,
+	 * including its Yellow Change and Red Clearance intervals.
+	 */
+	uint8_t splitTime;
+
+	/* The operational mode of the phase under this split. */
+	enum
+	{
+		SPLIT_MODE_OTHER                 = 1,
+		SPLIT_MODE_NONE                  = 2,
+		SPLIT_MODE_MINIMUM_VEHICLE       = 3,
+		SPLIT_MODE_MAXIMUM_VEHICLE       = 4,
+		SPLIT_MODE_PEDESTRIAN            = 5,
+		SPLIT_MODE_MAXIMUM_VEHICLE_PED   = 6,
+		SPLIT_MODE_OMITTED               = 7
+	} splitMode;
+
+	/* Whether the phase is a coordinated phase (1) or not (0). The
+	 * coordinated phase of a ring is held Green until its yield point, and the
+	 * offset is measured to the start of its Green.
+	 */
+	uint8_t splitCoordPhase;
+} SplitEntry;
+
+/* This node shall contain objects that configure, monitor or control
+ * coordination for this device.
+ */
+typedef struct Coord
+{
+	/* The Operational Mode of coordination. 0 is automatic, where the pattern
+	 * in effect is that of systemPatternControl, or else of the time base;
+	 * 1 to 253 run that pattern; 254 runs free and 255 flashes.
+	 */
+	uint8_t coordOperationalMode;
+
+	/* How the controller corrects to a new offset. */
+	enum
+	{
+		COORD_CORRECTION_OTHER    = 1,
+		COORD_CORRECTION_DWELL    = 2,
+		COORD_CORRECTION_SHORTWAY = 3,
+		COORD_CORRECTION_ADD_ONLY = 4
+	} coordCorrectionMode;
+
+	/* Which maximum timing applies while coordinated. */
+	enum
+	{
+		COORD_MAXIMUM_OTHER   = 1,
+		COORD_MAXIMUM_1       = 2,
+		COORD_MAXIMUM_2       = 3,
+		COORD_MAXIMUM_INHIBIT = 4
+	} coordMaximumMode;
+
+	/* How force off points are placed. Fixed places each at a fixed point
+	 * of the cycle; floating limits each phase to its split time from the
+	 * moment it starts.
+	 */
+	enum
+	{
+		COORD_FORCE_OTHER    = 1,
+		COORD_FORCE_FLOATING = 2,
+		COORD_FORCE_FIXED    = 3
+	} coordForceMode;
+
+	/* The Maximum Number of Patterns this device supports. */
+	uint8_t maxPatterns;
+
+	/* The organization of the pattern table. */
+	enum
+	{
+		PATTERN_TABLE_OTHER    = 1,
+		PATTERN_TABLE_PATTERNS = 2,
+		PATTERN_TABLE_OFFSET3  = 3,
+		PATTERN_TABLE_OFFSET5  = 4
+	} patternTableType;
+
+	/* A table containing the coordination patterns. The number of rows in
+	 * this table is equal to the maxPatterns object.
+	 */
+	OBJECT_TABLE(PatternEntry, patternTable, CONFIG_MAX_PATTERNS);
+
+	/* The Maximum Number of Split plans this device supports. */
+	uint8_t maxSplits;
+
+	/* A table containing the split times of each phase under each split
+	 * plan, indexed by splitNumber.splitPhase. The number of rows in this
+	 * table is equal to maxSplits times maxPhases.
+	 */
+	OBJECT_TABLE(SplitEntry, splitTable, CONFIG_MAX_SPLITS * CONFIG_MAX_PHASES);
+
+	/* The pattern running: 0 when none is, 1 to 253 the pattern number, 254
+	 * free and 255 flash.
+	 */
+	uint8_t coordPatternStatus;
+
+	/* Why the controller is running free, if it is. */
+	enum
+	{
+		LOCAL_FREE_OTHER           = 1,
+		LOCAL_FREE_NOT_FREE        = 2,
+		LOCAL_FREE_COMMAND_FREE    = 3,
+		LOCAL_FREE_TRANSITION_FREE = 4,
+		LOCAL_FREE_INPUT_FREE      = 5,
+		LOCAL_FREE_COORD_FREE      = 6,
+		LOCAL_FREE_BAD_PLAN        = 7,
+		LOCAL_FREE_BAD_CYCLE_TIME  = 8,
+		LOCAL_FREE_SPLIT_OVERRUN   = 9,
+		LOCAL_FREE_INVALID_OFFSET  = 10,
+		LOCAL_FREE_FAILED          = 11
+	} localFreeStatus;
+
+	/* Seconds left in the local cycle, counting down to zero at the start of
+	 * the coordinated phase green.
+	 */
+	uint16_t coordCycleStatus;
+
+	/* Seconds since the last system reference point of the cycle, counting
+	 * up from zero.
+	 */
+	uint16_t coordSyncStatus;
+
+	/* A pattern commanded by a central system, overriding the time base: 0
+	 * leaves the choice to the time base, 1 to 253 run that pattern, 254 runs
+	 * free and 255 flashes.
+	 */
+	uint8_t systemPatternControl;
+
+	/* Writing a value other than 255 resets the cycle reference point to
+	 * the time of the write.
+	 */
+	uint8_t systemSyncControl;
+} Coord;
+
+/* The action of a day plan event for this device. */
+typedef struct TimebaseAscActionEntry
+{
+	/* The action number for objects in this row. This value shall not
+	 * exceed the maxTimebaseAscActions object value. Day plan events refer to
+	 * an action by the OID of this object.
+	 */
+	uint8_t timebaseAscActionNumber;
+
+	/* The pattern the action selects: 0 none, 1 to 253 that pattern, 254
+	 * free and 255 flash.
+	 */
+	uint8_t timebaseAscPattern;
+
+	/* Auxiliary functions the action sets, one per bit. */
+	uint8_t timebaseAscAuxillaryFunction;
+
+	/* Special functions the action sets, one per bit. */
+	uint8_t timebaseAscSpecialFunction;
+} TimebaseAscActionEntry;
+
+/* This node shall contain the time base objects specific to this device. */
+typedef struct TimebaseAsc
+{
+	/* The system reference point of every cycle, in minutes after midnight.
+	 * Values of 1440 or more refer to midnight.
+	 */
+	uint16_t timebaseAscPatternSync;
+
+	/* The Maximum Number of Actions this device supports. */
+	uint8_t maxTimebaseAscActions;
+
+	/* A table containing the actions day plan events may refer to. The
+	 * number of rows in this table is equal to the maxTimebaseAscActions
+	 * object.
+	 */
+	OBJECT_TABLE(TimebaseAscActionEntry, timebaseAscActionTable,
+	             CONFIG_MAX_TIMEBASE_ASC_ACTIONS);
+
+	/* The action in effect, or 0 if none is. */
+	uint8_t timebaseAscActionStatus;
+} TimebaseAsc;
+
+/* Parameters and state of one preempt input. Phase lists hold one phase
+ * number per octet.
+ */
+typedef struct PreemptEntry
+{
+	/* The preempt number for objects in this row. This value shall not
+	 * exceed the maxPreempts object value. Lower numbered preempts take
+	 * priority over higher numbered ones.
+	 */
+	uint8_t preemptNumber;
+
+	/* Preempt miscellaneous control parameter.
+	 *
+	 *     Bit      | Meaning
+	 *     ---------+--------------------------------------------------------
+	 *     0        | Non-Locking Memory: a call that goes away before the
+	 *              | Delay has timed is dropped.
+	 *     1        | Override Flash (not supported).
+	 *     2        | Preempt Override Priority (not supported).
+	 *     3        | Flash Dwell (not supported).
+	 */
+	uint8_t preemptControl;
+
+	/* A higher numbered preempt called when this one leaves dwell, or 0. */
+	uint8_t preemptLink;
+
+	/* Seconds a call must be present before the preempt starts (0 to 600). */
+	uint16_t preemptDelay;
+
+	/* Seconds the preempt is serviced at least, from the start of entry. */
+	uint16_t preemptMinimumDuration;
+
+	/* Seconds of green a terminating phase is guaranteed on entry. Phases
+	 * whose own minimum green is shorter keep theirs.
+	 */
+	uint8_t preemptMinimumGreen;
+
+	/* Seconds of walk a terminating pedestrian movement is guaranteed. */
+	uint8_t preemptMinimumWalk;
+
+	/* Seconds of pedestrian clearance a terminating movement times. */
+	uint8_t preemptEnterPedClear;
+
+	/* Seconds of green of the track clearance phases. */
+	uint8_t preemptTrackGreen;
+
+	/* Seconds of green of the dwell phases at least. */
+	uint8_t preemptDwellGreen;
+
+	/* Seconds a call may be present before it is taken as failed and the
+	 * preempt is left until the call goes away, or 0 for no limit.
+	 */
+	uint16_t preemptMaximumPresence;
+
+	/* The track clearance phases. */
+	OctetText   preemptTrackPhase;
+
+	/* The phases served during dwell. */
+	OctetText   preemptDwellPhase;
+
+	/* The pedestrian movements served during dwell. */
+	OctetText   preemptDwellPed;
+
+	/* The phase called as the preempt exits, or 0. */
+	uint8_t preemptExitPhase;
+
+	/* The state of the preempt. */
+	enum
+	{
+		PREEMPT_STATE_OTHER                = 1,
+		PREEMPT_STATE_NOT_ACTIVE           = 2,
+		PREEMPT_STATE_NOT_ACTIVE_WITH_CALL = 3,
+		PREEMPT_STATE_ENTRY_STARTED        = 4,
+		PREEMPT_STATE_TRACK_SERVICE        = 5,
+		PREEMPT_STATE_DWELL                = 6,
+		PREEMPT_STATE_LINK_ACTIVE          = 7,
+		PREEMPT_STATE_EXIT_STARTED         = 8,
+		PREEMPT_STATE_MAXIMUM_PRESENCE     = 9
+	} preemptState;
+} PreemptEntry;
+
+/* Remote call of one preempt. */
+typedef struct PreemptControlEntry
+{
+	/* The preempt number for objects in this row. */
+	uint8_t preemptControlNumber;
+
+	/* When not zero, the preempt is called as if its input were active. */
+	uint8_t preemptControlState;
+} PreemptControlEntry;
+
+/* This node shall contain objects that configure, monitor or control
+ * preemption for this device.
+ */
+typedef struct Preempt
+{
+	/* The Maximum Number of Preempts this device supports. */
+	uint8_t maxPreempts;
+
+	/* A table containing the preempt parameters. The number of rows in this
+	 * table is equal to the maxPreempts object.
+	 */
+	OBJECT_TABLE(PreemptEntry, preemptTable, CONFIG_MAX_PREEMPTS);
+
+	/* A table with one remote call per preempt. The number of rows in this
+	 * table is equal to the maxPreempts object.
+	 */
+	OBJECT_TABLE(PreemptControlEntry, preemptControlTable,
+	             CONFIG_MAX_PREEMPTS);
+} Preempt;
+
 typedef struct ASC
 {
-	Phase    phase;
-	Detector detector;
-	Unit     unit;
+	Phase       phase;
+	Detector    detector;
+	Unit        unit;
+	Coord       coord;
+	TimebaseAsc timebaseAsc;
+	Preempt     preempt;
 } ASC;
 
 #endif /* ASC_H */
@@ -2,6 +2,8 @@
 #define COMMON_OBJECTS_H
 
 #include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
 
 enum Month
 {
@@ -61,13 +63,13 @@ typedef struct ModuleTableEntry
 	/* This object specifies the manufacturer of the associated module.
 	 * A null-string shall be transmitted if this object has no entry.
 	 */
-	const char *const moduleMake;
+	OctetString moduleMake;
 
 	/* This object specifies the model number (hardware) or firmware reference
 	 * (software) of the associated module. A null-string shall be transmitted
 	 * if this object has no entry.
 	 */
-	const char *const moduleModel;
+	OctetString moduleModel;
 
 	/* This object specifies the version of the associated module. If the
 	 * moduleType has a value of software, the value of this object shall
@@ -79,7 +81,7 @@ typedef struct ModuleTableEntry
 	 * presented as 20020705 – v7.03.02 A null-string shall be transmitted if
 	 * this object has no entry.
 	 */
-	const char *const moduleVersion;
+	OctetString moduleVersion;
 
 	/* This object specifies whether the associated module is a hardware or
 	 * software module.
@@ -231,8 +233,12 @@ typedef struct TimeBaseDayPlanEntry
 	 * device may be able to perform. If the action to be performed is defined
 	 * by a row of a table, one of the index columns should be identified as the
 	 * explicit object that is referenced.
+	 *
+	 * Actions of this device are rows of the timebaseAscActionTable, so the
+	 * object is held as the timebaseAscActionNumber it references, or 0 for
+	 * none, and served as the instance of that column.
 	 */
-	const char *const dayPlanActionNumberOID;
+	uint8_t dayPlanActionNumberOID;
 } TimeBaseDayPlanEntry;
 
 typedef struct Timebase
@@ -260,7 +266,8 @@ typedef struct Timebase
 	 * deactivated by setting the Month, Day, Date, or DayPlan parameters to
 	 * zero (0)
 	 */
-	TimeBaseScheduleEntry *timeBaseScheduleTable;
+	OBJECT_TABLE(TimeBaseScheduleEntry, timeBaseScheduleTable,
+	             CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES);
 
 	/* This object specifies what Plan number shall be associated with this
 	 * timeBaseScheduleDayPlan object. The value of this object cannot exceed
@@ -299,7 +306,8 @@ typedef struct Timebase
 	 * logic searches for all events that may have occurred for at least the
 	 * previous 24 hours.
 	 */
-	TimeBaseDayPlanEntry *timeBaseDayPlanTable;
+	OBJECT_TABLE(TimeBaseDayPlanEntry, timeBaseDayPlanTable,
+	             CONFIG_MAX_DAY_PLANS * CONFIG_MAX_DAY_PLAN_EVENTS);
 
 	/* This object indicates the current value of the active
 	 * dayPlanNumber-object. A value of zero (0) indicates that there is no
@@ -454,7 +462,7 @@ typedef struct DaylightSavingNode
 	 * The number of rows in this table is equal to the maxDaylightSavingEntries
 	 * object.
 	 */
-	DSTEntry *dstTable;
+	OBJECT_TABLE(DSTEntry, dstTable, CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES);
 } DaylightSavingNode;
 
 /* This node is an identifier used to group all objects for support of
@@ -486,7 +494,7 @@ typedef struct GlobalConfiguration
 	 * an indicator if the module is hardware or software related. The number of
 	 * rows in this table shall equal the value of the globalMaxModules object.
 	 */
-	ModuleTableEntry *globalModuleTable;
+	OBJECT_TABLE(ModuleTableEntry, globalModuleTable, CONFIG_MAX_MODULES);
 
 	/* For use in this object, an ASCII string that shall identify all of the
 	 * standard document numbers that define or reference MIBs upon which the
@@ -514,7 +522,7 @@ typedef struct GlobalConfiguration
 	 *   NTCIP 2201:v01.14
 	 *   NTCIP 2301:2001 v01.08
 	 */
-	const char *const controllerBaseStandards;
+	OctetString controllerBaseStandards;
 } GlobalConfiguration;
 
 /* This node is an identifier used to group those objects used to manage a
@@ -691,7 +699,7 @@ typedef struct GlobalDatabaseManagement
 	 * valid when the dbCreateTransaction object is in the Error state. It is
 	 * undefined when the dbCreateTransaction object is in other states.
 	 */
-	const char *const dbErrorID;
+	OctetString dbErrorID;
 
 	/* This object has been deprecated since 1996.
 	 * This object contains the transaction ID value that is to be contained in
@@ -705,7 +713,7 @@ typedef struct GlobalDatabaseManagement
 	 * the SET operations that are being buffered or modifying the state of
 	 * dbCreateTransaction.
 	 */
-	const char *const dbTransactionID;
+	OctetString dbTransactionID;
 
 	/* This object has been deprecated since 1996.
 	 * This object is used to create unique transaction ID’s for management
@@ -748,7 +756,7 @@ typedef struct GlobalDatabaseManagement
 	 * in the Done state and the dbVerifyStatus object is in the doneWithError
 	 * state.
 	 */
-	const char *const dbVerifyError;
+	OctetText   dbVerifyError;
 } GlobalDatabaseManagement;
 
 /* This node is an identifier used to organize all objects for support of
@@ -901,7 +909,7 @@ typedef struct AuxIOv2Entry
 	 * NOTE: In NTCIP 1203 v01, the SYNTAX SIZE was listed as (0 .. 50).
 	 * In NTCIP 1201 v02 and NTCIP 1201 v03, this was changed to (0 .. 255).
 	 */
-	char *auxIOv2PortDescription;
+	OctetString auxIOv2PortDescription;
 
 	/* Defines number of bits used for the IO-port (e.g. width of digital,
 	 * resolution of analog). Thus, this feature allows the digital monitoring
@@ -1001,7 +1009,8 @@ typedef struct AuxIOv2
 	 * used by the ports are not standardized by auxIOv2Table objects; such
 	 * information should be contained in the hardware manual.
 	 */
-	AuxIOv2Entry *auxIOv2Table;
+	OBJECT_TABLE(AuxIOv2Entry, auxIOv2Table,
+	             CONFIG_MAX_AUX_DIGITAL_PORTS + CONFIG_MAX_AUX_ANALOG_PORTS);
 } AuxIOv2;
 
 typedef struct Global
@@ -0,0 +1,349 @@
+#ifndef DMS_H
+#define DMS_H
+
+#include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
+
+/* Octets of the longest MULTI string a message may hold. */
+#define MULTI_MAX_LENGTH 512
+
+/* A MULTI string, held in its row since managers rewrite messages often. */
+typedef OCTET_BUFFER(MULTI_MAX_LENGTH) MultiText;
+
+/* Memory types of the message table. */
+enum MessageMemoryType
+{
+	MEMORY_TYPE_OTHER          = 1,
+	MEMORY_TYPE_PERMANENT      = 2,
+	MEMORY_TYPE_CHANGEABLE     = 3,
+	MEMORY_TYPE_VOLATILE       = 4,
+	MEMORY_TYPE_CURRENT_BUFFER = 5,
+	MEMORY_TYPE_SCHEDULE       = 6,
+	MEMORY_TYPE_BLANK          = 7
+};
+
+/* Errors found in a MULTI string by validation or activation. */
+enum MultiSyntaxError
+{
+	MULTI_SYNTAX_OTHER                  = 1,
+	MULTI_SYNTAX_NONE                   = 2,
+	MULTI_SYNTAX_UNSUPPORTED_TAG        = 3,
+	MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE  = 4,
+	MULTI_SYNTAX_TEXT_TOO_BIG           = 5,
+	MULTI_SYNTAX_FONT_NOT_DEFINED       = 6,
+	MULTI_SYNTAX_CHARACTER_NOT_DEFINED  = 7,
+	MULTI_SYNTAX_FIELD_DEVICE_NOT_EXIST = 8,
+	MULTI_SYNTAX_FIELD_DEVICE_ERROR     = 9,
+	MULTI_SYNTAX_FLASH_REGION_ERROR     = 10,
+	MULTI_SYNTAX_TAG_CONFLICT           = 11,
+	MULTI_SYNTAX_TOO_MANY_PAGES         = 12,
+	MULTI_SYNTAX_FONT_VERSION_ID        = 13,
+	MULTI_SYNTAX_GRAPHIC_ID             = 14,
+	MULTI_SYNTAX_GRAPHIC_NOT_DEFINED    = 15
+};
+
+/* Line and page justification of MULTI text. */
+enum Justification
+{
+	JUSTIFICATION_OTHER  = 1,
+	JUSTIFICATION_LEFT   = 2, /* Top for pages. */
+	JUSTIFICATION_CENTER = 3, /* Middle for pages. */
+	JUSTIFICATION_RIGHT  = 4, /* Bottom for pages. */
+	JUSTIFICATION_FULL   = 5
+};
+
+/* This node shall contain the configuration of the sign as a whole. */
+typedef struct DmsSignCfg
+{
+	/* Access to the sign face, one per bit: 1 other, 2 walk-in, 4 rear, 8
+	 * front.
+	 */
+	uint8_t dmsSignAccess;
+
+	/* The type of the sign: 2 bos, 3 cms, 4 vmsChar, 5 vmsLine, 6 vmsFull,
+	 * plus 128 for a portable sign.
+	 */
+	uint8_t dmsSignType;
+
+	/* Height and width of the sign face, including the borders, in
+	 * millimeters.
+	 */
+	uint16_t dmsSignHeight;
+	uint16_t dmsSignWidth;
+
+	/* Width of the left and right border and height of the top and bottom
+	 * border of the sign face, in millimeters.
+	 */
+	uint16_t dmsHorizontalBorder;
+	uint16_t dmsVerticalBorder;
+
+	/* The display technologies of the sign, one per bit: 1 other, 2 LED, 4
+	 * flip disk, 8 fiber optics, 16 shuttered, 32 lamp, 64 drum.
+	 */
+	uint16_t dmsSignTechnology;
+} DmsSignCfg;
+
+/* This node shall contain the pixel geometry of a matrix sign. */
+typedef struct VmsCfg
+{
+	/* Height and width of a character cell in pixels, or 0 when characters
+	 * are not confined to cells.
+	 */
+	uint8_t vmsCharacterHeightPixels;
+	uint8_t vmsCharacterWidthPixels;
+
+	/* Height and width of the sign face in pixels. */
+	uint16_t vmsSignHeightPixels;
+	uint16_t vmsSignWidthPixels;
+
+	/* Distance between the centers of adjacent pixels in millimeters. */
+	uint8_t vmsHorizontalPitch;
+	uint8_t vmsVerticalPitch;
+
+	/* The red, green and blue of an unlit and of a lit pixel of a
+	 * monochrome sign, one octet each.
+	 */
+	OctetString monochromeColor;
+} VmsCfg;
+
+/* One font of the sign. */
+typedef struct FontEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the numFonts object value.
+	 */
+	uint8_t fontIndex;
+
+	/* The number MULTI [fo] tags refer to the font by. */
+	uint8_t fontNumber;
+
+	OctetText   fontName;
+
+	/* Height of every character of the font in pixels. */
+	uint8_t fontHeight;
+
+	/* Default pixels between adjacent characters, and between adjacent
+	 * lines of text.
+	 */
+	uint8_t fontCharSpacing;
+	uint8_t fontLineSpacing;
+
+	/* CRC-16 of the font, which a [fo] tag may name to make sure of the
+	 * font it is rendered with.
+	 */
+	uint16_t fontVersionID;
+
+	/* The state of the font. */
+	enum
+	{
+		FONT_STATUS_NOT_USED          = 1,
+		FONT_STATUS_MODIFYING         = 2,
+		FONT_STATUS_CALCULATING       = 3,
+		FONT_STATUS_READY_FOR_USE     = 4,
+		FONT_STATUS_IN_USE            = 5,
+		FONT_STATUS_PERMANENT         = 6,
+		FONT_STATUS_MODIFY_REQ        = 7,
+		FONT_STATUS_READY_FOR_USE_REQ = 8,
+		FONT_STATUS_NOT_USED_REQ      = 9,
+		FONT_STATUS_UNMANAGED_REQ     = 10,
+		FONT_STATUS_UNMANAGED         = 11
+	} fontStatus;
+} FontEntry;
+
+/* One character of a font, indexed by fontIndex.characterNumber. */
+typedef struct CharacterEntry
+{
+	/* The code of the character in MULTI text. */
+	uint16_t characterNumber;
+
+	/* Width of the character in pixels, or 0 if it is not defined. */
+	uint8_t characterWidth;
+
+	/* The pixels of the character, fontHeight rows of characterWidth, one
+	 * bit per pixel with the most significant bit first and no padding
+	 * between rows. A set bit is lit.
+	 */
+	OctetText   characterBitmap;
+} CharacterEntry;
+
+/* This node shall contain the fonts of the sign. */
+typedef struct FontDefinition
+{
+	/* The Maximum Number of Fonts this device supports. */
+	uint8_t numFonts;
+
+	/* A table containing the fonts. The number of rows in this table is
+	 * equal to the numFonts object.
+	 */
+	OBJECT_TABLE(FontEntry, fontTable, CONFIG_MAX_FONTS);
+
+	/* The Maximum Number of Characters each font may define. */
+	uint16_t maxFontCharacters;
+
+	/* A table containing the characters of every font, indexed by
+	 * fontIndex.characterNumber. The number of rows in this table is equal
+	 * to numFonts times maxFontCharacters.
+	 */
+	OBJECT_TABLE(CharacterEntry, characterTable,
+	             CONFIG_MAX_FONTS * CONFIG_MAX_FONT_CHARACTERS);
+
+	/* Octets a characterBitmap may hold. */
+	uint16_t fontMaxCharacterSize;
+} FontDefinition;
+
+/* This node shall contain the defaults of MULTI text, in effect until a tag
+ * of the message changes them.
+ */
+typedef struct MultiCfg
+{
+	uint8_t defaultBackgroundColor;
+	uint8_t defaultForegroundColor;
+
+	/* Tenths of a second flashing text is on and off. */
+	uint8_t defaultFlashOn;
+	uint8_t defaultFlashOff;
+
+	/* The fontNumber of the font text starts in. */
+	uint8_t defaultFont;
+
+	enum Justification defaultJustificationLine;
+	enum Justification defaultJustificationPage;
+
+	/* Tenths of a second each page of a message is on and off. */
+	uint8_t defaultPageOnTime;
+	uint8_t defaultPageOffTime;
+
+	/* The octets per character code: 1 eight bit, 2 other. */
+	uint8_t defaultCharacterSet;
+} MultiCfg;
+
+/* One message of the sign, indexed by dmsMessageMemoryType.dmsMessageNumber.
+ * Only changeable messages are stored; the rows of the memory types before
+ * it are present and empty.
+ */
+typedef struct DmsMessageEntry
+{
+	enum MessageMemoryType dmsMessageMemoryType;
+
+	/* The message number for objects in this row. This value shall not
+	 * exceed the dmsMaxChangeableMsg object value.
+	 */
+	uint16_t dmsMessageNumber;
+
+	/* The message in MULTI markup. */
+	MultiText   dmsMessageMultiString;
+
+	/* The owner or author of the message. */
+	OctetText   dmsMessageOwner;
+
+	/* CRC-16 of the MULTI string, beacon and pixel service objects of the
+	 * row, worked out when the message is validated.
+	 */
+	uint16_t dmsMessageCRC;
+
+	/* 1 if the beacons are lit while the message is displayed. */
+	uint8_t dmsMessageBeacon;
+
+	/* 1 if pixel service may run while the message is displayed. */
+	uint8_t dmsMessagePixelService;
+
+	/* Priority of the message against the one displayed, 1 lowest. */
+	uint8_t dmsMessageRunTimePriority;
+
+	/* The state of the message. Writing modifyReq, validateReq or
+	 * notUsedReq requests the change of state; the other values are read
+	 * only.
+	 */
+	enum
+	{
+		MESSAGE_STATUS_NOT_USED     = 1,
+		MESSAGE_STATUS_MODIFYING    = 2,
+		MESSAGE_STATUS_VALIDATING   = 3,
+		MESSAGE_STATUS_VALID        = 4,
+		MESSAGE_STATUS_ERROR        = 5,
+		MESSAGE_STATUS_MODIFY_REQ   = 6,
+		MESSAGE_STATUS_VALIDATE_REQ = 7,
+		MESSAGE_STATUS_NOT_USED_REQ = 8
+	} dmsMessageStatus;
+} DmsMessageEntry;
+
+/* This node shall contain the messages of the sign. */
+typedef struct DmsMessage
+{
+	/* Permanent messages stored by the sign. */
+	uint16_t dmsNumPermanentMsg;
+
+	/* Changeable messages not in the notUsed state. */
+	uint16_t dmsNumChangeableMsg;
+
+	/* The Maximum Number of Changeable Messages this device supports. */
+	uint16_t dmsMaxChangeableMsg;
+
+	/* Octets of changeable message memory left. */
+	uint32_t dmsFreeChangeableMemory;
+
+	/* A table containing the messages. The number of rows in this table is
+	 * equal to the dmsMaxChangeableMsg object times the changeable memory
+	 * type.
+	 */
+	OBJECT_TABLE(DmsMessageEntry, dmsMessageTable,
+	             MEMORY_TYPE_CHANGEABLE * CONFIG_MAX_CHANGEABLE_MESSAGES);
+
+	/* Why the last validation of a message failed. */
+	uint8_t dmsValidateMessageError;
+} DmsMessage;
+
+/* This node shall contain the objects that control the sign. */
+typedef struct SignControl
+{
+	/* The source of control: 2 local, 4 central, 5 central override. */
+	uint8_t dmsControlMode;
+
+	/* Writing displays a message: duration in minutes (2 octets, 65535
+	 * without end), priority (1), memory type (1), message number (2),
+	 * CRC (2) and the IPv4 address of the requester (4), most significant
+	 * octet first.
+	 */
+	OctetString dmsActivateMessage;
+
+	/* Minutes the message displayed has left, 65535 without end. */
+	uint16_t dmsMessageTimeRemaining;
+
+	/* The message displayed: memory type (1), message number (2) and CRC
+	 * (2).
+	 */
+	OctetString dmsMsgTableSource;
+
+	/* Why the last activation failed. */
+	enum
+	{
+		ACTIVATE_ERROR_OTHER               = 1,
+		ACTIVATE_ERROR_NONE                = 2,
+		ACTIVATE_ERROR_PRIORITY            = 3,
+		ACTIVATE_ERROR_MESSAGE_STATUS      = 4,
+		ACTIVATE_ERROR_MESSAGE_MEMORY_TYPE = 5,
+		ACTIVATE_ERROR_MESSAGE_NUMBER      = 6,
+		ACTIVATE_ERROR_MESSAGE_CRC         = 7,
+		ACTIVATE_ERROR_SYNTAX_MULTI        = 8,
+		ACTIVATE_ERROR_LOCAL_MODE          = 9
+	} dmsActivateMsgError;
+
+	/* The error in the MULTI string of the last failed validation or
+	 * activation, and the octet of the string it was found at.
+	 */
+	enum MultiSyntaxError dmsMultiSyntaxError;
+	uint16_t              dmsMultiSyntaxErrorPosition;
+} SignControl;
+
+typedef struct DMS
+{
+	DmsSignCfg     dmsSignCfg;
+	VmsCfg         vmsCfg;
+	FontDefinition fontDefinition;
+	MultiCfg       multiCfg;
+	DmsMessage     dmsMessage;
+	SignControl    signControl;
+} DMS;
+
+#endif /* DMS_H */
@@ -0,0 +1,141 @@
+#ifndef ESS_H
+#define ESS_H
+
+#include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
+
+/* Values reported while a sensor has no reading, or a failed one. */
+#define ESS_PRESSURE_MISSING    UINT16_MAX /* Tenths of a millibar. */
+#define ESS_DIRECTION_MISSING   361        /* Degrees. */
+#define ESS_SPEED_MISSING       UINT16_MAX /* Tenths of a meter per second. */
+#define ESS_TEMPERATURE_MISSING 1001       /* Tenths of a degree Celsius. */
+#define ESS_HUMIDITY_MISSING    101        /* Percent. */
+#define ESS_VISIBILITY_MISSING  1000001    /* Tenths of a meter. */
+
+/* This node shall contain the identification of the station. */
+typedef struct EssNtcip
+{
+	/* The kind of the station: 1 permanent, 2 transportable, 3 mobile. */
+	uint8_t essNtcipCategory;
+
+	/* Where the station is, as a human would describe it. */
+	OctetText   essNtcipSiteDescription;
+
+	/* The purpose of the station: 1 other, 2 weather, 3 traffic, 4 road
+	 * and weather, 5 environment.
+	 */
+	uint8_t essTypeofStation;
+} EssNtcip;
+
+/* This node shall contain the position of the station. */
+typedef struct EssLocation
+{
+	/* Latitude and longitude of the station in millionths of a degree. */
+	int32_t essLatitude;
+	int32_t essLongitude;
+
+	/* Height of the reference point of the station above sea level in
+	 * meters, to which the heights of its sensors are relative.
+	 */
+	int16_t essReferenceHeight;
+} EssLocation;
+
+/* This node shall contain the measurements of the atmosphere. */
+typedef struct EssAtmosphere
+{
+	/* Pressure of the air in tenths of a millibar. */
+	uint16_t essAtmosphericPressure;
+
+	/* Direction and speed of the wind averaged over the last two minutes,
+	 * in degrees from north and tenths of a meter per second.
+	 */
+	uint16_t essAvgWindDirection;
+	uint16_t essAvgWindSpeed;
+
+	/* The strongest gust of the last ten minutes and its direction. */
+	uint16_t essMaxWindGustSpeed;
+	uint16_t essMaxWindGustDir;
+
+	/* Direction and speed of the wind as last measured. */
+	uint16_t essSpotWindDirection;
+	uint16_t essSpotWindSpeed;
+
+	/* Highest and lowest temperature of the air over the last day at the
+	 * first temperature sensor, in tenths of a degree Celsius.
+	 */
+	int16_t essMaxTemp;
+	int16_t essMinTemp;
+
+	/* Relative humidity of the air in percent. */
+	uint8_t essRelativeHumidity;
+
+	/* Horizontal visibility in tenths of a meter. */
+	uint32_t essVisibility;
+} EssAtmosphere;
+
+/* One sensor of the temperature of the air. */
+typedef struct EssTemperatureSensorEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the essNumTemperatureSensors object value.
+	 */
+	uint8_t essTemperatureSensorIndex;
+
+	/* Height of the sensor above the reference height in meters. */
+	uint8_t essTemperatureSensorHeight;
+
+	/* Temperature of the air as last measured, in tenths of a degree
+	 * Celsius.
+	 */
+	int16_t essAirTemperature;
+} EssTemperatureSensorEntry;
+
+/* This node shall contain the temperature sensors of the station. */
+typedef struct EssTemperature
+{
+	/* The number of rows in the temperature sensor table. */
+	uint8_t essNumTemperatureSensors;
+
+	OBJECT_TABLE(EssTemperatureSensorEntry, essTemperatureSensorTable,
+	             CONFIG_MAX_TEMPERATURE_SENSORS);
+} EssTemperature;
+
+/* One sensor of the pavement. */
+typedef struct EssPavementSensorEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the numEssPavementSensors object value.
+	 */
+	uint8_t essPavementSensorIndex;
+
+	/* Where the sensor is, as a human would describe it. */
+	OctetText   essPavementSensorLocation;
+
+	/* Temperature of the surface of the pavement, and of the pavement
+	 * beneath it, as last measured, in tenths of a degree Celsius.
+	 */
+	int16_t essSurfaceTemperature;
+	int16_t essPavementTemperature;
+} EssPavementSensorEntry;
+
+/* This node shall contain the pavement sensors of the station. */
+typedef struct EssPavement
+{
+	/* The number of rows in the pavement sensor table. */
+	uint8_t numEssPavementSensors;
+
+	OBJECT_TABLE(EssPavementSensorEntry, essPavementSensorTable,
+	             CONFIG_MAX_PAVEMENT_SENSORS);
+} EssPavement;
+
+typedef struct ESS
+{
+	EssNtcip       essNtcip;
+	EssLocation    essLocation;
+	EssAtmosphere  essAtmosphere;
+	EssTemperature essTemperature;
+	EssPavement    essPavement;
+} ESS;
+
+#endif /* ESS_H */
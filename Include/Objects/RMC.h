@@ -0,0 +1,162 @@
+#ifndef RMC_H
+#define RMC_H
+
+#include <Common.h>
+#include <Config.h>
+
+/* Occupancy is reported in tenths of a percent. */
+#define RMC_OCCUPANCY_FULL 1000
+
+/* Longest window mainline data is averaged over, in seconds. */
+#define RMC_MAX_CALC_INTERVAL 60
+
+/* How a metered lane is run. */
+enum RmcMeterMode
+{
+	RMC_METER_DARK               = 1, /* Not metering: the signal is dark. */
+	RMC_METER_FIXED              = 2, /* At rmcCmdRate. */
+	RMC_METER_TRAFFIC_RESPONSIVE = 3  /* At the rate of the level reached. */
+};
+
+/* This node shall contain the settings of the ramp meter. */
+typedef struct RmcGeneralConfiguration
+{
+	/* Seconds of the window the mainline volume and occupancy are averaged
+	 * over.
+	 */
+	uint8_t rmcCalcInterval;
+} RmcGeneralConfiguration;
+
+/* One lane of the mainline upstream of the ramp. */
+typedef struct RmcMainlineLaneEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the rmcMaxNumMainlineLanes object value.
+	 */
+	uint8_t rmcMainlineLaneIndex;
+
+	/* The vehicleDetectorNumber of the loop of the lane, 0 if it has
+	 * none.
+	 */
+	uint8_t rmcMainlineLaneDetector;
+} RmcMainlineLaneEntry;
+
+/* This node shall contain the mainline lanes and what was measured on
+ * them.
+ */
+typedef struct RmcMainline
+{
+	/* The number of rows in the mainline lane table. */
+	uint8_t rmcMaxNumMainlineLanes;
+
+	OBJECT_TABLE(RmcMainlineLaneEntry, rmcMainlineLaneTable,
+	             CONFIG_MAX_MAINLINE_LANES);
+
+	/* Occupancy of the lanes with a detector over the window, in tenths
+	 * of a percent.
+	 */
+	uint16_t rmcMainlineOccupancy;
+
+	/* Flow rate of the lanes with a detector over the window, in vehicles
+	 * per hour per lane.
+	 */
+	uint16_t rmcMainlineFlowRate;
+} RmcMainline;
+
+/* One metered lane of the ramp, and the rate it is metered at. */
+typedef struct RmcMeteredLaneEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the rmcMaxNumMeteredLanes object value.
+	 */
+	uint8_t rmcMeteredLaneIndex;
+
+	enum RmcMeterMode rmcMeterMode;
+
+	/* Rate in fixed mode, in vehicles per hour. */
+	uint16_t rmcCmdRate;
+
+	/* Bounds of the rate of the lane, in vehicles per hour. */
+	uint16_t rmcMinMeterRate;
+	uint16_t rmcMaxMeterRate;
+
+	/* The vehicleDetectorNumber of the queue detector of the lane, 0 if it
+	 * has none.
+	 */
+	uint8_t rmcQueueDetector;
+
+	/* Tenths of a second the queue detector must be occupied for before
+	 * the queue is flushed at rmcMaxMeterRate.
+	 */
+	uint16_t rmcQueueOccupiedTime;
+
+	/* The rate the lane is metered at, in vehicles per hour, 0 when it is
+	 * not metered.
+	 */
+	uint16_t rmcMeterRate;
+
+	/* The traffic responsive level reached, 0 below the first. */
+	uint8_t rmcMeterLevel;
+
+	/* 1 while the queue is being flushed. */
+	uint8_t rmcQueueActive;
+
+	/* Tenths of a second between the release of two vehicles, 0 when the
+	 * lane is not metered.
+	 */
+	uint16_t rmcReleaseInterval;
+} RmcMeteredLaneEntry;
+
+/* This node shall contain the metered lanes. */
+typedef struct RmcMeteredLane
+{
+	/* The number of rows in the metered lane table. */
+	uint8_t rmcMaxNumMeteredLanes;
+
+	OBJECT_TABLE(RmcMeteredLaneEntry, rmcMeteredLaneTable,
+	             CONFIG_MAX_METERED_LANES);
+} RmcMeteredLane;
+
+/* One traffic responsive level. Levels are ordered from the least to the
+ * most restrictive; the highest level whose occupancy or flow rate the
+ * mainline reaches sets the rate.
+ */
+typedef struct RmcTRLevelEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the rmcMaxNumTRLevels object value.
+	 */
+	uint8_t rmcTRLevelIndex;
+
+	/* Rate of the level, in vehicles per hour. */
+	uint16_t rmcTRLevelRate;
+
+	/* Mainline occupancy reaching the level in tenths of a percent, 0 if
+	 * occupancy does not.
+	 */
+	uint16_t rmcTRLevelOccupancy;
+
+	/* Mainline flow rate reaching the level in vehicles per hour per lane,
+	 * 0 if flow does not.
+	 */
+	uint16_t rmcTRLevelFlowRate;
+} RmcTRLevelEntry;
+
+/* This node shall contain the traffic responsive levels. */
+typedef struct RmcTrafficResponsive
+{
+	/* The number of rows in the traffic responsive level table. */
+	uint8_t rmcMaxNumTRLevels;
+
+	OBJECT_TABLE(RmcTRLevelEntry, rmcTRLevelTable, CONFIG_MAX_TR_LEVELS);
+} RmcTrafficResponsive;
+
+typedef struct RMC
+{
+	RmcGeneralConfiguration rmcGeneralConfiguration;
+	RmcMainline             rmcMainline;
+	RmcMeteredLane          rmcMeteredLane;
+	RmcTrafficResponsive    rmcTrafficResponsive;
+} RMC;
+
+#endif /* RMC_H */
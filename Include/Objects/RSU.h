@@ -0,0 +1,93 @@
+#ifndef RSU_H
+#define RSU_H
+
+#include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
+
+/* Octets of the longest message an RSU sends over the air. */
+#define RSU_MAX_PAYLOAD 2302
+
+/* A message payload, held in its row since managers replace it often. */
+typedef OCTET_BUFFER(RSU_MAX_PAYLOAD) RsuPayload;
+
+/* States of a row of a table whose rows are created and destroyed by the
+ * manager (SNMPv2-TC RowStatus).
+ */
+enum RowStatus
+{
+	ROW_STATUS_ACTIVE          = 1,
+	ROW_STATUS_NOT_IN_SERVICE  = 2,
+	ROW_STATUS_NOT_READY       = 3,
+	ROW_STATUS_CREATE_AND_GO   = 4,
+	ROW_STATUS_CREATE_AND_WAIT = 5,
+	ROW_STATUS_DESTROY         = 6
+};
+
+/* This node shall describe the roadside unit. */
+typedef struct RsuSysDescription
+{
+	/* The version of NTCIP 1218 the unit implements. */
+	OctetString rsuMibVersion;
+
+	/* The version of the software of the unit. */
+	OctetString rsuFirmwareVersion;
+
+	/* Where the unit is, as a human would describe it. */
+	OctetText   rsuLocationDesc;
+
+	/* The name the operator knows the unit by. */
+	OctetText   rsuID;
+} RsuSysDescription;
+
+/* One immediate forward message: a payload sent over the air once, as soon
+ * as its row is made active and enabled.
+ */
+typedef struct RsuIFMEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the maxRsuIFMs object value.
+	 */
+	uint16_t rsuIFMIndex;
+
+	/* The provider service identifier of the message, one to four
+	 * octets.
+	 */
+	OctetString rsuIFMPsid;
+
+	/* The radio channel the message is sent on. */
+	uint8_t rsuIFMTxChannel;
+
+	/* 1 to send the message, 0 to hold it. */
+	uint8_t rsuIFMEnable;
+
+	enum RowStatus rsuIFMStatus;
+
+	/* Priority of the message over the air, 0 (lowest) to 63. */
+	uint8_t rsuIFMPriority;
+
+	/* Options of the message, one per bit: bit 0 set to send it without
+	 * security, bit 1 set to send it on the alternating channels.
+	 */
+	uint8_t rsuIFMOptions;
+
+	/* The message, as sent over the air. */
+	RsuPayload  rsuIFMPayload;
+} RsuIFMEntry;
+
+/* This node shall contain the immediate forward messages. */
+typedef struct RsuIFM
+{
+	/* The number of rows in the immediate forward message table. */
+	uint16_t maxRsuIFMs;
+
+	OBJECT_TABLE(RsuIFMEntry, rsuIFMTable, CONFIG_MAX_RSU_IFMS);
+} RsuIFM;
+
+typedef struct RSU
+{
+	RsuSysDescription rsuSysDescription;
+	RsuIFM            rsuIFM;
+} RSU;
+
+#endif /* RSU_H */
@@ -0,0 +1,116 @@
+#ifndef TSS_H
+#define TSS_H
+
+#include <Common.h>
+#include <Config.h>
+#include <OctetString.h>
+
+/* Average speed reported for a zone no vehicle of known speed crossed. */
+#define TSS_SPEED_MISSING UINT8_MAX
+
+/* Occupancy is reported in tenths of a percent. */
+#define TSS_OCCUPANCY_FULL 1000
+
+/* One detection zone of the sensor. */
+typedef struct SensorZoneEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the numSensorZones object value.
+	 */
+	uint16_t sensorZoneNumber;
+
+	/* What the zone covers, as a human would describe it. */
+	OctetText   sensorZoneLabel;
+
+	/* Nonzero to collect samples of the zone. */
+	uint8_t sensorZoneEnable;
+} SensorZoneEntry;
+
+/* This node shall contain the detection zones of the sensor. */
+typedef struct SensorZones
+{
+	/* The number of rows in the sensor zone table. */
+	uint16_t numSensorZones;
+
+	OBJECT_TABLE(SensorZoneEntry, sensorZoneTable, CONFIG_MAX_SENSOR_ZONES);
+} SensorZones;
+
+/* One class vehicles are sorted into. */
+typedef struct VehicleClassEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the numVehicleClasses object value.
+	 */
+	uint8_t vehicleClassNumber;
+
+	OctetText   vehicleClassLabel;
+} VehicleClassEntry;
+
+/* This node shall contain the classes of vehicles the sensor tells apart. */
+typedef struct VehicleClasses
+{
+	/* The number of rows in the vehicle class table. */
+	uint8_t numVehicleClasses;
+
+	OBJECT_TABLE(VehicleClassEntry, vehicleClassTable,
+	             CONFIG_MAX_VEHICLE_CLASSES);
+} VehicleClasses;
+
+/* The counts of one zone over the last sample period. */
+typedef struct ZoneSampleEntry
+{
+	/* The row number for objects in this row. This value shall not exceed
+	 * the numSensorZones object value.
+	 */
+	uint16_t zoneSampleNumber;
+
+	/* Vehicles that crossed the zone. */
+	uint16_t zoneSampleVolume;
+
+	/* Share of the period the zone was occupied in tenths of a percent. */
+	uint16_t zoneSampleOccupancy;
+
+	/* Average speed of the vehicles of known speed in kilometers per hour,
+	 * 255 if there were none.
+	 */
+	uint8_t zoneSampleSpeed;
+} ZoneSampleEntry;
+
+/* The volume of one class of vehicle in one zone over the last sample
+ * period.
+ */
+typedef struct ZoneClassEntry
+{
+	uint16_t zoneClassVolume;
+} ZoneClassEntry;
+
+/* This node shall contain the samples of the zones. */
+typedef struct SampleData
+{
+	/* Seconds of a sample period, 0 to stop collecting. Periods end on
+	 * multiples of the period into the local day.
+	 */
+	uint16_t samplePeriod;
+
+	/* Incremented every time a sample period ends and the tables below are
+	 * updated.
+	 */
+	uint8_t sampleSequence;
+
+	OBJECT_TABLE(ZoneSampleEntry, zoneSampleTable, CONFIG_MAX_SENSOR_ZONES);
+
+	/* Indexed by zone and class, numSensorZones times numVehicleClasses
+	 * rows.
+	 */
+	OBJECT_TABLE(ZoneClassEntry, zoneClassTable,
+	             CONFIG_MAX_SENSOR_ZONES * CONFIG_MAX_VEHICLE_CLASSES);
+} SampleData;
+
+typedef struct TSS
+{
+	SensorZones    sensorZones;
+	VehicleClasses vehicleClasses;
+	SampleData     sampleData;
+} TSS;
+
+#endif /* TSS_H */
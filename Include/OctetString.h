@@ -0,0 +1,95 @@
+#ifndef OCTET_STRING_H
+#define OCTET_STRING_H
+
+#include <Common.h>
+#include <Config.h>
+
+/* Octets an OctetString holds in place. */
+#define OCTET_STRING_INLINE 23
+
+/* Value of OctetString.length for a string held in the arena. */
+#define OCTET_STRING_INTERNED UINT8_MAX
+
+/* Value of an OCTET STRING object. Short strings are held in place; longer
+ * ones are interned in a process-wide arena of length-prefixed, immutable
+ * entries and referred to by a pointer stored in octets. Either way the
+ * octets are contiguous and their length is known without scanning them,
+ * and a string is copied by copying the structure, so that trees copied
+ * with memcpy() share their interned strings. The zero value is the empty
+ * string. Interned strings are never freed, so an OctetString suits values
+ * set by the device itself; objects a manager writes use an OCTET_BUFFER.
+ *
+ * A string is written by the thread owning its tree only: the agent thread
+ * for the database, a manager thread for the images of its devices.
+ */
+typedef struct OctetString
+{
+	uint8_t length;
+	uint8_t octets[OCTET_STRING_INLINE];
+} OctetString;
+
+/* Stores length octets of data in string, interning them if they do not fit
+ * in place. Returns false, leaving string as it was, if the arena is full.
+ * Safe to call from any thread.
+ */
+bool octetStringSet (OctetString *string, const void *data, size_t length);
+
+/* As octetStringSet() for a NUL terminated string. */
+bool octetStringSetText (OctetString *string, const char *text);
+
+/* Holds room in the arena for length octets of data unless they fit in
+ * place or are interned already, so that octetStringSet() of them from the
+ * calling thread cannot fail. Returns false if there is no room beside what
+ * is held already. The same string reserved twice holds room twice, the
+ * second of which octetStringRelease() gives back unused.
+ */
+bool octetStringReserve (const void *data, size_t length);
+
+/* Gives back what the calling thread holds and has not used. */
+void octetStringRelease (void);
+
+/* The octets of string and their number. */
+const uint8_t *octetStringData (const OctetString *string, size_t *length);
+
+/* Occupancy of the arena. */
+typedef struct OctetStringArena
+{
+	size_t used;     /* Octets taken by entries. */
+	size_t entries;  /* Distinct interned strings. */
+	size_t requests; /* Strings interned, counting repeats. */
+} OctetStringArena;
+
+void octetStringArena (OctetStringArena *arena);
+
+/* A bounded OCTET STRING held in place, for the objects managers write: the
+ * arena keeps every string it is given, while a SET of a buffer overwrites
+ * its octets and takes nothing more however often it is repeated. A buffer
+ * is declared with the most octets its object may hold, and copied with the
+ * structure like any other field. The zero value is the empty string.
+ */
+#define OCTET_BUFFER(capacity)                                                 \
+	struct                                                                     \
+	{                                                                          \
+		uint16_t length;                                                       \
+		uint8_t  octets[capacity];                                             \
+	}
+
+/* A DisplayString or an OCTET STRING of as many octets. */
+typedef OCTET_BUFFER(UINT8_MAX) OctetText;
+
+/* Where the octets of any buffer start. */
+#define OCTET_BUFFER_OFFSET offsetof(OctetText, octets)
+
+/* Stores length octets of data in a buffer of capacity octets. Returns
+ * false, leaving the buffer as it was, if they do not fit.
+ */
+bool octetBufferSet (void *buffer, size_t capacity, const void *data,
+                     size_t length);
+
+#define OCTET_BUFFER_SET(buffer, data, length)                                 \
+	octetBufferSet(&(buffer), sizeof((buffer).octets), (data), (length))
+
+/* The octets of a buffer and their number. */
+const uint8_t *octetBufferData (const void *buffer, size_t *length);
+
+#endif /* OCTET_STRING_H */
@@ -0,0 +1,141 @@
+#ifndef PMPP_H
+#define PMPP_H
+
+#include <Common.h>
+#include <Agent.h>
+
+/* Point-to-MultiPoint Protocol (NTCIP 2101): HDLC-like UI frames over an
+ * asynchronous serial line, shared by every station on a multidrop link.
+ *
+ *   7E | address (1-2) | control | IPI | information | FCS-16 | 7E
+ *
+ * 7E and 7D inside a frame are sent as 7D followed by the octet XOR 20.
+ */
+#define PMPP_FLAG   0x7E
+#define PMPP_ESCAPE 0x7D
+
+/* Unnumbered information, with the poll/final bit set. */
+#define PMPP_CONTROL_UI 0x13
+
+/* Initial protocol identifiers (NTCIP 2301) of the information field. */
+#define PMPP_IPI_STMP 0xC0
+#define PMPP_IPI_SNMP 0xC1
+
+/* One-octet addresses carry 6 bits, two-octet ones 13. The highest of each
+ * is the all-stations address, which is never answered.
+ */
+#define PMPP_BROADCAST_SHORT 63
+#define PMPP_BROADCAST       8191
+
+/* FCS-16 (RFC 1662) over a frame including its FCS. */
+#define PMPP_FCS_INIT 0xFFFF
+#define PMPP_FCS_GOOD 0xF0B8
+
+/* Size of each ring buffer. A power of two and a multiple of the page
+ * size; it bounds the longest frame that can be received.
+ */
+#define PMPP_RING_SIZE 16384
+
+/* Buffer whose memory is mapped twice in a row, so that the bytes from any
+ * position onwards, up to the size of the ring, are contiguous even where
+ * they wrap around. Frames are unstuffed in place and handed on as a
+ * pointer into the ring.
+ */
+typedef struct PMPPRing
+{
+	uint8_t *data;
+	uint64_t head; /* Next byte to be written. */
+	uint64_t tail; /* First byte still in use. */
+} PMPPRing;
+
+typedef struct PMPPStatistics
+{
+	uint32_t inFrames;
+	uint32_t inBadFCS;
+	uint32_t inAborts;         /* Frames ended by 7D 7E. */
+	uint32_t inOverruns;       /* Frames longer than the ring. */
+	uint32_t inShortFrames;
+	uint32_t inOtherAddresses; /* Frames for other stations. */
+	uint32_t inUnknownProtocols;
+	uint32_t outFrames;
+	uint32_t outDiscards;      /* Frames the transmit ring had no room for. */
+} PMPPStatistics;
+
+/* A received frame. information points into the receive ring and stays
+ * valid until the next call to pmppNextFrame().
+ */
+typedef struct PMPPFrame
+{
+	uint16_t       address;
+	uint8_t        control;
+	uint8_t        protocol; /* IPI */
+	const uint8_t *information;
+	size_t         length;
+} PMPPFrame;
+
+typedef struct PMPPLink
+{
+	int      fd;
+	int      peer;    /* Held open slave of a pseudo-terminal, or -1. */
+	uint16_t address; /* Address of this station. */
+
+	PMPPRing receive;
+	PMPPRing transmit;
+
+	/* Frame being assembled: unstuffed octets from frame to end, the next
+	 * octet to examine at scan.
+	 */
+	uint64_t frame;
+	uint64_t end;
+	uint64_t scan;
+	uint16_t fcs;
+	bool     escaped; /* The last octet examined was 7D. */
+	bool     hunting; /* Discarding octets up to the next flag. */
+
+	PMPPStatistics statistics;
+} PMPPLink;
+
+/* Opens a serial device at the given speed in bits per second, in raw
+ * mode, as station address.
+ */
+bool pmppOpen (PMPPLink *link, const char *path, uint32_t speed,
+               uint16_t address);
+
+/* Opens the master of a new pseudo-terminal and stores the path of its
+ * slave in name, which a test peer opens in place of a serial device.
+ */
+bool pmppOpenPty (PMPPLink *link, uint16_t address, char *name,
+                  size_t capacity);
+
+void pmppClose (PMPPLink *link);
+
+/* Running FCS-16 over length octets. */
+uint16_t pmppFCS (uint16_t fcs, const uint8_t *data, size_t length);
+
+/* Reads whatever the line has into the receive ring. Returns false on a
+ * device error.
+ */
+bool pmppReceive (PMPPLink *link);
+
+/* Finds the next complete, intact frame in the receive ring. */
+bool pmppNextFrame (PMPPLink *link, PMPPFrame *frame);
+
+/* Frames information into the transmit ring and writes as much of the ring
+ * as the line takes.
+ */
+bool pmppSend (PMPPLink *link, uint16_t address, uint8_t protocol,
+               const uint8_t *information, size_t length);
+
+/* Writes the transmit ring to the line. Returns false on a device error. */
+bool pmppFlush (PMPPLink *link);
+
+/* Whether the transmit ring holds octets the line has not taken yet. */
+bool pmppPending (const PMPPLink *link);
+
+/* Receives, answers every SNMP frame for this station through agent and
+ * flushes the answers. STMP frames are counted as unknown protocols, since
+ * the agent does not serve STMP.
+ */
+bool pmppServe (PMPPLink *link, Agent *agent);
+
+#endif /* PMPP_H */
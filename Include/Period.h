@@ -0,0 +1,46 @@
+#ifndef PERIOD_H
+#define PERIOD_H
+
+#include <Common.h>
+#include <Calendar.h>
+
+/* Collection periods of counts published at regular intervals, such as
+ * volumeOccupancyPeriod. A period of a given number of seconds ends on
+ * multiples of its length into the local day; the last period of a day
+ * ends at midnight when the length does not divide the day. A length of
+ * zero stops the collection.
+ *
+ * The collector calls periodBegin() on every tick before it counts, and
+ * periodEnd() after, publishing what was counted when either says the
+ * period ended. A step of the clock only moves where the period ends: the
+ * counts are kept, and published at once if the step went past the end.
+ */
+
+typedef struct Period
+{
+	uint32_t length;  /* Seconds, zero when not collecting. */
+	int64_t  end;     /* Local seconds the period ends at. */
+	bool     stepped; /* The clock stepped since the last tick. */
+} Period;
+
+typedef enum PeriodEvent
+{
+	PERIOD_STOPPED = 0, /* Nothing is collected. */
+	PERIOD_STARTED = 1, /* A new length: the counts start over. */
+	PERIOD_RUNNING = 2,
+	PERIOD_ENDED   = 3  /* Publish the counts, then start over. */
+} PeriodEvent;
+
+/* Calendar step hooks of collectors call this. */
+void periodStep (Period *period);
+
+/* Starts, stops or realigns the period for the length now configured. */
+PeriodEvent periodBegin (Period *period, uint32_t length,
+                         const CalendarTime *date);
+
+/* True once the tick has reached the end of the period, which is then
+ * moved to the end of the next one.
+ */
+bool periodEnd (Period *period, const CalendarTime *date);
+
+#endif /* PERIOD_H */
@@ -0,0 +1,69 @@
+#ifndef PREEMPT_H
+#define PREEMPT_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Tick.h>
+
+/* Preemption (NTCIP 1202 preempt). A called preempt times its delay, then
+ * takes over the hold, force-off and omit masks of every enabled phase of
+ * the phaseControlGroupTable through these stages:
+ *
+ *   entry         every phase but the track and dwell phases is forced off
+ *                 and omitted, for as long as the slowest of them needs to
+ *                 finish its minimum green or walk and pedestrian
+ *                 clearance, then its yellow change and red clearance
+ *   track         the track phases are held for the track green, then
+ *                 forced off for their clearance
+ *   dwell         the dwell phases are held, at least for the dwell green
+ *                 and the minimum duration, until the call goes away
+ *   exit          the masks are released and the exit phase is called
+ *
+ * The masks of each stage and their durations are worked out from the
+ * preempt and phase tables when the database changes, so that a stage is
+ * entered by copying its masks. Lower numbered preempts take over from
+ * higher numbered ones.
+ *
+ * Inputs do not wait for the tick. preemptInput() wakes a thread of its
+ * own, run one priority above the tick thread in real-time mode, which
+ * starts the entry stage at once; the tick only times the stages after
+ * that. It reads only the stages worked out from the database, never the
+ * database, so it takes the preempt lock alone and waits neither for a SET
+ * nor for the tick. The interval from an input to the masks it drives is
+ * recorded as METRIC_PREEMPT.
+ */
+
+/* Allocates the state of the preempts for the limits of the database. */
+bool preemptInit (const DatabaseLimits *limits);
+void preemptFree (void);
+
+/* Starts the input thread with the scheduling of the tick thread, one
+ * priority higher when config is real-time.
+ */
+bool preemptStart (const TickConfig *config);
+void preemptStop (void);
+
+/* Calls preempt (numbered from one), or withdraws its call. Only atomic
+ * operations and sem_post() are used, so an input handler may call this
+ * from any thread or from a signal handler.
+ */
+void preemptInput (uint8_t preempt, bool active);
+
+/* Works out the stages again after a SET, with the database lock held, and
+ * swaps them in under the preempt lock.
+ */
+void preemptInvalidate (void);
+
+/* Tick hook: times the stages. */
+void preemptTick (uint64_t deadline, uint64_t now);
+
+/* Every writer of the phase control masks holds this lock while it writes
+ * them, and leaves them alone while a preempt is active. The lock inherits
+ * priority, so an input waiting on a tick that holds it is not left behind
+ * whatever else the tick CPU runs.
+ */
+void preemptLock (void);
+void preemptUnlock (void);
+bool preemptActive (void);
+
+#endif /* PREEMPT_H */
@@ -0,0 +1,178 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <Common.h>
+#include <SNMP.h>
+#include <Database.h>
+
+/* How the backing field of an object is stored. */
+typedef enum FieldKind
+{
+	FIELD_UNSIGNED = 1,
+	FIELD_SIGNED   = 2,
+	FIELD_STRING   = 3, /* Pointer to a NUL terminated string. */
+	FIELD_OCTETS   = 4, /* OctetString */
+	FIELD_BUFFER   = 5  /* OCTET_BUFFER(), such as OctetText */
+} FieldKind;
+
+#define FIELD_KIND(field)                                                      \
+	_Generic((field),                                                          \
+		int8_t:       FIELD_SIGNED,                                            \
+		int16_t:      FIELD_SIGNED,                                            \
+		int32_t:      FIELD_SIGNED,                                            \
+		int64_t:      FIELD_SIGNED,                                            \
+		char *:       FIELD_STRING,                                            \
+		const char *: FIELD_STRING,                                            \
+		OctetString:  FIELD_OCTETS,                                            \
+		OctetText:    FIELD_BUFFER,                                            \
+		MultiText:    FIELD_BUFFER,                                            \
+		RsuPayload:   FIELD_BUFFER,                                            \
+		default:      FIELD_UNSIGNED)
+
+/* How the rows of a table map to its instances, for a table indexed other
+ * than by the number of its row, or by two such numbers.
+ */
+typedef struct RegistryInstances
+{
+	/* The row an instance names. */
+	bool (*find) (const uint32_t *instance, size_t length, size_t *row);
+
+	/* The row of the first instance that follows the arcs given, or the
+	 * first of all if length is zero.
+	 */
+	bool (*next) (const uint32_t *instance, size_t length, size_t *row);
+
+	/* Appends the instance of row to name. */
+	void (*name) (size_t row, OID *name);
+} RegistryInstances;
+
+/* An object of the MIB and where its value lives. Scalars are addressed
+ * relative to the structure returned by base, columns relative to the row of
+ * the table returned by base. The registry never copies the object tree; it
+ * reads and writes the fields in place.
+ */
+typedef struct RegistryObject
+{
+	OID       oid;      /* Object identifier without the instance. */
+	uint8_t   syntax;   /* BER tag of the value on the wire. */
+	bool      writable;
+	bool      database; /* Part of the configuration, see registryCopy(). */
+	FieldKind kind;
+	uint16_t  width;    /* Size of the field in octets. */
+	size_t    offset;   /* Offset of the field in the structure or row. */
+	size_t    stride;   /* Size of a row, zero for scalars. */
+	int64_t   minimum;  /* Range accepted by a SET. */
+	int64_t   maximum;
+
+	void  *(*base) (void);
+	size_t (*rows) (void);
+
+	/* Rows per value of the first index for tables indexed by two objects,
+	 * NULL for tables indexed by one.
+	 */
+	size_t (*inner) (void);
+
+	/* For tables indexed otherwise, how their rows map to instances; NULL
+	 * for the others.
+	 */
+	const RegistryInstances *instances;
+
+	/* For an OBJECT IDENTIFIER held as the number of a row, the column whose
+	 * instance it names; the value on the wire is that column followed by
+	 * the number, or 0.0 for zero. NULL otherwise.
+	 */
+	const OID *reference;
+
+	/* Index of the device owning the object (see Device.h), resolved by
+	 * registryInit().
+	 */
+	uint8_t device;
+
+	/* Position of the object in OID order, set by registryInit(). */
+	uint16_t index;
+} RegistryObject;
+
+/* Most objects the registry holds. */
+#define REGISTRY_MAX_OBJECTS 1024
+
+/* A set of objects, one bit per object by RegistryObject.index. However
+ * the set was described, whether an object is in it is one bit test.
+ */
+typedef struct RegistryView
+{
+	uint64_t bits[REGISTRY_MAX_OBJECTS / 64];
+} RegistryView;
+
+static inline bool registryInView (const RegistryView *const view,
+                                   const RegistryObject *const object)
+{
+	return view->bits[object->index / 64] >> (object->index % 64) & 1;
+}
+
+typedef enum RegistryLookup
+{
+	REGISTRY_FOUND       = 0,
+	REGISTRY_NO_OBJECT   = 1,
+	REGISTRY_NO_INSTANCE = 2
+} RegistryLookup;
+
+/* Sorts the object table, keeping the objects of the devices registered.
+ * Must run once, after the devices are registered, before any other
+ * registry call.
+ */
+void registryInit (void);
+
+/* Selects the tree the calling thread reads and writes through the
+ * registry, or the agent database if tree is NULL, which is the default.
+ */
+void registrySelect (const ObjectTree *tree);
+
+/* Resolves name to an object and the row of the instance it names. */
+RegistryLookup registryFind (const OID *name, const RegistryObject **object,
+                             size_t *row);
+
+/* Resolves the first instance that follows name in lexicographic order,
+ * among the objects of view or, if view is NULL, among all of them, and
+ * stores its full name in next.
+ */
+bool registryNext (const OID *name, const RegistryView *view,
+                   const RegistryObject **object, size_t *row, OID *next);
+
+/* Adds every object at or below subtree to view, or removes them. Objects
+ * are the finest grain: a subtree below an object, such as one of its
+ * instances, selects nothing.
+ */
+void registryViewSet (RegistryView *view, const OID *subtree, bool included);
+
+/* Collects up to capacity objects below prefix, such as the columns of a
+ * table entry, in OID order. Returns how many there are.
+ */
+size_t registryColumns (const OID *prefix, const RegistryObject *columns[],
+                        size_t capacity);
+
+/* Copies every instance of every database object from one tree to another
+ * with the same limits. Status and control objects are left alone.
+ */
+void registryCopy (const ObjectTree *from, const ObjectTree *to);
+
+/* Stores the full name of an instance of object in name. */
+void registryName (const RegistryObject *object, size_t row, OID *name);
+
+void registryGet (const RegistryObject *object, size_t row, VarBind *varbind);
+
+/* Checks a SET value without storing it. */
+SNMPError registryCheck (const RegistryObject *object, const VarBind *varbind);
+
+/* Holds the room a checked value takes in the arena for the calling thread,
+ * so that storing it cannot fail. Returns false if the arena has none left.
+ * The room is given back by octetStringRelease().
+ */
+bool registryReserve (const RegistryObject *object, const VarBind *varbind);
+
+/* Stores a checked value. Returns false, leaving the instance as it was,
+ * only if the arena is full and the value was not reserved.
+ */
+bool registryStore (const RegistryObject *object, size_t row,
+                    const VarBind *varbind);
+
+#endif /* REGISTRY_H */
@@ -0,0 +1,162 @@
+#ifndef SNMP_H
+#define SNMP_H
+
+#include <Common.h>
+#include <BER.h>
+
+enum
+{
+	SNMP_VERSION_1  = 0,
+	SNMP_VERSION_2C = 1,
+	SNMP_VERSION_3  = 3
+};
+
+/* PDU tags (RFC 3416). */
+enum
+{
+	SNMP_GET_REQUEST      = 0xA0,
+	SNMP_GET_NEXT_REQUEST = 0xA1,
+	SNMP_RESPONSE         = 0xA2,
+	SNMP_SET_REQUEST      = 0xA3,
+	SNMP_GET_BULK_REQUEST = 0xA5,
+	SNMP_INFORM_REQUEST   = 0xA6,
+	SNMP_TRAP             = 0xA7,
+	SNMP_REPORT           = 0xA8
+};
+
+/* Bits of the msgFlags of an SNMPv3 message (RFC 3412). */
+enum
+{
+	SNMP_FLAG_AUTH       = 0x01,
+	SNMP_FLAG_PRIV       = 0x02,
+	SNMP_FLAG_REPORTABLE = 0x04
+};
+
+/* The user-based security model, the one msgSecurityModel the agent takes. */
+#define SNMP_SECURITY_MODEL_USM 3
+
+/* Values of the error-status field. */
+typedef enum SNMPError
+{
+	SNMP_NO_ERROR             = 0,
+	SNMP_TOO_BIG              = 1,
+	SNMP_NO_SUCH_NAME         = 2,
+	SNMP_BAD_VALUE            = 3,
+	SNMP_READ_ONLY            = 4,
+	SNMP_GEN_ERR              = 5,
+	SNMP_NO_ACCESS            = 6,
+	SNMP_WRONG_TYPE           = 7,
+	SNMP_WRONG_LENGTH         = 8,
+	SNMP_WRONG_VALUE          = 10,
+	SNMP_NO_CREATION          = 11,
+	SNMP_INCONSISTENT_VALUE   = 12,
+	SNMP_RESOURCE_UNAVAILABLE = 13,
+	SNMP_AUTHORIZATION_ERROR  = 16,
+	SNMP_NOT_WRITABLE         = 17
+} SNMPError;
+
+/* Largest datagram the agent sends or accepts. This keeps every message in a
+ * single Ethernet frame so that no response depends on IP fragmentation.
+ */
+#define SNMP_MAX_MESSAGE 1472
+
+/* Upper bound on the varbinds carried by one PDU. Every varbind needs at
+ * least a dozen octets on the wire, so a full message never exceeds this.
+ */
+#define SNMP_MAX_VARBINDS 128
+
+typedef struct VarBind
+{
+	OID     name;
+	uint8_t type; /* BER tag of the value, BER_NULL in requests. */
+
+	union
+	{
+		int64_t  integer; /* INTEGER */
+		uint64_t counter; /* Counter32, Gauge32, TimeTicks, Counter64 */
+
+		struct
+		{
+			const uint8_t *data;
+			size_t         length;
+		} string;         /* OCTET STRING, IpAddress, Opaque */
+
+		OID oid;          /* OBJECT IDENTIFIER */
+	} value;
+} VarBind;
+
+typedef struct SNMPPDU
+{
+	uint8_t type;
+	int32_t requestID;
+
+	/* For GetBulkRequest these carry non-repeaters and max-repetitions. */
+	int32_t errorStatus;
+	int32_t errorIndex;
+
+	size_t  count;
+	VarBind varbinds[SNMP_MAX_VARBINDS];
+} SNMPPDU;
+
+/* The header data, USM security parameters and scope of an SNMPv3 message
+ * (RFC 3412, RFC 3414).
+ */
+typedef struct SNMPSecurity
+{
+	int32_t msgID;
+	int32_t maxSize;
+	uint8_t flags;
+
+	const uint8_t *engineID;
+	size_t         engineIDLength;
+	int32_t        engineBoots;
+	int32_t        engineTime;
+	const uint8_t *userName;
+	size_t         userNameLength;
+
+	/* Offset of the authentication parameters in the message they were
+	 * decoded from.
+	 */
+	size_t         authOffset;
+	const uint8_t *authParameters;
+	size_t         authLength;
+	const uint8_t *privParameters;
+	size_t         privLength;
+
+	const uint8_t *contextEngineID;
+	size_t         contextEngineIDLength;
+	const uint8_t *contextName;
+	size_t         contextNameLength;
+} SNMPSecurity;
+
+typedef struct SNMPMessage
+{
+	int32_t        version;
+	const uint8_t *community;
+	size_t         communityLength;
+	SNMPSecurity   security; /* SNMPv3 only. */
+	SNMPPDU        pdu;
+} SNMPMessage;
+
+/* The version of a message, or -1 if it does not start like one. */
+int32_t snmpVersion (const uint8_t *data, size_t length);
+
+/* Decodes a community-based (v1/v2c) message. Strings in the result point
+ * into data.
+ */
+bool snmpDecode (const uint8_t *data, size_t length, SNMPMessage *message);
+
+/* Decodes the PDU that follows in reader, whatever message carries it. */
+bool snmpDecodePDU (BERReader *reader, SNMPPDU *pdu);
+
+/* Encodes message at the start of buffer and returns its length, or zero if
+ * it does not fit in capacity.
+ */
+size_t snmpEncode (const SNMPMessage *message, uint8_t *buffer,
+                   size_t capacity);
+
+bool snmpDecodeVarBinds (BERReader *reader, SNMPPDU *pdu);
+void snmpWriteVarBind (BERWriter *writer, const VarBind *varbind);
+void snmpWritePDU (BERWriter *writer, const SNMPPDU *pdu);
+
+#endif /* SNMP_H */
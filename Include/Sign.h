@@ -0,0 +1,67 @@
+#ifndef SIGN_H
+#define SIGN_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Multi.h>
+#include <Registry.h>
+
+/* Messages of the sign (NTCIP 1203). A changeable message is edited in the
+ * modifying state and validated by writing validateReq to its status, which
+ * renders its MULTI string and works out its CRC. Writing dmsActivateMessage
+ * displays a valid message, or blanks the sign, for a duration; an
+ * activation that fails is answered with genErr and the reason is left in
+ * dmsActivateMsgError.
+ *
+ * Rendered messages are cached by their CRC, so validating a message or
+ * activating one already rendered neither parses its MULTI string nor sets
+ * a character: it costs a lookup and a comparison of the string. The cache
+ * is emptied when a database object changes, since fonts and MULTI
+ * defaults are database objects; activations are control objects and leave
+ * it alone.
+ *
+ * The agent thread validates, renders and activates. An activation is
+ * handed to the tick, which times the duration and the pages of the
+ * message on display.
+ */
+
+/* Rendered messages kept. */
+#define SIGN_CACHE_ENTRIES 16
+
+/* Activation durations in minutes meaning without end. */
+#define SIGN_DURATION_INFINITE UINT16_MAX
+
+/* Publishes the sign as blank and counts the messages of the database. */
+bool signInit (void);
+
+/* Empties the cache after a change of the database. */
+void signInvalidate (void);
+
+/* Checks a SET of a message or of dmsActivateMessage before anything of
+ * the PDU is stored, rendering the message to activate.
+ */
+SNMPError signCheck (const RegistryObject *object, size_t row,
+                     const VarBind *varbind);
+
+/* Carries out a SET of a message status or of dmsActivateMessage once it
+ * has been stored.
+ */
+void signStore (const RegistryObject *object, size_t row);
+
+/* The rendering of a MULTI string whose message has the given CRC, from
+ * the cache if it is there. NULL after an error, which is stored in error
+ * with the offset it was found at in position.
+ */
+const MultiMessage *signRender (const MultiText *multi, uint16_t crc,
+                                enum MultiSyntaxError *error,
+                                size_t *position);
+
+/* Tick hook: picks up activations and times the message on display. */
+void signTick (uint64_t deadline, uint64_t now);
+
+/* The page lit as of the last tick, NULL while the sign is blank or
+ * between pages. Called from the tick thread only.
+ */
+const MultiPage *signPage (void);
+
+#endif /* SIGN_H */
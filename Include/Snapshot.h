@@ -0,0 +1,57 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <Common.h>
+#include <Database.h>
+
+/* Binary snapshot of the device objects of a tree (global, asc and every
+ * other MIB below devices), generated from the object definitions of the
+ * registry. A snapshot is:
+ *
+ *   magic     "NTSS"
+ *   version   varint, SNAPSHOT_VERSION
+ *   schema    4 octets, snapshotSchema() of the writer
+ *   objects   varint count, then every object in OID order
+ *   check     4 octets, FNV-1a of every octet before it
+ *
+ * An object is its row count as a varint, then its values. A number is
+ * written as the zigzag varint of its difference from the same column in
+ * the row before, zero for the first row, so that row numbers and columns
+ * of equal values take an octet per row. A string is its varint length
+ * followed by its octets. Multi-octet fields are little endian.
+ *
+ * The schema hashes the identifier, syntax and storage of every object, so
+ * a reader refuses a snapshot of another layout rather than misreading it.
+ */
+#define SNAPSHOT_VERSION 1
+
+/* Octets buffered between the encoder and its sink or source. */
+#define SNAPSHOT_BUFFER 512
+
+/* Takes the next length octets of a snapshot being written. */
+typedef bool (*SnapshotSink) (void *context, const uint8_t *data,
+                              size_t length);
+
+/* Fills up to capacity octets of a snapshot being read and returns how
+ * many, zero at its end.
+ */
+typedef size_t (*SnapshotSource) (void *context, uint8_t *data,
+                                  size_t capacity);
+
+/* Hash of the layout the snapshots of this build have. */
+uint32_t snapshotSchema (void);
+
+/* Streams a snapshot of tree to sink. False if the sink fails. */
+bool snapshotWrite (const ObjectTree *tree, SnapshotSink sink,
+                    void *context);
+
+/* Streams a snapshot from source into tree, which must have the limits of
+ * the tree it was taken from. Values are stored as they are decoded, so a
+ * snapshot that turns out bad leaves tree partly written: read into a
+ * scratch tree and copy it over once this succeeds. Strings held by
+ * pointer are firmware constants and are skipped.
+ */
+bool snapshotRead (const ObjectTree *tree, SnapshotSource source,
+                   void *context);
+
+#endif /* SNAPSHOT_H */
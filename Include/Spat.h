@@ -0,0 +1,96 @@
+#ifndef SPAT_H
+#define SPAT_H
+
+#include <Common.h>
+#include <Calendar.h>
+#include <Database.h>
+
+/* SPaT (SAE J2735 SignalPhaseAndTiming) of the controller, one
+ * IntersectionState with a MovementState for every enabled phase, whose
+ * signal group is the phase number. The fields are those of J2735 laid out
+ * on octet boundaries, big endian, rather than in its unaligned PER
+ * encoding, which the radio or a gateway applies:
+ *
+ *   octets  field
+ *   2       intersection ID
+ *   1       revision, counting messages modulo 128
+ *   2       IntersectionStatusObject, bit 0 the most significant
+ *   4       minute of the UTC year
+ *   2       milliseconds into the minute
+ *   1       movements
+ *   6       each movement: signal group, MovementPhaseState, and the
+ *           minimum and maximum end time in tenths of a second into the
+ *           UTC hour, or SPAT_TIME_UNKNOWN
+ *
+ * The movements are read straight from the phaseStatusGroupTable and the
+ * phaseTable into the buffer given.
+ *
+ * The end times come from a predictor run on the tick, which follows the
+ * phase intervals through the changes of the phaseStatusGroupTable and
+ * times them with the parameters of the phaseTable:
+ *
+ *   green         earliest at the end of the minimum green, or of the gap
+ *                 after the last actuation of a detector calling the phase,
+ *                 the passage reduced by gap reduction; latest at the end
+ *                 of maximum 1 timed from the first conflicting call, and
+ *                 not known before it
+ *   yellow        at the end of the yellow change
+ *   red           when the phase timing in its ring has cleared, then,
+ *                 at the latest, every phase between them in the ring at
+ *                 its maximum; across a barrier, when the phases of the
+ *                 other rings not concurrent with it (phaseConcurrency)
+ *                 have done the same
+ *
+ * Rings run their phases in phase number order. A green is predicted again
+ * only when its phase changes state, is actuated, or is past its earliest
+ * end, which then moves with the clock; reds only when one of those moves
+ * when a ring clears. A phase not seen changing since the start, or since
+ * the first conflicting call of a green, has its times unknown.
+ */
+
+#define SPAT_HEADER_OCTETS   12
+#define SPAT_MOVEMENT_OCTETS 6
+#define SPAT_MAX_OCTETS                                                        \
+	(SPAT_HEADER_OCTETS + UINT8_MAX * SPAT_MOVEMENT_OCTETS)
+
+/* TimeMark of a time not known. */
+#define SPAT_TIME_UNKNOWN 36001
+
+/* States of a movement (J2735 MovementPhaseState). */
+enum MovementPhaseState
+{
+	MOVEMENT_UNAVAILABLE          = 0,
+	MOVEMENT_DARK                 = 1,
+	MOVEMENT_STOP_THEN_PROCEED    = 2,
+	MOVEMENT_STOP_AND_REMAIN      = 3,
+	MOVEMENT_PRE_MOVEMENT         = 4,
+	MOVEMENT_PERMISSIVE_ALLOWED   = 5,
+	MOVEMENT_PROTECTED_ALLOWED    = 6,
+	MOVEMENT_PERMISSIVE_CLEARANCE = 7,
+	MOVEMENT_PROTECTED_CLEARANCE  = 8,
+	MOVEMENT_CAUTION              = 9
+};
+
+/* Allocates the predictor for the limits of the database, and subscribes
+ * it to the changes of the phaseTable.
+ */
+bool spatInit (const DatabaseLimits *limits);
+void spatFree (void);
+
+/* Marks the rings and concurrency of the predictor stale after the
+ * phaseTable was written other than by a SET, which the predictor follows
+ * through the change log (see Change.h). Safe to call from any thread.
+ */
+void spatInvalidate (void);
+
+/* Tick hook: follows the phase intervals and predicts their ends. */
+void spatTick (uint64_t deadline, uint64_t now);
+
+/* Encodes the SPaT of the controller as of date into buffer. Returns the
+ * octets written, or zero if they would not fit in capacity. Called from
+ * the tick thread only.
+ */
+size_t spatEncode (uint8_t buffer[], size_t capacity,
+                   const CalendarTime *date);
+
+#endif /* SPAT_H */
@@ -0,0 +1,190 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include <Common.h>
+#include <Database.h>
+#include <Manager.h>
+#include <Registry.h>
+
+/* Configuration sync. Both ends hash the database objects of each row of
+ * the timing tables, and each table over its row hashes. A manager compares
+ * the table hashes of a device with those of the database it should hold,
+ * reads the row hashes of the tables that differ only, and writes the rows
+ * that differ in a single dbCreateTransaction. Only numeric database
+ * objects are hashed and written; strings are not settable.
+ */
+typedef enum SyncTable
+{
+	SYNC_PHASE              = 0, /* phaseTable */
+	SYNC_VEHICLE_DETECTOR   = 1, /* vehicleDetectorTable */
+	SYNC_TIME_BASE_SCHEDULE = 2, /* timeBaseScheduleTable */
+	SYNC_DAY_PLAN           = 3, /* timeBaseDayPlanTable */
+	SYNC_DST                = 4, /* dstTable */
+	SYNC_TABLE_COUNT
+} SyncTable;
+
+/* Database objects of a row are at most this many. */
+#define SYNC_MAX_COLUMNS 32
+
+/* Message size the sync keeps its requests within, the size every SNMP
+ * entity must accept (RFC 3417). On a serial link smaller requests also
+ * lose less to a corrupted frame.
+ */
+#define SYNC_MAX_MESSAGE 484
+
+/* Polls of dbCreateTransaction before a verify is given up on. */
+#define SYNC_MAX_POLLS 50
+
+/* syncTableEntry: one row per SyncTable. */
+typedef struct SyncTableEntry
+{
+	uint32_t syncTableIndex;
+	uint32_t syncTableRows; /* Gauge32 */
+	uint32_t syncTableHash; /* Gauge32 */
+} SyncTableEntry;
+
+/* A row of one of the row hash columns, each of which is indexed like the
+ * table it covers.
+ */
+typedef struct SyncRowHash
+{
+	uint32_t syncRowHash; /* Gauge32 */
+} SyncRowHash;
+
+typedef struct SyncManifest
+{
+	SyncTableEntry syncTable[SYNC_TABLE_COUNT];
+
+	/* Events per day plan, the inner index of the day plan hashes. */
+	uint8_t dayPlanEvents;
+
+	/* Rows each hash table has room for. */
+	size_t capacity[SYNC_TABLE_COUNT];
+
+	OBJECT_TABLE(SyncRowHash, syncPhaseHashes, CONFIG_MAX_PHASES);
+	OBJECT_TABLE(SyncRowHash, syncVehicleDetectorHashes,
+	             CONFIG_MAX_VEHICLE_DETECTORS);
+	OBJECT_TABLE(SyncRowHash, syncTimeBaseScheduleHashes,
+	             CONFIG_MAX_TIME_BASE_SCHEDULE_ENTRIES);
+	OBJECT_TABLE(SyncRowHash, syncDayPlanHashes,
+	             CONFIG_MAX_DAY_PLANS * CONFIG_MAX_DAY_PLAN_EVENTS);
+	OBJECT_TABLE(SyncRowHash, syncDSTHashes,
+	             CONFIG_MAX_DAYLIGHT_SAVING_ENTRIES);
+} SyncManifest;
+
+/* Builds the manifest the agent serves for its own database, and subscribes
+ * it to the changes of the database. Requires changeInit().
+ */
+bool syncInit (const DatabaseLimits *limits);
+
+/* Brings the manifest of the database up to date after a SET, rehashing
+ * only the rows that changed since the last refresh (see Change.h), and
+ * sets globalSetIDParameter from its table hashes. Called by the agent
+ * only.
+ */
+void syncRefresh (void);
+
+/* The manifest of the database. Called by the agent only, when the sync
+ * objects are read.
+ */
+const SyncManifest *syncManifest (void);
+
+/* Sizes a manifest for a tree with the given limits. */
+bool syncManifestInit (SyncManifest *manifest, const DatabaseLimits *limits);
+void syncManifestFree (SyncManifest *manifest);
+
+/* Hashes every row and table of a tree. Requires registryInit(). */
+void     syncManifestBuild (SyncManifest *manifest, const ObjectTree *tree);
+uint32_t syncRowHash (const ObjectTree *tree, SyncTable table, size_t row);
+
+/* Stores a value read from the sync objects of a device. Returns false if
+ * the name is not that of a sync object instance.
+ */
+bool syncManifestStore (SyncManifest *manifest, const VarBind *varbind);
+
+/* A database object instance to be written. */
+typedef struct SyncChange
+{
+	const RegistryObject *object;
+	size_t                row;
+} SyncChange;
+
+/* Lists the writes that bring a device holding remote in line with the
+ * desired tree, of which local is the manifest. Where the image of the
+ * device is known to be current, because its hash matches remote, only the
+ * differing objects of a row are written; otherwise the whole row is.
+ * image may be NULL. Returns the number of changes, of which no more than
+ * capacity are stored.
+ */
+size_t syncDiff (const ObjectTree *desired, const SyncManifest *local,
+                 const SyncManifest *remote, const ObjectTree *image,
+                 SyncChange changes[], size_t capacity);
+
+typedef enum SyncState
+{
+	SYNC_IDLE   = 0,
+	SYNC_TABLES = 1, /* Reading the table hashes. */
+	SYNC_ROWS   = 2, /* Reading the row hashes of the tables that differ. */
+	SYNC_OPEN   = 3, /* Setting dbCreateTransaction to TRANSACTION. */
+	SYNC_PUSH   = 4, /* Writing the changes into the buffer. */
+	SYNC_VERIFY = 5, /* Setting VERIFY and polling until DONE. */
+	SYNC_CLOSE  = 6, /* Setting NORMAL to apply or discard the buffer. */
+	SYNC_DONE   = 7, /* The device holds the desired database. */
+	SYNC_FAILED = 8
+} SyncState;
+
+typedef struct SyncSession SyncSession;
+
+/* Called once a session has ended in SYNC_DONE or SYNC_FAILED. */
+typedef void (*SyncCallback) (SyncSession *session, void *context);
+
+/* Compare-and-push of one device. The device must have been added with its
+ * read-write community, and desired must have the limits of the device.
+ * The image of the device is used to narrow the writes and is updated with
+ * every value the device accepts.
+ */
+struct SyncSession
+{
+	Manager          *manager;
+	ManagerDevice    *device;
+	const ObjectTree *desired;
+	SyncCallback      callback;
+	void             *context;
+
+	SyncState state;
+	SyncTable table;    /* Table whose row hashes are being read. */
+	OID       cursor;   /* Last row hash read of that table. */
+	uint32_t  unread;   /* Row hashes of that table yet to be read. */
+	bool      failed;   /* A write was refused or lost. */
+	bool      verified; /* The buffer passed the consistency check. */
+	uint8_t   polls;
+
+	SyncManifest local;
+	SyncManifest remote;
+
+	SyncChange *changes;
+	size_t      capacity;
+	size_t      count;   /* Changes found by the diff. */
+	size_t      next;    /* First change not yet sent. */
+	size_t      pending; /* SETs in flight. */
+
+	uint32_t requests; /* Requests sent by the session. */
+
+	/* The next SET, encoded here to fit it within SYNC_MAX_MESSAGE. */
+	SNMPMessage message;
+	uint8_t     scratch[SYNC_MAX_MESSAGE];
+};
+
+/* Sizes a session for devices with the given limits. */
+bool syncSessionInit (SyncSession *session, const DatabaseLimits *limits);
+void syncSessionFree (SyncSession *session);
+
+/* Starts bringing device in line with desired. The session advances as the
+ * manager is serviced; callback reports the outcome. Returns false if the
+ * first request could not be sent.
+ */
+bool syncStart (SyncSession *session, Manager *manager,
+                ManagerDevice *device, const ObjectTree *desired,
+                SyncCallback callback, void *context);
+
+#endif /* SYNC_H */
@@ -0,0 +1,63 @@
+#ifndef TICK_H
+#define TICK_H
+
+#include <Common.h>
+#include <Clock.h>
+
+/* Period of the timing engine. NTCIP 1202 times intervals in tenths of a
+ * second, so every timer in the controller advances on this tick.
+ */
+#define TICK_PERIOD (100 * NANOSECONDS_PER_MILLISECOND)
+
+/* Upper bound on the hooks that can be registered. */
+#define TICK_MAX_HOOKS 16
+
+/* Called once per tick with the deadline the tick was scheduled for and the
+ * time it actually started; the difference is the tick lateness.
+ */
+typedef void (*TickHook) (uint64_t deadline, uint64_t now);
+
+typedef struct TickConfig
+{
+	/* Run the tick thread under SCHED_FIFO at the given priority and lock
+	 * the memory of the process, so that neither the agent thread nor
+	 * paging can delay a tick.
+	 */
+	bool realTime;
+	int  priority;
+
+	/* CPU the tick thread is pinned to, or -1 to let it migrate. */
+	int cpu;
+} TickConfig;
+
+/* Deadline monitor of the tick, written by the tick thread only. A tick
+ * overruns when its hooks are still running at the deadline of the next
+ * one; that tick then starts late and the timers catch up, so overruns
+ * never lose time, but they are counted here. Latenesses are nanoseconds
+ * between a deadline and the start of its tick.
+ */
+typedef struct TickStatus
+{
+	uint8_t  tickRealTime;      /* TruthValue: true (1), false (2). */
+	uint64_t tickCount;         /* Counter64 */
+	uint32_t tickOverruns;      /* Counter32 */
+	uint32_t tickLastLateness;  /* Gauge32 */
+	uint32_t tickWorstLateness; /* Gauge32 */
+} TickStatus;
+
+extern TickStatus tickStatus;
+
+/* Registers a hook to run on every tick, in registration order. Hooks must
+ * be registered before tickStart().
+ */
+bool tickRegister (TickHook hook);
+
+/* Starts the tick thread. Fails if the real-time settings of config cannot
+ * be applied, which usually means the process lacks CAP_SYS_NICE or
+ * CAP_IPC_LOCK; a real-time mode that silently degraded would defeat its
+ * purpose.
+ */
+bool tickStart (const TickConfig *config);
+void tickStop (void);
+
+#endif /* TICK_H */
@@ -0,0 +1,46 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include <Common.h>
+#include <Access.h>
+#include <Database.h>
+#include <Registry.h>
+#include <SNMP.h>
+
+/* dbCreateTransaction (NTCIP 1201). Opening a transaction copies every
+ * database object into a buffer tree with the limits of the database; SETs
+ * of database objects then go to the buffer until VERIFY has checked it and
+ * NORMAL has copied it back, or discarded it. The state table is the one
+ * documented with GlobalDatabaseManagement.
+ *
+ * The group that opens a transaction owns it: until it is closed, only the
+ * owner may SET database objects, and only the owner and an administrator
+ * may SET dbCreateTransaction. Every other group is refused with genErr.
+ * The rows a transaction buffers are staged (see Change.h) and logged once
+ * NORMAL has copied them back.
+ */
+
+/* Prepares the buffer tree. Without it every attempt to open a transaction
+ * fails with genErr.
+ */
+bool transactionInit (const DatabaseLimits *limits);
+void transactionFree (void);
+
+/* Whether object is dbCreateTransaction itself. */
+bool transactionIsCommand (const RegistryObject *object);
+
+/* Checks a command written to dbCreateTransaction by group against the
+ * state table and the owner of the transaction, and carries out one that was
+ * accepted.
+ */
+SNMPError transactionCheck (int64_t command, const AccessGroup *group);
+void      transactionCommand (int64_t command, const AccessGroup *group);
+
+/* Tree that SETs of database objects by group are stored in: the buffer
+ * while a transaction it owns is open, the database while none is, and NULL
+ * when they are refused, in the VERIFY and DONE states and while another
+ * group owns the transaction.
+ */
+const ObjectTree *transactionTarget (const AccessGroup *group);
+
+#endif /* TRANSACTION_H */
@@ -0,0 +1,141 @@
+#ifndef USM_H
+#define USM_H
+
+#include <Common.h>
+#include <Crypto.h>
+#include <OctetString.h>
+#include <SNMP.h>
+
+/* The user-based security model of SNMPv3 (RFC 3414) with HMAC-SHA-96
+ * authentication and AES-128 privacy in cipher feedback mode (RFC 3826).
+ * The agent is the authoritative engine of every message it takes.
+ *
+ * A user is configured with passwords. The password to key algorithm
+ * hashes a megabyte and is run once per user, and the key it gives is
+ * localized to an engine ID by a further hash, once per engine: each user
+ * keeps the keys localized to the last USM_KEY_CACHE engines, keyed for
+ * HMAC and expanded for AES. A message then costs its own length in SHA-1
+ * blocks and, with privacy, in AES blocks, and nothing more: the inner and
+ * outer hashes of the HMAC start from the states the key left them in, the
+ * digest is taken over the message in place with the authentication
+ * parameters skipped rather than zeroed in a copy, and the scoped PDU is
+ * enciphered in place in the buffer it was encoded into.
+ */
+
+#define USM_MAX_USERS      8
+#define USM_MAX_USER_NAME  32
+#define USM_MAX_ENGINE_ID  32
+#define USM_KEY_CACHE      4
+
+/* Octets of the authentication and privacy parameters. */
+#define USM_DIGEST_OCTETS  12
+#define USM_SALT_OCTETS    8
+
+/* Seconds an authenticated message may be off the time of the engine. */
+#define USM_TIME_WINDOW    150
+
+typedef enum USMStatus
+{
+	USM_OK                     = 0,
+	USM_PARSE_ERROR            = 1, /* Dropped without a report. */
+	USM_UNSUPPORTED_SEC_LEVELS = 2,
+	USM_NOT_IN_TIME_WINDOWS    = 3,
+	USM_UNKNOWN_USER_NAMES     = 4,
+	USM_UNKNOWN_ENGINE_IDS     = 5,
+	USM_WRONG_DIGESTS          = 6,
+	USM_DECRYPTION_ERRORS      = 7
+} USMStatus;
+
+/* The keys of a user localized to one engine. */
+typedef struct USMKeys
+{
+	uint8_t engineID[USM_MAX_ENGINE_ID];
+	uint8_t engineIDLength;
+	HMAC    auth;
+	AES     priv;
+} USMKeys;
+
+typedef struct USMUser
+{
+	uint8_t name[USM_MAX_USER_NAME];
+	uint8_t nameLength;
+	bool    privacy; /* Has a privacy password. */
+
+	/* The keys the passwords give, before localization. */
+	uint8_t authKey[SHA1_DIGEST_OCTETS];
+	uint8_t privKey[SHA1_DIGEST_OCTETS];
+
+	/* Localized keys, replaced in turn. */
+	USMKeys keys[USM_KEY_CACHE];
+	uint8_t cached;
+	uint8_t next;
+} USMUser;
+
+/* The snmpEngine group. */
+typedef struct USMEngine
+{
+	OctetString snmpEngineID;
+	int32_t     snmpEngineBoots;
+	int32_t     snmpEngineTime;
+	int32_t     snmpEngineMaxMessageSize;
+} USMEngine;
+
+/* The usmStats group, counted by usmDecode(). */
+typedef struct USMStatistics
+{
+	uint32_t usmStatsUnsupportedSecLevels; /* Counter32 */
+	uint32_t usmStatsNotInTimeWindows;     /* Counter32 */
+	uint32_t usmStatsUnknownUserNames;     /* Counter32 */
+	uint32_t usmStatsUnknownEngineIDs;     /* Counter32 */
+	uint32_t usmStatsWrongDigests;         /* Counter32 */
+	uint32_t usmStatsDecryptionErrors;     /* Counter32 */
+} USMStatistics;
+
+extern USMStatistics usmStatistics;
+
+/* Sets up the engine: its ID is the text format of RFC 3411 under the
+ * private enterprise with the host name, and its boots are the seconds from
+ * 2020 to now, so that they grow from one start to the next without being
+ * stored.
+ */
+void usmInit (void);
+
+/* Adds a user with an authentication password and, if priv is not NULL, a
+ * privacy password, and localizes its keys to the engine. Returns false if
+ * there is no room, the name is taken or too long, or a password is shorter
+ * than the eight characters RFC 3414 requires. What the user may do is up
+ * to its access group (see Access.h).
+ */
+bool usmAddUser (const char *name, const char *auth, const char *priv);
+
+USMUser *usmFind (const uint8_t *name, size_t length);
+
+/* The keys of user localized to an engine, from the cache when it has
+ * them.
+ */
+const USMKeys *usmLocalize (USMUser *user, const uint8_t *engineID,
+                            size_t length);
+
+/* The engine, its time brought up to date. */
+USMEngine *usmEngine (void);
+
+/* Decodes an SNMPv3 message and checks it as the authoritative engine,
+ * deciphering the scoped PDU into plain, of SNMP_MAX_MESSAGE octets, if it
+ * is enciphered. The user is stored in user once known. On an error other
+ * than USM_PARSE_ERROR, the header of the message has been decoded and the
+ * error counted, and a report may be sent with usmReport().
+ */
+USMStatus usmDecode (const uint8_t *data, size_t length, uint8_t *plain,
+                     SNMPMessage *message, USMUser **user);
+
+/* Encodes message at the start of buffer at the security level of its
+ * flags and returns its length, or zero if it does not fit in capacity.
+ * user is only used when the level has authentication.
+ */
+size_t usmEncode (const SNMPMessage *message, USMUser *user, uint8_t *buffer,
+                  size_t capacity);
+
+/* Fills a report PDU with the counter of the error. */
+void usmReport (USMStatus status, SNMPPDU *pdu);
+
+#endif /* USM_H */
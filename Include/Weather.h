@@ -0,0 +1,82 @@
+#ifndef WEATHER_H
+#define WEATHER_H
+
+#include <Common.h>
+#include <Database.h>
+
+/* Streaming aggregates of the sensors of the weather station (NTCIP 1204).
+ * Every sensor keeps the minimum, maximum, sum and count of its samples in
+ * WEATHER_BUCKETS buckets spanning the window of its quantity, so that
+ * whatever the rate of the samples an aggregate is of fixed size, a sample
+ * costs a constant time and the window slides a bucket at a time. The
+ * buckets but the one being filled are kept combined, so the minimum,
+ * maximum and mean of the window are at hand without going through them.
+ *
+ * Every sample, and every tick that slides a window, publishes the values
+ * the ess objects report, so a GET reads them like any other object:
+ *
+ *   pressure          last sample                      3 hours
+ *   wind direction    last sample, mean around north   2 minutes
+ *   wind speed        last sample, mean                2 minutes
+ *   wind gust         maximum, direction at it         10 minutes
+ *   humidity          last sample                      10 minutes
+ *   visibility        last sample                      10 minutes
+ *   air temperature   last sample; minimum and         24 hours
+ *                     maximum of the first sensor
+ *   pavement          last sample                      1 hour
+ *
+ * A sensor without a sample in its window reports its missing value.
+ */
+
+/* Buckets of the window of a sensor. */
+#define WEATHER_BUCKETS 12
+
+/* Quantities measured, in the units of the objects they are reported in. */
+typedef enum WeatherChannel
+{
+	WEATHER_PRESSURE             = 0, /* Tenths of a millibar. */
+	WEATHER_WIND_DIRECTION       = 1, /* Degrees from north. */
+	WEATHER_WIND_SPEED           = 2, /* Tenths of a meter per second. */
+	WEATHER_HUMIDITY             = 3, /* Percent. */
+	WEATHER_VISIBILITY           = 4, /* Tenths of a meter. */
+	WEATHER_AIR_TEMPERATURE      = 5, /* Tenths of a degree Celsius. */
+	WEATHER_SURFACE_TEMPERATURE  = 6,
+	WEATHER_PAVEMENT_TEMPERATURE = 7,
+	WEATHER_CHANNEL_COUNT        = 8
+} WeatherChannel;
+
+/* A window of one sensor. The other members are undefined while samples
+ * is zero.
+ */
+typedef struct WeatherSummary
+{
+	uint32_t samples;
+	int32_t  latest;
+	int32_t  minimum;
+	int32_t  maximum;
+	int32_t  mean;
+	int32_t  rate; /* Change of the mean across the window per hour. */
+} WeatherSummary;
+
+/* Allocates an aggregate for every sensor of the database. */
+bool weatherInit (const DatabaseLimits *limits);
+void weatherFree (void);
+
+/* Takes a sample of a sensor at now on the monotonic clock. The sensors of
+ * the temperature and pavement tables are numbered from one; the others
+ * take zero. Returns false for a sensor the station does not have. Any
+ * thread may take samples.
+ */
+bool weatherSample (WeatherChannel channel, uint8_t sensor, int32_t value,
+                    uint64_t now);
+
+/* The window of a sensor as of now. Returns false for a sensor the station
+ * does not have.
+ */
+bool weatherSummary (WeatherChannel channel, uint8_t sensor, uint64_t now,
+                     WeatherSummary *summary);
+
+/* Tick hook: slides the windows that moved on and publishes them. */
+void weatherTick (uint64_t deadline, uint64_t now);
+
+#endif /* WEATHER_H */
@@ -0,0 +1,49 @@
+#ifndef ZONE_H
+#define ZONE_H
+
+#include <Common.h>
+#include <Database.h>
+
+/* Samples of the detection zones of a transportation sensor (NTCIP 1209
+ * sampleData). Radar and video sensors report every vehicle that crosses
+ * one of their zones; the driver hands these over in batches, which are
+ * counted into per-zone accumulators kept as separate arrays (volume,
+ * occupied time, speed, and volume by class), so that a batch touches only
+ * the counters it adds to and a period of hundreds of zones is cleared and
+ * published a column at a time.
+ *
+ * Periods of samplePeriod seconds follow the rules of every collection
+ * period (see Period.h), like those of the volumeOccupancyReport. At the
+ * end of one the zoneSampleTable and zoneClassTable are published and
+ * sampleSequence is advanced. Occupancy is the share of the period, timed
+ * on the monotonic clock, the zone was occupied for.
+ */
+
+/* One vehicle that crossed a zone. */
+typedef struct ZoneSample
+{
+	uint16_t zone;         /* Numbered from one. */
+	uint8_t  vehicleClass; /* Numbered from one, zero if not classified. */
+	uint8_t  speed;        /* Kilometers per hour, zero if not measured. */
+	uint32_t occupancy;    /* Microseconds the zone was occupied for. */
+} ZoneSample;
+
+/* Allocates the accumulators for the limits of the database. */
+bool zoneInit (const DatabaseLimits *limits);
+void zoneFree (void);
+
+/* Counts a batch of vehicles. Vehicles of zones that do not exist or are
+ * not enabled, or taken while no period is running, are dropped. Returns
+ * the number counted. Safe to call from any thread.
+ */
+size_t zoneIngest (const ZoneSample samples[], size_t count);
+
+/* Calendar step hook: ends the period at once if the step went past its
+ * end, and aligns the next end to the new time.
+ */
+void zoneStep (int64_t step);
+
+/* Tick hook: publishes the period when it ends. */
+void zoneTick (uint64_t deadline, uint64_t now);
+
+#endif /* ZONE_H */
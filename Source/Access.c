@@ -0,0 +1,173 @@
+#include <Access.h>
+#include <MIB.h>
+
+typedef struct Family
+{
+	OID  subtree;
+	bool included;
+} Family;
+
+typedef struct View
+{
+	char         name[ACCESS_MAX_NAME + 1];
+	size_t       count;
+	Family       families[ACCESS_MAX_FAMILIES];
+	RegistryView objects; /* Built by accessCompile(). */
+} View;
+
+/* Written before accessCompile(), read only after. */
+static View views[ACCESS_MAX_VIEWS] =
+{
+	{
+		.name     = "all",
+		.count    = 1,
+		.families = { { .subtree = OID_INIT(1), .included = true } }
+	},
+	{
+		.name     = "devices",
+		.count    = 1,
+		.families = { { .subtree = DEVICES_NODE_OID, .included = true } }
+	},
+	{
+		.name     = "agent",
+		.count    = 3,
+		.families =
+		{
+			{ .subtree = PRIVATE_OID(),     .included = true },
+			{ .subtree = SNMP_ENGINE_OID(), .included = true },
+			{ .subtree = USM_STATS_OID(),   .included = true }
+		}
+	},
+	{
+		.name = "none"
+	}
+};
+
+static size_t      viewCount = 4;
+static AccessGroup groups[ACCESS_MAX_GROUPS];
+static size_t      groupCount;
+
+static View *findView (const char *const name)
+{
+	for (size_t index = 0; index < viewCount; index++)
+	{
+		if (strcmp(views[index].name, name) == 0)
+		{
+			return &views[index];
+		}
+	}
+
+	return NULL;
+}
+
+bool accessView (const char *const name, const OID *const subtree,
+                 const bool included)
+{
+	View *view = findView(name);
+
+	if (!view)
+	{
+		if (viewCount == ACCESS_MAX_VIEWS || strlen(name) > ACCESS_MAX_NAME)
+		{
+			return false;
+		}
+
+		view = &views[viewCount++];
+		strcpy(view->name, name);
+	}
+
+	if (view->count == ACCESS_MAX_FAMILIES)
+	{
+		return false;
+	}
+
+	view->families[view->count++] = (Family)
+	{
+		.subtree  = *subtree,
+		.included = included
+	};
+
+	return true;
+}
+
+const AccessGroup *accessFind (const AccessModel model,
+                               const uint8_t *const name, const size_t length)
+{
+	for (size_t index = 0; index < groupCount; index++)
+	{
+		const AccessGroup *const group = &groups[index];
+
+		if (group->model == model && group->nameLength == length
+		 && memcmp(group->name, name, length) == 0)
+		{
+			return group;
+		}
+	}
+
+	return NULL;
+}
+
+bool accessGroup (const AccessModel model, const char *const name,
+                  const char *const readView, const char *const writeView,
+                  const bool administrator)
+{
+	const size_t length = strlen(name);
+	const View  *none   = findView("none");
+	const View  *read   = readView ? findView(readView) : none;
+	const View  *write  = writeView ? findView(writeView) : none;
+
+	if (groupCount == ACCESS_MAX_GROUPS || length > ACCESS_MAX_NAME || !read
+	 || !write || accessFind(model, (const uint8_t *) name, length))
+	{
+		return false;
+	}
+
+	AccessGroup *const group = &groups[groupCount++];
+
+	*group = (AccessGroup)
+	{
+		.model         = model,
+		.nameLength    = (uint8_t) length,
+		.administrator = administrator,
+		.read          = &read->objects,
+		.write         = &write->objects
+	};
+
+	memcpy(group->name, name, length);
+
+	return true;
+}
+
+void accessCompile (void)
+{
+	for (size_t index = 0; index < viewCount; index++)
+	{
+		View *const   view = &views[index];
+		const Family *order[ACCESS_MAX_FAMILIES];
+
+		/* Shorter subtrees first, so that the longest one holding an object
+		 * is the last to set its bit.
+		 */
+		for (size_t family = 0; family < view->count; family++)
+		{
+			size_t position = family;
+
+			for (; position > 0 && order[position - 1]->subtree.length
+			                       > view->families[family].subtree.length;
+			     position--)
+			{
+				order[position] = order[position - 1];
+			}
+
+			order[position] = &view->families[family];
+		}
+
+		memset(&view->objects, 0, sizeof(view->objects));
+
+		for (size_t family = 0; family < view->count; family++)
+		{
+			registryViewSet(&view->objects, &order[family]->subtree,
+			                order[family]->included);
+		}
+	}
+}
@@ -0,0 +1,640 @@
+#include <Agent.h>
+#include <Calendar.h>
+#include <Change.h>
+#include <Device.h>
+#include <Metrics.h>
+#include <Registry.h>
+#include <Sync.h>
+#include <Transaction.h>
+
+bool agentInit (Agent *const agent, const AgentConfig *const config)
+{
+	memset(&agent->statistics, 0, sizeof(agent->statistics));
+
+	agent->config = *config;
+	agent->socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+	if (agent->socket < 0)
+	{
+		return false;
+	}
+
+	if (bind(agent->socket, (const struct sockaddr *) &config->address,
+	         sizeof(config->address)) < 0)
+	{
+		close(agent->socket);
+		agent->socket = -1;
+		return false;
+	}
+
+	return true;
+}
+
+void agentClose (Agent *const agent)
+{
+	if (agent->socket >= 0)
+	{
+		close(agent->socket);
+		agent->socket = -1;
+	}
+}
+
+/* SNMPv1 has no exception values and fewer error codes (RFC 3584). */
+static SNMPError versionError (const int32_t version, const SNMPError error)
+{
+	if (version != SNMP_VERSION_1)
+	{
+		return error;
+	}
+
+	switch (error)
+	{
+		case SNMP_NO_ACCESS:
+		case SNMP_NOT_WRITABLE:
+		case SNMP_NO_CREATION:
+		case SNMP_AUTHORIZATION_ERROR:
+			return SNMP_NO_SUCH_NAME;
+
+		case SNMP_WRONG_TYPE:
+		case SNMP_WRONG_LENGTH:
+		case SNMP_WRONG_VALUE:
+		case SNMP_INCONSISTENT_VALUE:
+			return SNMP_BAD_VALUE;
+
+		case SNMP_RESOURCE_UNAVAILABLE:
+			return SNMP_GEN_ERR;
+
+		default:
+			return error;
+	}
+}
+
+/* Answers with the request varbinds and the given error status, as both
+ * error responses and successful SET responses do.
+ */
+static void echo (Agent *const agent, const SNMPError error,
+                  const size_t index)
+{
+	SNMPPDU *const response = &agent->response.pdu;
+
+	response->errorStatus = versionError(agent->request.version, error);
+	response->errorIndex  = (int32_t) index;
+	response->count       = agent->request.pdu.count;
+
+	memcpy(response->varbinds, agent->request.pdu.varbinds,
+	       response->count * sizeof(VarBind));
+}
+
+static void getNext (const OID *const name, const RegistryView *const view,
+                     VarBind *const varbind)
+{
+	const RegistryObject *object;
+	size_t row;
+	const uint64_t start = clockMonotonic();
+	const bool     found = registryNext(name, view, &object, &row,
+	                                    &varbind->name);
+
+	metricsRecord(METRIC_LOOKUP, clockMonotonic() - start);
+
+	if (found)
+	{
+		registryGet(object, row, varbind);
+	}
+	else
+	{
+		varbind->name = *name;
+		varbind->type = BER_END_OF_MIB_VIEW;
+	}
+}
+
+static void processGet (Agent *const agent)
+{
+	const SNMPPDU *const request  = &agent->request.pdu;
+	SNMPPDU       *const response = &agent->response.pdu;
+
+	for (size_t index = 0; index < request->count; index++)
+	{
+		VarBind *const varbind = &response->varbinds[index];
+		const RegistryObject *object;
+		size_t row;
+		const uint64_t start = clockMonotonic();
+
+		varbind->name = request->varbinds[index].name;
+
+		RegistryLookup lookup = registryFind(&varbind->name, &object, &row);
+
+		metricsRecord(METRIC_LOOKUP, clockMonotonic() - start);
+
+		/* What the group may not read does not exist for it. */
+		if (lookup != REGISTRY_NO_OBJECT
+		 && !registryInView(agent->group->read, object))
+		{
+			lookup = REGISTRY_NO_OBJECT;
+		}
+
+		switch (lookup)
+		{
+			case REGISTRY_FOUND:
+				registryGet(object, row, varbind);
+				break;
+
+			case REGISTRY_NO_OBJECT:
+				varbind->type = BER_NO_SUCH_OBJECT;
+				break;
+
+			case REGISTRY_NO_INSTANCE:
+				varbind->type = BER_NO_SUCH_INSTANCE;
+				break;
+		}
+
+		if (varbind->type == BER_NO_SUCH_OBJECT
+		 || varbind->type == BER_NO_SUCH_INSTANCE)
+		{
+			if (agent->request.version == SNMP_VERSION_1)
+			{
+				echo(agent, SNMP_NO_SUCH_NAME, index + 1);
+				return;
+			}
+		}
+	}
+
+	response->count = request->count;
+}
+
+static void processGetNext (Agent *const agent)
+{
+	const SNMPPDU *const request  = &agent->request.pdu;
+	SNMPPDU       *const response = &agent->response.pdu;
+
+	for (size_t index = 0; index < request->count; index++)
+	{
+		VarBind *const varbind = &response->varbinds[index];
+
+		getNext(&request->varbinds[index].name, agent->group->read, varbind);
+
+		if (varbind->type == BER_END_OF_MIB_VIEW
+		 && agent->request.version == SNMP_VERSION_1)
+		{
+			echo(agent, SNMP_NO_SUCH_NAME, index + 1);
+			return;
+		}
+	}
+
+	response->count = request->count;
+}
+
+static void processGetBulk (Agent *const agent)
+{
+	const SNMPPDU *const request      = &agent->request.pdu;
+	SNMPPDU       *const response     = &agent->response.pdu;
+	const size_t         nonRepeaters =
+		MIN((size_t) MAX(request->errorStatus, 0), request->count);
+	const size_t         repetitions  = (size_t) MAX(request->errorIndex, 0);
+	const size_t         repeaters    = request->count - nonRepeaters;
+
+	for (size_t index = 0; index < nonRepeaters; index++)
+	{
+		getNext(&request->varbinds[index].name, agent->group->read,
+		        &response->varbinds[index]);
+	}
+
+	response->count = nonRepeaters;
+
+	/* Each repetition continues from the names returned by the previous
+	 * one. The response stops growing once it can no longer be encoded;
+	 * agentProcess() trims whatever does not fit in a datagram.
+	 */
+	for (size_t repetition = 0; repetition < repetitions; repetition++)
+	{
+		bool progressed = false;
+
+		if (repeaters == 0
+		 || response->count + repeaters > SNMP_MAX_VARBINDS)
+		{
+			break;
+		}
+
+		for (size_t index = 0; index < repeaters; index++)
+		{
+			const OID *const previous = repetition == 0
+				? &request->varbinds[nonRepeaters + index].name
+				: &response->varbinds[response->count - repeaters].name;
+			VarBind *const varbind = &response->varbinds[response->count];
+
+			getNext(previous, agent->group->read, varbind);
+			progressed |= varbind->type != BER_END_OF_MIB_VIEW;
+			response->count++;
+		}
+
+		if (!progressed)
+		{
+			break;
+		}
+	}
+}
+
+static void processSet (Agent *const agent)
+{
+	const SNMPPDU        *const request = &agent->request.pdu;
+	const AccessGroup    *const group   = agent->group;
+	const RegistryObject *objects[SNMP_MAX_VARBINDS];
+	size_t                rows[SNMP_MAX_VARBINDS];
+
+	/* A SET is applied as a whole or not at all: every varbind is checked,
+	 * and the room its value takes in the arena reserved, before the first
+	 * one is stored, so that no store can fail.
+	 */
+	for (size_t index = 0; index < request->count; index++)
+	{
+		const VarBind *const varbind = &request->varbinds[index];
+		SNMPError error;
+		size_t    errorIndex = index + 1;
+		const uint64_t start = clockMonotonic();
+		const RegistryLookup lookup =
+			registryFind(&varbind->name, &objects[index], &rows[index]);
+
+		metricsRecord(METRIC_LOOKUP, clockMonotonic() - start);
+
+		if (lookup != REGISTRY_NO_OBJECT
+		 && !registryInView(group->write, objects[index]))
+		{
+			octetStringRelease();
+			echo(agent, SNMP_NO_ACCESS, errorIndex);
+			return;
+		}
+
+		switch (lookup)
+		{
+			case REGISTRY_FOUND:
+				error = registryCheck(objects[index], varbind);
+
+				/* GlobalDatabaseManagement has the rules of transactions
+				 * answered with genErr at index zero.
+				 */
+				if (error == SNMP_NO_ERROR
+				 && transactionIsCommand(objects[index]))
+				{
+					error = transactionCheck(varbind->value.integer, group);
+					errorIndex = error == SNMP_GEN_ERR ? 0 : errorIndex;
+				}
+				else if (error == SNMP_NO_ERROR && objects[index]->database
+				      && !transactionTarget(group))
+				{
+					error      = SNMP_GEN_ERR;
+					errorIndex = 0;
+				}
+
+				if (error == SNMP_NO_ERROR)
+				{
+					error = deviceCheck(objects[index], rows[index], varbind);
+				}
+
+				if (error == SNMP_NO_ERROR
+				 && !registryReserve(objects[index], varbind))
+				{
+					error = SNMP_RESOURCE_UNAVAILABLE;
+				}
+				break;
+
+			case REGISTRY_NO_INSTANCE:
+				error = objects[index]->writable ? SNMP_NO_CREATION
+				                                 : SNMP_NOT_WRITABLE;
+				break;
+
+			default:
+				error = SNMP_NOT_WRITABLE;
+				break;
+		}
+
+		if (error != SNMP_NO_ERROR)
+		{
+			octetStringRelease();
+			echo(agent, error, errorIndex);
+			return;
+		}
+	}
+
+	/* Database objects go to the transaction buffer while one is open. A
+	 * dbCreateTransaction command takes effect after every other varbind of
+	 * its PDU has been stored. The tick sees none of it until all of it is.
+	 */
+	const ObjectTree *const target = transactionTarget(group);
+	bool                    changed = false;
+
+	databaseLock();
+
+	for (size_t index = 0; index < request->count; index++)
+	{
+		const RegistryObject *const object = objects[index];
+
+		if (transactionIsCommand(object))
+		{
+			continue;
+		}
+
+		if (calendarIsClock(object))
+		{
+			calendarSet(request->varbinds[index].value.counter);
+			continue;
+		}
+
+		if (object->database)
+		{
+			registrySelect(target);
+			changed = true;
+		}
+
+		registryStore(object, rows[index], &request->varbinds[index]);
+		registrySelect(NULL);
+
+		if (object->database && target != &database)
+		{
+			changeStage(object, rows[index]);
+		}
+		else
+		{
+			changeRecord(object, rows[index]);
+		}
+
+		if (!object->database)
+		{
+			deviceStore(object, rows[index]);
+		}
+	}
+
+	for (size_t index = 0; index < request->count; index++)
+	{
+		if (transactionIsCommand(objects[index]))
+		{
+			transactionCommand(request->varbinds[index].value.integer,
+			                   group);
+			changed = true;
+		}
+	}
+
+	octetStringRelease();
+
+	if (changed)
+	{
+		syncRefresh();
+	}
+
+	/* Control objects select the pattern as much as database ones do. */
+	calendarInvalidate();
+	deviceInvalidate(changed);
+	databaseUnlock();
+
+	echo(agent, SNMP_NO_ERROR, 0);
+}
+
+/* Encodes the response under the model of the request. */
+static size_t encode (Agent *const agent, uint8_t *const output,
+                      const size_t capacity)
+{
+	if (agent->response.version == SNMP_VERSION_3)
+	{
+		return usmEncode(&agent->response, agent->user, output, capacity);
+	}
+
+	return snmpEncode(&agent->response, output, capacity);
+}
+
+/* Fills in the header of an SNMPv3 response from that of its request, with
+ * the engine of the agent as the authoritative one.
+ */
+static void secure (Agent *const agent, const uint8_t flags)
+{
+	const SNMPSecurity *const request  = &agent->request.security;
+	SNMPSecurity       *const response = &agent->response.security;
+	const USMEngine    *const engine   = usmEngine();
+
+	*response = *request;
+
+	response->flags       = flags;
+	response->maxSize     = SNMP_MAX_MESSAGE;
+	response->engineID    = octetStringData(&engine->snmpEngineID,
+	                                        &response->engineIDLength);
+	response->engineBoots = engine->snmpEngineBoots;
+	response->engineTime  = engine->snmpEngineTime;
+
+	if (response->contextEngineIDLength == 0)
+	{
+		response->contextEngineID       = response->engineID;
+		response->contextEngineIDLength = response->engineIDLength;
+	}
+}
+
+/* Answers an SNMPv3 request the security model turned down with a report
+ * of why, if the request asks for one. Only a message out of the time
+ * window is reported authenticated, so that the manager can trust the time
+ * it learns from the report.
+ */
+static size_t report (Agent *const agent, const USMStatus status,
+                      uint8_t *const output, const size_t capacity)
+{
+	SNMPMessage *const response = &agent->response;
+
+	if (!(agent->request.security.flags & SNMP_FLAG_REPORTABLE))
+	{
+		return 0;
+	}
+
+	response->version       = SNMP_VERSION_3;
+	response->pdu.requestID = agent->request.pdu.requestID;
+
+	secure(agent, status == USM_NOT_IN_TIME_WINDOWS ? SNMP_FLAG_AUTH : 0);
+	usmReport(status, &response->pdu);
+
+	const size_t encoded = encode(agent, output, capacity);
+
+	agent->statistics.outPackets += encoded != 0;
+
+	return encoded;
+}
+
+size_t agentProcess (Agent *const agent, const uint8_t *const data,
+                     const size_t length, uint8_t *const output,
+                     const size_t capacity)
+{
+	SNMPMessage *const request  = &agent->request;
+	SNMPMessage *const response = &agent->response;
+	USMStatus          status   = USM_OK;
+	bool               decoded;
+
+	agent->statistics.inPackets++;
+
+	const uint64_t decodeStart = clockMonotonic();
+	const int32_t  version     = snmpVersion(data, length);
+
+	if (version == SNMP_VERSION_3)
+	{
+		status  = usmDecode(data, length, agent->plain, request, &agent->user);
+		decoded = status != USM_PARSE_ERROR;
+	}
+	else
+	{
+		decoded = snmpDecode(data, length, request);
+	}
+
+	metricsRecord(METRIC_DECODE, clockMonotonic() - decodeStart);
+
+	if (!decoded
+	 || (request->version != SNMP_VERSION_1
+	  && request->version != SNMP_VERSION_2C
+	  && request->version != SNMP_VERSION_3))
+	{
+		agent->statistics.inASNParseErrors++;
+		return 0;
+	}
+
+	/* An SNMPv3 response is no larger than the manager says it takes. */
+	const size_t room = request->version == SNMP_VERSION_3
+		? MIN(capacity, (size_t) request->security.maxSize)
+		: capacity;
+
+	if (status != USM_OK)
+	{
+		return report(agent, status, output, room);
+	}
+
+	if (request->version == SNMP_VERSION_3)
+	{
+		agent->group = accessFind(ACCESS_USER, agent->user->name,
+		                          agent->user->nameLength);
+
+		secure(agent, request->security.flags
+		            & (SNMP_FLAG_AUTH | SNMP_FLAG_PRIV));
+	}
+	else
+	{
+		agent->group = accessFind(ACCESS_COMMUNITY, request->community,
+		                          request->communityLength);
+
+		if (!agent->group)
+		{
+			agent->statistics.inBadCommunityNames++;
+			return 0;
+		}
+
+		response->community       = request->community;
+		response->communityLength = request->communityLength;
+	}
+
+	response->version         = request->version;
+	response->pdu.type        = SNMP_RESPONSE;
+	response->pdu.requestID   = request->pdu.requestID;
+	response->pdu.errorStatus = SNMP_NO_ERROR;
+	response->pdu.errorIndex  = 0;
+	response->pdu.count       = 0;
+
+	switch (request->pdu.type)
+	{
+		case SNMP_GET_REQUEST:
+		case SNMP_GET_NEXT_REQUEST:
+		case SNMP_SET_REQUEST:
+			break;
+
+		case SNMP_GET_BULK_REQUEST:
+			if (request->version == SNMP_VERSION_1)
+			{
+				return 0;
+			}
+
+			break;
+
+		default:
+			return 0;
+	}
+
+	/* SNMPv3 users are known by their keys alone, so a request without
+	 * authentication may do nothing, and neither may a user without a group.
+	 */
+	if (request->version == SNMP_VERSION_3
+	 && (!(request->security.flags & SNMP_FLAG_AUTH) || !agent->group))
+	{
+		echo(agent, SNMP_AUTHORIZATION_ERROR, 0);
+	}
+	else
+	{
+		switch (request->pdu.type)
+		{
+			case SNMP_GET_REQUEST:
+				processGet(agent);
+				break;
+
+			case SNMP_GET_NEXT_REQUEST:
+				processGetNext(agent);
+				break;
+
+			case SNMP_GET_BULK_REQUEST:
+				processGetBulk(agent);
+				break;
+
+			case SNMP_SET_REQUEST:
+				processSet(agent);
+				break;
+		}
+	}
+
+	const uint64_t encodeStart = clockMonotonic();
+	size_t         encoded     = encode(agent, output, room);
+
+	if (request->pdu.type == SNMP_GET_BULK_REQUEST
+	 && response->pdu.errorStatus == SNMP_NO_ERROR)
+	{
+		/* Drop trailing repetitions until the response fits. */
+		while (encoded == 0 && response->pdu.count > 0)
+		{
+			response->pdu.count--;
+			encoded = encode(agent, output, room);
+		}
+	}
+	else if (encoded == 0)
+	{
+		agent->statistics.outTooBigs++;
+		response->pdu.errorStatus = SNMP_TOO_BIG;
+		response->pdu.errorIndex  = 0;
+		response->pdu.count       = 0;
+		encoded = encode(agent, output, room);
+	}
+
+	metricsRecord(METRIC_ENCODE, clockMonotonic() - encodeStart);
+
+	agent->statistics.outPackets += encoded != 0;
+
+	return encoded;
+}
+
+bool agentServe (Agent *const agent, const int timeout)
+{
+	struct pollfd descriptor = { .fd = agent->socket, .events = POLLIN };
+
+	if (poll(&descriptor, 1, timeout) < 0)
+	{
+		return errno == EINTR;
+	}
+
+	for (;;)
+	{
+		struct sockaddr_in source;
+		socklen_t          sourceLength = sizeof(source);
+		const ssize_t      length =
+			recvfrom(agent->socket, agent->input, sizeof(agent->input),
+			         MSG_DONTWAIT, (struct sockaddr *) &source, &sourceLength);
+
+		if (length < 0)
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+
+		const size_t response = agentProcess(agent, agent->input,
+		                                     (size_t) length, agent->output,
+		                                     sizeof(agent->output));
+
+		if (response != 0)
+		{
+			(void) sendto(agent->socket, agent->output, response, 0,
+			              (const struct sockaddr *) &source, sourceLength);
+		}
+	}
+}
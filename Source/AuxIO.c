@@ -0,0 +1,645 @@
+#include <AuxIO.h>
+#include <Device.h>
+#include <MIB.h>
+
+#define WORD(port) ((port) / 64)
+#define BIT(port)  (UINT64_C(1) << (port) % 64)
+
+static const OID portEntry   = GLOBAL_OID(7, 3, 1);
+static const OID valueColumn = GLOBAL_OID(7, 3, 1, 5);
+
+static AuxIOv2Entry *ports (void)
+{
+	return global.auxIOv2.auxIOv2Table;
+}
+
+/* Sorts the digital ports into the direction bitmaps. */
+static void classify (AuxIO *const engine)
+{
+	for (size_t port = 0; port < engine->digitalPorts; port++)
+	{
+		const size_t   word = WORD(port);
+		const uint64_t bit  = BIT(port);
+
+		switch (ports()[port].auxIOv2PortDirection)
+		{
+			case PORT_DIRECTION_OUTPUT:
+				engine->drives[word] |= bit;
+				break;
+
+			case PORT_DIRECTION_BIDIRECTIONAL:
+				engine->inputs[word] |= bit;
+				engine->drives[word] |= bit;
+				break;
+
+			default:
+				engine->inputs[word] |= bit;
+				break;
+		}
+	}
+}
+
+bool auxIOInit (AuxIO *const engine, const AuxIOBackend *const backend,
+                const AuxIOConfig *const config)
+{
+	const AuxIOv2 *const auxIOv2 = &global.auxIOv2;
+
+	memset(engine, 0, sizeof(*engine));
+
+	if (config->window == 0 || config->window > AUX_IO_MAX_WINDOW
+	 || config->resolution == 0 || config->resolution > 32)
+	{
+		errno = EINVAL;
+		return false;
+	}
+
+	engine->backend       = *backend;
+	engine->config        = *config;
+	engine->digitalPorts  = auxIOv2->maxAuxIOv2TableNumDigitalPorts;
+	engine->analogPorts   = auxIOv2->maxAuxIOv2TableNumAnalogPorts;
+	engine->analogMaximum = UINT32_MAX >> (32 - config->resolution);
+
+	if (!PROVIDE(engine->averages, engine->analogPorts)
+	 || !PROVIDE(engine->samples, engine->analogPorts)
+	 || !PROVIDE(engine->driving, engine->analogPorts))
+	{
+		auxIOFree(engine);
+		return false;
+	}
+
+	classify(engine);
+
+	for (size_t port = 0; port < engine->analogPorts; port++)
+	{
+		ports()[engine->digitalPorts + port].auxIOv2PortResolution =
+			config->resolution;
+	}
+
+	return true;
+}
+
+void auxIOFree (AuxIO *const engine)
+{
+#ifdef STATIC_STORAGE
+	(void) engine;
+#else
+	free(engine->averages);
+	free(engine->samples);
+	free(engine->driving);
+
+	engine->averages = NULL;
+	engine->samples  = NULL;
+	engine->driving  = NULL;
+#endif
+}
+
+/* Writes the value of a port only when it changes, so that a quiet port
+ * never dirties the cache line of its row.
+ */
+static void update (uint32_t *const field, const uint32_t value)
+{
+	if (*field != value)
+	{
+		*field = value;
+	}
+}
+
+/* Debounces the digital inputs a word at a time. A port is examined on its
+ * own only while its raw level differs from its debounced one.
+ */
+static void debounce (AuxIO *const engine, const uint64_t raw[AUX_IO_WORDS])
+{
+	const size_t words = (engine->digitalPorts + 63) / 64;
+
+	for (size_t word = 0; word < words; word++)
+	{
+		const uint64_t changed = (raw[word] ^ engine->stable[word])
+		                       & engine->inputs[word];
+
+		/* Ports back at their debounced level stop counting; ports newly
+		 * away from it start.
+		 */
+		const uint64_t started = changed & ~engine->pending[word];
+
+		engine->pending[word] = changed;
+
+		for (uint64_t bits = changed; bits != 0; bits &= bits - 1)
+		{
+			const size_t   port = word * 64 + (size_t) __builtin_ctzll(bits);
+			const uint64_t bit  = BIT(port);
+
+			if (started & bit)
+			{
+				engine->held[port] = 0;
+			}
+
+			if (++engine->held[port] < engine->config.debounce)
+			{
+				continue;
+			}
+
+			engine->stable[word]  ^= bit;
+			engine->pending[word] &= ~bit;
+
+			update(&ports()[port].auxIOv2PortValue,
+			       (engine->stable[word] & bit) != 0);
+		}
+	}
+}
+
+/* Adds a sample to the moving average of an analog input. */
+static uint32_t average (AuxIOAverage *const filter, const uint8_t window,
+                         const uint32_t sample)
+{
+	if (filter->count == window)
+	{
+		filter->sum -= filter->samples[filter->next];
+	}
+	else
+	{
+		filter->count++;
+	}
+
+	filter->samples[filter->next] = sample;
+	filter->sum                  += sample;
+	filter->next                  = (uint8_t) ((filter->next + 1) % window);
+
+	return (uint32_t) (filter->sum / filter->count);
+}
+
+static bool readInputs (AuxIO *const engine)
+{
+	const AuxIOBackend *const backend = &engine->backend;
+	uint64_t                  raw[AUX_IO_WORDS] = { 0 };
+
+	if (!backend->sample(backend->context)
+	 || !backend->readDigital(backend->context, raw)
+	 || !backend->readAnalog(backend->context, engine->samples,
+	                         engine->analogPorts))
+	{
+		return false;
+	}
+
+	debounce(engine, raw);
+
+	for (size_t port = 0; port < engine->analogPorts; port++)
+	{
+		AuxIOv2Entry *const entry = &ports()[engine->digitalPorts + port];
+
+		if (entry->auxIOv2PortDirection == PORT_DIRECTION_OUTPUT)
+		{
+			continue;
+		}
+
+		const uint32_t value =
+			average(&engine->averages[port], engine->config.window,
+			        MIN(engine->samples[port], engine->analogMaximum));
+
+		update(&entry->auxIOv2PortValue, value);
+	}
+
+	return true;
+}
+
+/* The level an output port is to be driven to. */
+static uint32_t commandOf (AuxIOv2Entry *const entry)
+{
+	if (entry->auxIOv2PortDirection == PORT_DIRECTION_OUTPUT)
+	{
+		/* Output ports report the last command as their value. */
+		update(&entry->auxIOv2PortValue, entry->auxIOv2PortLastCommandedState);
+	}
+
+	return entry->auxIOv2PortLastCommandedState;
+}
+
+static bool writeOutputs (AuxIO *const engine)
+{
+	const AuxIOBackend *const backend = &engine->backend;
+	const size_t              words   = (engine->digitalPorts + 63) / 64;
+	uint64_t                  levels[AUX_IO_WORDS]  = { 0 };
+	uint64_t                  changed[AUX_IO_WORDS] = { 0 };
+	bool                      any = false;
+
+	for (size_t word = 0; word < words; word++)
+	{
+		for (uint64_t bits = engine->drives[word]; bits != 0; bits &= bits - 1)
+		{
+			const size_t port = word * 64 + (size_t) __builtin_ctzll(bits);
+
+			if (commandOf(&ports()[port]) != 0)
+			{
+				levels[word] |= BIT(port);
+			}
+		}
+
+		changed[word] = engine->driven
+		              ? (levels[word] ^ engine->commanded[word])
+		              : engine->drives[word];
+		any          |= changed[word] != 0;
+	}
+
+	if (any)
+	{
+		if (!backend->writeDigital(backend->context, levels, changed))
+		{
+			return false;
+		}
+
+		memcpy(engine->commanded, levels, sizeof(levels));
+	}
+
+	for (size_t port = 0; port < engine->analogPorts; port++)
+	{
+		AuxIOv2Entry *const entry = &ports()[engine->digitalPorts + port];
+
+		if (entry->auxIOv2PortDirection == PORT_DIRECTION_INPUT)
+		{
+			continue;
+		}
+
+		const uint32_t value = MIN(commandOf(entry), engine->analogMaximum);
+
+		if (engine->driven && engine->driving[port] == value)
+		{
+			continue;
+		}
+
+		if (!backend->writeAnalog(backend->context, port, value))
+		{
+			return false;
+		}
+
+		engine->driving[port] = value;
+	}
+
+	engine->driven = true;
+
+	return true;
+}
+
+bool auxIOScan (AuxIO *const engine)
+{
+	engine->scans++;
+
+	if (!readInputs(engine) || !writeOutputs(engine))
+	{
+		engine->errors++;
+		return false;
+	}
+
+	return true;
+}
+
+bool auxIODirections (const char *list)
+{
+	const AuxIOv2 *const auxIOv2 = &global.auxIOv2;
+	const size_t         digital = auxIOv2->maxAuxIOv2TableNumDigitalPorts;
+
+	while (*list != '\0')
+	{
+		const char          type   = *list;
+		char               *end;
+		const unsigned long number = strtoul(list + 1, &end, 10);
+		const size_t        count  =
+			type == 'd' ? digital
+			: type == 'a' ? auxIOv2->maxAuxIOv2TableNumAnalogPorts : 0;
+
+		if (number == 0 || number > count)
+		{
+			return false;
+		}
+
+		AuxIOv2Entry *const entry =
+			&ports()[(type == 'd' ? 0 : digital) + number - 1];
+
+		entry->auxIOv2PortDirection = *end == 'b'
+			? PORT_DIRECTION_BIDIRECTIONAL : PORT_DIRECTION_OUTPUT;
+		end                        += *end == 'b';
+
+		if (*end != ',' && *end != '\0')
+		{
+			return false;
+		}
+
+		list = end + (*end == ',');
+	}
+
+	return true;
+}
+
+SNMPError auxIOCheck (const RegistryObject *const object, const size_t row,
+                      const VarBind *const varbind)
+{
+	if (!oidIsPrefix(&portEntry, &object->oid))
+	{
+		return SNMP_NO_ERROR;
+	}
+
+	const AuxIOv2Entry *const entry      = &ports()[row];
+	const uint8_t             resolution = entry->auxIOv2PortResolution;
+	const uint64_t            maximum    = resolution >= 32 ? UINT32_MAX
+		: (UINT64_C(1) << resolution) - 1;
+
+	return entry->auxIOv2PortDirection == PORT_DIRECTION_INPUT
+	    || (uint64_t) varbind->value.integer > maximum
+	     ? SNMP_GEN_ERR : SNMP_NO_ERROR;
+}
+
+void auxIOStore (const RegistryObject *const object, const size_t row)
+{
+	if (!oidIsPrefix(&portEntry, &object->oid))
+	{
+		return;
+	}
+
+	AuxIOv2Entry *const entry = &ports()[row];
+
+	if (oidCompare(&object->oid, &valueColumn) == 0)
+	{
+		entry->auxIOv2PortLastCommandedState = entry->auxIOv2PortValue;
+	}
+	else if (entry->auxIOv2PortDirection == PORT_DIRECTION_OUTPUT)
+	{
+		entry->auxIOv2PortValue = entry->auxIOv2PortLastCommandedState;
+	}
+}
+
+/* The engine is started by the application, over the backend it chooses,
+ * so the device has no hooks beyond those of a SET.
+ */
+const Device auxDevice =
+{
+	.name    = "aux",
+	.subtree = GLOBAL_OID(7),
+	.check   = auxIOCheck,
+	.store   = auxIOStore
+};
+
+/* Simulation backend. */
+
+static void setLevel (uint64_t levels[const AUX_IO_WORDS], const size_t port,
+                      const bool level)
+{
+	if (level)
+	{
+		levels[WORD(port)] |= BIT(port);
+	}
+	else
+	{
+		levels[WORD(port)] &= ~BIT(port);
+	}
+}
+
+/* Applies one line. Returns false for the empty line ending a sample;
+ * malformed lines are ignored.
+ */
+static bool apply (AuxIOSimulation *const simulation, const char *const line)
+{
+	char               *end;
+	const unsigned long port = strtoul(line + (line[0] != '\0'), &end, 10);
+
+	if (line[0] == '\0')
+	{
+		return false;
+	}
+
+	if (port == 0 || port > UINT8_MAX || *end != ' ')
+	{
+		return true;
+	}
+
+	const unsigned long value = strtoul(end + 1, NULL, 10);
+
+	switch (line[0])
+	{
+		case 'd':
+			setLevel(simulation->levels, port - 1, value != 0);
+			break;
+
+		case 'a':
+			simulation->values[port - 1] = (uint32_t) MIN(value, UINT32_MAX);
+			break;
+	}
+
+	return true;
+}
+
+static bool simulationSample (void *const context)
+{
+	AuxIOSimulation *const simulation = context;
+
+	for (;;)
+	{
+		/* Lines are taken from the carried over part first. */
+		char *const newline = memchr(simulation->line, '\n',
+		                             simulation->length);
+
+		if (newline)
+		{
+			const size_t length = (size_t) (newline - simulation->line) + 1;
+
+			*newline = '\0';
+
+			const bool more = apply(simulation, simulation->line);
+
+			memmove(simulation->line, simulation->line + length,
+			        simulation->length - length);
+			simulation->length -= length;
+
+			if (!more)
+			{
+				return true;
+			}
+
+			continue;
+		}
+
+		/* A line longer than the buffer is dropped. */
+		if (simulation->length == sizeof(simulation->line))
+		{
+			simulation->length = 0;
+		}
+
+		const ssize_t length =
+			read(simulation->fd, simulation->line + simulation->length,
+			     sizeof(simulation->line) - simulation->length);
+
+		if (length <= 0)
+		{
+			return length == 0 || errno == EAGAIN || errno == EWOULDBLOCK
+			    || errno == EINTR;
+		}
+
+		simulation->length += (size_t) length;
+	}
+}
+
+static bool simulationReadDigital (void *const context,
+                                   uint64_t levels[const AUX_IO_WORDS])
+{
+	const AuxIOSimulation *const simulation = context;
+
+	memcpy(levels, simulation->levels, sizeof(simulation->levels));
+
+	return true;
+}
+
+static bool simulationReadAnalog (void *const context, uint32_t samples[const],
+                                  const size_t count)
+{
+	const AuxIOSimulation *const simulation = context;
+
+	memcpy(samples, simulation->values, count * sizeof(samples[0]));
+
+	return true;
+}
+
+static bool report (AuxIOSimulation *const simulation, const char type,
+                    const size_t port, const uint32_t value)
+{
+	if (!simulation->writable)
+	{
+		return true;
+	}
+
+	char         line[32];
+	const size_t length = (size_t) snprintf(line, sizeof(line), "%c%zu %lu\n",
+	                                        type, port + 1,
+	                                        (unsigned long) value);
+
+	/* A peer that does not keep up misses levels rather than stalling the
+	 * scan.
+	 */
+	return write(simulation->fd, line, length) >= 0 || errno == EAGAIN
+	    || errno == EWOULDBLOCK;
+}
+
+static bool simulationWriteDigital (void *const context,
+                                    const uint64_t levels[const AUX_IO_WORDS],
+                                    const uint64_t changed[const AUX_IO_WORDS])
+{
+	AuxIOSimulation *const simulation = context;
+
+	for (size_t word = 0; word < AUX_IO_WORDS; word++)
+	{
+		for (uint64_t bits = changed[word]; bits != 0; bits &= bits - 1)
+		{
+			const size_t port = word * 64 + (size_t) __builtin_ctzll(bits);
+
+			setLevel(simulation->levels, port, levels[word] & BIT(port));
+
+			if (!report(simulation, 'D', port, (levels[word] & BIT(port)) != 0))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool simulationWriteAnalog (void *const context, const size_t port,
+                                   const uint32_t value)
+{
+	AuxIOSimulation *const simulation = context;
+
+	simulation->values[port] = value;
+
+	return report(simulation, 'A', port, value);
+}
+
+/* Opens the master of a new pseudo-terminal in raw mode. */
+static int openPty (AuxIOSimulation *const simulation, char *const name,
+                    const size_t capacity)
+{
+	const int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+	if (master < 0)
+	{
+		return -1;
+	}
+
+	/* Held open, so that the master does not hang up while no peer has the
+	 * slave open.
+	 */
+	struct termios settings;
+	int            slave = -1;
+
+	if (grantpt(master) != 0 || unlockpt(master) != 0
+	 || ptsname_r(master, name, capacity) != 0
+	 || (slave = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0
+	 || tcgetattr(slave, &settings) != 0)
+	{
+		if (slave >= 0)
+		{
+			close(slave);
+		}
+
+		close(master);
+		return -1;
+	}
+
+	/* Canonical input is left alone, so the peer may be a person typing. */
+	settings.c_oflag &= ~(tcflag_t) OPOST;
+	settings.c_lflag &= ~(tcflag_t) ECHO;
+	(void) tcsetattr(slave, TCSANOW, &settings);
+
+	simulation->peer = slave;
+
+	return master;
+}
+
+bool auxIOSimulationOpen (AuxIOSimulation *const simulation,
+                          const char *const path, char *const name,
+                          const size_t capacity, AuxIOBackend *const backend)
+{
+	memset(simulation, 0, sizeof(*simulation));
+	simulation->peer = -1;
+
+	const bool pty = strcmp(path, "pty") == 0;
+	const int  fd  = pty ? openPty(simulation, name, capacity)
+	                     : open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	struct stat status;
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	if (fstat(fd, &status) != 0
+	 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+	{
+		simulation->fd = fd;
+		auxIOSimulationClose(simulation);
+		return false;
+	}
+
+	simulation->fd       = fd;
+	simulation->writable = !S_ISREG(status.st_mode);
+
+	*backend = (AuxIOBackend)
+	{
+		.context      = simulation,
+		.sample       = simulationSample,
+		.readDigital  = simulationReadDigital,
+		.readAnalog   = simulationReadAnalog,
+		.writeDigital = simulationWriteDigital,
+		.writeAnalog  = simulationWriteAnalog
+	};
+
+	return true;
+}
+
+void auxIOSimulationClose (AuxIOSimulation *const simulation)
+{
+	close(simulation->fd);
+
+	if (simulation->peer >= 0)
+	{
+		close(simulation->peer);
+	}
+
+	simulation->fd   = -1;
+	simulation->peer = -1;
+}
@@ -0,0 +1,433 @@
+#include <BER.h>
+
+void berWriterInit (BERWriter *const writer, uint8_t *const buffer,
+                    const size_t capacity)
+{
+	writer->buffer   = buffer;
+	writer->capacity = capacity;
+	writer->cursor   = capacity;
+	writer->overflow = false;
+}
+
+size_t berWriterLength (const BERWriter *const writer)
+{
+	return writer->capacity - writer->cursor;
+}
+
+const uint8_t *berWriterData (const BERWriter *const writer)
+{
+	return writer->buffer + writer->cursor;
+}
+
+void berWriteBytes (BERWriter *const writer, const void *const data,
+                    const size_t length)
+{
+	if (writer->overflow || length > writer->cursor)
+	{
+		writer->overflow = true;
+		return;
+	}
+
+	writer->cursor -= length;
+	memcpy(writer->buffer + writer->cursor, data, length);
+}
+
+static void writeByte (BERWriter *const writer, const uint8_t byte)
+{
+	if (writer->overflow || writer->cursor == 0)
+	{
+		writer->overflow = true;
+		return;
+	}
+
+	writer->buffer[--writer->cursor] = byte;
+}
+
+void berWriteHeader (BERWriter *const writer, const uint8_t tag,
+                     const size_t length)
+{
+	if (length < 0x80)
+	{
+		writeByte(writer, (uint8_t) length);
+	}
+	else
+	{
+		uint8_t octets = 0;
+
+		for (size_t remaining = length; remaining != 0; remaining >>= 8)
+		{
+			writeByte(writer, (uint8_t) remaining);
+			octets++;
+		}
+
+		writeByte(writer, 0x80 | octets);
+	}
+
+	writeByte(writer, tag);
+}
+
+void berWriteInteger (BERWriter *const writer, const uint8_t tag,
+                      const int64_t value)
+{
+	const size_t mark = berWriterLength(writer);
+	int64_t remaining = value;
+
+	/* Emit two's complement octets from the least significant end until the
+	 * remaining value is pure sign extension of the last octet written.
+	 */
+	for (;;)
+	{
+		const uint8_t octet = (uint8_t) remaining;
+
+		writeByte(writer, octet);
+		remaining >>= 8;
+
+		if ((remaining ==  0 && !(octet & 0x80))
+		 || (remaining == -1 &&  (octet & 0x80)))
+		{
+			break;
+		}
+	}
+
+	berWriteHeader(writer, tag, berWriterLength(writer) - mark);
+}
+
+void berWriteUnsigned (BERWriter *const writer, const uint8_t tag,
+                       const uint64_t value)
+{
+	const size_t mark = berWriterLength(writer);
+	uint64_t remaining = value;
+	uint8_t octet;
+
+	do
+	{
+		octet = (uint8_t) remaining;
+		writeByte(writer, octet);
+		remaining >>= 8;
+	} while (remaining != 0);
+
+	/* A set high bit would read back as negative. */
+	if (octet & 0x80)
+	{
+		writeByte(writer, 0x00);
+	}
+
+	berWriteHeader(writer, tag, berWriterLength(writer) - mark);
+}
+
+void berWriteOctetString (BERWriter *const writer, const void *const data,
+                          const size_t length)
+{
+	berWriteBytes(writer, data, length);
+	berWriteHeader(writer, BER_OCTET_STRING, length);
+}
+
+void berWriteNull (BERWriter *const writer, const uint8_t tag)
+{
+	berWriteHeader(writer, tag, 0);
+}
+
+static void writeArc (BERWriter *const writer, uint32_t arc)
+{
+	writeByte(writer, arc & 0x7F);
+
+	for (arc >>= 7; arc != 0; arc >>= 7)
+	{
+		writeByte(writer, 0x80 | (arc & 0x7F));
+	}
+}
+
+void berWriteOID (BERWriter *const writer, const OID *const oid)
+{
+	const size_t mark = berWriterLength(writer);
+
+	for (size_t index = oid->length; index > 2; index--)
+	{
+		writeArc(writer, oid->arcs[index - 1]);
+	}
+
+	/* The first two arcs share one sub-identifier. */
+	const uint32_t first  = oid->length > 0 ? oid->arcs[0] : 0;
+	const uint32_t second = oid->length > 1 ? oid->arcs[1] : 0;
+
+	writeArc(writer, first * 40 + second);
+	berWriteHeader(writer, BER_OID, berWriterLength(writer) - mark);
+}
+
+void berWriteConstructed (BERWriter *const writer, const uint8_t tag,
+                          const size_t mark)
+{
+	berWriteHeader(writer, tag, berWriterLength(writer) - mark);
+}
+
+void berReaderInit (BERReader *const reader, const uint8_t *const data,
+                    const size_t length)
+{
+	reader->data   = data;
+	reader->length = length;
+	reader->offset = 0;
+}
+
+bool berReaderAtEnd (const BERReader *const reader)
+{
+	return reader->offset >= reader->length;
+}
+
+bool berReadHeader (BERReader *const reader, uint8_t *const tag,
+                    size_t *const length)
+{
+	if (reader->length - reader->offset < 2)
+	{
+		return false;
+	}
+
+	*tag = reader->data[reader->offset++];
+
+	const uint8_t first = reader->data[reader->offset++];
+
+	if (first < 0x80)
+	{
+		*length = first;
+	}
+	else
+	{
+		/* Indefinite lengths (0x80) are not permitted by SNMP. */
+		const uint8_t octets = first & 0x7F;
+
+		if (octets == 0 || octets > sizeof(uint32_t)
+		 || reader->length - reader->offset < octets)
+		{
+			return false;
+		}
+
+		*length = 0;
+
+		for (uint8_t index = 0; index < octets; index++)
+		{
+			*length = (*length << 8) | reader->data[reader->offset++];
+		}
+	}
+
+	return *length <= reader->length - reader->offset;
+}
+
+bool berEnter (BERReader *const reader, const uint8_t tag,
+               BERReader *const contents)
+{
+	uint8_t actual;
+	size_t  length;
+
+	if (!berReadHeader(reader, &actual, &length) || actual != tag)
+	{
+		return false;
+	}
+
+	berReaderInit(contents, reader->data + reader->offset, length);
+	reader->offset += length;
+
+	return true;
+}
+
+bool berDecodeInteger (const uint8_t *const data, const size_t length,
+                       int64_t *const value)
+{
+	if (length == 0 || length > sizeof(int64_t))
+	{
+		return false;
+	}
+
+	uint64_t result = (data[0] & 0x80) ? UINT64_MAX : 0;
+
+	for (size_t index = 0; index < length; index++)
+	{
+		result = (result << 8) | data[index];
+	}
+
+	*value = (int64_t) result;
+
+	return true;
+}
+
+bool berDecodeUnsigned (const uint8_t *const data, const size_t length,
+                        uint64_t *const value)
+{
+	/* Allow one leading zero octet on top of a full 64-bit magnitude. */
+	if (length == 0 || length > sizeof(uint64_t) + 1
+	 || (length == sizeof(uint64_t) + 1 && data[0] != 0))
+	{
+		return false;
+	}
+
+	*value = 0;
+
+	for (size_t index = 0; index < length; index++)
+	{
+		*value = (*value << 8) | data[index];
+	}
+
+	return true;
+}
+
+bool berDecodeOID (const uint8_t *const data, const size_t length,
+                   OID *const oid)
+{
+	uint32_t arc = 0;
+
+	oid->length = 0;
+
+	for (size_t index = 0; index < length; index++)
+	{
+		if (arc > (UINT32_MAX >> 7))
+		{
+			return false;
+		}
+
+		arc = (arc << 7) | (data[index] & 0x7F);
+
+		if (data[index] & 0x80)
+		{
+			continue;
+		}
+
+		if (oid->length == 0)
+		{
+			const uint32_t first = arc < 80 ? arc / 40 : 2;
+
+			oid->arcs[0] = first;
+			oid->arcs[1] = arc - first * 40;
+			oid->length  = 2;
+		}
+		else if (!oidAppend(oid, arc))
+		{
+			return false;
+		}
+
+		arc = 0;
+	}
+
+	/* A trailing octet with the continuation bit set is malformed. */
+	return length > 0 && !(data[length - 1] & 0x80);
+}
+
+static bool readPrimitive (BERReader *const reader, const uint8_t tag,
+                           const uint8_t **const data, size_t *const length)
+{
+	uint8_t actual;
+
+	if (!berReadHeader(reader, &actual, length) || actual != tag)
+	{
+		return false;
+	}
+
+	*data = reader->data + reader->offset;
+	reader->offset += *length;
+
+	return true;
+}
+
+bool berReadInteger (BERReader *const reader, const uint8_t tag,
+                     int64_t *const value)
+{
+	const uint8_t *data;
+	size_t length;
+
+	return readPrimitive(reader, tag, &data, &length)
+	    && berDecodeInteger(data, length, value);
+}
+
+bool berReadUnsigned (BERReader *const reader, const uint8_t tag,
+                      uint64_t *const value)
+{
+	const uint8_t *data;
+	size_t length;
+
+	return readPrimitive(reader, tag, &data, &length)
+	    && berDecodeUnsigned(data, length, value);
+}
+
+bool berReadOctetString (BERReader *const reader, const uint8_t **const data,
+                         size_t *const length)
+{
+	return readPrimitive(reader, BER_OCTET_STRING, data, length);
+}
+
+bool berReadOID (BERReader *const reader, OID *const oid)
+{
+	const uint8_t *data;
+	size_t length;
+
+	return readPrimitive(reader, BER_OID, &data, &length)
+	    && berDecodeOID(data, length, oid);
+}
+
+bool oidParse (const char *const text, OID *const oid)
+{
+	const char *cursor = text;
+
+	oid->length = 0;
+
+	for (;;)
+	{
+		char *end;
+
+		if (!isdigit((unsigned char) *cursor))
+		{
+			return false;
+		}
+
+		errno = 0;
+
+		const unsigned long arc = strtoul(cursor, &end, 10);
+
+		if (errno != 0 || arc > UINT32_MAX || !oidAppend(oid, (uint32_t) arc))
+		{
+			return false;
+		}
+
+		if (*end == '\0')
+		{
+			return oid->length >= 2;
+		}
+
+		if (*end != '.')
+		{
+			return false;
+		}
+
+		cursor = end + 1;
+	}
+}
+
+int oidCompare (const OID *const left, const OID *const right)
+{
+	const uint8_t common = MIN(left->length, right->length);
+
+	for (uint8_t index = 0; index < common; index++)
+	{
+		if (left->arcs[index] != right->arcs[index])
+		{
+			return left->arcs[index] < right->arcs[index] ? -1 : 1;
+		}
+	}
+
+	return (left->length > right->length) - (left->length < right->length);
+}
+
+bool oidIsPrefix (const OID *const prefix, const OID *const oid)
+{
+	return prefix->length <= oid->length
+	    && memcmp(prefix->arcs, oid->arcs,
+	              prefix->length * sizeof(uint32_t)) == 0;
+}
+
+bool oidAppend (OID *const oid, const uint32_t arc)
+{
+	if (oid->length >= OID_MAX_ARCS)
+	{
+		return false;
+	}
+
+	oid->arcs[oid->length++] = arc;
+
+	return true;
+}
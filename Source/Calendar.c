@@ -0,0 +1,512 @@
+#include <Calendar.h>
+#include <Clock.h>
+#include <MIB.h>
+
+#define SECONDS_PER_DAY 86400
+
+/* Where the MIB names no time of day, transitions take place at 2:00. */
+#define TWO_AM   (2 * 3600)
+#define THREE_AM (3 * 3600)
+
+/* The rules of the retired globalDaylightSaving values, as dstTable rows,
+ * indexed by the value less enableUSDST. Iran follows the solar hijri
+ * calendar, which a row cannot express, and keeps standard time.
+ */
+#define RULE(beginMonth, beginOccurrence, beginDay, beginDate, beginTime,      \
+             endMonth, endOccurrence, endDay, endDate, endTime)                \
+	{                                                                          \
+		.dstBeginMonth               = (beginMonth),                           \
+		.dstBeginOccurrences         = (beginOccurrence),                      \
+		.dstBeginDayOfWeek           = (beginDay),                             \
+		.dstBeginDayOfMonth          = (beginDate),                            \
+		.dstBeginSecondsToTransition = (beginTime),                            \
+		.dstEndMonth                 = (endMonth),                             \
+		.dstEndOccurrences           = (endOccurrence),                        \
+		.dstEndDayOfWeek             = (endDay),                               \
+		.dstEndDayOfMonth            = (endDate),                              \
+		.dstEndSecondsToTransition   = (endTime),                              \
+		.dstSecondsToAdjust          = 3600                                    \
+	}
+
+static const DSTEntry rules[] =
+{
+	/* enableUSDST */
+	RULE(APRIL,     FIRST, SUNDAY, 1,  TWO_AM,
+	     OCTOBER,   LAST,  SUNDAY, 31, TWO_AM),
+	/* enableEuropeDST */
+	RULE(MARCH,     LAST,  SUNDAY, 31, TWO_AM,
+	     OCTOBER,   LAST,  SUNDAY, 31, THREE_AM),
+	/* enableAustraliaDST */
+	RULE(OCTOBER,   LAST,  SUNDAY, 31, TWO_AM,
+	     MARCH,     LAST,  SUNDAY, 31, TWO_AM),
+	/* enableTasmaniaDST */
+	RULE(OCTOBER,   FIRST, SUNDAY, 1,  TWO_AM,
+	     MARCH,     LAST,  SUNDAY, 31, THREE_AM),
+	/* enableEgyptDST */
+	RULE(APRIL,     LAST,  FRIDAY, 30, TWO_AM,
+	     SEPTEMBER, LAST,  THURSDAY, 30, TWO_AM),
+	/* enableNamibiaDST */
+	RULE(SEPTEMBER, FIRST, SUNDAY, 1,  TWO_AM,
+	     APRIL,     FIRST, SUNDAY, 1,  TWO_AM),
+	/* enableIraqDST */
+	RULE(APRIL,     SPECIFIC_DAY, SUNDAY, 1, TWO_AM,
+	     OCTOBER,   SPECIFIC_DAY, SUNDAY, 1, TWO_AM),
+	/* enableMongoliaDST */
+	RULE(MARCH,     LAST,  SUNDAY, 31, TWO_AM,
+	     SEPTEMBER, LAST,  SUNDAY, 30, TWO_AM),
+	/* enableIranDST */
+	RULE(DISABLED,  FIRST, SUNDAY, 1,  0,
+	     DISABLED,  FIRST, SUNDAY, 1,  0),
+	/* enableFijiDST */
+	RULE(NOVEMBER,  FIRST, SUNDAY, 1,  TWO_AM,
+	     FEBRUARY,  LAST,  SUNDAY, 29, TWO_AM),
+	/* enableNewZealandDST */
+	RULE(OCTOBER,   FIRST, SUNDAY, 1,  TWO_AM,
+	     MARCH,     FIRST, SUNDAY, 5,  TWO_AM),
+	/* enableTongaDST */
+	RULE(OCTOBER,   FIRST, SATURDAY, 1,  TWO_AM,
+	     APRIL,     FIRST, SATURDAY, 15, TWO_AM),
+	/* enableCubaDST */
+	RULE(APRIL,     SPECIFIC_DAY, SUNDAY, 1, TWO_AM,
+	     OCTOBER,   LAST,  SUNDAY, 31, TWO_AM),
+	/* enableBrazilDST */
+	RULE(OCTOBER,   FIRST, SUNDAY, 1,  TWO_AM,
+	     FEBRUARY,  LAST,  SUNDAY, 29, TWO_AM),
+	/* enableChileDST */
+	RULE(OCTOBER,   FIRST, SUNDAY, 9,  TWO_AM,
+	     MARCH,     FIRST, SUNDAY, 9,  TWO_AM),
+	/* enableFalklandsDST */
+	RULE(SEPTEMBER, FIRST, SUNDAY, 8,  TWO_AM,
+	     APRIL,     FIRST, SUNDAY, 8,  TWO_AM),
+	/* enableParaguayDST */
+	RULE(OCTOBER,   FIRST, SUNDAY, 1,  TWO_AM,
+	     FEBRUARY,  LAST,  SATURDAY, 29, TWO_AM)
+};
+
+static_assert(sizeof(rules) / sizeof(rules[0])
+              == enableParaguayDST - enableUSDST + 1,
+              "a rule is needed for every retired globalDaylightSaving");
+
+static const OID clockObject = GLOBAL_OID(3, 1);
+
+static struct
+{
+	CalendarTime time;
+
+	/* Time of the controller, in nanoseconds since the epoch, at the
+	 * monotonic time monotonic, and how far it is from the system clock.
+	 */
+	int64_t  wall;
+	uint64_t monotonic;
+	int64_t  offset;
+
+	/* Correction still to be slewed, and when it was last slewed. */
+	int64_t  slew;
+	uint64_t slewed;
+
+	int64_t dayStart;       /* Local seconds at the start of the day. */
+	int64_t nextTransition; /* UTC seconds of the next DST transition. */
+} cache;
+
+static atomic_bool stale = true;
+
+/* A SET of the clock: the time it set less the monotonic time of the SET,
+ * published by pending.
+ */
+static atomic_int_fast64_t setting;
+static atomic_bool         pending;
+
+static CalendarStepHook hooks[CALENDAR_MAX_HOOKS];
+static size_t           hookCount;
+
+bool calendarRegister (const CalendarStepHook hook)
+{
+	if (hookCount == CALENDAR_MAX_HOOKS)
+	{
+		return false;
+	}
+
+	hooks[hookCount++] = hook;
+
+	return true;
+}
+
+bool calendarIsClock (const RegistryObject *const object)
+{
+	return oidCompare(&object->oid, &clockObject) == 0;
+}
+
+void calendarSet (const uint64_t seconds)
+{
+	/* globalTime counts whole seconds, so the middle of the second set is
+	 * the best estimate of the time.
+	 */
+	const int64_t wall = (int64_t) (seconds * NANOSECONDS_PER_SECOND
+	                                + NANOSECONDS_PER_SECOND / 2);
+
+	atomic_store_explicit(&setting, wall - (int64_t) clockMonotonic(),
+	                      memory_order_relaxed);
+	atomic_store_explicit(&pending, true, memory_order_release);
+}
+
+void calendarInvalidate (void)
+{
+	atomic_store_explicit(&stale, true, memory_order_release);
+}
+
+const CalendarTime *calendarNow (void)
+{
+	return &cache.time;
+}
+
+/* Days since the epoch of a civil date, and back (proleptic Gregorian). */
+static int64_t daysFromCivil (int64_t year, const uint32_t month,
+                              const uint32_t day)
+{
+	year -= month <= 2;
+
+	const int64_t  era       = (year >= 0 ? year : year - 399) / 400;
+	const uint32_t yearOfEra = (uint32_t) (year - era * 400);
+	const uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2)
+	                         / 5 + day - 1;
+	const uint32_t dayOfEra  = yearOfEra * 365 + yearOfEra / 4
+	                         - yearOfEra / 100 + dayOfYear;
+
+	return era * 146097 + dayOfEra - 719468;
+}
+
+static void civilFromDays (int64_t days, int64_t *const year,
+                           uint32_t *const month, uint32_t *const day)
+{
+	days += 719468;
+
+	const int64_t  era       = (days >= 0 ? days : days - 146096) / 146097;
+	const uint32_t dayOfEra  = (uint32_t) (days - era * 146097);
+	const uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460
+	                            + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	const uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4
+	                                       - yearOfEra / 100);
+	const uint32_t shifted   = (5 * dayOfYear + 2) / 153;
+
+	*day   = dayOfYear - (153 * shifted + 2) / 5 + 1;
+	*month = shifted < 10 ? shifted + 3 : shifted - 9;
+	*year  = (int64_t) yearOfEra + era * 400 + (*month <= 2);
+}
+
+uint16_t calendarDayOfYear (const int64_t days)
+{
+	int64_t  year;
+	uint32_t month, day;
+
+	civilFromDays(days, &year, &month, &day);
+
+	return (uint16_t) (days - daysFromCivil(year, 1, 1) + 1);
+}
+
+/* enum Day of days since the epoch, a Thursday. */
+static uint8_t weekdayOf (const int64_t days)
+{
+	return (uint8_t) (((days + 4) % 7 + 7) % 7 + 1);
+}
+
+/* Days since the epoch of the transition day of a rule in year. */
+static int64_t transitionDay (const int64_t year, const uint32_t month,
+                              const enum Occurrence occurrence,
+                              const enum Day weekday, const uint32_t date)
+{
+	const int64_t  first  = daysFromCivil(year, month, 1);
+	const uint32_t length = (uint32_t)
+		(daysFromCivil(year + (month == 12), month % 12 + 1, 1) - first);
+	const int64_t  day    = first + MIN(MAX(date, 1u), length) - 1;
+	const int64_t  shift  = ((int64_t) weekday - weekdayOf(day) + 7) % 7;
+
+	if (occurrence >= FIRST && occurrence <= FOURTH)
+	{
+		return day + shift + (occurrence - FIRST) * 7;
+	}
+
+	if (occurrence >= LAST && occurrence <= FOURTH_LAST)
+	{
+		return day - (7 - shift) % 7 - (occurrence - LAST) * 7;
+	}
+
+	return day;
+}
+
+/* UTC seconds of the begin and end of rule in year, local times of which
+ * are standard time for the begin and daylight time for the end.
+ */
+static int64_t beginOf (const DSTEntry *const rule, const int64_t year,
+                        const int32_t zone)
+{
+	return transitionDay(year, rule->dstBeginMonth, rule->dstBeginOccurrences,
+	                     rule->dstBeginDayOfWeek, rule->dstBeginDayOfMonth)
+	     * SECONDS_PER_DAY + rule->dstBeginSecondsToTransition - zone;
+}
+
+static int64_t endOf (const DSTEntry *const rule, const int64_t year,
+                      const int32_t zone)
+{
+	return transitionDay(year, rule->dstEndMonth, rule->dstEndOccurrences,
+	                     rule->dstEndDayOfWeek, rule->dstEndDayOfMonth)
+	     * SECONDS_PER_DAY + rule->dstEndSecondsToTransition - zone
+	     - rule->dstSecondsToAdjust;
+}
+
+/* Adds the rule to the offset in effect at utc, keeping the active rule
+ * with the latest begin in *latest, and lowers *next to its first
+ * transition after utc.
+ */
+static void evaluateRule (const DSTEntry *const rule, const int64_t utc,
+                          const int32_t zone, int64_t *const latest,
+                          uint16_t *const adjust, int64_t *const next)
+{
+	if (rule->dstBeginMonth == ABSOLUTE)
+	{
+		const int64_t begin = rule->dstBeginSecondsToTransition;
+		const int64_t end   = rule->dstEndSecondsToTransition;
+
+		if (begin <= utc && utc < end && begin > *latest)
+		{
+			*latest = begin;
+			*adjust = rule->dstSecondsToAdjust;
+		}
+
+		*next = begin > utc ? MIN(*next, begin) : *next;
+		*next = end > utc ? MIN(*next, end) : *next;
+		return;
+	}
+
+	if (rule->dstBeginMonth < JANUARY || rule->dstBeginMonth > DECEMBER
+	 || rule->dstEndMonth < JANUARY || rule->dstEndMonth > DECEMBER)
+	{
+		return;
+	}
+
+	int64_t  year;
+	uint32_t month, day;
+
+	civilFromDays((utc + zone) / SECONDS_PER_DAY
+	              - ((utc + zone) % SECONDS_PER_DAY < 0), &year, &month, &day);
+
+	/* A period begun last year may still run, as south of the equator. */
+	for (int64_t from = year - 1; from <= year + 1; from++)
+	{
+		const int64_t begin = beginOf(rule, from, zone);
+		int64_t       end   = endOf(rule, from, zone);
+
+		if (end <= begin)
+		{
+			end = endOf(rule, from + 1, zone);
+		}
+
+		if (begin <= utc && utc < end && begin > *latest)
+		{
+			*latest = begin;
+			*adjust = rule->dstSecondsToAdjust;
+		}
+
+		*next = begin > utc ? MIN(*next, begin) : *next;
+		*next = end > utc ? MIN(*next, end) : *next;
+	}
+}
+
+/* The DST adjustment at utc, storing the next transition in next. */
+static uint16_t adjustmentAt (const int64_t utc, const int32_t zone,
+                              int64_t *const next)
+{
+	const GlobalTimeManagement *const time = &global.globalTimeManagement;
+	const DaylightSavingNode *const   node = &time->daylightSavingNode;
+	int64_t                           latest = INT64_MIN;
+	uint16_t                          adjust = 0;
+
+	*next = INT64_MAX;
+
+	if (time->globalDaylightSaving == enableDaylightSavingNode)
+	{
+		for (size_t row = 0; row < node->maxDaylightSavingEntries; row++)
+		{
+			evaluateRule(&node->dstTable[row], utc, zone, &latest, &adjust,
+			             next);
+		}
+	}
+	else if (time->globalDaylightSaving >= enableUSDST
+	      && time->globalDaylightSaving <= enableParaguayDST)
+	{
+		evaluateRule(&rules[time->globalDaylightSaving - enableUSDST], utc,
+		             zone, &latest, &adjust, next);
+	}
+
+	return adjust;
+}
+
+static void anchor (const uint64_t now)
+{
+	struct timespec wall;
+
+	clock_gettime(CLOCK_REALTIME, &wall);
+
+	cache.monotonic = clockMonotonic();
+	cache.wall      = (int64_t) wall.tv_sec * (int64_t) NANOSECONDS_PER_SECOND
+	                + wall.tv_nsec - (int64_t) (cache.monotonic - now)
+	                + cache.offset;
+	cache.monotonic = now;
+}
+
+static void correct (const int64_t amount)
+{
+	cache.wall   += amount;
+	cache.offset += amount;
+}
+
+/* Takes up a SET of the clock at now, returning the step it makes, or zero
+ * if the error is left to slew.
+ */
+static int64_t discipline (const uint64_t now)
+{
+	if (atomic_exchange_explicit(&pending, false, memory_order_acquire))
+	{
+		const int64_t wanted = atomic_load_explicit(&setting,
+		                                            memory_order_relaxed)
+		                     + (int64_t) now;
+		const int64_t error  = wanted - cache.wall
+		                     - (int64_t) (now - cache.monotonic);
+
+		if (error > (int64_t) CALENDAR_STEP_THRESHOLD
+		 || error < -(int64_t) CALENDAR_STEP_THRESHOLD)
+		{
+			cache.slew = 0;
+			correct(error);
+			return error;
+		}
+
+		cache.slew   = error;
+		cache.slewed = now;
+	}
+
+	if (cache.slew != 0)
+	{
+		const int64_t most   = (int64_t) (now - cache.slewed)
+		                     * CALENDAR_SLEW_RATE / 1000000;
+		const int64_t amount = cache.slew > 0 ? MIN(cache.slew, most)
+		                                      : MAX(cache.slew, -most);
+
+		correct(amount);
+		cache.slew  -= amount;
+		cache.slewed = now;
+	}
+
+	return 0;
+}
+
+static void setTimeOfDay (CalendarTime *const time)
+{
+	time->secondOfDay = (uint32_t) (time->local - cache.dayStart);
+	time->hour        = (uint8_t) (time->secondOfDay / 3600);
+	time->minute      = (uint8_t) (time->secondOfDay / 60 % 60);
+	time->second      = (uint8_t) (time->secondOfDay % 60);
+}
+
+/* Works the whole calendar out at utc. */
+static void rebuild (const int64_t utc)
+{
+	CalendarTime *const time = &cache.time;
+	const int32_t       zone =
+		global.globalTimeManagement.controllerStandardTimeZone;
+	const uint16_t      adjust = adjustmentAt(utc, zone, &cache.nextTransition);
+
+	time->utc            = utc;
+	time->offset         = zone + adjust;
+	time->daylightSaving = adjust != 0;
+	time->local          = utc + time->offset;
+
+	const int64_t days = time->local / SECONDS_PER_DAY
+	                   - (time->local % SECONDS_PER_DAY < 0);
+	int64_t       year;
+	uint32_t      month, day;
+
+	civilFromDays(days, &year, &month, &day);
+
+	cache.dayStart   = days * SECONDS_PER_DAY;
+	time->year       = (uint16_t) year;
+	time->month      = (uint8_t) month;
+	time->dayOfMonth = (uint8_t) day;
+	time->dayOfWeek  = weekdayOf(days);
+	time->dayOfYear  = calendarDayOfYear(days);
+
+	setTimeOfDay(time);
+}
+
+static void update (const uint64_t now)
+{
+	CalendarTime *const time = &cache.time;
+	bool                full = atomic_exchange_explicit(&stale, false,
+	                                                    memory_order_acquire);
+
+	if (full)
+	{
+		anchor(now);
+	}
+
+	const int64_t step = discipline(now);
+
+	full = full || step != 0;
+
+	int64_t wall = cache.wall + (int64_t) (now - cache.monotonic);
+	int64_t utc  = wall / (int64_t) NANOSECONDS_PER_SECOND;
+
+	if (!full && utc == time->utc)
+	{
+		time->nanoseconds = (uint32_t) (wall - utc
+		                                * (int64_t) NANOSECONDS_PER_SECOND);
+		return;
+	}
+
+	const int64_t local = utc + time->offset;
+
+	if (!full && (utc >= cache.nextTransition || local < cache.dayStart
+	           || local >= cache.dayStart + SECONDS_PER_DAY))
+	{
+		/* The day rolled: follow the wall clock again. */
+		anchor(now);
+
+		wall = cache.wall + (int64_t) (now - cache.monotonic);
+		utc  = wall / (int64_t) NANOSECONDS_PER_SECOND;
+		full = true;
+	}
+
+	time->nanoseconds = (uint32_t) (wall - utc
+	                                * (int64_t) NANOSECONDS_PER_SECOND);
+
+	if (full)
+	{
+		rebuild(utc);
+	}
+	else
+	{
+		time->utc   = utc;
+		time->local = local;
+		setTimeOfDay(time);
+	}
+
+	global.globalTimeManagement.globalTime          = (size_t) time->utc;
+	global.globalTimeManagement.controllerLocalTime = (size_t) time->local;
+
+	for (size_t index = 0; step != 0 && index < hookCount; index++)
+	{
+		hooks[index](step);
+	}
+}
+
+void calendarInit (void)
+{
+	calendarInvalidate();
+	update(clockMonotonic());
+}
+
+void calendarTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	update(now);
+}
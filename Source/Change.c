@@ -0,0 +1,299 @@
+#include <Change.h>
+#include <MIB.h>
+
+/* Entries of the tracked tables, in ChangeTable order. */
+static const OID entries[CHANGE_TABLE_COUNT] =
+{
+	ASC_OID(1, 2, 1),
+	ASC_OID(2, 2, 1),
+	ASC_OID(2, 7, 1),
+	GLOBAL_OID(3, 3, 2, 1),
+	GLOBAL_OID(3, 3, 5, 1),
+	GLOBAL_OID(3, 7, 2, 1),
+	ASC_OID(5, 3, 1),
+	GLOBAL_OID(1, 3, 1)
+};
+
+/* Columns of an entry looked for in the registry. */
+#define MAX_COLUMNS 64
+
+/* An entry of the log is its sequence number, truncated, over the change:
+ * the table, the column and the row. A table of CHANGE_TABLE_COUNT stands
+ * for a reset.
+ */
+#define ENTRY(sequence, payload) ((uint64_t) (sequence) << 32 | (payload))
+#define PAYLOAD(table, column, row)                                            \
+	((uint32_t) (table) << 24 | (uint32_t) (column) << 16 | (uint32_t) (row))
+#define RESET PAYLOAD(CHANGE_TABLE_COUNT, 0, 0)
+
+static_assert((CHANGE_LOG_SIZE & (CHANGE_LOG_SIZE - 1)) == 0,
+              "CHANGE_LOG_SIZE must be a power of two");
+
+/* Written by changeInit(), read only after. */
+static uint8_t tableOf[REGISTRY_MAX_OBJECTS]; /* ChangeTable + 1, or 0. */
+static size_t  first[CHANGE_TABLE_COUNT + 1];  /* Number of the first row. */
+
+static _Atomic uint64_t     ring[CHANGE_LOG_SIZE];
+static atomic_uint_fast64_t head;
+
+/* Owned by the agent thread. */
+static uint32_t staged[CHANGE_LOG_SIZE];
+static size_t   stagedCount;
+static bool     stagedLost;
+
+void changeInit (const DatabaseLimits *const limits)
+{
+	const size_t rows[CHANGE_TABLE_COUNT] =
+	{
+		[CHANGE_PHASE]               = limits->maxPhases,
+		[CHANGE_VEHICLE_DETECTOR]    = limits->maxVehicleDetectors,
+		[CHANGE_PEDESTRIAN_DETECTOR] = limits->maxPedestrianDetectors,
+		[CHANGE_TIME_BASE_SCHEDULE]  = limits->maxTimeBaseScheduleEntries,
+		[CHANGE_DAY_PLAN]            = (size_t) limits->maxDayPlans
+		                             * limits->maxDayPlanEvents,
+		[CHANGE_DST]                 = limits->maxDaylightSavingEntries,
+		[CHANGE_TIMEBASE_ACTION]     = limits->maxTimebaseAscActions,
+		[CHANGE_MODULE]              = limits->globalMaxModules
+	};
+
+	memset(tableOf, 0, sizeof(tableOf));
+
+	for (ChangeTable table = 0; table < CHANGE_TABLE_COUNT; table++)
+	{
+		const RegistryObject *columns[MAX_COLUMNS];
+		const size_t count = MIN(registryColumns(&entries[table], columns,
+		                                         MAX_COLUMNS),
+		                         (size_t) MAX_COLUMNS);
+
+		for (size_t index = 0; index < count; index++)
+		{
+			tableOf[columns[index]->index] = (uint8_t) (table + 1);
+		}
+
+		first[table + 1] = first[table] + rows[table];
+	}
+
+	stagedCount = 0;
+	stagedLost  = false;
+	atomic_store(&head, 0);
+}
+
+bool changeSubscribe (ChangeSubscriber *const subscriber)
+{
+	const size_t rows = first[CHANGE_TABLE_COUNT];
+
+	subscriber->cursor = atomic_load(&head);
+	subscriber->count  = 0;
+	subscriber->next   = 0;
+
+	if (!PROVIDE(subscriber->columns, rows)
+	 || !PROVIDE(subscriber->pending, rows))
+	{
+		return false;
+	}
+
+	memset(subscriber->columns, 0, rows * sizeof(subscriber->columns[0]));
+
+	return true;
+}
+
+void changeUnsubscribe (ChangeSubscriber *const subscriber)
+{
+#ifdef STATIC_STORAGE
+	(void) subscriber;
+#else
+	free(subscriber->columns);
+	free(subscriber->pending);
+
+	subscriber->columns = NULL;
+	subscriber->pending = NULL;
+#endif
+}
+
+static void publish (const uint32_t payload)
+{
+	const uint64_t sequence = atomic_load_explicit(&head,
+	                                               memory_order_relaxed);
+
+	atomic_store_explicit(&ring[sequence % CHANGE_LOG_SIZE],
+	                      ENTRY(sequence, payload), memory_order_relaxed);
+	atomic_store_explicit(&head, sequence + 1, memory_order_release);
+}
+
+/* The payload of a store, 0 if untracked, which no store is since columns
+ * count from 1. Rows past 16 bits cannot be described and reset.
+ */
+static uint32_t payloadOf (const RegistryObject *const object,
+                           const size_t row)
+{
+	const uint8_t table = tableOf[object->index];
+
+	if (table == 0)
+	{
+		return 0;
+	}
+
+	if (row > UINT16_MAX)
+	{
+		return RESET;
+	}
+
+	const OID *const name = &object->oid;
+
+	return PAYLOAD(table - 1, MIN(name->arcs[name->length - 1], 63), row);
+}
+
+void changeRecord (const RegistryObject *const object, const size_t row)
+{
+	const uint32_t payload = payloadOf(object, row);
+
+	if (payload != 0)
+	{
+		publish(payload);
+	}
+}
+
+void changeStage (const RegistryObject *const object, const size_t row)
+{
+	const uint32_t payload = payloadOf(object, row);
+
+	if (payload == 0)
+	{
+		return;
+	}
+
+	if (stagedCount == CHANGE_LOG_SIZE)
+	{
+		stagedLost = true;
+		return;
+	}
+
+	staged[stagedCount++] = payload;
+}
+
+void changeCommit (void)
+{
+	if (stagedLost)
+	{
+		publish(RESET);
+	}
+	else
+	{
+		for (size_t index = 0; index < stagedCount; index++)
+		{
+			publish(staged[index]);
+		}
+	}
+
+	changeDiscard();
+}
+
+void changeDiscard (void)
+{
+	stagedCount = 0;
+	stagedLost  = false;
+}
+
+void changeReset (void)
+{
+	publish(RESET);
+}
+
+static void clear (ChangeSubscriber *const subscriber)
+{
+	for (size_t index = subscriber->next; index < subscriber->count; index++)
+	{
+		subscriber->columns[subscriber->pending[index]] = 0;
+	}
+
+	subscriber->count = 0;
+	subscriber->next  = 0;
+}
+
+bool changeDrain (ChangeSubscriber *const subscriber)
+{
+	const uint64_t last = atomic_load_explicit(&head, memory_order_acquire);
+	bool           kept = last - subscriber->cursor <= CHANGE_LOG_SIZE;
+
+	/* Rows not taken yet go to the front, so that each dirty row is in
+	 * pending once and pending never overflows.
+	 */
+	memmove(subscriber->pending, subscriber->pending + subscriber->next,
+	        (subscriber->count - subscriber->next)
+	        * sizeof(subscriber->pending[0]));
+	subscriber->count -= subscriber->next;
+	subscriber->next   = 0;
+
+	for (uint64_t sequence = subscriber->cursor; kept && sequence < last;
+	     sequence++)
+	{
+		const uint64_t entry =
+			atomic_load_explicit(&ring[sequence % CHANGE_LOG_SIZE],
+			                     memory_order_relaxed);
+		const uint32_t payload = (uint32_t) entry;
+		const size_t   table   = payload >> 24;
+
+		/* An entry of a later sequence means the writer has lapped the
+		 * subscriber since the head was read, and a reset loses every row
+		 * alike.
+		 */
+		if ((uint32_t) (entry >> 32) != (uint32_t) sequence
+		 || table == CHANGE_TABLE_COUNT)
+		{
+			kept = false;
+			break;
+		}
+
+		const size_t row = first[table] + (payload & UINT16_MAX);
+
+		if (row >= first[table + 1])
+		{
+			continue;
+		}
+
+		if (subscriber->columns[row] == 0)
+		{
+			subscriber->pending[subscriber->count++] = (uint32_t) row;
+		}
+
+		subscriber->columns[row] |= UINT64_C(1) << (payload >> 16 & 0xFF);
+	}
+
+	subscriber->cursor = last;
+
+	if (!kept)
+	{
+		clear(subscriber);
+	}
+
+	return kept;
+}
+
+bool changeNext (ChangeSubscriber *const subscriber, ChangeRow *const change)
+{
+	if (subscriber->next == subscriber->count)
+	{
+		subscriber->count = 0;
+		subscriber->next  = 0;
+		return false;
+	}
+
+	const uint32_t row   = subscriber->pending[subscriber->next++];
+	ChangeTable    table = 0;
+
+	while (row >= first[table + 1])
+	{
+		table++;
+	}
+
+	*change = (ChangeRow)
+	{
+		.table   = table,
+		.row     = row - first[table],
+		.columns = subscriber->columns[row]
+	};
+
+	subscriber->columns[row] = 0;
+
+	return true;
+}
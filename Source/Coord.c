@@ -0,0 +1,839 @@
+#include <Coord.h>
+#include <Calendar.h>
+#include <Clock.h>
+#include <Detector.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Preempt.h>
+
+/* The masks of the phaseControlGroupTable the plan drives. */
+typedef enum Mask
+{
+	MASK_HOLD      = 0,
+	MASK_FORCE_OFF = 1,
+	MASK_OMIT      = 2,
+	MASK_COUNT     = 3
+} Mask;
+
+/* Where in the cycle a mask of a phase is asserted: [from, to), wrapping
+ * around the end of the cycle when to is not after from.
+ */
+typedef struct Interval
+{
+	enum
+	{
+		INTERVAL_NEVER  = 0,
+		INTERVAL_ALWAYS = 1,
+		INTERVAL_SPAN   = 2
+	} kind;
+
+	uint16_t from;
+	uint16_t to;
+} Interval;
+
+/* A phase of the plan, indexed by phase number less one. */
+typedef struct Slot
+{
+	CoordWindow window;
+	bool        used;
+	Interval    intervals[MASK_COUNT];
+} Slot;
+
+/* A mask of a phase turning on or off at a position of the cycle. */
+typedef struct Change
+{
+	uint16_t position;
+	uint8_t  phase; /* Counted from zero. */
+	uint8_t  mask;
+	bool     asserted;
+} Change;
+
+/* Each phase changes two masks at most, each twice a cycle. */
+#define CHANGES_PER_PHASE 4
+
+#define GROUPS CONFIG_GROUPS(UINT8_MAX)
+
+/* Ring numbers are one bit each in a bitmap of this many words. */
+#define RING_WORDS ((UINT8_MAX + 64) / 64)
+
+static struct
+{
+	OBJECT_TABLE(Slot,   slots,   CONFIG_MAX_PHASES);
+	OBJECT_TABLE(Change, changes, CONFIG_MAX_PHASES * CHANGES_PER_PHASE);
+	size_t phases;
+	size_t count; /* Changes in the plan. */
+	size_t next;  /* First change after position. */
+
+	uint8_t  pattern;  /* Pattern laid out, or 0 if none. */
+	uint16_t cycle;    /* Tenths of a second, 0 when not coordinated. */
+	uint16_t offset;
+	uint16_t position; /* Last position in the cycle. */
+
+	/* Levels of the masks of the plan, and the bits of them it owns. */
+	uint8_t levels[MASK_COUNT][GROUPS];
+	uint8_t owned[MASK_COUNT][GROUPS];
+
+	/* Minute of the last time base evaluation, in local time. */
+	int64_t minute;
+
+	/* Cycle reference point in tenths of a second after midnight, and the
+	 * timebaseAscPatternSync it was taken from, unless systemSyncControl
+	 * has moved it.
+	 */
+	uint32_t reference;
+	uint16_t patternSync;
+	bool     resynced;
+
+	/* The masks were left to a preempt and are written again once it
+	 * ends.
+	 */
+	bool suspended;
+
+	/* The clock was stepped since the last evaluation. */
+	bool stepped;
+} plan;
+
+static atomic_bool stale = true;
+
+#define DECISECONDS_PER_DAY (24 * 60 * 60 * 10)
+
+bool coordInit (const DatabaseLimits *const limits)
+{
+	plan.phases  = limits->maxPhases;
+	plan.pattern = 0;
+	plan.cycle   = 0;
+	plan.minute  = -1;
+	memset(plan.owned, 0, sizeof(plan.owned));
+	atomic_store(&stale, true);
+
+	return PROVIDE(plan.slots, plan.phases)
+	    && PROVIDE(plan.changes, plan.phases * CHANGES_PER_PHASE);
+}
+
+void coordFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(plan.slots);
+	free(plan.changes);
+
+	plan.slots   = NULL;
+	plan.changes = NULL;
+#endif
+}
+
+void coordInvalidate (void)
+{
+	atomic_store_explicit(&stale, true, memory_order_release);
+}
+
+void coordStep (const int64_t step)
+{
+	(void) step;
+
+	plan.stepped = true;
+}
+
+/* Number of bits set, which is how specific a schedule field is. */
+static uint32_t bits (const uint32_t value)
+{
+	return (uint32_t) __builtin_popcount(value);
+}
+
+/* The day plan of the most specific schedule entry allowed on date, or 0.
+ * Sets timeBaseScheduleTableStatus.
+ */
+static uint8_t dayPlanOn (Timebase *const timebase,
+                          const CalendarTime *const date)
+{
+	const TimeBaseScheduleEntry *best = NULL;
+	uint16_t                     row  = 0;
+
+	for (uint16_t index = 0; index < timebase->maxTimeBaseScheduleEntries;
+	     index++)
+	{
+		const TimeBaseScheduleEntry *const entry =
+			&timebase->timeBaseScheduleTable[index];
+
+		if (entry->timeBaseScheduleDayPlan == 0
+		 || !(entry->timeBaseScheduleMonth & (1u << date->month))
+		 || !(entry->timeBaseScheduleDay   & (1u << date->dayOfWeek))
+		 || !(entry->timeBaseScheduleDate  & (1u << date->dayOfMonth)))
+		{
+			continue;
+		}
+
+		/* Fewer months first, then fewer dates, then fewer days. */
+		if (best)
+		{
+			const int64_t months = (int64_t) bits(entry->timeBaseScheduleMonth)
+			                     - bits(best->timeBaseScheduleMonth);
+			const int64_t dates  = (int64_t) bits(entry->timeBaseScheduleDate)
+			                     - bits(best->timeBaseScheduleDate);
+			const int64_t days   = (int64_t) bits(entry->timeBaseScheduleDay)
+			                     - bits(best->timeBaseScheduleDay);
+
+			if (months > 0 || (months == 0 && dates > 0)
+			 || (months == 0 && dates == 0 && days >= 0))
+			{
+				continue;
+			}
+		}
+
+		best = entry;
+		row  = index + 1;
+	}
+
+	timebase->timeBaseScheduleTableStatus = row;
+
+	return best ? best->timeBaseScheduleDayPlan : 0;
+}
+
+/* The action of the event of dayPlan in effect at minute of the day: the
+ * latest one started, the highest numbered of those starting together, or
+ * the latest of the plan if none has started yet today. 0 if the plan has
+ * no events.
+ */
+static uint8_t actionAt (const Timebase *const timebase, const uint8_t dayPlan,
+                         const uint16_t minute)
+{
+	if (dayPlan == 0 || dayPlan > timebase->maxDayPlans)
+	{
+		return 0;
+	}
+
+	const TimeBaseDayPlanEntry *const events =
+		&timebase->timeBaseDayPlanTable[(size_t) (dayPlan - 1)
+		                                * timebase->maxDayPlanEvents];
+	int32_t today = -1;
+	int32_t latest = -1;
+	uint8_t todayAction = 0;
+	uint8_t latestAction = 0;
+
+	for (uint8_t index = 0; index < timebase->maxDayPlanEvents; index++)
+	{
+		const TimeBaseDayPlanEntry *const event = &events[index];
+		const int32_t start = event->dayPlanHourNumber * 60
+		                    + event->dayPlanMinuteNumber;
+
+		if (event->dayPlanActionNumberOID == 0)
+		{
+			continue;
+		}
+
+		if (start <= minute && start >= today)
+		{
+			today       = start;
+			todayAction = event->dayPlanActionNumberOID;
+		}
+
+		if (start >= latest)
+		{
+			latest       = start;
+			latestAction = event->dayPlanActionNumberOID;
+		}
+	}
+
+	return today >= 0 ? todayAction : latestAction;
+}
+
+/* Evaluates the time base on date and returns the pattern selected,
+ * storing why the controller is free in status.
+ */
+static uint8_t selectPattern (const CalendarTime *const date,
+                              uint8_t *const status)
+{
+	Timebase    *const timebase    = &global.globalTimeManagement.timebase;
+	TimebaseAsc *const timebaseAsc = &asc.timebaseAsc;
+	const Coord *const coord       = &asc.coord;
+
+	const uint8_t dayPlan = dayPlanOn(timebase, date);
+	const uint8_t action  = actionAt(timebase, dayPlan,
+	                                 date->hour * 60 + date->minute);
+
+	timebase->dayPlanStatus              = dayPlan;
+	timebaseAsc->timebaseAscActionStatus =
+		action <= timebaseAsc->maxTimebaseAscActions ? action : 0;
+
+	if (coord->coordOperationalMode != PATTERN_NONE)
+	{
+		*status = LOCAL_FREE_COMMAND_FREE;
+		return coord->coordOperationalMode;
+	}
+
+	if (coord->systemPatternControl != PATTERN_NONE)
+	{
+		*status = LOCAL_FREE_COMMAND_FREE;
+		return coord->systemPatternControl;
+	}
+
+	*status = LOCAL_FREE_COORD_FREE;
+
+	return timebaseAsc->timebaseAscActionStatus != 0
+		? timebaseAsc->timebaseAscActionTable
+			[timebaseAsc->timebaseAscActionStatus - 1].timebaseAscPattern
+		: PATTERN_NONE;
+}
+
+static Interval span (const uint16_t from, const uint16_t to)
+{
+	return from == to
+		? (Interval) { .kind = INTERVAL_NEVER }
+		: (Interval) { .kind = INTERVAL_SPAN, .from = from, .to = to };
+}
+
+/* Lays out the phases of one ring, given as indices in phase number order,
+ * over a cycle of the given length. Returns a localFreeStatus.
+ */
+static uint8_t layoutRing (const uint8_t order[const], const size_t count,
+                           const SplitEntry *const splits,
+                           const uint16_t cycle)
+{
+	const PhaseEntry *const phases = asc.phase.phaseTable;
+	size_t                  first  = 0;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		if (splits[order[index]].splitCoordPhase)
+		{
+			first = index;
+			break;
+		}
+	}
+
+	const bool coordinated = splits[order[first]].splitCoordPhase != 0;
+	uint32_t   position    = 0;
+
+	for (size_t step = 0; step < count; step++)
+	{
+		const uint8_t           phase     = order[(first + step) % count];
+		const PhaseEntry *const entry     = &phases[phase];
+		const uint32_t          split     = splits[phase].splitTime * 10u;
+		const uint32_t          clearance = (uint32_t) entry->phaseYellowChange
+		                                  + entry->phaseRedClear;
+		const uint32_t          minimum   = entry->phaseMinimumGreen * 10u;
+
+		if (split < clearance + minimum)
+		{
+			return LOCAL_FREE_BAD_PLAN;
+		}
+
+		plan.slots[phase].window = (CoordWindow)
+		{
+			.phase       = phase + 1,
+			.coordinated = coordinated && step == 0,
+			.start       = (uint16_t) position,
+			.forceOff    = (uint16_t) (position + split - clearance),
+			.permissive  = (uint16_t) (position + split - clearance - minimum)
+		};
+
+		position += split;
+
+		if (position > cycle)
+		{
+			return LOCAL_FREE_BAD_CYCLE_TIME;
+		}
+	}
+
+	/* Time the ring leaves over returns to the coordinated phase. */
+	const uint16_t end   = (uint16_t) (position % cycle);
+	const uint16_t yield = coordinated
+		? plan.slots[order[first]].window.forceOff : 0;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		Slot *const slot = &plan.slots[order[index]];
+
+		slot->used = true;
+
+		if (slot->window.coordinated)
+		{
+			slot->intervals[MASK_HOLD]      = span(end, yield);
+			slot->intervals[MASK_FORCE_OFF] = span(yield, end);
+		}
+		else
+		{
+			slot->intervals[MASK_FORCE_OFF] = span(slot->window.forceOff,
+			                                       yield);
+			slot->intervals[MASK_OMIT]      = span(slot->window.permissive,
+			                                       yield);
+		}
+	}
+
+	return LOCAL_FREE_NOT_FREE;
+}
+
+/* Lays out pattern, which names a row of the pattern table, into the slots.
+ * Returns a localFreeStatus, LOCAL_FREE_NOT_FREE if the plan can run.
+ */
+static uint8_t layout (const uint8_t pattern)
+{
+	const Coord *const coord  = &asc.coord;
+	const Phase *const phases = &asc.phase;
+
+	memset(plan.slots, 0, plan.phases * sizeof(plan.slots[0]));
+
+	if (pattern > coord->maxPatterns)
+	{
+		return LOCAL_FREE_BAD_PLAN;
+	}
+
+	const PatternEntry *const entry = &coord->patternTable[pattern - 1];
+
+	if (entry->patternSplitNumber == 0
+	 || entry->patternSplitNumber > coord->maxSplits)
+	{
+		return LOCAL_FREE_BAD_PLAN;
+	}
+
+	if (entry->patternCycleTime == 0)
+	{
+		return LOCAL_FREE_BAD_CYCLE_TIME;
+	}
+
+	if (entry->patternOffsetTime >= entry->patternCycleTime)
+	{
+		return LOCAL_FREE_INVALID_OFFSET;
+	}
+
+	const SplitEntry *const splits =
+		&coord->splitTable[(size_t) (entry->patternSplitNumber - 1)
+		                   * phases->maxPhases];
+
+	plan.cycle  = entry->patternCycleTime * 10;
+	plan.offset = entry->patternOffsetTime * 10;
+
+	/* Rings present among the enabled phases. */
+	uint64_t rings[RING_WORDS] = { 0 };
+
+	for (uint8_t phase = 0; phase < plan.phases; phase++)
+	{
+		const PhaseEntry *const row = &phases->phaseTable[phase];
+
+		if ((row->phaseOptions & 1) && row->phaseRing != 0)
+		{
+			rings[row->phaseRing / 64] |= UINT64_C(1) << (row->phaseRing % 64);
+		}
+	}
+
+	for (uint32_t ring = 1; ring <= UINT8_MAX; ring++)
+	{
+		if (!(rings[ring / 64] & (UINT64_C(1) << (ring % 64))))
+		{
+			continue;
+		}
+
+		uint8_t order[UINT8_MAX];
+		size_t  count = 0;
+
+		for (uint8_t phase = 0; phase < plan.phases; phase++)
+		{
+			const PhaseEntry *const row = &phases->phaseTable[phase];
+
+			if (!(row->phaseOptions & 1) || row->phaseRing != ring)
+			{
+				continue;
+			}
+
+			/* An omitted phase is left out of the ring and kept omitted. */
+			if (splits[phase].splitMode == SPLIT_MODE_OMITTED
+			 || splits[phase].splitTime == 0)
+			{
+				plan.slots[phase].used   = true;
+				plan.slots[phase].window = (CoordWindow) { .phase = phase + 1 };
+				plan.slots[phase].intervals[MASK_OMIT] =
+					(Interval) { .kind = INTERVAL_ALWAYS };
+				continue;
+			}
+
+			order[count++] = phase;
+		}
+
+		const uint8_t status = count != 0
+			? layoutRing(order, count, splits, plan.cycle)
+			: LOCAL_FREE_NOT_FREE;
+
+		if (status != LOCAL_FREE_NOT_FREE)
+		{
+			return status;
+		}
+	}
+
+	return LOCAL_FREE_NOT_FREE;
+}
+
+static bool within (const Interval *const interval, const uint16_t position)
+{
+	switch (interval->kind)
+	{
+		case INTERVAL_ALWAYS:
+			return true;
+
+		case INTERVAL_SPAN:
+			return interval->from < interval->to
+				? position >= interval->from && position < interval->to
+				: position >= interval->from || position < interval->to;
+
+		default:
+			return false;
+	}
+}
+
+static int compareChanges (const void *const left, const void *const right)
+{
+	const Change *const a = left;
+	const Change *const b = right;
+
+	return (a->position > b->position) - (a->position < b->position);
+}
+
+static void setLevel (const size_t mask, const size_t phase,
+                      const bool asserted)
+{
+	const uint8_t bit = (uint8_t) (1u << (phase % 8));
+
+	if (asserted)
+	{
+		plan.levels[mask][phase / 8] |= bit;
+	}
+	else
+	{
+		plan.levels[mask][phase / 8] &= (uint8_t) ~bit;
+	}
+}
+
+/* Turns the intervals of the slots into the sorted list of changes, and
+ * the masks into their levels at the start of the cycle.
+ */
+static void compile (void)
+{
+	memset(plan.levels, 0, sizeof(plan.levels));
+	plan.count = 0;
+
+	for (size_t phase = 0; phase < plan.phases; phase++)
+	{
+		const Slot *const slot = &plan.slots[phase];
+
+		if (!slot->used)
+		{
+			continue;
+		}
+
+		for (size_t mask = 0; mask < MASK_COUNT; mask++)
+		{
+			const Interval *const interval = &slot->intervals[mask];
+
+			setLevel(mask, phase, within(interval, 0));
+
+			if (interval->kind != INTERVAL_SPAN)
+			{
+				continue;
+			}
+
+			plan.changes[plan.count++] = (Change)
+			{
+				.position = interval->from,
+				.phase    = (uint8_t) phase,
+				.mask     = (uint8_t) mask,
+				.asserted = true
+			};
+			plan.changes[plan.count++] = (Change)
+			{
+				.position = interval->to,
+				.phase    = (uint8_t) phase,
+				.mask     = (uint8_t) mask,
+				.asserted = false
+			};
+		}
+	}
+
+	qsort(plan.changes, plan.count, sizeof(plan.changes[0]), compareChanges);
+
+	plan.position = 0;
+	plan.next     = 0;
+
+	while (plan.next < plan.count && plan.changes[plan.next].position == 0)
+	{
+		plan.next++;
+	}
+
+	plan.next = plan.count != 0 ? plan.next % plan.count : 0;
+}
+
+/* Writes the levels of the plan to the bits it owns, taking ownership of
+ * the bits of owned and releasing the others it held. While a preempt is
+ * active only the ownership is recorded.
+ */
+static void drive (const uint8_t owned[const MASK_COUNT][GROUPS],
+                   const bool dirty[const GROUPS])
+{
+	PhaseControlGroupEntry *const groups = asc.phase.phaseControlGroupTable;
+
+	preemptLock();
+
+	if (preemptActive())
+	{
+		memcpy(plan.owned, owned, sizeof(plan.owned));
+		plan.suspended = true;
+		preemptUnlock();
+		return;
+	}
+
+	plan.suspended = false;
+
+	for (size_t group = 0; group < asc.phase.maxPhaseGroups; group++)
+	{
+		if (!dirty[group])
+		{
+			continue;
+		}
+
+		PhaseControlGroupEntry *const entry = &groups[group];
+		uint8_t *const fields[MASK_COUNT] =
+		{
+			[MASK_HOLD]      = &entry->phaseControlGroupHold,
+			[MASK_FORCE_OFF] = &entry->phaseControlGroupForceOff,
+			[MASK_OMIT]      = &entry->phaseControlGroupPhaseOmit
+		};
+
+		for (size_t mask = 0; mask < MASK_COUNT; mask++)
+		{
+			const uint8_t value = (uint8_t)
+				((*fields[mask] & ~(plan.owned[mask][group]
+				                    | owned[mask][group]))
+				 | (plan.levels[mask][group] & owned[mask][group]));
+
+			if (*fields[mask] != value)
+			{
+				*fields[mask] = value;
+			}
+
+			plan.owned[mask][group] = owned[mask][group];
+		}
+	}
+
+	preemptUnlock();
+}
+
+/* Lays out pattern and takes over the masks of its phases, or releases
+ * every mask if pattern is not coordinated.
+ */
+static uint8_t rebuild (const uint8_t pattern, const uint8_t freeStatus)
+{
+	uint8_t status = freeStatus;
+	uint8_t owned[MASK_COUNT][GROUPS] = { { 0 } };
+	bool    dirty[GROUPS];
+
+	plan.cycle   = 0;
+	plan.pattern = pattern;
+
+	if (pattern != PATTERN_NONE && pattern < PATTERN_FREE)
+	{
+		status = layout(pattern);
+
+		if (status == LOCAL_FREE_NOT_FREE)
+		{
+			compile();
+
+			for (size_t phase = 0; phase < plan.phases; phase++)
+			{
+				const Slot *const slot = &plan.slots[phase];
+
+				/* Only coordinated phases are held. */
+				for (size_t mask = 0; slot->used && mask < MASK_COUNT;
+				     mask++)
+				{
+					if (mask != MASK_HOLD || slot->window.coordinated)
+					{
+						owned[mask][phase / 8] |= (uint8_t) (1u << (phase % 8));
+					}
+				}
+			}
+		}
+		else
+		{
+			plan.cycle = 0;
+		}
+	}
+	else if (pattern == PATTERN_FLASH)
+	{
+		status = LOCAL_FREE_OTHER;
+	}
+
+	memset(dirty, true, sizeof(dirty));
+	drive((const uint8_t (*)[GROUPS]) owned, dirty);
+
+	return status;
+}
+
+/* Applies the changes between the last position and position. */
+static void advance (const uint16_t position)
+{
+	const uint16_t distance = (uint16_t)
+		((position + plan.cycle - plan.position) % plan.cycle);
+	bool dirty[GROUPS] = { false };
+	bool changed       = false;
+
+	for (size_t step = 0; step < plan.count; step++)
+	{
+		const Change *const change = &plan.changes[plan.next];
+		const uint16_t      ahead  = (uint16_t)
+			((change->position + plan.cycle - plan.position) % plan.cycle);
+
+		if (ahead == 0 || ahead > distance)
+		{
+			break;
+		}
+
+		setLevel(change->mask, change->phase, change->asserted);
+		dirty[change->phase / 8] = true;
+		changed                  = true;
+		plan.next                = (plan.next + 1) % plan.count;
+	}
+
+	plan.position = position;
+
+	if (changed)
+	{
+		drive((const uint8_t (*)[GROUPS]) plan.owned, dirty);
+	}
+}
+
+void coordTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+	(void) now;
+
+	Coord              *const coord       = &asc.coord;
+	TimebaseAsc        *const timebaseAsc = &asc.timebaseAsc;
+	const CalendarTime *const date        = calendarNow();
+
+	const uint32_t tenths = date->secondOfDay * 10
+	                      + date->nanoseconds / (NANOSECONDS_PER_SECOND / 10);
+	const int64_t  minute = date->local / 60;
+
+	if (coord->systemSyncControl != UINT8_MAX)
+	{
+		coord->systemSyncControl = UINT8_MAX;
+		plan.reference           = tenths;
+		plan.resynced            = true;
+		plan.patternSync         = timebaseAsc->timebaseAscPatternSync;
+	}
+
+	if (!plan.resynced
+	 || plan.patternSync != timebaseAsc->timebaseAscPatternSync)
+	{
+		const uint16_t sync = timebaseAsc->timebaseAscPatternSync;
+
+		plan.reference   = sync < 24 * 60 ? sync * 600u : 0;
+		plan.patternSync = sync;
+		plan.resynced    = false;
+	}
+
+	const bool invalid = atomic_exchange_explicit(&stale, false,
+	                                              memory_order_acquire);
+
+	if (invalid || plan.stepped || minute != plan.minute)
+	{
+		uint8_t       freeStatus;
+		const uint8_t pattern = selectPattern(date, &freeStatus);
+
+		plan.minute  = minute;
+		plan.stepped = false;
+
+		if (invalid || pattern != plan.pattern)
+		{
+			const uint8_t status = rebuild(pattern, freeStatus);
+
+			coord->localFreeStatus    = status;
+			coord->coordPatternStatus =
+				status == LOCAL_FREE_NOT_FREE || pattern == PATTERN_FLASH
+				? pattern : PATTERN_FREE;
+		}
+	}
+
+	/* A preempt releases every mask when it ends; the plan takes its own
+	 * back on the first tick after.
+	 */
+	if (preemptActive())
+	{
+		plan.suspended = true;
+	}
+	else if (plan.suspended)
+	{
+		bool dirty[GROUPS];
+
+		memset(dirty, true, sizeof(dirty));
+		drive((const uint8_t (*)[GROUPS]) plan.owned, dirty);
+	}
+
+	const uint32_t sinceSync = (tenths + DECISECONDS_PER_DAY - plan.reference)
+	                         % DECISECONDS_PER_DAY;
+
+	if (plan.cycle == 0)
+	{
+		coord->coordCycleStatus = 0;
+		coord->coordSyncStatus  = 0;
+		return;
+	}
+
+	const uint16_t position = (uint16_t)
+		((sinceSync + plan.cycle - plan.offset % plan.cycle) % plan.cycle);
+
+	advance(position);
+
+	coord->coordCycleStatus = (uint16_t) ((plan.cycle - position + 9) / 10);
+	coord->coordSyncStatus  = (uint16_t) (sinceSync % plan.cycle / 10);
+}
+
+size_t coordPlan (CoordWindow windows[const], const size_t capacity,
+                  uint16_t *const cycle)
+{
+	size_t count = 0;
+
+	*cycle = plan.cycle;
+
+	for (size_t phase = 0; plan.cycle != 0 && phase < plan.phases
+	                       && count < capacity; phase++)
+	{
+		if (plan.slots[phase].used)
+		{
+			windows[count++] = plan.slots[phase].window;
+		}
+	}
+
+	return count;
+}
+
+/* The actuated controller: coordination, preemption and the detectors. */
+static bool ascInit (const DatabaseLimits *const limits)
+{
+	return coordInit(limits) && preemptInit(limits) && detectorInit(limits);
+}
+
+static void ascFree (void)
+{
+	detectorFree();
+	preemptFree();
+	coordFree();
+}
+
+/* Control objects select the pattern as much as database ones do. */
+static void ascInvalidate (const bool database)
+{
+	(void) database;
+
+	coordInvalidate();
+	preemptInvalidate();
+}
+
+/* Preemption runs after coordination so that it overrides it. */
+const Device ascDevice =
+{
+	.name       = "asc",
+	.subtree    = ASC_OID(),
+	.init       = ascInit,
+	.free       = ascFree,
+	.invalidate = ascInvalidate,
+	.ticks      = { detectorTick, coordTick, preemptTick },
+	.steps      = { coordStep, detectorStep }
+};
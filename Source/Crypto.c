@@ -0,0 +1,362 @@
+#include <Crypto.h>
+
+static inline uint32_t rotateLeft (const uint32_t value, const uint32_t bits)
+{
+	return value << bits | value >> (32 - bits);
+}
+
+static inline uint32_t loadBig (const uint8_t *const data)
+{
+	return (uint32_t) data[0] << 24 | (uint32_t) data[1] << 16
+	     | (uint32_t) data[2] << 8  | (uint32_t) data[3];
+}
+
+static inline void storeBig (uint8_t *const data, const uint32_t value)
+{
+	data[0] = (uint8_t) (value >> 24);
+	data[1] = (uint8_t) (value >> 16);
+	data[2] = (uint8_t) (value >> 8);
+	data[3] = (uint8_t) value;
+}
+
+void sha1Init (SHA1 *const sha)
+{
+	*sha = (SHA1)
+	{
+		.state = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+		           0xC3D2E1F0 }
+	};
+}
+
+/* Each round takes f of b, c and d and a constant. The message schedule is
+ * kept as a ring of sixteen words, worked out as the rounds need them, and
+ * the rounds are unrolled by group so that f is never chosen at run time.
+ */
+#define CHOOSE(b, c, d)   (((b) & (c)) | (~(b) & (d)))
+#define PARITY(b, c, d)   ((b) ^ (c) ^ (d))
+#define MAJORITY(b, c, d) (((b) & (c)) | ((b) & (d)) | ((c) & (d)))
+
+#define SCHEDULE(w, i)                                                         \
+	((w)[(i) & 15] = rotateLeft((w)[((i) + 13) & 15] ^ (w)[((i) + 8) & 15]    \
+	                            ^ (w)[((i) + 2) & 15] ^ (w)[(i) & 15], 1))
+
+#define ROUNDS(f, k, first, last)                                              \
+	for (size_t index = (first); index < (last); index++)                      \
+	{                                                                          \
+		const uint32_t word = index < 16 ? w[index] : SCHEDULE(w, index);      \
+		const uint32_t t    = rotateLeft(a, 5) + f(b, c, d) + e + (k) + word;  \
+                                                                               \
+		e = d;                                                                 \
+		d = c;                                                                 \
+		c = rotateLeft(b, 30);                                                 \
+		b = a;                                                                 \
+		a = t;                                                                 \
+	}
+
+static void compress (uint32_t state[const 5], const uint8_t *const block)
+{
+	uint32_t w[16];
+
+	for (size_t index = 0; index < 16; index++)
+	{
+		w[index] = loadBig(block + 4 * index);
+	}
+
+	uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+	         e = state[4];
+
+	ROUNDS(CHOOSE,   0x5A827999, 0,  20)
+	ROUNDS(PARITY,   0x6ED9EBA1, 20, 40)
+	ROUNDS(MAJORITY, 0x8F1BBCDC, 40, 60)
+	ROUNDS(PARITY,   0xCA62C1D6, 60, 80)
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+void sha1Update (SHA1 *const sha, const void *const data, size_t length)
+{
+	const uint8_t *octets = data;
+	size_t         used   = sha->length % SHA1_BLOCK_OCTETS;
+
+	sha->length += length;
+
+	if (used != 0)
+	{
+		const size_t taken = MIN(length, SHA1_BLOCK_OCTETS - used);
+
+		memcpy(sha->block + used, octets, taken);
+		octets += taken;
+		length -= taken;
+		used   += taken;
+
+		if (used < SHA1_BLOCK_OCTETS)
+		{
+			return;
+		}
+
+		compress(sha->state, sha->block);
+	}
+
+	for (; length >= SHA1_BLOCK_OCTETS; length -= SHA1_BLOCK_OCTETS)
+	{
+		compress(sha->state, octets);
+		octets += SHA1_BLOCK_OCTETS;
+	}
+
+	memcpy(sha->block, octets, length);
+}
+
+void sha1Final (SHA1 *const sha, uint8_t digest[const SHA1_DIGEST_OCTETS])
+{
+	const uint64_t bits = sha->length * 8;
+	const size_t   used = sha->length % SHA1_BLOCK_OCTETS;
+	uint8_t        tail[2 * SHA1_BLOCK_OCTETS] = { 0x80 };
+	const size_t   pad  = (used < 56 ? 56 : 120) - used;
+
+	for (size_t index = 0; index < 8; index++)
+	{
+		tail[pad + index] = (uint8_t) (bits >> (56 - 8 * index));
+	}
+
+	sha1Update(sha, tail, pad + 8);
+
+	for (size_t index = 0; index < 5; index++)
+	{
+		storeBig(digest + 4 * index, sha->state[index]);
+	}
+}
+
+void hmacKey (HMAC *const hmac, const uint8_t *const key, const size_t length)
+{
+	uint8_t inner[SHA1_BLOCK_OCTETS] = { 0 };
+	uint8_t outer[SHA1_BLOCK_OCTETS];
+
+	if (length > SHA1_BLOCK_OCTETS)
+	{
+		SHA1 sha;
+
+		sha1Init(&sha);
+		sha1Update(&sha, key, length);
+		sha1Final(&sha, inner);
+	}
+	else
+	{
+		memcpy(inner, key, length);
+	}
+
+	for (size_t index = 0; index < SHA1_BLOCK_OCTETS; index++)
+	{
+		outer[index]  = inner[index] ^ 0x5C;
+		inner[index] ^= 0x36;
+	}
+
+	sha1Init(&hmac->inner);
+	sha1Update(&hmac->inner, inner, sizeof(inner));
+	sha1Init(&hmac->outer);
+	sha1Update(&hmac->outer, outer, sizeof(outer));
+}
+
+void hmacFinal (const HMAC *const hmac, SHA1 *const inner,
+                uint8_t digest[const SHA1_DIGEST_OCTETS])
+{
+	SHA1 outer = hmac->outer;
+
+	sha1Final(inner, digest);
+	sha1Update(&outer, digest, SHA1_DIGEST_OCTETS);
+	sha1Final(&outer, digest);
+}
+
+/* The S-box and the round tables, which combine SubBytes, ShiftRows and
+ * MixColumns into four lookups per column. They are derived once from the
+ * field arithmetic rather than written out.
+ */
+static uint8_t  sbox[256];
+static uint32_t tables[4][256];
+static once_flag built = ONCE_FLAG_INIT;
+
+static inline uint8_t rotate8 (const uint8_t value, const uint32_t bits)
+{
+	return (uint8_t) (value << bits | value >> (8 - bits));
+}
+
+static inline uint8_t times2 (const uint8_t value)
+{
+	return (uint8_t) (value << 1 ^ (value & 0x80 ? 0x1B : 0));
+}
+
+static void build (void)
+{
+	uint8_t p = 1, q = 1;
+
+	/* p runs over the multiplicative group by powers of 3 and q over the
+	 * inverses, by powers of 3^-1.
+	 */
+	do
+	{
+		p = p ^ times2(p);
+
+		q ^= q << 1;
+		q ^= q << 2;
+		q ^= q << 4;
+		q ^= q & 0x80 ? 0x09 : 0;
+
+		sbox[p] = q ^ rotate8(q, 1) ^ rotate8(q, 2) ^ rotate8(q, 3)
+		        ^ rotate8(q, 4) ^ 0x63;
+	}
+	while (p != 1);
+
+	sbox[0] = 0x63;
+
+	for (size_t index = 0; index < 256; index++)
+	{
+		const uint8_t  s    = sbox[index];
+		const uint32_t word = (uint32_t) times2(s) << 24 | (uint32_t) s << 16
+		                    | (uint32_t) s << 8 | (uint32_t) (times2(s) ^ s);
+
+		tables[0][index] = word;
+		tables[1][index] = word >> 8  | word << 24;
+		tables[2][index] = word >> 16 | word << 16;
+		tables[3][index] = word >> 24 | word << 8;
+	}
+}
+
+static inline uint32_t substitute (const uint32_t word)
+{
+	return (uint32_t) sbox[word >> 24] << 24
+	     | (uint32_t) sbox[word >> 16 & 0xFF] << 16
+	     | (uint32_t) sbox[word >> 8 & 0xFF] << 8
+	     | (uint32_t) sbox[word & 0xFF];
+}
+
+void aesKey (AES *const aes, const uint8_t key[const AES_KEY_OCTETS])
+{
+	uint8_t constant = 1;
+
+	call_once(&built, build);
+
+	for (size_t index = 0; index < 4; index++)
+	{
+		aes->keys[index] = loadBig(key + 4 * index);
+	}
+
+	for (size_t index = 4; index < 44; index++)
+	{
+		uint32_t word = aes->keys[index - 1];
+
+		if (index % 4 == 0)
+		{
+			word     = substitute(rotateLeft(word, 8))
+			         ^ (uint32_t) constant << 24;
+			constant = times2(constant);
+		}
+
+		aes->keys[index] = aes->keys[index - 4] ^ word;
+	}
+}
+
+void aesEncrypt (const AES *const aes,
+                 const uint8_t input[const AES_BLOCK_OCTETS],
+                 uint8_t output[const AES_BLOCK_OCTETS])
+{
+	const uint32_t *key = aes->keys;
+	uint32_t s0 = loadBig(input)      ^ key[0];
+	uint32_t s1 = loadBig(input + 4)  ^ key[1];
+	uint32_t s2 = loadBig(input + 8)  ^ key[2];
+	uint32_t s3 = loadBig(input + 12) ^ key[3];
+
+	for (size_t round = 1; round < 10; round++)
+	{
+		key += 4;
+
+		const uint32_t t0 = tables[0][s0 >> 24] ^ tables[1][s1 >> 16 & 0xFF]
+		                  ^ tables[2][s2 >> 8 & 0xFF] ^ tables[3][s3 & 0xFF]
+		                  ^ key[0];
+		const uint32_t t1 = tables[0][s1 >> 24] ^ tables[1][s2 >> 16 & 0xFF]
+		                  ^ tables[2][s3 >> 8 & 0xFF] ^ tables[3][s0 & 0xFF]
+		                  ^ key[1];
+		const uint32_t t2 = tables[0][s2 >> 24] ^ tables[1][s3 >> 16 & 0xFF]
+		                  ^ tables[2][s0 >> 8 & 0xFF] ^ tables[3][s1 & 0xFF]
+		                  ^ key[2];
+		const uint32_t t3 = tables[0][s3 >> 24] ^ tables[1][s0 >> 16 & 0xFF]
+		                  ^ tables[2][s1 >> 8 & 0xFF] ^ tables[3][s2 & 0xFF]
+		                  ^ key[3];
+
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	key += 4;
+
+	/* The last round has no MixColumns. */
+	storeBig(output,      (uint32_t) sbox[s0 >> 24] << 24
+	                    ^ (uint32_t) sbox[s1 >> 16 & 0xFF] << 16
+	                    ^ (uint32_t) sbox[s2 >> 8 & 0xFF] << 8
+	                    ^ (uint32_t) sbox[s3 & 0xFF] ^ key[0]);
+	storeBig(output + 4,  (uint32_t) sbox[s1 >> 24] << 24
+	                    ^ (uint32_t) sbox[s2 >> 16 & 0xFF] << 16
+	                    ^ (uint32_t) sbox[s3 >> 8 & 0xFF] << 8
+	                    ^ (uint32_t) sbox[s0 & 0xFF] ^ key[1]);
+	storeBig(output + 8,  (uint32_t) sbox[s2 >> 24] << 24
+	                    ^ (uint32_t) sbox[s3 >> 16 & 0xFF] << 16
+	                    ^ (uint32_t) sbox[s0 >> 8 & 0xFF] << 8
+	                    ^ (uint32_t) sbox[s1 & 0xFF] ^ key[2]);
+	storeBig(output + 12, (uint32_t) sbox[s3 >> 24] << 24
+	                    ^ (uint32_t) sbox[s0 >> 16 & 0xFF] << 16
+	                    ^ (uint32_t) sbox[s1 >> 8 & 0xFF] << 8
+	                    ^ (uint32_t) sbox[s2 & 0xFF] ^ key[3]);
+}
+
+/* In CFB mode the cipher only ever enciphers the feedback, which is the
+ * ciphertext whichever way the data goes.
+ */
+void aesEncryptCFB (const AES *const aes,
+                    const uint8_t iv[const AES_BLOCK_OCTETS],
+                    uint8_t *const data, const size_t length)
+{
+	uint8_t feedback[AES_BLOCK_OCTETS];
+
+	memcpy(feedback, iv, sizeof(feedback));
+
+	for (size_t offset = 0; offset < length; offset += AES_BLOCK_OCTETS)
+	{
+		const size_t count = MIN(length - offset, (size_t) AES_BLOCK_OCTETS);
+
+		aesEncrypt(aes, feedback, feedback);
+
+		for (size_t index = 0; index < count; index++)
+		{
+			data[offset + index] ^= feedback[index];
+			feedback[index]       = data[offset + index];
+		}
+	}
+}
+
+void aesDecryptCFB (const AES *const aes,
+                    const uint8_t iv[const AES_BLOCK_OCTETS],
+                    uint8_t *const data, const size_t length)
+{
+	uint8_t feedback[AES_BLOCK_OCTETS];
+
+	memcpy(feedback, iv, sizeof(feedback));
+
+	for (size_t offset = 0; offset < length; offset += AES_BLOCK_OCTETS)
+	{
+		const size_t count = MIN(length - offset, (size_t) AES_BLOCK_OCTETS);
+
+		aesEncrypt(aes, feedback, feedback);
+
+		for (size_t index = 0; index < count; index++)
+		{
+			const uint8_t cipher = data[offset + index];
+
+			data[offset + index] ^= feedback[index];
+			feedback[index]       = cipher;
+		}
+	}
+}
@@ -0,0 +1,533 @@
+#include <Database.h>
+
+Global global =
+{
+	.globalDBManagement =
+	{
+		.dbCreateTransaction = NORMAL,
+		.dbErrorType         = noError,
+		.dbVerifyStatus      = notDone
+	},
+
+	.globalTimeManagement =
+	{
+		.globalDaylightSaving = disableDST
+	}
+};
+
+ASC asc;
+DMS dms;
+ESS ess;
+TSS tss;
+RSU rsu;
+RMC rmc;
+
+const ObjectTree database =
+{
+	.global = &global, .asc = &asc, .dms = &dms, .ess = &ess, .tss = &tss,
+	.rsu    = &rsu,    .rmc = &rmc
+};
+
+static pthread_mutex_t lock;
+
+/* The module row describing this software. Its members are const, so it is
+ * copied into the table rather than assigned.
+ */
+static const ModuleTableEntry softwareModule =
+{
+	.moduleNumber     = 1,
+	.moduleDeviceNode = "1.3.6.1.4.1.1206.4.2.1",
+	.moduleType       = MODULE_TYPE_SOFTWARE
+};
+
+bool databaseInitTree (const ObjectTree *const tree,
+                       const DatabaseLimits *const limits)
+{
+	GlobalConfiguration *const configuration =
+		&tree->global->globalConfiguration;
+	Timebase            *const timebase      =
+		&tree->global->globalTimeManagement.timebase;
+	DaylightSavingNode  *const daylightSaving =
+		&tree->global->globalTimeManagement.daylightSavingNode;
+	AuxIOv2             *const auxIOv2       = &tree->global->auxIOv2;
+	Phase               *const phase         = &tree->asc->phase;
+	Detector            *const detector      = &tree->asc->detector;
+	Coord               *const coord         = &tree->asc->coord;
+	TimebaseAsc         *const timebaseAsc   = &tree->asc->timebaseAsc;
+	Preempt             *const preempt       = &tree->asc->preempt;
+	FontDefinition      *const fonts         = &tree->dms->fontDefinition;
+	DmsMessage          *const messages      = &tree->dms->dmsMessage;
+	EssTemperature      *const temperature   = &tree->ess->essTemperature;
+	EssPavement         *const pavement      = &tree->ess->essPavement;
+	SensorZones         *const zones         = &tree->tss->sensorZones;
+	VehicleClasses      *const classes       = &tree->tss->vehicleClasses;
+	SampleData          *const samples       = &tree->tss->sampleData;
+	RsuIFM              *const forwards      = &tree->rsu->rsuIFM;
+	RmcMainline         *const mainline      = &tree->rmc->rmcMainline;
+	RmcMeteredLane      *const metered       = &tree->rmc->rmcMeteredLane;
+	RmcTrafficResponsive *const levels =
+		&tree->rmc->rmcTrafficResponsive;
+
+	const size_t dayPlanRows = (size_t) limits->maxDayPlans
+	                         * limits->maxDayPlanEvents;
+	const size_t auxIOv2Rows = (size_t) limits->maxAuxIOv2TableNumDigitalPorts
+	                         + limits->maxAuxIOv2TableNumAnalogPorts;
+	const size_t splitRows   = (size_t) limits->maxSplits * limits->maxPhases;
+
+	const size_t characterRows = (size_t) limits->numFonts
+	                           * limits->maxFontCharacters;
+	const size_t messageRows   = (size_t) MEMORY_TYPE_CHANGEABLE
+	                           * limits->dmsMaxChangeableMsg;
+	const size_t zoneClassRows = (size_t) limits->numSensorZones
+	                           * limits->numVehicleClasses;
+
+	configuration->globalMaxModules          = limits->globalMaxModules;
+	timebase->maxTimeBaseScheduleEntries     =
+		limits->maxTimeBaseScheduleEntries;
+	timebase->maxDayPlans                    = limits->maxDayPlans;
+	timebase->maxDayPlanEvents               = limits->maxDayPlanEvents;
+	daylightSaving->maxDaylightSavingEntries =
+		limits->maxDaylightSavingEntries;
+	auxIOv2->maxAuxIOv2TableNumDigitalPorts  =
+		limits->maxAuxIOv2TableNumDigitalPorts;
+	auxIOv2->maxAuxIOv2TableNumAnalogPorts   =
+		limits->maxAuxIOv2TableNumAnalogPorts;
+	phase->maxPhases                         = limits->maxPhases;
+	phase->maxPhaseGroups                    = CONFIG_GROUPS(limits->maxPhases);
+	detector->maxVehicleDetectors            = limits->maxVehicleDetectors;
+	detector->maxVehicleDetectorStatusGroups =
+		CONFIG_GROUPS(limits->maxVehicleDetectors);
+	detector->maxPedestrianDetectors         = limits->maxPedestrianDetectors;
+	detector->volumeOccupancyReport.activeVolumeOccupancyDetectors =
+		limits->maxVehicleDetectors;
+	coord->maxPatterns                       = limits->maxPatterns;
+	coord->maxSplits                         = limits->maxSplits;
+	coord->coordCorrectionMode               = COORD_CORRECTION_SHORTWAY;
+	coord->coordMaximumMode                  = COORD_MAXIMUM_1;
+	coord->coordForceMode                    = COORD_FORCE_FIXED;
+	coord->patternTableType                  = PATTERN_TABLE_PATTERNS;
+	coord->localFreeStatus                   = LOCAL_FREE_NOT_FREE;
+	coord->systemSyncControl                 = UINT8_MAX;
+	timebaseAsc->maxTimebaseAscActions       = limits->maxTimebaseAscActions;
+	preempt->maxPreempts                     = limits->maxPreempts;
+	fonts->numFonts                          = limits->numFonts;
+	fonts->maxFontCharacters                 = limits->maxFontCharacters;
+	messages->dmsMaxChangeableMsg            = limits->dmsMaxChangeableMsg;
+	temperature->essNumTemperatureSensors    =
+		limits->essNumTemperatureSensors;
+	pavement->numEssPavementSensors          = limits->numEssPavementSensors;
+	zones->numSensorZones                    = limits->numSensorZones;
+	classes->numVehicleClasses               = limits->numVehicleClasses;
+	forwards->maxRsuIFMs                     = limits->maxRsuIFMs;
+	mainline->rmcMaxNumMainlineLanes         = limits->rmcMaxNumMainlineLanes;
+	metered->rmcMaxNumMeteredLanes           = limits->rmcMaxNumMeteredLanes;
+	levels->rmcMaxNumTRLevels                = limits->rmcMaxNumTRLevels;
+	tree->rmc->rmcGeneralConfiguration.rmcCalcInterval = 30;
+
+	if (!PROVIDE(configuration->globalModuleTable,
+	             configuration->globalMaxModules)
+	 || !PROVIDE(timebase->timeBaseScheduleTable,
+	             timebase->maxTimeBaseScheduleEntries)
+	 || !PROVIDE(timebase->timeBaseDayPlanTable, dayPlanRows)
+	 || !PROVIDE(daylightSaving->dstTable,
+	             daylightSaving->maxDaylightSavingEntries)
+	 || !PROVIDE(auxIOv2->auxIOv2Table, auxIOv2Rows)
+	 || !PROVIDE(phase->phaseTable, phase->maxPhases)
+	 || !PROVIDE(phase->phaseStatusGroupTable, phase->maxPhaseGroups)
+	 || !PROVIDE(phase->phaseControlGroupTable, phase->maxPhaseGroups)
+	 || !PROVIDE(detector->vehicleDetectorTable,
+	             detector->maxVehicleDetectors)
+	 || !PROVIDE(detector->vehicleDetectorStatusGroupTable,
+	             detector->maxVehicleDetectorStatusGroups)
+	 || !PROVIDE(detector->volumeOccupancyReport.volumeOccupancyTable,
+	             detector->maxVehicleDetectors)
+	 || !PROVIDE(detector->pedestrianDetectorTable,
+	             detector->maxPedestrianDetectors)
+	 || !PROVIDE(coord->patternTable, coord->maxPatterns)
+	 || !PROVIDE(coord->splitTable, splitRows)
+	 || !PROVIDE(timebaseAsc->timebaseAscActionTable,
+	             timebaseAsc->maxTimebaseAscActions)
+	 || !PROVIDE(preempt->preemptTable, preempt->maxPreempts)
+	 || !PROVIDE(preempt->preemptControlTable, preempt->maxPreempts)
+	 || !PROVIDE(fonts->fontTable, fonts->numFonts)
+	 || !PROVIDE(fonts->characterTable, characterRows)
+	 || !PROVIDE(messages->dmsMessageTable, messageRows)
+	 || !PROVIDE(temperature->essTemperatureSensorTable,
+	             temperature->essNumTemperatureSensors)
+	 || !PROVIDE(pavement->essPavementSensorTable,
+	             pavement->numEssPavementSensors)
+	 || !PROVIDE(zones->sensorZoneTable, zones->numSensorZones)
+	 || !PROVIDE(classes->vehicleClassTable, classes->numVehicleClasses)
+	 || !PROVIDE(samples->zoneSampleTable, zones->numSensorZones)
+	 || !PROVIDE(samples->zoneClassTable, zoneClassRows)
+	 || !PROVIDE(forwards->rsuIFMTable, forwards->maxRsuIFMs)
+	 || !PROVIDE(mainline->rmcMainlineLaneTable,
+	             mainline->rmcMaxNumMainlineLanes)
+	 || !PROVIDE(metered->rmcMeteredLaneTable,
+	             metered->rmcMaxNumMeteredLanes)
+	 || !PROVIDE(levels->rmcTRLevelTable, levels->rmcMaxNumTRLevels))
+	{
+		databaseFreeTree(tree);
+		return false;
+	}
+
+	/* Index objects are read-only and equal to the row position. */
+	for (uint8_t row = 0; row < configuration->globalMaxModules; row++)
+	{
+		const ModuleTableEntry module = { .moduleNumber = row + 1 };
+
+		memcpy(&configuration->globalModuleTable[row], &module,
+		       sizeof(module));
+	}
+
+	for (uint16_t row = 0; row < timebase->maxTimeBaseScheduleEntries; row++)
+	{
+		timebase->timeBaseScheduleTable[row].timeBaseScheduleNumber = row + 1;
+	}
+
+	for (size_t row = 0; row < dayPlanRows; row++)
+	{
+		TimeBaseDayPlanEntry *const entry =
+			&timebase->timeBaseDayPlanTable[row];
+
+		entry->dayPlanNumber      = row / timebase->maxDayPlanEvents + 1;
+		entry->dayPlanEventNumber = row % timebase->maxDayPlanEvents + 1;
+	}
+
+	for (uint8_t row = 0; row < daylightSaving->maxDaylightSavingEntries; row++)
+	{
+		daylightSaving->dstTable[row].dstEntryNumber = row + 1;
+		daylightSaving->dstTable[row].dstBeginMonth  = DISABLED;
+	}
+
+	/* Digital ports first, then analog, each numbered from one. */
+	for (size_t row = 0; row < auxIOv2Rows; row++)
+	{
+		AuxIOv2Entry *const entry   = &auxIOv2->auxIOv2Table[row];
+		const bool          digital =
+			row < auxIOv2->maxAuxIOv2TableNumDigitalPorts;
+
+		entry->auxIOv2PortType       = digital ? PORT_TYPE_DIGITAL
+		                                       : PORT_TYPE_ANALOG;
+		entry->auxIOv2PortNumber     = digital
+			? row + 1
+			: row - auxIOv2->maxAuxIOv2TableNumDigitalPorts + 1;
+		entry->auxIOv2PortResolution = digital ? 1 : 0;
+		entry->auxIOv2PortDirection  = PORT_DIRECTION_INPUT;
+	}
+
+	for (uint8_t row = 0; row < phase->maxPhases; row++)
+	{
+		phase->phaseTable[row].phaseNumber = row + 1;
+	}
+
+	for (uint8_t row = 0; row < phase->maxPhaseGroups; row++)
+	{
+		phase->phaseStatusGroupTable[row].phaseStatusGroupNumber   = row + 1;
+		phase->phaseControlGroupTable[row].phaseControlGroupNumber = row + 1;
+	}
+
+	for (uint8_t row = 0; row < detector->maxVehicleDetectors; row++)
+	{
+		detector->vehicleDetectorTable[row].vehicleDetectorNumber = row + 1;
+	}
+
+	for (uint8_t row = 0; row < detector->maxVehicleDetectorStatusGroups; row++)
+	{
+		detector->vehicleDetectorStatusGroupTable[row]
+			.vehicleDetectorStatusGroupNumber = row + 1;
+	}
+
+	for (uint8_t row = 0; row < detector->maxPedestrianDetectors; row++)
+	{
+		detector->pedestrianDetectorTable[row].pedestrianDetectorNumber =
+			row + 1;
+	}
+
+	for (uint8_t row = 0; row < coord->maxPatterns; row++)
+	{
+		coord->patternTable[row].patternNumber = row + 1;
+	}
+
+	for (size_t row = 0; row < splitRows; row++)
+	{
+		SplitEntry *const entry = &coord->splitTable[row];
+
+		entry->splitNumber = row / phase->maxPhases + 1;
+		entry->splitPhase  = row % phase->maxPhases + 1;
+		entry->splitMode   = SPLIT_MODE_NONE;
+	}
+
+	for (uint8_t row = 0; row < timebaseAsc->maxTimebaseAscActions; row++)
+	{
+		timebaseAsc->timebaseAscActionTable[row].timebaseAscActionNumber =
+			row + 1;
+	}
+
+	for (uint8_t row = 0; row < preempt->maxPreempts; row++)
+	{
+		PreemptEntry *const entry = &preempt->preemptTable[row];
+
+		entry->preemptNumber = row + 1;
+		entry->preemptState  = PREEMPT_STATE_NOT_ACTIVE;
+		preempt->preemptControlTable[row].preemptControlNumber = row + 1;
+	}
+
+	for (uint8_t row = 0; row < fonts->numFonts; row++)
+	{
+		FontEntry *const entry = &fonts->fontTable[row];
+
+		entry->fontIndex  = row + 1;
+		entry->fontNumber = row + 1;
+		entry->fontStatus = FONT_STATUS_NOT_USED;
+	}
+
+	for (size_t row = 0; row < characterRows; row++)
+	{
+		fonts->characterTable[row].characterNumber =
+			row % fonts->maxFontCharacters + 1;
+	}
+
+	/* Rows of the memory types before changeable stay not used. */
+	for (size_t row = 0; row < messageRows; row++)
+	{
+		DmsMessageEntry *const entry = &messages->dmsMessageTable[row];
+
+		entry->dmsMessageMemoryType = row / messages->dmsMaxChangeableMsg + 1;
+		entry->dmsMessageNumber     = row % messages->dmsMaxChangeableMsg + 1;
+		entry->dmsMessageStatus     = MESSAGE_STATUS_NOT_USED;
+	}
+
+	for (uint8_t row = 0; row < temperature->essNumTemperatureSensors; row++)
+	{
+		EssTemperatureSensorEntry *const entry =
+			&temperature->essTemperatureSensorTable[row];
+
+		entry->essTemperatureSensorIndex = row + 1;
+		entry->essAirTemperature         = ESS_TEMPERATURE_MISSING;
+	}
+
+	for (uint8_t row = 0; row < pavement->numEssPavementSensors; row++)
+	{
+		EssPavementSensorEntry *const entry =
+			&pavement->essPavementSensorTable[row];
+
+		entry->essPavementSensorIndex = row + 1;
+		entry->essSurfaceTemperature  = ESS_TEMPERATURE_MISSING;
+		entry->essPavementTemperature = ESS_TEMPERATURE_MISSING;
+	}
+
+	for (uint16_t row = 0; row < zones->numSensorZones; row++)
+	{
+		zones->sensorZoneTable[row].sensorZoneNumber   = row + 1;
+		zones->sensorZoneTable[row].sensorZoneEnable   = 1;
+		samples->zoneSampleTable[row].zoneSampleNumber = row + 1;
+		samples->zoneSampleTable[row].zoneSampleSpeed  = TSS_SPEED_MISSING;
+	}
+
+	for (uint8_t row = 0; row < classes->numVehicleClasses; row++)
+	{
+		classes->vehicleClassTable[row].vehicleClassNumber = row + 1;
+	}
+
+	for (uint16_t row = 0; row < forwards->maxRsuIFMs; row++)
+	{
+		forwards->rsuIFMTable[row].rsuIFMIndex  = row + 1;
+		forwards->rsuIFMTable[row].rsuIFMStatus = ROW_STATUS_NOT_READY;
+	}
+
+	for (uint8_t row = 0; row < mainline->rmcMaxNumMainlineLanes; row++)
+	{
+		mainline->rmcMainlineLaneTable[row].rmcMainlineLaneIndex = row + 1;
+	}
+
+	/* Lanes are dark until configured, between one vehicle every 15 and
+	 * every 4 seconds.
+	 */
+	for (uint8_t row = 0; row < metered->rmcMaxNumMeteredLanes; row++)
+	{
+		RmcMeteredLaneEntry *const entry = &metered->rmcMeteredLaneTable[row];
+
+		entry->rmcMeteredLaneIndex = row + 1;
+		entry->rmcMeterMode        = RMC_METER_DARK;
+		entry->rmcMinMeterRate     = 240;
+		entry->rmcMaxMeterRate     = 900;
+		entry->rmcCmdRate          = 900;
+	}
+
+	for (uint8_t row = 0; row < levels->rmcMaxNumTRLevels; row++)
+	{
+		levels->rmcTRLevelTable[row].rmcTRLevelIndex = row + 1;
+	}
+
+	return true;
+}
+
+bool databaseInit (const DatabaseLimits *const limits)
+{
+	pthread_mutexattr_t attributes;
+
+	if (pthread_mutexattr_init(&attributes) != 0
+	 || pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT) != 0
+	 || pthread_mutex_init(&lock, &attributes) != 0)
+	{
+		return false;
+	}
+
+	pthread_mutexattr_destroy(&attributes);
+
+	if (!databaseInitTree(&database, limits))
+	{
+		return false;
+	}
+
+	if (global.globalConfiguration.globalMaxModules != 0)
+	{
+		memcpy(&global.globalConfiguration.globalModuleTable[0],
+		       &softwareModule, sizeof(softwareModule));
+	}
+
+	/* An amber LED matrix, unlit black. */
+	static const uint8_t amber[6] = { 0, 0, 0, 255, 176, 0 };
+
+	dms.dmsSignCfg = (DmsSignCfg)
+	{
+		.dmsSignAccess     = 8,
+		.dmsSignType       = 6,
+		.dmsSignTechnology = 2
+	};
+
+	dms.vmsCfg.vmsSignHeightPixels = CONFIG_SIGN_HEIGHT_PIXELS;
+	dms.vmsCfg.vmsSignWidthPixels  = CONFIG_SIGN_WIDTH_PIXELS;
+
+	dms.fontDefinition.fontMaxCharacterSize = UINT8_MAX;
+
+	dms.multiCfg = (MultiCfg)
+	{
+		.defaultForegroundColor   = 1,
+		.defaultFlashOn           = 5,
+		.defaultFlashOff          = 5,
+		.defaultFont              = 1,
+		.defaultJustificationLine = JUSTIFICATION_CENTER,
+		.defaultJustificationPage = JUSTIFICATION_CENTER,
+		.defaultPageOnTime        = 30,
+		.defaultCharacterSet      = 1
+	};
+
+	dms.signControl.dmsControlMode = 4;
+
+	/* A permanent weather station with nothing measured yet. */
+	ess.essNtcip.essNtcipCategory = 1;
+	ess.essNtcip.essTypeofStation = 2;
+
+	ess.essAtmosphere = (EssAtmosphere)
+	{
+		.essAtmosphericPressure = ESS_PRESSURE_MISSING,
+		.essAvgWindDirection    = ESS_DIRECTION_MISSING,
+		.essAvgWindSpeed        = ESS_SPEED_MISSING,
+		.essMaxWindGustSpeed    = ESS_SPEED_MISSING,
+		.essMaxWindGustDir      = ESS_DIRECTION_MISSING,
+		.essSpotWindDirection   = ESS_DIRECTION_MISSING,
+		.essSpotWindSpeed       = ESS_SPEED_MISSING,
+		.essMaxTemp             = ESS_TEMPERATURE_MISSING,
+		.essMinTemp             = ESS_TEMPERATURE_MISSING,
+		.essRelativeHumidity    = ESS_HUMIDITY_MISSING,
+		.essVisibility          = ESS_VISIBILITY_MISSING
+	};
+
+	return octetStringSet(&dms.vmsCfg.monochromeColor, amber, sizeof(amber))
+	    && octetStringSetText(&rsu.rsuSysDescription.rsuMibVersion,
+	                          "NTCIP 1218 v01")
+	    && octetStringSetText(&global.globalConfiguration
+	                                    .controllerBaseStandards,
+	                          "NTCIP 1201:v03\r\nNTCIP 1202:v03\r\n"
+	                          "NTCIP 1203:v03\r\nNTCIP 1204:v03\r\n"
+	                          "NTCIP 1207:v02\r\nNTCIP 1209:v02\r\n"
+	                          "NTCIP 1218:v01");
+}
+
+void databaseFreeTree (const ObjectTree *const tree)
+{
+#ifndef STATIC_STORAGE
+	Global *const global = tree->global;
+	ASC    *const asc    = tree->asc;
+	DMS    *const dms    = tree->dms;
+	ESS    *const ess    = tree->ess;
+	TSS    *const tss    = tree->tss;
+	RSU    *const rsu    = tree->rsu;
+	RMC    *const rmc    = tree->rmc;
+
+	free(global->globalConfiguration.globalModuleTable);
+	free(global->globalTimeManagement.timebase.timeBaseScheduleTable);
+	free(global->globalTimeManagement.timebase.timeBaseDayPlanTable);
+	free(global->globalTimeManagement.daylightSavingNode.dstTable);
+	free(global->auxIOv2.auxIOv2Table);
+	free(asc->phase.phaseTable);
+	free(asc->phase.phaseStatusGroupTable);
+	free(asc->phase.phaseControlGroupTable);
+	free(asc->detector.vehicleDetectorTable);
+	free(asc->detector.vehicleDetectorStatusGroupTable);
+	free(asc->detector.volumeOccupancyReport.volumeOccupancyTable);
+	free(asc->detector.pedestrianDetectorTable);
+	free(asc->coord.patternTable);
+	free(asc->coord.splitTable);
+	free(asc->timebaseAsc.timebaseAscActionTable);
+	free(asc->preempt.preemptTable);
+	free(asc->preempt.preemptControlTable);
+	free(dms->fontDefinition.fontTable);
+	free(dms->fontDefinition.characterTable);
+	free(dms->dmsMessage.dmsMessageTable);
+	free(ess->essTemperature.essTemperatureSensorTable);
+	free(ess->essPavement.essPavementSensorTable);
+	free(tss->sensorZones.sensorZoneTable);
+	free(tss->vehicleClasses.vehicleClassTable);
+	free(tss->sampleData.zoneSampleTable);
+	free(tss->sampleData.zoneClassTable);
+	free(rsu->rsuIFM.rsuIFMTable);
+	free(rmc->rmcMainline.rmcMainlineLaneTable);
+	free(rmc->rmcMeteredLane.rmcMeteredLaneTable);
+	free(rmc->rmcTrafficResponsive.rmcTRLevelTable);
+
+	global->globalConfiguration.globalModuleTable              = NULL;
+	global->globalTimeManagement.timebase.timeBaseScheduleTable = NULL;
+	global->globalTimeManagement.timebase.timeBaseDayPlanTable  = NULL;
+	global->globalTimeManagement.daylightSavingNode.dstTable    = NULL;
+	global->auxIOv2.auxIOv2Table                                = NULL;
+	asc->phase.phaseTable                                       = NULL;
+	asc->phase.phaseStatusGroupTable                            = NULL;
+	asc->phase.phaseControlGroupTable                           = NULL;
+	asc->detector.vehicleDetectorTable                          = NULL;
+	asc->detector.vehicleDetectorStatusGroupTable               = NULL;
+	asc->detector.volumeOccupancyReport.volumeOccupancyTable    = NULL;
+	asc->detector.pedestrianDetectorTable                       = NULL;
+	asc->coord.patternTable                                     = NULL;
+	asc->coord.splitTable                                       = NULL;
+	asc->timebaseAsc.timebaseAscActionTable                     = NULL;
+	asc->preempt.preemptTable                                   = NULL;
+	asc->preempt.preemptControlTable                            = NULL;
+	dms->fontDefinition.fontTable                               = NULL;
+	dms->fontDefinition.characterTable                          = NULL;
+	dms->dmsMessage.dmsMessageTable                             = NULL;
+	ess->essTemperature.essTemperatureSensorTable               = NULL;
+	ess->essPavement.essPavementSensorTable                     = NULL;
+	tss->sensorZones.sensorZoneTable                            = NULL;
+	tss->vehicleClasses.vehicleClassTable                       = NULL;
+	tss->sampleData.zoneSampleTable                             = NULL;
+	tss->sampleData.zoneClassTable                              = NULL;
+	rsu->rsuIFM.rsuIFMTable                                     = NULL;
+	rmc->rmcMainline.rmcMainlineLaneTable                       = NULL;
+	rmc->rmcMeteredLane.rmcMeteredLaneTable                     = NULL;
+	rmc->rmcTrafficResponsive.rmcTRLevelTable                   = NULL;
+#else
+	(void) tree;
+#endif
+}
+
+void databaseFree (void)
+{
+	databaseFreeTree(&database);
+	pthread_mutex_destroy(&lock);
+}
+
+void databaseLock (void)   { pthread_mutex_lock(&lock); }
+void databaseUnlock (void) { pthread_mutex_unlock(&lock); }
@@ -0,0 +1,197 @@
+#include <Detector.h>
+#include <Period.h>
+
+/* Occupancy is reported in half percents. */
+#define OCCUPANCY_FULL 200
+
+/* Volumes of 255 report an overflow. */
+#define VOLUME_OVERFLOW UINT8_MAX
+
+#define GROUPS CONFIG_GROUPS(UINT8_MAX)
+
+typedef struct Counter
+{
+	uint16_t volume;
+	uint32_t occupied; /* Ticks. */
+} Counter;
+
+static struct
+{
+	OBJECT_TABLE(Counter, counters, CONFIG_MAX_VEHICLE_DETECTORS);
+	size_t count;
+
+	uint8_t  previous[GROUPS]; /* Active bits of the last tick. */
+	uint8_t  changed[GROUPS];  /* Bits that differ from the last tick. */
+	uint32_t ticks;            /* Ticks of the period so far. */
+	Period   period;
+} aggregate;
+
+static DetectorHook hooks[DETECTOR_MAX_HOOKS];
+static size_t       hookCount;
+
+bool detectorInit (const DatabaseLimits *const limits)
+{
+	aggregate.count  = limits->maxVehicleDetectors;
+	aggregate.ticks  = 0;
+	aggregate.period = (Period) { 0 };
+	memset(aggregate.previous, 0, sizeof(aggregate.previous));
+
+	if (!PROVIDE(aggregate.counters, aggregate.count))
+	{
+		return false;
+	}
+
+	memset(aggregate.counters, 0,
+	       aggregate.count * sizeof(aggregate.counters[0]));
+
+	return true;
+}
+
+void detectorFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(aggregate.counters);
+
+	aggregate.counters = NULL;
+#endif
+}
+
+bool detectorRegister (const DetectorHook hook)
+{
+	if (hookCount == DETECTOR_MAX_HOOKS)
+	{
+		return false;
+	}
+
+	hooks[hookCount++] = hook;
+
+	return true;
+}
+
+void detectorStep (const int64_t step)
+{
+	(void) step;
+
+	periodStep(&aggregate.period);
+}
+
+static void publish (void)
+{
+	VolumeOccupancyReport *const report = &asc.detector.volumeOccupancyReport;
+	const size_t rows = MIN(aggregate.count,
+	                        (size_t) report->activeVolumeOccupancyDetectors);
+
+	for (size_t detector = 0; detector < rows; detector++)
+	{
+		const Counter *const        counter = &aggregate.counters[detector];
+		VolumeOccupancyEntry *const entry   =
+			&report->volumeOccupancyTable[detector];
+
+		entry->detectorVolume    = (uint8_t)
+			MIN(counter->volume, (uint16_t) VOLUME_OVERFLOW);
+		entry->detectorOccupancy = (uint8_t) (aggregate.ticks != 0
+			? (uint64_t) counter->occupied * OCCUPANCY_FULL / aggregate.ticks
+			: 0);
+	}
+
+	report->volumeOccupancySequence++;
+
+	memset(aggregate.counters, 0,
+	       aggregate.count * sizeof(aggregate.counters[0]));
+	aggregate.ticks = 0;
+}
+
+/* Takes the edges of one tick, and counts its vehicles and occupied ticks
+ * while a period runs. Returns true if a detector changed.
+ */
+static bool accumulate (const bool counting)
+{
+	const VehicleDetectorStatusGroupEntry *const groups =
+		asc.detector.vehicleDetectorStatusGroupTable;
+	const size_t total = asc.detector.maxVehicleDetectorStatusGroups;
+	uint8_t      any   = 0;
+
+	for (size_t group = 0; group < total; group++)
+	{
+		const uint8_t active = groups[group].vehicleDetectorStatusGroupActive;
+		const uint8_t rising = active & ~aggregate.previous[group];
+
+		aggregate.changed[group]  = active ^ aggregate.previous[group];
+		aggregate.previous[group] = active;
+		any                      |= aggregate.changed[group];
+
+		if (!counting)
+		{
+			continue;
+		}
+
+		for (uint32_t bits = active; bits != 0; bits &= bits - 1)
+		{
+			const size_t detector = group * 8 + __builtin_ctz(bits);
+
+			if (detector < aggregate.count)
+			{
+				Counter *const counter = &aggregate.counters[detector];
+
+				counter->occupied++;
+				counter->volume += (rising >> (detector % 8)) & 1
+				                && counter->volume < UINT16_MAX;
+			}
+		}
+	}
+
+	aggregate.ticks += counting;
+
+	return any != 0;
+}
+
+void detectorTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	const CalendarTime *const date  = calendarNow();
+	const PeriodEvent         event =
+		periodBegin(&aggregate.period,
+		            asc.detector.volumeOccupancyReport.volumeOccupancyPeriod,
+		            date);
+
+	switch (event)
+	{
+		case PERIOD_STOPPED:
+			break;
+
+		case PERIOD_STARTED:
+			memset(aggregate.counters, 0,
+			       aggregate.count * sizeof(aggregate.counters[0]));
+			aggregate.ticks = 0;
+			break;
+
+		case PERIOD_ENDED:
+			publish();
+			break;
+
+		case PERIOD_RUNNING:
+			break;
+	}
+
+	if (accumulate(event != PERIOD_STOPPED))
+	{
+		const DetectorEdges edges =
+		{
+			.active  = aggregate.previous,
+			.changed = aggregate.changed,
+			.groups  = asc.detector.maxVehicleDetectorStatusGroups,
+			.now     = now
+		};
+
+		for (size_t index = 0; index < hookCount; index++)
+		{
+			hooks[index](&edges);
+		}
+	}
+
+	if (event != PERIOD_STOPPED && periodEnd(&aggregate.period, date))
+	{
+		publish();
+	}
+}
@@ -0,0 +1,176 @@
+#include <Device.h>
+#include <MIB.h>
+
+typedef struct Subtree
+{
+	OID     oid;
+	uint8_t device;
+} Subtree;
+
+static const Device *const builtIn[] =
+{
+	&ascDevice, &dmsDevice, &essDevice, &tssDevice, &rsuDevice, &rmcDevice
+};
+
+static const OID devicesNode = DEVICES_NODE_OID;
+static const OID globalNode  = GLOBAL_OID();
+
+/* Written before registryInit(), read only after. */
+static const Device *devices[DEVICE_MAX];
+static Subtree       subtrees[DEVICE_MAX]; /* Sorted by OID. */
+static size_t        count;
+
+const Device *deviceFind (const char *const name)
+{
+	for (size_t index = 0; index < sizeof(builtIn) / sizeof(builtIn[0]);
+	     index++)
+	{
+		if (strcmp(builtIn[index]->name, name) == 0)
+		{
+			return builtIn[index];
+		}
+	}
+
+	return NULL;
+}
+
+bool deviceRegister (const Device *const device)
+{
+	if (count == DEVICE_MAX)
+	{
+		return false;
+	}
+
+	size_t position = count;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		const int order = oidCompare(&device->subtree, &subtrees[index].oid);
+
+		if (order == 0)
+		{
+			return false;
+		}
+
+		if (order < 0 && position == count)
+		{
+			position = index;
+		}
+	}
+
+	memmove(&subtrees[position + 1], &subtrees[position],
+	        (count - position) * sizeof(subtrees[0]));
+
+	subtrees[position] = (Subtree)
+	{
+		.oid    = device->subtree,
+		.device = (uint8_t) count
+	};
+	devices[count++] = device;
+
+	return true;
+}
+
+uint8_t deviceResolve (const OID *const name)
+{
+	size_t low = 0, high = count;
+
+	/* The last subtree sorting at or before name is the only one that can
+	 * hold it, as no subtree holds another.
+	 */
+	while (low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+
+		if (oidCompare(&subtrees[middle].oid, name) <= 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if (low > 0 && oidIsPrefix(&subtrees[low - 1].oid, name))
+	{
+		return subtrees[low - 1].device;
+	}
+
+	return oidIsPrefix(&devicesNode, name) && !oidIsPrefix(&globalNode, name)
+	     ? DEVICE_ABSENT : DEVICE_NONE;
+}
+
+bool deviceInit (const DatabaseLimits *const limits)
+{
+	for (size_t index = 0; index < count; index++)
+	{
+		const Device *const device = devices[index];
+
+		if (device->init && !device->init(limits))
+		{
+			return false;
+		}
+
+		for (size_t hook = 0; hook < DEVICE_MAX_HOOKS && device->ticks[hook];
+		     hook++)
+		{
+			if (!tickRegister(device->ticks[hook]))
+			{
+				return false;
+			}
+		}
+
+		for (size_t hook = 0; hook < DEVICE_MAX_HOOKS && device->steps[hook];
+		     hook++)
+		{
+			if (!calendarRegister(device->steps[hook]))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void deviceFree (void)
+{
+	for (size_t index = count; index-- > 0;)
+	{
+		if (devices[index]->free)
+		{
+			devices[index]->free();
+		}
+	}
+}
+
+SNMPError deviceCheck (const RegistryObject *const object, const size_t row,
+                       const VarBind *const varbind)
+{
+	if (object->device >= count || !devices[object->device]->check)
+	{
+		return SNMP_NO_ERROR;
+	}
+
+	return devices[object->device]->check(object, row, varbind);
+}
+
+void deviceStore (const RegistryObject *const object, const size_t row)
+{
+	if (object->device < count && devices[object->device]->store)
+	{
+		devices[object->device]->store(object, row);
+	}
+}
+
+void deviceInvalidate (const bool database)
+{
+	for (size_t index = 0; index < count; index++)
+	{
+		if (devices[index]->invalidate)
+		{
+			devices[index]->invalidate(database);
+		}
+	}
+}
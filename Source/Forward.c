@@ -0,0 +1,350 @@
+#include <Forward.h>
+#include <Calendar.h>
+#include <Clock.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Metrics.h>
+#include <Spat.h>
+
+static_assert((FORWARD_SLOTS & (FORWARD_SLOTS - 1)) == 0,
+              "FORWARD_SLOTS must be a power of two");
+static_assert(SPAT_MAX_OCTETS <= RSU_MAX_PAYLOAD,
+              "the SPaT must fit in a message");
+
+#define CACHE_LINE 64
+
+static const OID ifmEntry      = RSU_OID(4, 2, 1);
+static const OID enableColumn  = RSU_OID(4, 2, 1, 4);
+static const OID statusColumn  = RSU_OID(4, 2, 1, 5);
+static const OID payloadColumn = RSU_OID(4, 2, 1, 8);
+
+/* A slot is free for the producer claiming position when its sequence is
+ * position, and ready for the consumer when it is position + 1; the
+ * consumer frees it for the next lap at position + FORWARD_SLOTS.
+ */
+typedef struct Slot
+{
+	atomic_size_t  sequence;
+	size_t         position;
+	ForwardMessage message;
+} Slot;
+
+static Slot slots[FORWARD_SLOTS];
+
+_Alignas(CACHE_LINE) static atomic_size_t head;
+_Alignas(CACHE_LINE) static size_t        tail; /* Owned by the consumer. */
+
+static atomic_uint_fast32_t overflows;
+static atomic_uint_fast32_t spats;
+static atomic_bool          running;
+static sem_t                wake;
+static thrd_t               thread;
+static ForwardBackend       radio;
+
+ForwardStatus forwardStatus;
+
+bool forwardInit (void)
+{
+	for (size_t position = 0; position < FORWARD_SLOTS; position++)
+	{
+		atomic_init(&slots[position].sequence, position);
+	}
+
+	atomic_store(&head, 0);
+	atomic_store(&overflows, 0);
+	atomic_store(&spats, 0);
+	tail          = 0;
+	forwardStatus = (ForwardStatus) { 0 };
+
+	return sem_init(&wake, 0, 0) == 0;
+}
+
+void forwardFree (void)
+{
+	sem_destroy(&wake);
+}
+
+ForwardMessage *forwardClaim (void)
+{
+	size_t position = atomic_load_explicit(&head, memory_order_relaxed);
+
+	for (;;)
+	{
+		Slot *const slot = &slots[position & (FORWARD_SLOTS - 1)];
+		const size_t sequence =
+			atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		const intptr_t lag = (intptr_t) sequence - (intptr_t) position;
+
+		if (lag == 0)
+		{
+			if (atomic_compare_exchange_weak_explicit(&head, &position,
+			                                          position + 1,
+			                                          memory_order_relaxed,
+			                                          memory_order_relaxed))
+			{
+				slot->position = position;
+				return &slot->message;
+			}
+		}
+		else if (lag < 0)
+		{
+			/* The consumer has yet to free the slot of the last lap. */
+			atomic_fetch_add_explicit(&overflows, 1, memory_order_relaxed);
+			return NULL;
+		}
+		else
+		{
+			position = atomic_load_explicit(&head, memory_order_relaxed);
+		}
+	}
+}
+
+void forwardCommit (ForwardMessage *const message)
+{
+	Slot *const slot = (Slot *) ((char *) message - offsetof(Slot, message));
+
+	message->committed = clockMonotonic();
+	atomic_store_explicit(&slot->sequence, slot->position + 1,
+	                      memory_order_release);
+	sem_post(&wake);
+}
+
+bool forwardSubmit (const uint32_t psid, const uint8_t channel,
+                    const uint8_t priority, const uint8_t payload[const],
+                    const size_t length)
+{
+	if (length > RSU_MAX_PAYLOAD)
+	{
+		return false;
+	}
+
+	ForwardMessage *const message = forwardClaim();
+
+	if (message == NULL)
+	{
+		return false;
+	}
+
+	message->psid     = psid;
+	message->channel  = channel;
+	message->priority = priority;
+	message->length   = (uint16_t) length;
+	memcpy(message->payload, payload, length);
+	forwardCommit(message);
+
+	return true;
+}
+
+/* Hands over every message committed in order, stopping at the first slot
+ * still being written.
+ */
+static void drain (void)
+{
+	for (;;)
+	{
+		Slot *const slot = &slots[tail & (FORWARD_SLOTS - 1)];
+
+		if (atomic_load_explicit(&slot->sequence, memory_order_acquire)
+		    != tail + 1)
+		{
+			break;
+		}
+
+		const ForwardMessage *const message = &slot->message;
+
+		if (radio.transmit(radio.context, message))
+		{
+			forwardStatus.forwardMessages++;
+			metricsRecord(METRIC_FORWARD,
+			              clockMonotonic() - message->committed);
+		}
+		else
+		{
+			forwardStatus.forwardErrors++;
+		}
+
+		atomic_store_explicit(&slot->sequence, tail + FORWARD_SLOTS,
+		                      memory_order_release);
+		tail++;
+	}
+
+	forwardStatus.forwardSpats     = (uint32_t) atomic_load(&spats);
+	forwardStatus.forwardOverflows = (uint32_t) atomic_load(&overflows);
+}
+
+static int run (void *const argument)
+{
+	(void) argument;
+
+	while (atomic_load_explicit(&running, memory_order_relaxed))
+	{
+		if (sem_wait(&wake) == 0)
+		{
+			drain();
+		}
+	}
+
+	drain();
+
+	return 0;
+}
+
+bool forwardStart (const ForwardBackend *const backend)
+{
+	radio = *backend;
+	atomic_store(&running, true);
+
+	if (thrd_create(&thread, run, NULL) != thrd_success)
+	{
+		atomic_store(&running, false);
+		return false;
+	}
+
+	return true;
+}
+
+void forwardStop (void)
+{
+	if (atomic_exchange(&running, false))
+	{
+		sem_post(&wake);
+		thrd_join(thread, NULL);
+	}
+}
+
+SNMPError forwardCheck (const RegistryObject *const object, const size_t row,
+                        const VarBind *const varbind)
+{
+	if (oidCompare(&object->oid, &statusColumn) != 0)
+	{
+		return SNMP_NO_ERROR;
+	}
+
+	const RsuIFMEntry *const entry = &rsu.rsuIFM.rsuIFMTable[row];
+	const bool exists = entry->rsuIFMStatus != ROW_STATUS_NOT_READY;
+
+	switch (varbind->value.integer)
+	{
+		case ROW_STATUS_ACTIVE:
+		case ROW_STATUS_NOT_IN_SERVICE:
+			return exists ? SNMP_NO_ERROR : SNMP_INCONSISTENT_VALUE;
+
+		case ROW_STATUS_CREATE_AND_GO:
+		case ROW_STATUS_CREATE_AND_WAIT:
+			return exists ? SNMP_INCONSISTENT_VALUE : SNMP_NO_ERROR;
+
+		case ROW_STATUS_DESTROY:
+			return SNMP_NO_ERROR;
+
+		default:
+			return SNMP_WRONG_VALUE;
+	}
+}
+
+static void submit (const RsuIFMEntry *const entry)
+{
+	size_t length;
+	const uint8_t *const psid = octetStringData(&entry->rsuIFMPsid, &length);
+	uint32_t identifier = 0;
+
+	for (size_t octet = 0; octet < length; octet++)
+	{
+		identifier = identifier << 8 | psid[octet];
+	}
+
+	forwardSubmit(identifier, entry->rsuIFMTxChannel, entry->rsuIFMPriority,
+	              entry->rsuIFMPayload.octets, entry->rsuIFMPayload.length);
+}
+
+void forwardStore (const RegistryObject *const object, const size_t row)
+{
+	if (!oidIsPrefix(&ifmEntry, &object->oid))
+	{
+		return;
+	}
+
+	RsuIFMEntry *const entry = &rsu.rsuIFM.rsuIFMTable[row];
+
+	if (oidCompare(&object->oid, &statusColumn) == 0)
+	{
+		switch (entry->rsuIFMStatus)
+		{
+			case ROW_STATUS_ACTIVE:
+			case ROW_STATUS_CREATE_AND_GO:
+				entry->rsuIFMStatus = ROW_STATUS_ACTIVE;
+				break;
+
+			case ROW_STATUS_DESTROY:
+				*entry = (RsuIFMEntry)
+				{
+					.rsuIFMIndex  = entry->rsuIFMIndex,
+					.rsuIFMStatus = ROW_STATUS_NOT_READY
+				};
+				return;
+
+			default:
+				entry->rsuIFMStatus = ROW_STATUS_NOT_IN_SERVICE;
+				return;
+		}
+	}
+	else if (oidCompare(&object->oid, &enableColumn) != 0
+	      && oidCompare(&object->oid, &payloadColumn) != 0)
+	{
+		return;
+	}
+
+	if (entry->rsuIFMStatus == ROW_STATUS_ACTIVE && entry->rsuIFMEnable == 1)
+	{
+		submit(entry);
+	}
+}
+
+void forwardTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+	(void) now;
+
+	if (!atomic_load_explicit(&running, memory_order_relaxed))
+	{
+		return;
+	}
+
+	ForwardMessage *const message = forwardClaim();
+
+	if (message == NULL)
+	{
+		return;
+	}
+
+	message->psid     = FORWARD_PSID_SPAT;
+	message->channel  = FORWARD_CHANNEL_SPAT;
+	message->priority = 0;
+	message->length   = (uint16_t) spatEncode(message->payload,
+	                                          RSU_MAX_PAYLOAD,
+	                                          calendarNow());
+	forwardCommit(message);
+	atomic_fetch_add_explicit(&spats, 1, memory_order_relaxed);
+}
+
+static bool rsuInit (const DatabaseLimits *const limits)
+{
+	return spatInit(limits) && forwardInit();
+}
+
+static void rsuFree (void)
+{
+	forwardFree();
+	spatFree();
+}
+
+/* The SPaT is predicted before it is built. */
+const Device rsuDevice =
+{
+	.name       = "rsu",
+	.subtree    = RSU_OID(),
+	.init       = rsuInit,
+	.free       = rsuFree,
+	.check      = forwardCheck,
+	.store      = forwardStore,
+	.ticks      = { spatTick, forwardTick }
+};
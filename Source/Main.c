@@ -1,13 +1,538 @@
 #include <NTCIP.h>
+#include <Access.h>
+#include <Agent.h>
+#include <AuxIO.h>
+#include <Calendar.h>
+#include <Change.h>
+#include <Database.h>
+#include <Device.h>
+#include <Forward.h>
+#include <Notify.h>
+#include <PMPP.h>
+#include <Preempt.h>
+#include <Registry.h>
+#include <Sync.h>
+#include <Tick.h>
+#include <Transaction.h>
+#include <USM.h>
+
+static const DatabaseLimits limits = DATABASE_LIMITS;
+
+static Agent    agent;
+static Notify   notify;
+static PMPPLink line;
+static bool     serial;
+
+static AuxIO           auxIO;
+static AuxIOSimulation auxIOSimulation;
+
+/* Octets before the payload of a datagram to the radio: the service
+ * identifier, channel, priority and length of the message, big endian.
+ */
+#define RADIO_HEADER_OCTETS 8
+
+static int                radio = -1;
+static struct sockaddr_in radioAddress;
+
+static void notifyTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	notifyScan(&notify, &asc, now);
+	notifyService(&notify, now);
+}
+
+static void auxIOTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+	(void) now;
+
+	(void) auxIOScan(&auxIO);
+}
+
+static bool radioTransmit (void *const context,
+                           const ForwardMessage *const message)
+{
+	(void) context;
+
+	uint8_t datagram[RADIO_HEADER_OCTETS + RSU_MAX_PAYLOAD] =
+	{
+		(uint8_t) (message->psid >> 24),
+		(uint8_t) (message->psid >> 16),
+		(uint8_t) (message->psid >> 8),
+		(uint8_t) message->psid,
+		message->channel,
+		message->priority,
+		(uint8_t) (message->length >> 8),
+		(uint8_t) message->length
+	};
+
+	memcpy(datagram + RADIO_HEADER_OCTETS, message->payload, message->length);
+
+	return sendto(radio, datagram, RADIO_HEADER_OCTETS + message->length, 0,
+	              (const struct sockaddr *) &radioAddress,
+	              sizeof(radioAddress)) >= 0;
+}
+
+/* Registers the devices of a comma separated list of names. Returns false
+ * for a name that is not a device or is listed twice, and for ramp metering
+ * without the controller whose detectors it meters from.
+ */
+static bool registerDevices (const char *const list, bool *const asc)
+{
+	char        names[64];
+	char       *state;
+	const char *name;
+	bool        rmc = false;
+
+	if (strlen(list) >= sizeof(names))
+	{
+		return false;
+	}
+
+	strcpy(names, list);
+
+	if (!deviceRegister(&auxDevice))
+	{
+		return false;
+	}
+
+	for (name = strtok_r(names, ",", &state); name;
+	     name = strtok_r(NULL, ",", &state))
+	{
+		const Device *const device = deviceFind(name);
+
+		if (!device || !deviceRegister(device))
+		{
+			return false;
+		}
+
+		*asc |= device == &ascDevice;
+		rmc  |= device == &rmcDevice;
+	}
+
+	return *asc || !rmc;
+}
+
+/* Adds an SNMPv3 user from "name:auth-password[:priv-password]", in a group
+ * of its own that reads every object and, if writable, writes them.
+ */
+static bool addUser (const char *const text, const bool writable)
+{
+	char fields[128];
+
+	if (strlen(text) >= sizeof(fields))
+	{
+		return false;
+	}
+
+	strcpy(fields, text);
+
+	char *const auth = strchr(fields, ':');
+
+	if (!auth)
+	{
+		return false;
+	}
+
+	*auth = '\0';
+
+	char *const priv = strchr(auth + 1, ':');
+
+	if (priv)
+	{
+		*priv = '\0';
+	}
+
+	return usmAddUser(fields, auth + 1, priv ? priv + 1 : NULL)
+	    && accessGroup(ACCESS_USER, fields, "all", writable ? "all" : NULL,
+	                   false);
+}
+
+/* Adds a community from "community:read-view[:write-view]". */
+static bool addCommunity (const char *const text)
+{
+	char fields[128];
+
+	if (strlen(text) >= sizeof(fields))
+	{
+		return false;
+	}
+
+	strcpy(fields, text);
+
+	char *const read = strchr(fields, ':');
+
+	if (!read)
+	{
+		return false;
+	}
+
+	*read = '\0';
+
+	char *const write = strchr(read + 1, ':');
+
+	if (write)
+	{
+		*write = '\0';
+	}
+
+	return accessGroup(ACCESS_COMMUNITY, fields, read + 1,
+	                   write ? write + 1 : NULL, false);
+}
+
+/* Parses "address:port". */
+static bool parseAddress (const char *const text,
+                          struct sockaddr_in *const address)
+{
+	char host[INET_ADDRSTRLEN];
+	const char *const separator = strrchr(text, ':');
+
+	if (!separator || (size_t) (separator - text) >= sizeof(host))
+	{
+		return false;
+	}
+
+	memcpy(host, text, (size_t) (separator - text));
+	host[separator - text] = '\0';
+
+	const long port = strtol(separator + 1, NULL, 10);
+
+	address->sin_family = AF_INET;
+	address->sin_port   = htons((uint16_t) port);
+
+	return port > 0 && port <= UINT16_MAX
+	    && inet_pton(AF_INET, host, &address->sin_addr) == 1;
+}
+
+static void usage (const char *const program)
+{
+	fprintf(stderr, "usage: %s [-p port] [-t address:port [-i]] "
+	                "[-r priority] [-c cpu] [-s device|pty [-b speed] "
+	                "[-a address]] [-x file|pty [-o port,...]] "
+	                "[-f address:port] [-d device,...] "
+	                "[-u|-U user:auth[:priv]] [-C community:view[:view]] "
+	                "[-A community]\n",
+	                program);
+	exit(EXIT_FAILURE);
+}
 
 static void init (const uint32_t argc, const char *const argv[static argc])
 {
-	(void) argc;
-	(void) argv;
+	AgentConfig config =
+	{
+		.address =
+		{
+			.sin_family      = AF_INET,
+			.sin_port        = htons(161),
+			.sin_addr.s_addr = htonl(INADDR_ANY)
+		}
+	};
 
+	NotifyConfig notifyConfig =
+	{
+		.community      = "public",
+		.coalesceWindow = 200,
+		.informTimeout  = 1000,
+		.informRetries  = 3
+	};
+
+	TickConfig tickConfig =
+	{
+		.realTime = false,
+		.cpu      = -1
+	};
+
+	const char *device    = NULL;
+	const char *ports     = NULL;
+	const char *outputs   = NULL;
+	const char *devices   = "asc,dms,ess,tss,rsu,rmc";
+	const char *admin     = "administrator";
+	uint32_t    speed     = 9600;
+	uint16_t    station   = 1;
+	bool        notifying = false;
+	bool        radioing  = false;
+	bool        asc       = false;
+	int         option;
+
+	usmInit();
+
+	while ((option = getopt((int) argc, (char *const *) argv,
+	                        "p:t:ir:c:s:b:a:x:o:f:d:u:U:C:A:")) != -1)
+	{
+		switch (option)
+		{
+			case 'p':
+				config.address.sin_port = htons((uint16_t) atoi(optarg));
+				break;
+
+			case 't':
+				if (!parseAddress(optarg, &notifyConfig.destination))
+				{
+					usage(argv[0]);
+				}
+
+				notifying = true;
+				break;
+
+			case 'i':
+				notifyConfig.inform = true;
+				break;
+
+			case 'r':
+				tickConfig.realTime = true;
+				tickConfig.priority = atoi(optarg);
+				break;
+
+			case 'c':
+				tickConfig.cpu = atoi(optarg);
+				break;
+
+			case 's':
+				device = optarg;
+				break;
+
+			case 'b':
+				speed = (uint32_t) strtoul(optarg, NULL, 10);
+				break;
+
+			case 'a':
+				station = (uint16_t) atoi(optarg);
+
+				if (station == 0 || station >= PMPP_BROADCAST)
+				{
+					usage(argv[0]);
+				}
+
+				break;
+
+			case 'x':
+				ports = optarg;
+				break;
+
+			case 'o':
+				outputs = optarg;
+				break;
+
+			case 'f':
+				if (!parseAddress(optarg, &radioAddress))
+				{
+					usage(argv[0]);
+				}
+
+				radioing = true;
+				break;
+
+			case 'd':
+				devices = optarg;
+				break;
+
+			case 'u':
+			case 'U':
+				if (!addUser(optarg, option == 'U'))
+				{
+					usage(argv[0]);
+				}
+
+				break;
+
+			case 'C':
+				if (!addCommunity(optarg))
+				{
+					usage(argv[0]);
+				}
+
+				break;
+
+			case 'A':
+				admin = optarg;
+				break;
+
+			default:
+				usage(argv[0]);
+		}
+	}
+
+	/* The communities of NTCIP 1201: the administrator, and public unless
+	 * -C has configured it.
+	 */
+	if (!accessGroup(ACCESS_COMMUNITY, admin, "all", "all", true))
+	{
+		usage(argv[0]);
+	}
+
+	(void) accessGroup(ACCESS_COMMUNITY, "public", "all", NULL, false);
+
+	if (!registerDevices(devices, &asc))
+	{
+		usage(argv[0]);
+	}
+
+	if (!databaseInit(&limits))
+	{
+		fputs("Unable to allocate the object tree.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	registryInit();
+	accessCompile();
+	changeInit(&limits);
+	calendarInit();
+
+	if (!transactionInit(&limits) || !syncInit(&limits))
+	{
+		fputs("Unable to allocate the transaction buffer.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	if (!agentInit(&agent, &config))
+	{
+		perror("Unable to open the agent socket");
+		exit(EXIT_FAILURE);
+	}
+
+	if (device)
+	{
+		char name[64];
+
+		serial = strcmp(device, "pty") == 0
+		       ? pmppOpenPty(&line, station, name, sizeof(name))
+		       : pmppOpen(&line, device, speed, station);
+
+		if (!serial)
+		{
+			perror("Unable to open the serial link");
+			exit(EXIT_FAILURE);
+		}
+
+		if (strcmp(device, "pty") == 0)
+		{
+			printf("PMPP station %u on %s\n", station, name);
+			fflush(stdout);
+		}
+	}
+
+	if (ports)
+	{
+		static const AuxIOConfig auxIOConfig =
+		{
+			.debounce   = 3,
+			.window     = 8,
+			.resolution = 12
+		};
+
+		char         name[64];
+		AuxIOBackend backend;
+
+		if (outputs && !auxIODirections(outputs))
+		{
+			usage(argv[0]);
+		}
+
+		if (!auxIOSimulationOpen(&auxIOSimulation, ports, name, sizeof(name),
+		                         &backend)
+		 || !auxIOInit(&auxIO, &backend, &auxIOConfig))
+		{
+			perror("Unable to open the auxiliary I/O simulation");
+			exit(EXIT_FAILURE);
+		}
+
+		if (strcmp(ports, "pty") == 0)
+		{
+			printf("Auxiliary I/O on %s\n", name);
+			fflush(stdout);
+		}
+
+		tickRegister(auxIOTick);
+	}
+
+	tickRegister(calendarTick);
+
+	if (!deviceInit(&limits))
+	{
+		fputs("Unable to initialize the devices.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	if (notifying)
+	{
+		if (!notifyInit(&notify, &notifyConfig))
+		{
+			perror("Unable to open the notification socket");
+			exit(EXIT_FAILURE);
+		}
+
+		tickRegister(notifyTick);
+	}
+
+	if (radioing)
+	{
+		static const ForwardBackend backend = { .transmit = radioTransmit };
+
+		radio = socket(AF_INET, SOCK_DGRAM, 0);
+
+		if (radio < 0 || !forwardStart(&backend))
+		{
+			perror("Unable to open the radio socket");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (!tickStart(&tickConfig))
+	{
+		perror("Unable to start the tick thread");
+		exit(EXIT_FAILURE);
+	}
+
+	if (asc && !preemptStart(&tickConfig))
+	{
+		perror("Unable to start the preemption thread");
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* Serves the socket and the serial link from one thread, which then owns
+ * the buffers of the agent alone.
+ */
+static bool serve (void)
+{
+	struct pollfd descriptors[] =
+	{
+		{ .fd = agent.socket, .events = POLLIN },
+		{ .fd = line.fd,      .events = POLLIN }
+	};
+
+	if (pmppPending(&line))
+	{
+		descriptors[1].events |= POLLOUT;
+	}
+
+	if (poll(descriptors, 2, -1) < 0)
+	{
+		return errno == EINTR;
+	}
+
+	if (descriptors[0].revents && !agentServe(&agent, 0))
+	{
+		return false;
+	}
+
+	if (descriptors[1].revents && !pmppServe(&line, &agent))
+	{
+		perror("Serial link failed");
+		exit(EXIT_FAILURE);
+	}
+
+	return true;
 }
 
 int32_t main (const int32_t argc, const char *const argv[const static argc])
 {
 	init(argc, argv);
+
+	while (serial ? serve() : agentServe(&agent, -1));
+
+	perror("Agent socket failed");
+
+	return EXIT_FAILURE;
 }
@@ -0,0 +1,460 @@
+#include <Manager.h>
+#include <MIB.h>
+#include <Registry.h>
+
+static_assert(MANAGER_MAX_REQUESTS < MANAGER_NONE,
+              "request slots must be addressable by 16 bits");
+
+/* Only the device MIBs are stored; anything else a device returns (its
+ * private objects, say) has no place in the image.
+ */
+static const OID devices = DEVICES_NODE_OID;
+
+static size_t bucketOf (const uint64_t time)
+{
+	return (size_t) (time / MANAGER_WHEEL_RESOLUTION % MANAGER_WHEEL_SLOTS);
+}
+
+static void schedule (Manager *const manager, const uint16_t index)
+{
+	ManagerRequest *const request = &manager->requests[index];
+	uint16_t       *const head    =
+		&manager->wheel[bucketOf(request->deadline)];
+
+	request->previous = MANAGER_NONE;
+	request->next     = *head;
+
+	if (*head != MANAGER_NONE)
+	{
+		manager->requests[*head].previous = index;
+	}
+
+	*head = index;
+}
+
+static void deschedule (Manager *const manager, const uint16_t index)
+{
+	const ManagerRequest *const request = &manager->requests[index];
+
+	if (request->previous != MANAGER_NONE)
+	{
+		manager->requests[request->previous].next = request->next;
+	}
+	else
+	{
+		manager->wheel[bucketOf(request->deadline)] = request->next;
+	}
+
+	if (request->next != MANAGER_NONE)
+	{
+		manager->requests[request->next].previous = request->previous;
+	}
+}
+
+bool managerInit (Manager *const manager, const ManagerConfig *const config)
+{
+	const uint64_t now = clockMonotonic();
+
+	manager->config     = *config;
+	manager->active     = 0;
+	manager->freeList   = 0;
+	manager->wheelTime  = now - now % MANAGER_WHEEL_RESOLUTION;
+	manager->statistics = (ManagerStatistics) { 0 };
+	manager->socket     = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK
+	                                      | SOCK_CLOEXEC, 0);
+
+	if (manager->socket < 0)
+	{
+		return false;
+	}
+
+	if (getrandom(&manager->sequence, sizeof(manager->sequence), 0) < 0)
+	{
+		manager->sequence = (uint16_t) now;
+	}
+
+	for (size_t slot = 0; slot < MANAGER_WHEEL_SLOTS; slot++)
+	{
+		manager->wheel[slot] = MANAGER_NONE;
+	}
+
+	for (uint16_t index = 0; index < MANAGER_MAX_REQUESTS; index++)
+	{
+		manager->requests[index].active = false;
+		manager->requests[index].next   =
+			index + 1 < MANAGER_MAX_REQUESTS ? index + 1 : MANAGER_NONE;
+	}
+
+	return true;
+}
+
+void managerClose (Manager *const manager)
+{
+	if (manager->socket >= 0)
+	{
+		close(manager->socket);
+		manager->socket = -1;
+	}
+}
+
+bool managerDeviceInit (ManagerDevice *const device,
+                        const struct sockaddr_in *const address,
+                        const char *const community, const uint16_t window,
+                        const DatabaseLimits *const limits)
+{
+	memset(device, 0, sizeof(*device));
+
+	device->address     = *address;
+	device->community   = community;
+	device->window      = MAX(window, 1);
+	device->tree.global = &device->global;
+	device->tree.asc    = &device->asc;
+	device->tree.dms    = &device->dms;
+	device->tree.ess    = &device->ess;
+	device->tree.tss    = &device->tss;
+	device->tree.rsu    = &device->rsu;
+	device->tree.rmc    = &device->rmc;
+
+	return databaseInitTree(&device->tree, limits);
+}
+
+void managerDeviceFree (ManagerDevice *const device)
+{
+	databaseFreeTree(&device->tree);
+}
+
+static void transmit (Manager *const manager,
+                      const ManagerRequest *const request)
+{
+	/* A request the kernel cannot queue is recovered by retransmission like
+	 * one lost on the wire.
+	 */
+	const struct sockaddr_in *const address = &request->device->address;
+
+	if (sendto(manager->socket, request->message, request->length,
+	           MSG_DONTWAIT, (const struct sockaddr *) address,
+	           sizeof(*address)) >= 0)
+	{
+		manager->statistics.outPackets++;
+	}
+}
+
+static bool available (const Manager *const manager,
+                       const ManagerDevice *const device, const size_t count)
+{
+	return manager->freeList != MANAGER_NONE
+	    && device->outstanding < device->window
+	    && count <= SNMP_MAX_VARBINDS;
+}
+
+/* Sends the varbinds the caller has placed in manager->message. */
+static bool issue (Manager *const manager, ManagerDevice *const device,
+                   const uint8_t type, const size_t count,
+                   const int32_t nonRepeaters, const int32_t maxRepetitions,
+                   const ManagerCallback callback, void *const context)
+{
+	const uint16_t        index   = manager->freeList;
+	ManagerRequest *const request = &manager->requests[index];
+	SNMPMessage    *const message = &manager->message;
+
+	/* The slot travels in the low half of the request-id, so a response is
+	 * matched without a search; the sequence in the high half tells a late
+	 * response from one to the next request using the same slot.
+	 */
+	manager->sequence++;
+
+	message->version         = SNMP_VERSION_2C;
+	message->community       = (const uint8_t *) device->community;
+	message->communityLength = strlen(device->community);
+	message->pdu.type        = type;
+	message->pdu.requestID   = (int32_t) ((manager->sequence & 0x7FFFu) << 16
+	                                      | index);
+	message->pdu.errorStatus = nonRepeaters;
+	message->pdu.errorIndex  = maxRepetitions;
+	message->pdu.count       = count;
+
+	request->length = snmpEncode(message, request->message,
+	                             sizeof(request->message));
+
+	if (request->length == 0)
+	{
+		return false;
+	}
+
+	manager->freeList = request->next;
+	manager->active++;
+
+	request->device    = device;
+	request->callback  = callback;
+	request->context   = context;
+	request->requestID = message->pdu.requestID;
+	request->retries   = 0;
+	request->timeout   = manager->config.timeout * NANOSECONDS_PER_MILLISECOND;
+	request->deadline  = clockMonotonic() + request->timeout;
+	request->active    = true;
+
+	device->outstanding++;
+	device->statistics.requests++;
+
+	schedule(manager, index);
+	transmit(manager, request);
+
+	return true;
+}
+
+static void prepare (Manager *const manager, const OID names[const],
+                     const size_t count)
+{
+	for (size_t varbind = 0; varbind < count; varbind++)
+	{
+		manager->message.pdu.varbinds[varbind] = (VarBind)
+		{
+			.name = names[varbind],
+			.type = BER_NULL
+		};
+	}
+}
+
+bool managerGet (Manager *const manager, ManagerDevice *const device,
+                 const OID names[const], const size_t count,
+                 const ManagerCallback callback, void *const context)
+{
+	if (!available(manager, device, count))
+	{
+		return false;
+	}
+
+	prepare(manager, names, count);
+
+	return issue(manager, device, SNMP_GET_REQUEST, count, 0, 0, callback,
+	             context);
+}
+
+bool managerGetBulk (Manager *const manager, ManagerDevice *const device,
+                     const OID names[const], const size_t count,
+                     const uint32_t nonRepeaters,
+                     const uint32_t maxRepetitions,
+                     const ManagerCallback callback, void *const context)
+{
+	if (!available(manager, device, count))
+	{
+		return false;
+	}
+
+	prepare(manager, names, count);
+
+	return issue(manager, device, SNMP_GET_BULK_REQUEST, count,
+	             (int32_t) MIN(nonRepeaters, (uint32_t) INT32_MAX),
+	             (int32_t) MIN(maxRepetitions, (uint32_t) INT32_MAX),
+	             callback, context);
+}
+
+bool managerSet (Manager *const manager, ManagerDevice *const device,
+                 const VarBind varbinds[const], const size_t count,
+                 const ManagerCallback callback, void *const context)
+{
+	if (!available(manager, device, count))
+	{
+		return false;
+	}
+
+	memcpy(manager->message.pdu.varbinds, varbinds, count * sizeof(VarBind));
+
+	return issue(manager, device, SNMP_SET_REQUEST, count, 0, 0, callback,
+	             context);
+}
+
+/* Returns the slot to the free list before the callback runs, so that the
+ * callback can issue the next request of a walk in its place.
+ */
+static void finish (Manager *const manager, const uint16_t index,
+                    const SNMPPDU *const response)
+{
+	ManagerRequest *const request  = &manager->requests[index];
+	ManagerDevice  *const device   = request->device;
+	const ManagerCallback callback = request->callback;
+	void           *const context  = request->context;
+
+	request->active   = false;
+	request->next     = manager->freeList;
+	manager->freeList = index;
+	manager->active--;
+	device->outstanding--;
+
+	if (callback)
+	{
+		callback(device, response, context);
+	}
+}
+
+/* Decodes the values of a response into the object tree of the device.
+ * Error responses, which echo the request, exceptions, objects the device
+ * tree has no row for and values of the wrong type are skipped. The values
+ * of a successful SET are stored like those of a GET. OCTET STRINGs are
+ * copied into the tree, and interned if long, so that the images of many
+ * devices share one copy of each module and standards string. Strings held
+ * as pointers, which a response would not outlive, are not stored.
+ */
+static void store (ManagerDevice *const device, const SNMPPDU *const response)
+{
+	if (response->errorStatus != SNMP_NO_ERROR)
+	{
+		return;
+	}
+
+	registrySelect(&device->tree);
+
+	for (size_t index = 0; index < response->count; index++)
+	{
+		const VarBind *const varbind = &response->varbinds[index];
+		const RegistryObject *object;
+		size_t row;
+
+		if (!oidIsPrefix(&devices, &varbind->name)
+		 || registryFind(&varbind->name, &object, &row) != REGISTRY_FOUND
+		 || object->syntax != varbind->type || object->kind == FIELD_STRING)
+		{
+			continue;
+		}
+
+		if (registryStore(object, row, varbind))
+		{
+			device->statistics.varbinds++;
+		}
+	}
+
+	registrySelect(NULL);
+}
+
+static void receive (Manager *const manager)
+{
+	struct sockaddr_in source;
+	socklen_t          sourceLength = sizeof(source);
+	ssize_t            length;
+
+	while ((length = recvfrom(manager->socket, manager->buffer,
+	                          sizeof(manager->buffer), MSG_DONTWAIT,
+	                          (struct sockaddr *) &source,
+	                          &sourceLength)) >= 0)
+	{
+		const SNMPPDU *const response = &manager->message.pdu;
+
+		sourceLength = sizeof(source);
+		manager->statistics.inPackets++;
+
+		if (!snmpDecode(manager->buffer, (size_t) length, &manager->message)
+		 || response->type != SNMP_RESPONSE)
+		{
+			manager->statistics.inASNParseErrors++;
+			continue;
+		}
+
+		const uint16_t index = (uint16_t) (response->requestID & 0xFFFF);
+		const ManagerRequest *const request = &manager->requests[index];
+
+		if (index >= MANAGER_MAX_REQUESTS || !request->active
+		 || request->requestID != response->requestID
+		 || request->device->address.sin_addr.s_addr
+		    != source.sin_addr.s_addr
+		 || request->device->address.sin_port != source.sin_port)
+		{
+			manager->statistics.unmatchedResponses++;
+			continue;
+		}
+
+		ManagerDevice *const device = request->device;
+
+		device->statistics.responses++;
+		device->statistics.errors += response->errorStatus != SNMP_NO_ERROR;
+
+		deschedule(manager, index);
+		store(device, response);
+		finish(manager, index, response);
+	}
+}
+
+/* Retransmits or times out the expired requests of one bucket. */
+static void expire (Manager *const manager, const size_t bucket,
+                    const uint64_t now)
+{
+	uint16_t index = manager->wheel[bucket];
+
+	while (index != MANAGER_NONE)
+	{
+		ManagerRequest *const request = &manager->requests[index];
+		const uint16_t        next    = request->next;
+
+		if (request->deadline <= now)
+		{
+			deschedule(manager, index);
+
+			if (request->retries < manager->config.retries)
+			{
+				request->retries++;
+				request->timeout  *= 2;
+				request->deadline  = now + request->timeout;
+				request->device->statistics.retransmissions++;
+
+				schedule(manager, index);
+				transmit(manager, request);
+			}
+			else
+			{
+				request->device->statistics.timeouts++;
+				finish(manager, index, NULL);
+			}
+		}
+
+		index = next;
+	}
+}
+
+static void advance (Manager *const manager, const uint64_t now)
+{
+	/* After a long stall one turn visits every bucket, which is enough to
+	 * find every expired request.
+	 */
+	for (size_t step = 0; step < MANAGER_WHEEL_SLOTS
+	     && manager->wheelTime + MANAGER_WHEEL_RESOLUTION <= now; step++)
+	{
+		expire(manager, bucketOf(manager->wheelTime), now);
+		manager->wheelTime += MANAGER_WHEEL_RESOLUTION;
+	}
+
+	if (manager->wheelTime + MANAGER_WHEEL_RESOLUTION <= now)
+	{
+		manager->wheelTime = now - now % MANAGER_WHEEL_RESOLUTION;
+	}
+}
+
+bool managerService (Manager *const manager, int timeout)
+{
+	/* While requests are in flight the wait ends at the next bucket. */
+	if (manager->active != 0)
+	{
+		const uint64_t now  = clockMonotonic();
+		const uint64_t next = manager->wheelTime + MANAGER_WHEEL_RESOLUTION;
+		const int      tick = next > now
+			? (int) ((next - now + NANOSECONDS_PER_MILLISECOND - 1)
+			         / NANOSECONDS_PER_MILLISECOND)
+			: 0;
+
+		timeout = timeout < 0 ? tick : MIN(timeout, tick);
+	}
+
+	struct pollfd descriptor = { .fd = manager->socket, .events = POLLIN };
+
+	if (poll(&descriptor, 1, timeout) < 0 && errno != EINTR)
+	{
+		return false;
+	}
+
+	if (descriptor.revents & POLLIN)
+	{
+		receive(manager);
+	}
+
+	advance(manager, clockMonotonic());
+
+	return true;
+}
@@ -0,0 +1,436 @@
+#include <Meter.h>
+#include <Clock.h>
+#include <Device.h>
+#include <MIB.h>
+
+#define GROUPS CONFIG_GROUPS(UINT8_MAX)
+
+#define NANOSECONDS_PER_TENTH (100 * NANOSECONDS_PER_MILLISECOND)
+
+/* Tenths of a second in an hour, which divided by a rate in vehicles per
+ * hour is the interval between two releases.
+ */
+#define TENTHS_PER_HOUR 36000
+
+typedef struct Bucket
+{
+	uint32_t volume;
+	uint64_t occupied; /* Nanoseconds, summed over the lanes. */
+} Bucket;
+
+/* Times are on the monotonic clock, zero while the detector is off. */
+typedef struct Mainline
+{
+	uint8_t  detector; /* Numbered from one, zero for none. */
+	uint64_t onset;
+} Mainline;
+
+typedef struct Metered
+{
+	uint8_t  detector; /* Of the queue. */
+	uint64_t onset;
+	bool     dirty;    /* The rate is to be worked out again. */
+} Metered;
+
+static struct
+{
+	OBJECT_TABLE(Mainline, mainline, CONFIG_MAX_MAINLINE_LANES);
+	OBJECT_TABLE(Metered,  metered,  CONFIG_MAX_METERED_LANES);
+	size_t mainlineLanes;
+	size_t meteredLanes;
+	size_t measured; /* Mainline lanes with a detector. */
+
+	/* The detectors of the lanes, laid out like the status groups, and the
+	 * lane of each detector plus one, zero if it has none.
+	 */
+	uint8_t watched[GROUPS];
+	uint8_t mainlineOf[UINT8_MAX];
+	uint8_t queueOf[UINT8_MAX];
+
+	Bucket   buckets[RMC_MAX_CALC_INTERVAL];
+	Bucket   current;
+	Bucket   window;  /* The sum of the buckets. */
+	size_t   length;  /* Buckets of the window. */
+	size_t   filled;
+	size_t   next;    /* The bucket replaced next. */
+	uint64_t start;   /* Of the current bucket. */
+
+	uint8_t level;
+} meter;
+
+static atomic_bool stale = true;
+
+bool meterInit (const DatabaseLimits *const limits)
+{
+	meter.mainlineLanes = limits->rmcMaxNumMainlineLanes;
+	meter.meteredLanes  = limits->rmcMaxNumMeteredLanes;
+	meter.length        = 0;
+
+	if (!PROVIDE(meter.mainline, meter.mainlineLanes)
+	 || !PROVIDE(meter.metered, meter.meteredLanes))
+	{
+		return false;
+	}
+
+	memset(meter.mainline, 0, meter.mainlineLanes * sizeof(meter.mainline[0]));
+	memset(meter.metered, 0, meter.meteredLanes * sizeof(meter.metered[0]));
+	atomic_store(&stale, true);
+
+	return detectorRegister(meterDetect);
+}
+
+void meterFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(meter.mainline);
+	free(meter.metered);
+
+	meter.mainline = NULL;
+	meter.metered  = NULL;
+#endif
+}
+
+void meterInvalidate (void)
+{
+	atomic_store_explicit(&stale, true, memory_order_release);
+}
+
+/* Whether a detector is occupied now, for lanes given a detector while it
+ * already was.
+ */
+static bool occupied (const uint8_t detector)
+{
+	const size_t group = (size_t) (detector - 1) / 8;
+
+	return group < asc.detector.maxVehicleDetectorStatusGroups
+	    && (asc.detector.vehicleDetectorStatusGroupTable[group]
+	            .vehicleDetectorStatusGroupActive >> ((detector - 1) % 8) & 1);
+}
+
+static void watch (const uint8_t detector)
+{
+	meter.watched[(detector - 1) / 8] |= 1 << ((detector - 1) % 8);
+}
+
+/* Empties the window, which starts over at now. */
+static void restart (const size_t length, const uint64_t now)
+{
+	meter.length  = length;
+	meter.filled  = 0;
+	meter.next    = 0;
+	meter.current = (Bucket) { 0 };
+	meter.window  = (Bucket) { 0 };
+	meter.start   = now;
+}
+
+/* Takes the lanes from the database. The window is kept unless its length
+ * or the mainline detectors changed.
+ */
+static void rebuild (const uint64_t now)
+{
+	const RmcMainline *const    mainline = &rmc.rmcMainline;
+	const RmcMeteredLane *const metered  = &rmc.rmcMeteredLane;
+	const size_t length = MIN(MAX(rmc.rmcGeneralConfiguration.rmcCalcInterval,
+	                              (uint8_t) 1),
+	                          (uint8_t) RMC_MAX_CALC_INTERVAL);
+	bool moved = length != meter.length;
+
+	memset(meter.watched, 0, sizeof(meter.watched));
+	memset(meter.mainlineOf, 0, sizeof(meter.mainlineOf));
+	memset(meter.queueOf, 0, sizeof(meter.queueOf));
+	meter.measured = 0;
+
+	for (size_t lane = 0; lane < meter.mainlineLanes; lane++)
+	{
+		const uint8_t   detector =
+			mainline->rmcMainlineLaneTable[lane].rmcMainlineLaneDetector;
+		Mainline *const state    = &meter.mainline[lane];
+
+		if (detector != state->detector)
+		{
+			state->detector = detector;
+			state->onset    = detector != 0 && occupied(detector) ? now : 0;
+			moved           = true;
+		}
+
+		if (detector != 0)
+		{
+			watch(detector);
+			meter.mainlineOf[detector - 1] = (uint8_t) (lane + 1);
+			meter.measured++;
+		}
+	}
+
+	for (size_t lane = 0; lane < meter.meteredLanes; lane++)
+	{
+		const uint8_t  detector =
+			metered->rmcMeteredLaneTable[lane].rmcQueueDetector;
+		Metered *const state    = &meter.metered[lane];
+
+		if (detector != state->detector)
+		{
+			state->detector = detector;
+			state->onset    = detector != 0 && occupied(detector) ? now : 0;
+		}
+
+		if (detector != 0)
+		{
+			watch(detector);
+			meter.queueOf[detector - 1] = (uint8_t) (lane + 1);
+		}
+
+		state->dirty = true;
+	}
+
+	if (moved)
+	{
+		restart(length, now);
+	}
+}
+
+void meterDetect (const DetectorEdges *const edges)
+{
+	const size_t groups = MIN(edges->groups, (size_t) GROUPS);
+
+	for (size_t group = 0; group < groups; group++)
+	{
+		for (uint32_t bits = edges->changed[group] & meter.watched[group];
+		     bits != 0; bits &= bits - 1)
+		{
+			const uint32_t bit      = __builtin_ctz(bits);
+			const size_t   detector = group * 8 + bit;
+			const bool     on       = edges->active[group] >> bit & 1;
+			const uint8_t  mainline = meter.mainlineOf[detector];
+			const uint8_t  queue    = meter.queueOf[detector];
+
+			if (mainline != 0)
+			{
+				Mainline *const state = &meter.mainline[mainline - 1];
+
+				if (on)
+				{
+					meter.current.volume++;
+					state->onset = edges->now;
+				}
+				else if (state->onset != 0)
+				{
+					meter.current.occupied +=
+						edges->now - MAX(state->onset, meter.start);
+					state->onset = 0;
+				}
+			}
+
+			if (queue != 0)
+			{
+				meter.metered[queue - 1].onset = on ? edges->now : 0;
+			}
+		}
+	}
+}
+
+/* Selects the traffic responsive level of the mainline as published, and
+ * has the lanes metered by level settle if it changed.
+ */
+static void choose (void)
+{
+	const RmcTrafficResponsive *const levels   = &rmc.rmcTrafficResponsive;
+	const uint16_t occupancy = rmc.rmcMainline.rmcMainlineOccupancy;
+	const uint16_t flow      = rmc.rmcMainline.rmcMainlineFlowRate;
+	uint8_t        level     = 0;
+
+	for (uint8_t row = 0; row < levels->rmcMaxNumTRLevels; row++)
+	{
+		const RmcTRLevelEntry *const entry = &levels->rmcTRLevelTable[row];
+
+		if ((entry->rmcTRLevelOccupancy != 0
+		  && occupancy >= entry->rmcTRLevelOccupancy)
+		 || (entry->rmcTRLevelFlowRate != 0
+		  && flow >= entry->rmcTRLevelFlowRate))
+		{
+			level = row + 1;
+		}
+	}
+
+	if (level == meter.level)
+	{
+		return;
+	}
+
+	meter.level = level;
+
+	for (size_t lane = 0; lane < meter.meteredLanes; lane++)
+	{
+		meter.metered[lane].dirty |=
+			rmc.rmcMeteredLane.rmcMeteredLaneTable[lane].rmcMeterMode
+			== RMC_METER_TRAFFIC_RESPONSIVE;
+	}
+}
+
+/* Publishes the occupancy and flow rate of the window, selecting the level
+ * again if either changed.
+ */
+static void measure (void)
+{
+	RmcMainline *const mainline  = &rmc.rmcMainline;
+	const uint64_t     lanes     = (uint64_t) meter.filled * meter.measured;
+	const uint16_t     occupancy = (uint16_t) (lanes != 0
+		? MIN(meter.window.occupied * RMC_OCCUPANCY_FULL
+		          / (lanes * NANOSECONDS_PER_SECOND),
+		      (uint64_t) RMC_OCCUPANCY_FULL)
+		: 0);
+	const uint16_t     flow      = (uint16_t) (lanes != 0
+		? MIN((uint64_t) meter.window.volume * 3600 / lanes,
+		      (uint64_t) UINT16_MAX)
+		: 0);
+
+	if (occupancy != mainline->rmcMainlineOccupancy
+	 || flow != mainline->rmcMainlineFlowRate)
+	{
+		mainline->rmcMainlineOccupancy = occupancy;
+		mainline->rmcMainlineFlowRate  = flow;
+		choose();
+	}
+}
+
+/* Ends the current bucket at end, replacing the oldest of the window. */
+static void roll (const uint64_t end)
+{
+	for (size_t lane = 0; lane < meter.mainlineLanes; lane++)
+	{
+		const uint64_t onset = meter.mainline[lane].onset;
+
+		if (onset != 0)
+		{
+			meter.current.occupied += end - MAX(onset, meter.start);
+		}
+	}
+
+	Bucket *const oldest = &meter.buckets[meter.next];
+
+	if (meter.filled == meter.length)
+	{
+		meter.window.volume   -= oldest->volume;
+		meter.window.occupied -= oldest->occupied;
+	}
+	else
+	{
+		meter.filled++;
+	}
+
+	*oldest                = meter.current;
+	meter.window.volume   += meter.current.volume;
+	meter.window.occupied += meter.current.occupied;
+	meter.next             = (meter.next + 1) % meter.length;
+	meter.current          = (Bucket) { 0 };
+	meter.start            = end;
+
+	measure();
+}
+
+/* Works out the rate of a lane. */
+static void settle (const size_t lane)
+{
+	RmcMeteredLaneEntry *const entry =
+		&rmc.rmcMeteredLane.rmcMeteredLaneTable[lane];
+	const RmcTrafficResponsive *const levels = &rmc.rmcTrafficResponsive;
+	uint16_t rate = 0;
+
+	switch (entry->rmcMeterMode)
+	{
+		case RMC_METER_FIXED:
+			rate = entry->rmcCmdRate;
+			break;
+
+		case RMC_METER_TRAFFIC_RESPONSIVE:
+			rate = meter.level != 0 && meter.level <= levels->rmcMaxNumTRLevels
+			     ? levels->rmcTRLevelTable[meter.level - 1].rmcTRLevelRate
+			     : entry->rmcMaxMeterRate;
+			break;
+
+		default:
+			break;
+	}
+
+	if (entry->rmcMeterMode == RMC_METER_FIXED
+	 || entry->rmcMeterMode == RMC_METER_TRAFFIC_RESPONSIVE)
+	{
+		if (entry->rmcQueueActive)
+		{
+			rate = entry->rmcMaxMeterRate;
+		}
+
+		rate = MIN(MAX(rate, entry->rmcMinMeterRate), entry->rmcMaxMeterRate);
+	}
+
+	entry->rmcMeterLevel      =
+		entry->rmcMeterMode == RMC_METER_TRAFFIC_RESPONSIVE ? meter.level : 0;
+	entry->rmcMeterRate       = rate;
+	entry->rmcReleaseInterval = (uint16_t) (rate != 0
+		? (TENTHS_PER_HOUR + rate / 2) / rate
+		: 0);
+
+	meter.metered[lane].dirty = false;
+}
+
+void meterTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	if (atomic_exchange_explicit(&stale, false, memory_order_acquire))
+	{
+		rebuild(now);
+		measure();
+		choose();
+	}
+
+	/* A stall longer than the window leaves nothing of it to keep. */
+	if (now - meter.start > (meter.length + 1) * NANOSECONDS_PER_SECOND)
+	{
+		restart(meter.length, now);
+	}
+
+	while (now - meter.start >= NANOSECONDS_PER_SECOND)
+	{
+		roll(meter.start + NANOSECONDS_PER_SECOND);
+	}
+
+	for (size_t lane = 0; lane < meter.meteredLanes; lane++)
+	{
+		RmcMeteredLaneEntry *const entry =
+			&rmc.rmcMeteredLane.rmcMeteredLaneTable[lane];
+		Metered *const state = &meter.metered[lane];
+		const bool     queued = state->onset != 0
+			&& now - state->onset
+			   >= entry->rmcQueueOccupiedTime * NANOSECONDS_PER_TENTH;
+
+		if (queued != (entry->rmcQueueActive != 0))
+		{
+			entry->rmcQueueActive = queued;
+			state->dirty          = true;
+		}
+
+		if (state->dirty)
+		{
+			settle(lane);
+		}
+	}
+}
+
+static void rmcInvalidate (const bool database)
+{
+	if (database)
+	{
+		meterInvalidate();
+	}
+}
+
+/* Meters from the detectors of the asc device, which is served with it. */
+const Device rmcDevice =
+{
+	.name       = "rmc",
+	.subtree    = RMC_OID(),
+	.init       = meterInit,
+	.free       = meterFree,
+	.invalidate = rmcInvalidate,
+	.ticks      = { meterTick }
+};
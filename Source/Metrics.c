@@ -0,0 +1,245 @@
+#include <Metrics.h>
+
+/* Counters of one thread. A shard has a single writer, so an update is a
+ * relaxed load and store rather than a locked read-modify-write; the atomic
+ * types only keep the aggregating reader from seeing torn values.
+ */
+typedef struct MetricsShard
+{
+	atomic_uint_fast64_t count[METRIC_COUNT];
+	atomic_uint_fast64_t total[METRIC_COUNT];
+	atomic_uint_fast64_t maximum[METRIC_COUNT];
+	atomic_uint_fast64_t buckets[METRIC_COUNT][METRICS_BUCKETS];
+} MetricsShard;
+
+static const char *const metricNames[METRIC_COUNT] =
+{
+	[METRIC_DECODE]   = "decode",
+	[METRIC_LOOKUP]   = "lookup",
+	[METRIC_ENCODE]   = "encode",
+	[METRIC_TICK]     = "tick",
+	[METRIC_VERIFY]   = "verify",
+	[METRIC_FSYNC]    = "fsync",
+	[METRIC_LATENESS] = "lateness",
+	[METRIC_PREEMPT]  = "preempt",
+	[METRIC_FORWARD]  = "forward"
+};
+
+static MetricsShard    shards[METRICS_MAX_THREADS];
+static MetricsShard    shared;
+static atomic_size_t   shardsClaimed;
+static MetricsSnapshot snapshot;
+
+static thread_local MetricsShard *ownShard;
+
+static size_t bucketOf (const uint64_t nanoseconds)
+{
+	if (nanoseconds < METRICS_SUB_BUCKETS)
+	{
+		return (size_t) nanoseconds;
+	}
+
+	if (nanoseconds > UINT32_MAX)
+	{
+		return METRICS_BUCKETS - 1;
+	}
+
+	const unsigned shift = 63 - (unsigned) __builtin_clzll(nanoseconds)
+	                     - METRICS_SUB_BITS;
+
+	return (shift + 1) * METRICS_SUB_BUCKETS
+	     + (size_t) ((nanoseconds >> shift) & (METRICS_SUB_BUCKETS - 1));
+}
+
+static uint64_t lowerBoundOf (const size_t bucket)
+{
+	if (bucket < METRICS_SUB_BUCKETS)
+	{
+		return bucket;
+	}
+
+	const unsigned shift = (unsigned) (bucket / METRICS_SUB_BUCKETS) - 1;
+
+	return (uint64_t) (METRICS_SUB_BUCKETS + bucket % METRICS_SUB_BUCKETS)
+	    << shift;
+}
+
+uint32_t metricsBucketLowerBound (const size_t bucket)
+{
+	return (uint32_t) lowerBoundOf(bucket);
+}
+
+static inline void add (atomic_uint_fast64_t *const counter,
+                        const uint64_t amount)
+{
+	atomic_store_explicit(counter,
+	                      atomic_load_explicit(counter, memory_order_relaxed)
+	                      + amount, memory_order_relaxed);
+}
+
+static inline void raiseTo (atomic_uint_fast64_t *const maximum,
+                            const uint64_t value)
+{
+	if (value > atomic_load_explicit(maximum, memory_order_relaxed))
+	{
+		atomic_store_explicit(maximum, value, memory_order_relaxed);
+	}
+}
+
+/* The shared shard has concurrent writers and falls back to atomic
+ * read-modify-write operations.
+ */
+static void recordShared (const Metric metric, const uint64_t nanoseconds)
+{
+	uint_fast64_t maximum =
+		atomic_load_explicit(&shared.maximum[metric], memory_order_relaxed);
+
+	atomic_fetch_add_explicit(&shared.count[metric], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&shared.total[metric], nanoseconds,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shared.buckets[metric][bucketOf(nanoseconds)],
+	                          1, memory_order_relaxed);
+
+	while (nanoseconds > maximum
+	    && !atomic_compare_exchange_weak_explicit(&shared.maximum[metric],
+	                                              &maximum, nanoseconds,
+	                                              memory_order_relaxed,
+	                                              memory_order_relaxed));
+}
+
+void metricsRecord (const Metric metric, const uint64_t nanoseconds)
+{
+	MetricsShard *shard = ownShard;
+
+	if (!shard)
+	{
+		const size_t claimed = atomic_fetch_add_explicit(&shardsClaimed, 1,
+		                                                 memory_order_relaxed);
+
+		shard = ownShard = claimed < METRICS_MAX_THREADS ? &shards[claimed]
+		                                                 : &shared;
+	}
+
+	if (shard == &shared)
+	{
+		recordShared(metric, nanoseconds);
+		return;
+	}
+
+	add(&shard->count[metric], 1);
+	add(&shard->total[metric], nanoseconds);
+	add(&shard->buckets[metric][bucketOf(nanoseconds)], 1);
+	raiseTo(&shard->maximum[metric], nanoseconds);
+}
+
+static uint32_t saturate (const uint64_t value)
+{
+	return (uint32_t) MIN(value, (uint64_t) UINT32_MAX);
+}
+
+/* Upper bound of the bucket holding the given fraction of the samples. */
+static uint32_t percentile (const MetricBucketEntry *const buckets,
+                            const uint64_t count, const uint64_t maximum,
+                            const double fraction)
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	const uint64_t rank = (uint64_t) (fraction * (double) count + 0.5);
+	uint64_t       seen = 0;
+
+	for (size_t bucket = 0; bucket < METRICS_BUCKETS; bucket++)
+	{
+		seen += buckets[bucket].metricBucketCount;
+
+		if (seen >= MAX(rank, 1))
+		{
+			return saturate(MIN(lowerBoundOf(bucket + 1) - 1, maximum));
+		}
+	}
+
+	return saturate(maximum);
+}
+
+static void aggregate (const Metric metric)
+{
+	MetricEntry       *const entry   = &snapshot.metricTable[metric];
+	MetricBucketEntry *const buckets =
+		&snapshot.metricBucketTable[metric * METRICS_BUCKETS];
+	const size_t owned = MIN(atomic_load(&shardsClaimed),
+	                         (size_t) METRICS_MAX_THREADS);
+	uint64_t maximum = atomic_load_explicit(&shared.maximum[metric],
+	                                        memory_order_relaxed);
+
+	entry->metricIndex = metric + 1;
+	entry->metricName  = metricNames[metric];
+	entry->metricCount = atomic_load_explicit(&shared.count[metric],
+	                                          memory_order_relaxed);
+	entry->metricTotal = atomic_load_explicit(&shared.total[metric],
+	                                          memory_order_relaxed);
+
+	for (size_t bucket = 0; bucket < METRICS_BUCKETS; bucket++)
+	{
+		MetricBucketEntry *const row = &buckets[bucket];
+
+		row->metricBucketIndex      = (uint32_t) bucket + 1;
+		row->metricBucketLowerBound = metricsBucketLowerBound(bucket);
+		row->metricBucketCount      =
+			atomic_load_explicit(&shared.buckets[metric][bucket],
+			                     memory_order_relaxed);
+	}
+
+	for (size_t index = 0; index < owned; index++)
+	{
+		const MetricsShard *const shard = &shards[index];
+
+		entry->metricCount += atomic_load_explicit(&shard->count[metric],
+		                                           memory_order_relaxed);
+		entry->metricTotal += atomic_load_explicit(&shard->total[metric],
+		                                           memory_order_relaxed);
+		maximum = MAX(maximum,
+		              atomic_load_explicit(&shard->maximum[metric],
+		                                   memory_order_relaxed));
+
+		for (size_t bucket = 0; bucket < METRICS_BUCKETS; bucket++)
+		{
+			buckets[bucket].metricBucketCount +=
+				atomic_load_explicit(&shard->buckets[metric][bucket],
+				                     memory_order_relaxed);
+		}
+	}
+
+	/* The shards are read while they are written, so the count may lag the
+	 * buckets; the percentiles use the bucket total.
+	 */
+	uint64_t sampled = 0;
+
+	for (size_t bucket = 0; bucket < METRICS_BUCKETS; bucket++)
+	{
+		sampled += buckets[bucket].metricBucketCount;
+	}
+
+	entry->metricMaximum = saturate(maximum);
+	entry->metricP50     = percentile(buckets, sampled, maximum, 0.50);
+	entry->metricP99     = percentile(buckets, sampled, maximum, 0.99);
+	entry->metricP999    = percentile(buckets, sampled, maximum, 0.999);
+}
+
+const MetricsSnapshot *metricsSnapshot (void)
+{
+	const uint64_t now = clockMonotonic();
+
+	if (snapshot.taken == 0 || now - snapshot.taken >= METRICS_SNAPSHOT_AGE)
+	{
+		for (Metric metric = 0; metric < METRIC_COUNT; metric++)
+		{
+			aggregate(metric);
+		}
+
+		snapshot.taken = now;
+	}
+
+	return &snapshot;
+}
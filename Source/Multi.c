@@ -0,0 +1,609 @@
+#include <Multi.h>
+
+#define SIGN_WIDTH  CONFIG_SIGN_WIDTH_PIXELS
+#define SIGN_HEIGHT CONFIG_SIGN_HEIGHT_PIXELS
+
+/* Left, center and right justified text of a line. */
+#define SEGMENTS 3
+
+/* A character set on a line. */
+typedef struct Glyph
+{
+	const CharacterEntry *character;
+	uint8_t               height;   /* Of its font. */
+	uint8_t               segment;
+	uint8_t               spacing;  /* Pixels before it. */
+	uint8_t               fontSpacing;
+} Glyph;
+
+typedef struct Line
+{
+	size_t   first;
+	size_t   count;
+	uint16_t widths[SEGMENTS];
+	uint8_t  height;
+	uint8_t  lineSpacing; /* Largest of its fonts. */
+	int16_t  spacing;     /* Pixels above it from [nlN], or -1. */
+} Line;
+
+/* The page being set, and the state the tags leave for the text after
+ * them.
+ */
+typedef struct Layout
+{
+	const DMS       *sign;
+	const FontEntry *font;
+	size_t           fontRow;
+	int16_t          characterSpacing; /* From [scN], or -1. */
+
+	enum Justification line;
+	enum Justification page;
+	enum Justification pageJustification; /* Of the page being set. */
+	bool               justified;
+	uint8_t            onTime;
+	uint8_t            offTime;
+
+	Glyph  glyphs[MULTI_MAX_LENGTH];
+	size_t glyphCount;
+	Line   lines[MULTI_MAX_LINES];
+	size_t lineCount;
+} Layout;
+
+/* The font numbered number, if it is usable. */
+static bool selectFont (Layout *const layout, const uint32_t number)
+{
+	const FontDefinition *const fonts = &layout->sign->fontDefinition;
+
+	for (size_t row = 0; row < fonts->numFonts; row++)
+	{
+		const FontEntry *const font = &fonts->fontTable[row];
+
+		if (font->fontNumber == number && font->fontHeight != 0
+		 && font->fontStatus != FONT_STATUS_NOT_USED
+		 && font->fontStatus != FONT_STATUS_MODIFYING)
+		{
+			layout->font    = font;
+			layout->fontRow = row;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint8_t lineHeight (const Layout *const layout, const Line *const line)
+{
+	if (line->count != 0 || !layout->font)
+	{
+		return line->height;
+	}
+
+	/* A line without text is as high as the font it was left in. */
+	return MAX(line->height, layout->font->fontHeight);
+}
+
+/* Pixels from the top of the first line to the bottom of the last. */
+static uint32_t pageHeight (const Layout *const layout)
+{
+	uint32_t height = 0;
+
+	for (size_t index = 0; index < layout->lineCount; index++)
+	{
+		const Line *const line = &layout->lines[index];
+
+		if (index != 0)
+		{
+			const Line *const above = &layout->lines[index - 1];
+
+			height += line->spacing >= 0
+			        ? (uint32_t) line->spacing
+			        : MAX(above->lineSpacing, line->lineSpacing);
+		}
+
+		height += lineHeight(layout, line);
+	}
+
+	return height;
+}
+
+static void startPage (Layout *const layout)
+{
+	layout->glyphCount = 0;
+	layout->lineCount  = 1;
+	layout->justified  = false;
+	layout->lines[0]   = (Line) { .spacing = -1 };
+}
+
+static enum MultiSyntaxError newLine (Layout *const layout,
+                                      const int16_t spacing)
+{
+	if (layout->lineCount == MULTI_MAX_LINES)
+	{
+		return MULTI_SYNTAX_TEXT_TOO_BIG;
+	}
+
+	Line *const above = &layout->lines[layout->lineCount - 1];
+
+	above->height = lineHeight(layout, above);
+
+	layout->lines[layout->lineCount++] = (Line)
+	{
+		.first   = layout->glyphCount,
+		.spacing = spacing
+	};
+
+	return pageHeight(layout) > SIGN_HEIGHT ? MULTI_SYNTAX_TEXT_TOO_BIG
+	                                        : MULTI_SYNTAX_NONE;
+}
+
+static enum MultiSyntaxError addCharacter (Layout *const layout,
+                                           const uint32_t code)
+{
+	const FontEntry *const font = layout->font;
+
+	if (!font)
+	{
+		return MULTI_SYNTAX_FONT_NOT_DEFINED;
+	}
+
+	const FontDefinition *const fonts = &layout->sign->fontDefinition;
+
+	if (code == 0 || code > fonts->maxFontCharacters)
+	{
+		return MULTI_SYNTAX_CHARACTER_NOT_DEFINED;
+	}
+
+	const CharacterEntry *const character = &fonts->characterTable
+		[layout->fontRow * fonts->maxFontCharacters + code - 1];
+
+	const size_t length = character->characterBitmap.length;
+
+	if (character->characterWidth == 0
+	 || length * 8 < (size_t) character->characterWidth * font->fontHeight)
+	{
+		return MULTI_SYNTAX_CHARACTER_NOT_DEFINED;
+	}
+
+	if (layout->line < JUSTIFICATION_LEFT
+	 || layout->line > JUSTIFICATION_RIGHT)
+	{
+		return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+	}
+
+	Line *const   line    = &layout->lines[layout->lineCount - 1];
+	const uint8_t segment = (uint8_t) (layout->line - JUSTIFICATION_LEFT);
+	Glyph *const  glyph   = &layout->glyphs[layout->glyphCount];
+
+	/* Segments follow each other from left to right. */
+	if (line->count != 0 && layout->glyphs[layout->glyphCount - 1].segment
+	                      > segment)
+	{
+		return MULTI_SYNTAX_TAG_CONFLICT;
+	}
+
+	*glyph = (Glyph)
+	{
+		.character   = character,
+		.height      = font->fontHeight,
+		.segment     = segment,
+		.fontSpacing = layout->characterSpacing >= 0
+		             ? (uint8_t) layout->characterSpacing
+		             : font->fontCharSpacing
+	};
+
+	/* Between characters of two fonts, the larger spacing of the two. */
+	if (line->count != 0 && glyph[-1].segment == segment)
+	{
+		glyph->spacing = layout->characterSpacing >= 0
+		               ? glyph->fontSpacing
+		               : MAX(glyph[-1].fontSpacing, glyph->fontSpacing);
+	}
+
+	line->widths[segment] += glyph->spacing + character->characterWidth;
+	line->height           = MAX(line->height, font->fontHeight);
+	line->lineSpacing      = MAX(line->lineSpacing, font->fontLineSpacing);
+	line->count++;
+	layout->glyphCount++;
+
+	if (!layout->justified)
+	{
+		layout->pageJustification = layout->page;
+		layout->justified         = true;
+	}
+
+	if ((uint32_t) line->widths[0] + line->widths[1] + line->widths[2]
+	    > SIGN_WIDTH
+	 || pageHeight(layout) > SIGN_HEIGHT)
+	{
+		return MULTI_SYNTAX_TEXT_TOO_BIG;
+	}
+
+	return MULTI_SYNTAX_NONE;
+}
+
+static void blit (uint8_t *const bitmap, const Glyph *const glyph,
+                  const uint32_t left, const uint32_t top)
+{
+	const uint8_t  width = glyph->character->characterWidth;
+	const uint8_t *bits  = glyph->character->characterBitmap.octets;
+
+	for (uint32_t y = 0, bit = 0; y < glyph->height; y++)
+	{
+		uint32_t pixel = (top + y) * SIGN_WIDTH + left;
+
+		for (uint32_t x = 0; x < width; x++, bit++, pixel++)
+		{
+			if (bits[bit / 8] & (0x80 >> (bit % 8)))
+			{
+				bitmap[pixel / 8] |= (uint8_t) (0x80 >> (pixel % 8));
+			}
+		}
+	}
+}
+
+static void renderPage (const Layout *const layout, MultiPage *const page)
+{
+	const uint32_t height = pageHeight(layout);
+	uint32_t       top    = 0;
+
+	memset(page->bitmap, 0, sizeof(page->bitmap));
+	page->onTime  = layout->onTime;
+	page->offTime = layout->offTime;
+
+	switch (layout->justified ? layout->pageJustification : layout->page)
+	{
+		case JUSTIFICATION_CENTER:
+			top = (SIGN_HEIGHT - height) / 2;
+			break;
+
+		case JUSTIFICATION_RIGHT:
+			top = SIGN_HEIGHT - height;
+			break;
+
+		default:
+			break;
+	}
+
+	for (size_t index = 0; index < layout->lineCount; index++)
+	{
+		const Line *const line = &layout->lines[index];
+
+		if (index != 0)
+		{
+			top += line->spacing >= 0
+			     ? (uint32_t) line->spacing
+			     : MAX(layout->lines[index - 1].lineSpacing,
+			           line->lineSpacing);
+		}
+
+		/* Centered text stays clear of the left and right text. */
+		const uint32_t center =
+			MIN(MAX((SIGN_WIDTH - line->widths[1]) / 2, line->widths[0]),
+			    SIGN_WIDTH - line->widths[2] - line->widths[1]);
+		const uint8_t  lineHigh = lineHeight(layout, line);
+
+		uint32_t left[SEGMENTS] = { 0, center, SIGN_WIDTH - line->widths[2] };
+
+		for (size_t at = line->first; at < line->first + line->count; at++)
+		{
+			const Glyph *const glyph = &layout->glyphs[at];
+
+			left[glyph->segment] += glyph->spacing;
+			blit(page->bitmap, glyph, left[glyph->segment],
+			     top + lineHigh - glyph->height);
+			left[glyph->segment] += glyph->character->characterWidth;
+		}
+
+		top += lineHigh;
+	}
+}
+
+/* Reads a number in base from text, advancing at past it. False if there
+ * is none or it exceeds maximum.
+ */
+static bool readNumber (const uint8_t *const text, const size_t length,
+                        size_t *const at, const uint32_t base,
+                        const uint32_t maximum, uint32_t *const value)
+{
+	const size_t start = *at;
+
+	*value = 0;
+
+	for (; *at < length; (*at)++)
+	{
+		const uint8_t octet = text[*at];
+		uint32_t      digit;
+
+		if (octet >= '0' && octet <= '9')
+		{
+			digit = octet - '0';
+		}
+		else if (base == 16 && (octet | 0x20) >= 'a' && (octet | 0x20) <= 'f')
+		{
+			digit = (octet | 0x20) - 'a' + 10;
+		}
+		else
+		{
+			break;
+		}
+
+		*value = *value * base + digit;
+
+		if (*value > maximum)
+		{
+			return false;
+		}
+	}
+
+	return *at > start;
+}
+
+/* True if the tag starts with name, in any case, leaving at after it. */
+static bool tagIs (const uint8_t *const tag, const size_t length,
+                   const char *const name, size_t *const at)
+{
+	const size_t size = strlen(name);
+
+	if (length < size)
+	{
+		return false;
+	}
+
+	for (size_t index = 0; index < size; index++)
+	{
+		if ((tag[index] | 0x20) != (uint8_t) name[index])
+		{
+			return false;
+		}
+	}
+
+	*at = size;
+	return true;
+}
+
+static enum MultiSyntaxError applyTag (Layout *const layout,
+                                       MultiMessage *const message,
+                                       const uint8_t *const tag,
+                                       const size_t length)
+{
+	const MultiCfg *const defaults = &layout->sign->multiCfg;
+	size_t                at       = 0;
+	uint32_t              value;
+
+	if (tagIs(tag, length, "nl", &at))
+	{
+		if (at == length)
+		{
+			return newLine(layout, -1);
+		}
+
+		return readNumber(tag, length, &at, 10, 9, &value) && at == length
+		     ? newLine(layout, (int16_t) value)
+		     : MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+	}
+
+	if (tagIs(tag, length, "np", &at) && at == length)
+	{
+		if (message->pageCount + 1 == MULTI_MAX_PAGES)
+		{
+			return MULTI_SYNTAX_TOO_MANY_PAGES;
+		}
+
+		renderPage(layout, &message->pages[message->pageCount++]);
+		startPage(layout);
+		return MULTI_SYNTAX_NONE;
+	}
+
+	if (tagIs(tag, length, "fo", &at))
+	{
+		if (at == length)
+		{
+			return selectFont(layout, defaults->defaultFont)
+			     ? MULTI_SYNTAX_NONE : MULTI_SYNTAX_FONT_NOT_DEFINED;
+		}
+
+		if (!readNumber(tag, length, &at, 10, UINT8_MAX, &value))
+		{
+			return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+		}
+
+		if (!selectFont(layout, value))
+		{
+			return MULTI_SYNTAX_FONT_NOT_DEFINED;
+		}
+
+		if (at < length && tag[at] == ',')
+		{
+			at++;
+
+			if (!readNumber(tag, length, &at, 16, UINT16_MAX, &value)
+			 || at != length)
+			{
+				return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+			}
+
+			if (value != layout->font->fontVersionID)
+			{
+				return MULTI_SYNTAX_FONT_VERSION_ID;
+			}
+		}
+
+		return at == length ? MULTI_SYNTAX_NONE
+		                    : MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+	}
+
+	if (tagIs(tag, length, "jl", &at))
+	{
+		if (at == length)
+		{
+			layout->line = defaults->defaultJustificationLine;
+			return MULTI_SYNTAX_NONE;
+		}
+
+		if (!readNumber(tag, length, &at, 10, 9, &value) || at != length
+		 || value < JUSTIFICATION_LEFT || value > JUSTIFICATION_RIGHT)
+		{
+			return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+		}
+
+		layout->line = value;
+		return MULTI_SYNTAX_NONE;
+	}
+
+	if (tagIs(tag, length, "jp", &at))
+	{
+		if (at == length)
+		{
+			layout->page = defaults->defaultJustificationPage;
+			return MULTI_SYNTAX_NONE;
+		}
+
+		if (!readNumber(tag, length, &at, 10, 9, &value) || at != length
+		 || value < JUSTIFICATION_LEFT || value > JUSTIFICATION_RIGHT)
+		{
+			return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+		}
+
+		layout->page = value;
+		return MULTI_SYNTAX_NONE;
+	}
+
+	if (tagIs(tag, length, "pt", &at))
+	{
+		layout->onTime  = defaults->defaultPageOnTime;
+		layout->offTime = defaults->defaultPageOffTime;
+
+		if (readNumber(tag, length, &at, 10, UINT8_MAX, &value))
+		{
+			layout->onTime = (uint8_t) value;
+		}
+
+		if (at < length && (tag[at] | 0x20) == 'o')
+		{
+			at++;
+
+			if (!readNumber(tag, length, &at, 10, UINT8_MAX, &value))
+			{
+				return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+			}
+
+			layout->offTime = (uint8_t) value;
+		}
+
+		return at == length ? MULTI_SYNTAX_NONE
+		                    : MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+	}
+
+	if (tagIs(tag, length, "/sc", &at) && at == length)
+	{
+		layout->characterSpacing = -1;
+		return MULTI_SYNTAX_NONE;
+	}
+
+	if (tagIs(tag, length, "sc", &at))
+	{
+		if (!readNumber(tag, length, &at, 10, 99, &value) || at != length)
+		{
+			return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+		}
+
+		layout->characterSpacing = (int16_t) value;
+		return MULTI_SYNTAX_NONE;
+	}
+
+	if (tagIs(tag, length, "hc", &at))
+	{
+		if (!readNumber(tag, length, &at, 16, UINT16_MAX, &value)
+		 || at != length)
+		{
+			return MULTI_SYNTAX_UNSUPPORTED_TAG_VALUE;
+		}
+
+		return addCharacter(layout, value);
+	}
+
+	return MULTI_SYNTAX_UNSUPPORTED_TAG;
+}
+
+enum MultiSyntaxError multiRender (const DMS *const sign,
+                                   const uint8_t *const multi,
+                                   const size_t length,
+                                   MultiMessage *const message,
+                                   size_t *const position)
+{
+	static thread_local Layout layout;
+
+	const MultiCfg *const defaults = &sign->multiCfg;
+	size_t                at       = 0;
+	enum MultiSyntaxError error    = MULTI_SYNTAX_NONE;
+
+	layout = (Layout)
+	{
+		.sign             = sign,
+		.characterSpacing = -1,
+		.line             = defaults->defaultJustificationLine,
+		.page             = defaults->defaultJustificationPage,
+		.onTime           = defaults->defaultPageOnTime,
+		.offTime          = defaults->defaultPageOffTime
+	};
+
+	message->pageCount = 0;
+	selectFont(&layout, defaults->defaultFont);
+	startPage(&layout);
+
+	if (length > MULTI_MAX_LENGTH)
+	{
+		*position = MULTI_MAX_LENGTH;
+		return MULTI_SYNTAX_TEXT_TOO_BIG;
+	}
+
+	while (at < length && error == MULTI_SYNTAX_NONE)
+	{
+		const uint8_t octet = multi[at];
+
+		*position = at;
+
+		if (octet == '[' && at + 1 < length && multi[at + 1] == '[')
+		{
+			error = addCharacter(&layout, '[');
+			at   += 2;
+		}
+		else if (octet == ']' && at + 1 < length && multi[at + 1] == ']')
+		{
+			error = addCharacter(&layout, ']');
+			at   += 2;
+		}
+		else if (octet == '[')
+		{
+			const uint8_t *const end =
+				memchr(multi + at + 1, ']', length - at - 1);
+
+			if (!end)
+			{
+				return MULTI_SYNTAX_OTHER;
+			}
+
+			error = applyTag(&layout, message, multi + at + 1,
+			                 (size_t) (end - multi) - at - 1);
+			at    = (size_t) (end - multi) + 1;
+		}
+		else if (octet == ']')
+		{
+			return MULTI_SYNTAX_OTHER;
+		}
+		else
+		{
+			error = addCharacter(&layout, octet);
+			at++;
+		}
+	}
+
+	if (error != MULTI_SYNTAX_NONE)
+	{
+		return error;
+	}
+
+	renderPage(&layout, &message->pages[message->pageCount++]);
+
+	return MULTI_SYNTAX_NONE;
+}
@@ -0,0 +1,374 @@
+#include <Notify.h>
+#include <Clock.h>
+#include <MIB.h>
+
+/* NTCIP 1202 defines no notifications of its own, so changes are reported
+ * under this OID below the asc node. The varbinds that follow the standard
+ * sysUpTime.0 and snmpTrapOID.0 pair are the changed objects themselves.
+ */
+static const OID ascStatusChange = ASC_OID(0, 1);
+
+static const OID vehicleDetectorAlarms    = ASC_OID(2, 2, 1, 12);
+static const OID pedestrianDetectorAlarms = ASC_OID(2, 7, 1, 6);
+
+/* Columns 2 .. 11 of the phaseStatusGroupTable, in column order. */
+static const size_t phaseStatusGroupColumns[] =
+{
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupReds),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupYellows),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupGreens),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupDontWalks),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupPedClears),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupWalks),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupVehCalls),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupPedCalls),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupPhaseOns),
+	offsetof(PhaseStatusGroupEntry, phaseStatusGroupPhaseNexts)
+};
+
+bool notifyInit (Notify *const notify, const NotifyConfig *const config)
+{
+	memset(notify, 0, sizeof(*notify));
+
+	notify->config = *config;
+	notify->epoch  = clockMonotonic();
+	notify->socket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+	                        0);
+
+	if (notify->socket < 0)
+	{
+		return false;
+	}
+
+	/* A random starting request-id keeps acknowledgements of a previous run
+	 * from matching informs of this one.
+	 */
+	if (getrandom(&notify->requestID, sizeof(notify->requestID), 0) < 0)
+	{
+		notify->requestID = (int32_t) notify->epoch;
+	}
+
+	notify->requestID &= INT32_MAX;
+
+	return true;
+}
+
+void notifyClose (Notify *const notify)
+{
+	if (notify->socket >= 0)
+	{
+		close(notify->socket);
+		notify->socket = -1;
+	}
+}
+
+static void transmit (const Notify *const notify, const uint8_t *const message,
+                      const size_t length)
+{
+	/* A notification that cannot be queued by the kernel is lost just as one
+	 * lost on the wire; informs are recovered by retransmission.
+	 */
+	(void) sendto(notify->socket, message, length, MSG_DONTWAIT,
+	              (const struct sockaddr *) &notify->config.destination,
+	              sizeof(notify->config.destination));
+}
+
+static NotifyInform *allocateInform (Notify *const notify)
+{
+	NotifyInform *oldest = &notify->informs[0];
+
+	for (size_t index = 0; index < NOTIFY_MAX_INFORMS; index++)
+	{
+		NotifyInform *const inform = &notify->informs[index];
+
+		if (!inform->active)
+		{
+			return inform;
+		}
+
+		if (inform->deadline < oldest->deadline)
+		{
+			oldest = inform;
+		}
+	}
+
+	/* Every slot is waiting on a manager that is not answering; give up on
+	 * the one closest to its next retransmission.
+	 */
+	notify->informsDropped++;
+
+	return oldest;
+}
+
+static void flush (Notify *const notify, const uint64_t now)
+{
+	const VarBind upTime =
+	{
+		.name          = SYS_UP_TIME_OID,
+		.type          = BER_TIMETICKS,
+		.value.counter = (now - notify->epoch)
+		               / (10 * NANOSECONDS_PER_MILLISECOND)
+	};
+
+	const VarBind trapOID =
+	{
+		.name      = SNMP_TRAP_OID_OID,
+		.type      = BER_OID,
+		.value.oid = ascStatusChange
+	};
+
+	const uint8_t type      = notify->config.inform ? SNMP_INFORM_REQUEST
+	                                                : SNMP_TRAP;
+	const int32_t requestID = notify->requestID;
+	uint8_t       buffer[SNMP_MAX_MESSAGE];
+	BERWriter     writer;
+
+	notify->requestID = (notify->requestID + 1) & INT32_MAX;
+
+	berWriterInit(&writer, buffer, sizeof(buffer));
+
+	for (size_t index = notify->pending; index > 0; index--)
+	{
+		snmpWriteVarBind(&writer, &notify->batch[index - 1]);
+	}
+
+	snmpWriteVarBind(&writer, &trapOID);
+	snmpWriteVarBind(&writer, &upTime);
+	berWriteConstructed(&writer, BER_SEQUENCE, 0);
+	berWriteInteger(&writer, BER_INTEGER, 0);
+	berWriteInteger(&writer, BER_INTEGER, 0);
+	berWriteInteger(&writer, BER_INTEGER, requestID);
+	berWriteConstructed(&writer, type, 0);
+	berWriteOctetString(&writer, notify->config.community,
+	                    strlen(notify->config.community));
+	berWriteInteger(&writer, BER_INTEGER, SNMP_VERSION_2C);
+	berWriteConstructed(&writer, BER_SEQUENCE, 0);
+
+	notify->pending = 0;
+
+	if (writer.overflow)
+	{
+		return;
+	}
+
+	const size_t length = berWriterLength(&writer);
+
+	transmit(notify, berWriterData(&writer), length);
+	notify->notificationsSent++;
+
+	if (notify->config.inform)
+	{
+		NotifyInform *const inform = allocateInform(notify);
+
+		inform->active    = true;
+		inform->requestID = requestID;
+		inform->retries   = 0;
+		inform->timeout   = notify->config.informTimeout
+		                  * NANOSECONDS_PER_MILLISECOND;
+		inform->deadline  = now + inform->timeout;
+		inform->length    = length;
+		memcpy(inform->message, berWriterData(&writer), length);
+	}
+}
+
+static void queueChange (Notify *const notify, const OID *const column,
+                         const uint32_t instance, const uint8_t value,
+                         const uint64_t now)
+{
+	OID name = *column;
+
+	oidAppend(&name, instance);
+
+	/* A second change of the same object inside the window replaces the
+	 * value already queued rather than taking another varbind.
+	 */
+	for (size_t index = 0; index < notify->pending; index++)
+	{
+		if (oidCompare(&notify->batch[index].name, &name) == 0)
+		{
+			notify->batch[index].value.integer = value;
+			notify->changesCoalesced++;
+			return;
+		}
+	}
+
+	if (notify->pending == NOTIFY_MAX_BATCH)
+	{
+		flush(notify, now);
+	}
+
+	if (notify->pending == 0)
+	{
+		notify->windowDeadline = now + notify->config.coalesceWindow
+		                             * NANOSECONDS_PER_MILLISECOND;
+	}
+
+	VarBind *const varbind = &notify->batch[notify->pending++];
+
+	varbind->name          = name;
+	varbind->type          = BER_INTEGER;
+	varbind->value.integer = value;
+}
+
+static void watch (Notify *const notify, uint8_t *const reported,
+                   const uint8_t value, const OID *const column,
+                   const uint32_t instance, const uint64_t now)
+{
+	if (*reported == value)
+	{
+		return;
+	}
+
+	*reported = value;
+
+	/* The first scan only records the baseline. */
+	if (notify->primed)
+	{
+		queueChange(notify, column, instance, value, now);
+	}
+}
+
+void notifyScan (Notify *const notify, const ASC *const asc,
+                 const uint64_t now)
+{
+	const Detector *const detector = &asc->detector;
+	const Phase    *const phase    = &asc->phase;
+
+	for (uint8_t index = 0; index < detector->maxVehicleDetectors; index++)
+	{
+		watch(notify, &notify->vehicleDetectorAlarms[index],
+		      detector->vehicleDetectorTable[index].vehicleDetectorAlarms,
+		      &vehicleDetectorAlarms, index + 1u, now);
+	}
+
+	for (uint8_t index = 0; index < detector->maxPedestrianDetectors; index++)
+	{
+		watch(notify, &notify->pedestrianDetectorAlarms[index],
+		      detector->pedestrianDetectorTable[index].pedestrianDetectorAlarms,
+		      &pedestrianDetectorAlarms, index + 1u, now);
+	}
+
+	for (uint8_t index = 0; index < phase->maxPhaseGroups; index++)
+	{
+		const uint8_t *const current  =
+			(const uint8_t *) &phase->phaseStatusGroupTable[index];
+		uint8_t       *const reported =
+			(uint8_t *) &notify->phaseStatusGroups[index];
+
+		for (size_t column = 0; column < sizeof(phaseStatusGroupColumns)
+		                               / sizeof(size_t); column++)
+		{
+			const size_t offset = phaseStatusGroupColumns[column];
+
+			if (current[offset] == reported[offset])
+			{
+				continue;
+			}
+
+			const OID name = ASC_OID(1, 4, 1, (uint32_t) column + 2);
+
+			watch(notify, &reported[offset], current[offset], &name,
+			      index + 1u, now);
+		}
+	}
+
+	notify->primed = true;
+}
+
+/* Returns the request-id of a well-formed Response, or -1. */
+static int32_t responseID (const uint8_t *const data, const size_t length)
+{
+	BERReader      reader, message, pdu;
+	const uint8_t *community;
+	size_t         communityLength;
+	int64_t        version, requestID;
+
+	berReaderInit(&reader, data, length);
+
+	if (!berEnter(&reader, BER_SEQUENCE, &message)
+	 || !berReadInteger(&message, BER_INTEGER, &version)
+	 || !berReadOctetString(&message, &community, &communityLength)
+	 || !berEnter(&message, SNMP_RESPONSE, &pdu)
+	 || !berReadInteger(&pdu, BER_INTEGER, &requestID)
+	 || requestID < 0 || requestID > INT32_MAX)
+	{
+		return -1;
+	}
+
+	return (int32_t) requestID;
+}
+
+static void receiveAcknowledgements (Notify *const notify)
+{
+	uint8_t            buffer[SNMP_MAX_MESSAGE];
+	struct sockaddr_in source;
+	socklen_t          sourceLength = sizeof(source);
+	ssize_t            length;
+
+	while ((length = recvfrom(notify->socket, buffer, sizeof(buffer),
+	                          MSG_DONTWAIT, (struct sockaddr *) &source,
+	                          &sourceLength)) >= 0)
+	{
+		const struct sockaddr_in *const destination =
+			&notify->config.destination;
+		const int32_t requestID = responseID(buffer, (size_t) length);
+
+		sourceLength = sizeof(source);
+
+		if (requestID < 0
+		 || source.sin_addr.s_addr != destination->sin_addr.s_addr
+		 || source.sin_port != destination->sin_port)
+		{
+			continue;
+		}
+
+		for (size_t index = 0; index < NOTIFY_MAX_INFORMS; index++)
+		{
+			NotifyInform *const inform = &notify->informs[index];
+
+			if (inform->active && inform->requestID == requestID)
+			{
+				inform->active = false;
+				notify->informsAcknowledged++;
+				break;
+			}
+		}
+	}
+}
+
+void notifyService (Notify *const notify, const uint64_t now)
+{
+	if (notify->config.inform)
+	{
+		receiveAcknowledgements(notify);
+	}
+
+	if (notify->pending != 0 && now >= notify->windowDeadline)
+	{
+		flush(notify, now);
+	}
+
+	for (size_t index = 0; index < NOTIFY_MAX_INFORMS; index++)
+	{
+		NotifyInform *const inform = &notify->informs[index];
+
+		if (!inform->active || now < inform->deadline)
+		{
+			continue;
+		}
+
+		if (inform->retries == notify->config.informRetries)
+		{
+			inform->active = false;
+			notify->informsDropped++;
+			continue;
+		}
+
+		inform->retries++;
+		inform->timeout  *= 2;
+		inform->deadline  = now + inform->timeout;
+		notify->informsRetransmitted++;
+
+		transmit(notify, inform->message, inform->length);
+	}
+}
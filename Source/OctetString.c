@@ -0,0 +1,263 @@
+#include <OctetString.h>
+
+/* An interned string. Entries are appended to the arena and never change or
+ * move, so a pointer to one stays valid for the life of the process.
+ */
+typedef struct Entry
+{
+	uint32_t hash;
+	uint16_t length;
+	uint8_t  octets[];
+} Entry;
+
+/* Entries start on a word of the arena, so their headers are aligned. */
+#define ENTRY_ALIGNMENT sizeof(uint32_t)
+
+/* Where the pointer of an interned string is stored within octets. */
+#define POINTER_OFFSET 7
+
+static_assert((CONFIG_STRING_SLOTS & (CONFIG_STRING_SLOTS - 1)) == 0,
+              "CONFIG_STRING_SLOTS must be a power of two");
+
+static uint32_t arena[CONFIG_STRING_ARENA_SIZE / ENTRY_ALIGNMENT];
+
+/* Open-addressed index of the arena: offset of an entry plus one, or zero
+ * for a free slot.
+ */
+static uint32_t slots[CONFIG_STRING_SLOTS];
+
+static size_t          used;
+static size_t          entries;
+static size_t          requests;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Room held by octetStringReserve() for every thread, and what the calling
+ * thread holds of it.
+ */
+static size_t              reserved;
+static size_t              reservedEntries;
+static thread_local size_t held;
+static thread_local size_t heldEntries;
+
+/* FNV-1a */
+static uint32_t hashOf (const uint8_t *const data, const size_t length)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t index = 0; index < length; index++)
+	{
+		hash = (hash ^ data[index]) * 16777619u;
+	}
+
+	return hash;
+}
+
+static const Entry *entryAt (const uint32_t slot)
+{
+	return (const Entry *) ((const uint8_t *) arena + slot - 1);
+}
+
+/* The slot holding data, or the free slot where it goes. */
+static size_t find (const uint8_t *const data, const size_t length,
+                    const uint32_t hash)
+{
+	size_t slot = hash & (CONFIG_STRING_SLOTS - 1);
+
+	for (; slots[slot] != 0; slot = (slot + 1) & (CONFIG_STRING_SLOTS - 1))
+	{
+		const Entry *const entry = entryAt(slots[slot]);
+
+		if (entry->hash == hash && entry->length == length
+		 && memcmp(entry->octets, data, length) == 0)
+		{
+			break;
+		}
+	}
+
+	return slot;
+}
+
+/* Octets an entry of length octets takes. */
+static size_t sizeOf (const size_t length)
+{
+	return (sizeof(Entry) + length + ENTRY_ALIGNMENT - 1)
+	     & ~(ENTRY_ALIGNMENT - 1);
+}
+
+/* Whether count more entries taking octets more fit beside the room held.
+ * Half the slots at most are used, which keeps probes short.
+ */
+static bool room (const size_t octets, const size_t count)
+{
+	return entries + reservedEntries + count <= CONFIG_STRING_SLOTS / 2
+	    && used + reserved + octets <= sizeof(arena);
+}
+
+/* The entry holding data, added if there is none. NULL if the arena or its
+ * index is full.
+ */
+static const Entry *intern (const uint8_t *const data, const size_t length)
+{
+	const uint32_t hash = hashOf(data, length);
+	const size_t   slot = find(data, length, hash);
+
+	if (slots[slot] != 0)
+	{
+		return entryAt(slots[slot]);
+	}
+
+	const size_t size = sizeOf(length);
+
+	/* An entry the calling thread reserved takes the room it holds. */
+	if (heldEntries > 0 && held >= size)
+	{
+		held            -= size;
+		heldEntries     -= 1;
+		reserved        -= size;
+		reservedEntries -= 1;
+	}
+	else if (length > UINT16_MAX || !room(size, 1))
+	{
+		return NULL;
+	}
+
+	Entry *const entry = (Entry *) ((uint8_t *) arena + used);
+
+	entry->hash   = hash;
+	entry->length = (uint16_t) length;
+	memcpy(entry->octets, data, length);
+
+	slots[slot] = (uint32_t) used + 1;
+	used       += size;
+	entries++;
+
+	return entry;
+}
+
+bool octetStringSet (OctetString *const string, const void *const data,
+                     const size_t length)
+{
+	if (length <= OCTET_STRING_INLINE)
+	{
+		string->length = (uint8_t) length;
+		memcpy(string->octets, data, length);
+		return true;
+	}
+
+	pthread_mutex_lock(&lock);
+
+	const Entry *const entry = intern(data, length);
+
+	requests++;
+	pthread_mutex_unlock(&lock);
+
+	if (!entry)
+	{
+		return false;
+	}
+
+	string->length = OCTET_STRING_INTERNED;
+	memcpy(string->octets + POINTER_OFFSET, &entry, sizeof(entry));
+
+	return true;
+}
+
+bool octetStringSetText (OctetString *const string, const char *const text)
+{
+	return octetStringSet(string, text, strlen(text));
+}
+
+bool octetStringReserve (const void *const data, const size_t length)
+{
+	if (length <= OCTET_STRING_INLINE)
+	{
+		return true;
+	}
+
+	pthread_mutex_lock(&lock);
+
+	const size_t size   = sizeOf(length);
+	const bool   needed =
+		slots[find(data, length, hashOf(data, length))] == 0;
+	const bool   fits   = !needed
+	                   || (length <= UINT16_MAX && room(size, 1));
+
+	if (needed && fits)
+	{
+		held            += size;
+		heldEntries     += 1;
+		reserved        += size;
+		reservedEntries += 1;
+	}
+
+	pthread_mutex_unlock(&lock);
+
+	return fits;
+}
+
+void octetStringRelease (void)
+{
+	pthread_mutex_lock(&lock);
+
+	reserved        -= held;
+	reservedEntries -= heldEntries;
+	held             = 0;
+	heldEntries      = 0;
+
+	pthread_mutex_unlock(&lock);
+}
+
+const uint8_t *octetStringData (const OctetString *const string,
+                                size_t *const length)
+{
+	if (string->length != OCTET_STRING_INTERNED)
+	{
+		*length = string->length;
+		return string->octets;
+	}
+
+	const Entry *entry;
+
+	memcpy(&entry, string->octets + POINTER_OFFSET, sizeof(entry));
+
+	*length = entry->length;
+	return entry->octets;
+}
+
+void octetStringArena (OctetStringArena *const state)
+{
+	pthread_mutex_lock(&lock);
+
+	state->used     = used;
+	state->entries  = entries;
+	state->requests = requests;
+
+	pthread_mutex_unlock(&lock);
+}
+
+bool octetBufferSet (void *const buffer, const size_t capacity,
+                     const void *const data, const size_t length)
+{
+	if (length > capacity || length > UINT16_MAX)
+	{
+		return false;
+	}
+
+	const uint16_t stored = (uint16_t) length;
+
+	memcpy((uint8_t *) buffer + OCTET_BUFFER_OFFSET, data, length);
+	memcpy(buffer, &stored, sizeof(stored));
+
+	return true;
+}
+
+const uint8_t *octetBufferData (const void *const buffer,
+                                size_t *const length)
+{
+	uint16_t stored;
+
+	memcpy(&stored, buffer, sizeof(stored));
+
+	*length = stored;
+	return (const uint8_t *) buffer + OCTET_BUFFER_OFFSET;
+}
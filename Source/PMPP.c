@@ -0,0 +1,579 @@
+#include <PMPP.h>
+
+static_assert((PMPP_RING_SIZE & (PMPP_RING_SIZE - 1)) == 0,
+              "the ring size must be a power of two");
+
+/* FCS-16 lookup table, polynomial x^16 + x^12 + x^5 + 1 (RFC 1662). */
+static const uint16_t fcsTable[256] =
+{
+	0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+	0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+	0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+	0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+	0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+	0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+	0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+	0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+	0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+	0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+	0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+	0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+	0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+	0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+	0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+	0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+	0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+	0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+	0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+	0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+	0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+	0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+	0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+	0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+	0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+	0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+	0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+	0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+	0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+	0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+	0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+	0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
+};
+
+uint16_t pmppFCS (uint16_t fcs, const uint8_t *const data,
+                  const size_t length)
+{
+	for (size_t index = 0; index < length; index++)
+	{
+		fcs = (uint16_t) (fcs >> 8) ^ fcsTable[(fcs ^ data[index]) & 0xFF];
+	}
+
+	return fcs;
+}
+
+/* Maps the same memory twice, back to back. */
+static bool ringInit (PMPPRing *const ring)
+{
+	const int memory = memfd_create("pmpp", MFD_CLOEXEC);
+
+	if (memory < 0)
+	{
+		return false;
+	}
+
+	uint8_t *const area = ftruncate(memory, PMPP_RING_SIZE) == 0
+		? mmap(NULL, 2 * PMPP_RING_SIZE, PROT_NONE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+		: MAP_FAILED;
+
+	if (area == MAP_FAILED
+	 || mmap(area, PMPP_RING_SIZE, PROT_READ | PROT_WRITE,
+	         MAP_SHARED | MAP_FIXED, memory, 0) == MAP_FAILED
+	 || mmap(area + PMPP_RING_SIZE, PMPP_RING_SIZE, PROT_READ | PROT_WRITE,
+	         MAP_SHARED | MAP_FIXED, memory, 0) == MAP_FAILED)
+	{
+		if (area != MAP_FAILED)
+		{
+			munmap(area, 2 * PMPP_RING_SIZE);
+		}
+
+		close(memory);
+		return false;
+	}
+
+	close(memory);
+
+	ring->data = area;
+	ring->head = 0;
+	ring->tail = 0;
+
+	return true;
+}
+
+static void ringFree (PMPPRing *const ring)
+{
+	if (ring->data)
+	{
+		munmap(ring->data, 2 * PMPP_RING_SIZE);
+		ring->data = NULL;
+	}
+}
+
+/* Position in the first mapping. Up to PMPP_RING_SIZE octets from here are
+ * contiguous.
+ */
+static uint8_t *at (const PMPPRing *const ring, const uint64_t position)
+{
+	return ring->data + (position & (PMPP_RING_SIZE - 1));
+}
+
+static size_t ringSpace (const PMPPRing *const ring)
+{
+	return PMPP_RING_SIZE - (size_t) (ring->head - ring->tail);
+}
+
+/* Starts assembling a frame after the octet last examined. */
+static void restart (PMPPLink *const link)
+{
+	link->frame   = link->scan;
+	link->end     = link->scan;
+	link->fcs     = PMPP_FCS_INIT;
+	link->escaped = false;
+}
+
+static bool linkInit (PMPPLink *const link, const int fd,
+                      const uint16_t address)
+{
+	memset(link, 0, sizeof(*link));
+
+	link->fd      = fd;
+	link->peer    = -1;
+	link->address = address;
+	link->hunting = true;
+
+	restart(link);
+
+	if (!ringInit(&link->receive) || !ringInit(&link->transmit))
+	{
+		ringFree(&link->receive);
+		return false;
+	}
+
+	return true;
+}
+
+static bool speedOf (const uint32_t speed, speed_t *const value)
+{
+	switch (speed)
+	{
+		case 1200:   *value = B1200;   return true;
+		case 2400:   *value = B2400;   return true;
+		case 4800:   *value = B4800;   return true;
+		case 9600:   *value = B9600;   return true;
+		case 19200:  *value = B19200;  return true;
+		case 38400:  *value = B38400;  return true;
+		case 57600:  *value = B57600;  return true;
+		case 115200: *value = B115200; return true;
+		default:     return false;
+	}
+}
+
+/* Raw mode: no echo, no line editing and no translation of any octet. */
+static bool raw (const int fd, const speed_t *const speed)
+{
+	struct termios settings;
+
+	if (tcgetattr(fd, &settings) != 0)
+	{
+		return false;
+	}
+
+	cfmakeraw(&settings);
+	settings.c_cflag |= CLOCAL | CREAD;
+
+	if (speed && cfsetspeed(&settings, *speed) != 0)
+	{
+		return false;
+	}
+
+	return tcsetattr(fd, TCSANOW, &settings) == 0;
+}
+
+bool pmppOpen (PMPPLink *const link, const char *const path,
+               const uint32_t speed, const uint16_t address)
+{
+	speed_t value;
+
+	if (!speedOf(speed, &value))
+	{
+		errno = EINVAL;
+		return false;
+	}
+
+	const int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	if (!raw(fd, &value) || !linkInit(link, fd, address))
+	{
+		close(fd);
+		return false;
+	}
+
+	return true;
+}
+
+bool pmppOpenPty (PMPPLink *const link, const uint16_t address,
+                  char *const name, const size_t capacity)
+{
+	const int master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+	if (master < 0)
+	{
+		return false;
+	}
+
+	/* The slave is held open so that the master does not hang up while
+	 * no peer has it open.
+	 */
+	int slave = -1;
+
+	if (grantpt(master) != 0 || unlockpt(master) != 0
+	 || ptsname_r(master, name, capacity) != 0
+	 || (slave = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0
+	 || !raw(slave, NULL)
+	 || fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK) != 0
+	 || !linkInit(link, master, address))
+	{
+		if (slave >= 0)
+		{
+			close(slave);
+		}
+
+		close(master);
+		return false;
+	}
+
+	link->peer = slave;
+
+	return true;
+}
+
+void pmppClose (PMPPLink *const link)
+{
+	ringFree(&link->receive);
+	ringFree(&link->transmit);
+
+	if (link->peer >= 0)
+	{
+		close(link->peer);
+		link->peer = -1;
+	}
+
+	if (link->fd >= 0)
+	{
+		close(link->fd);
+		link->fd = -1;
+	}
+}
+
+bool pmppReceive (PMPPLink *const link)
+{
+	PMPPRing *const ring  = &link->receive;
+	const size_t    space = ringSpace(ring);
+
+	if (space == 0)
+	{
+		return true;
+	}
+
+	const ssize_t length = read(link->fd, at(ring, ring->head), space);
+
+	if (length < 0)
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	}
+
+	ring->head += (size_t) length;
+
+	return true;
+}
+
+/* Octets before the first flag or escape. Each search runs over whole
+ * blocks, which is where an unstuffed frame spends its time.
+ */
+static size_t span (const uint8_t *const data, const size_t length)
+{
+	const uint8_t *const flag   = memchr(data, PMPP_FLAG, length);
+	const size_t         limit  = flag ? (size_t) (flag - data) : length;
+	const uint8_t *const escape = memchr(data, PMPP_ESCAPE, limit);
+
+	return escape ? (size_t) (escape - data) : limit;
+}
+
+/* Checks and parses the frame assembled up to a closing flag. */
+static bool complete (PMPPLink *const link, PMPPFrame *const frame)
+{
+	const uint8_t *const data   = at(&link->receive, link->frame);
+	const size_t         length = (size_t) (link->end - link->frame);
+	const uint16_t       fcs    = link->fcs;
+
+	restart(link);
+
+	/* Flags between frames. */
+	if (length == 0)
+	{
+		return false;
+	}
+
+	if (fcs != PMPP_FCS_GOOD)
+	{
+		link->statistics.inBadFCS++;
+		return false;
+	}
+
+	const size_t header = (data[0] & 1) ? 1 : 2;
+
+	if (length < header + 4 || (header == 2 && !(data[1] & 1)))
+	{
+		link->statistics.inShortFrames++;
+		return false;
+	}
+
+	frame->address     = header == 1
+	                   ? data[0] >> 2
+	                   : (uint16_t) ((data[0] >> 2) << 7 | data[1] >> 1);
+	frame->control     = data[header];
+	frame->protocol    = data[header + 1];
+	frame->information = data + header + 2;
+	frame->length      = length - header - 4;
+
+	link->statistics.inFrames++;
+
+	return true;
+}
+
+bool pmppNextFrame (PMPPLink *const link, PMPPFrame *const frame)
+{
+	PMPPRing *const ring = &link->receive;
+
+	/* The frame returned last, and everything before it, is done with. */
+	ring->tail = link->frame;
+
+	while (link->scan < ring->head)
+	{
+		/* Read through the second mapping, so that the octets the frame is
+		 * unstuffed into always lie at lower addresses.
+		 */
+		const size_t offset    = (size_t) (link->scan & (PMPP_RING_SIZE - 1));
+		uint8_t     *const in  = ring->data + PMPP_RING_SIZE + offset;
+		const size_t available = MIN((size_t) (ring->head - link->scan),
+		                             PMPP_RING_SIZE - offset);
+
+		if (link->hunting)
+		{
+			const uint8_t *const flag = memchr(in, PMPP_FLAG, available);
+
+			link->scan += flag ? (size_t) (flag - in) + 1 : available;
+			link->hunting = !flag;
+			restart(link);
+			continue;
+		}
+
+		if (link->escaped)
+		{
+			link->scan++;
+
+			/* 7D 7E aborts the frame; the flag opens the next one. */
+			if (*in == PMPP_FLAG)
+			{
+				link->statistics.inAborts++;
+				restart(link);
+				continue;
+			}
+
+			uint8_t *const out = in - (link->scan - 1 - link->end);
+
+			*out          = *in ^ 0x20;
+			link->fcs     = pmppFCS(link->fcs, out, 1);
+			link->escaped = false;
+			link->end++;
+			continue;
+		}
+
+		const size_t run = span(in, available);
+
+		if (run != 0)
+		{
+			uint8_t *const out = in - (link->scan - link->end);
+
+			if (out != in)
+			{
+				memmove(out, in, run);
+			}
+
+			link->fcs   = pmppFCS(link->fcs, out, run);
+			link->end  += run;
+			link->scan += run;
+			continue;
+		}
+
+		link->scan++;
+
+		if (*in == PMPP_ESCAPE)
+		{
+			link->escaped = true;
+		}
+		else if (complete(link, frame))
+		{
+			return true;
+		}
+	}
+
+	/* A frame that fills the ring can never be completed. */
+	if (ring->head - link->frame == PMPP_RING_SIZE)
+	{
+		link->statistics.inOverruns++;
+		link->hunting = true;
+		restart(link);
+	}
+
+	ring->tail = link->frame;
+
+	return false;
+}
+
+/* Copies data with every flag and escape octet escaped. */
+static uint8_t *stuff (uint8_t *out, const uint8_t *data, size_t length)
+{
+	while (length != 0)
+	{
+		const size_t run = span(data, length);
+
+		memcpy(out, data, run);
+		out    += run;
+		data   += run;
+		length -= run;
+
+		if (length != 0)
+		{
+			*out++ = PMPP_ESCAPE;
+			*out++ = *data++ ^ 0x20;
+			length--;
+		}
+	}
+
+	return out;
+}
+
+bool pmppSend (PMPPLink *const link, const uint16_t address,
+               const uint8_t protocol, const uint8_t *const information,
+               const size_t length)
+{
+	PMPPRing *const ring = &link->transmit;
+	uint8_t         header[4];
+	size_t          headerLength = 0;
+
+	if (address <= PMPP_BROADCAST_SHORT)
+	{
+		header[headerLength++] = (uint8_t) (address << 2 | 1);
+	}
+	else
+	{
+		header[headerLength++] = (uint8_t) ((address >> 7) << 2);
+		header[headerLength++] = (uint8_t) ((address & 0x7F) << 1 | 1);
+	}
+
+	header[headerLength++] = PMPP_CONTROL_UI;
+	header[headerLength++] = protocol;
+
+	const uint16_t fcs = (uint16_t) ~pmppFCS(pmppFCS(PMPP_FCS_INIT, header,
+	                                                 headerLength),
+	                                         information, length);
+	const uint8_t  trailer[2] = { (uint8_t) fcs, (uint8_t) (fcs >> 8) };
+
+	/* Every octet escaped, plus both flags. */
+	const size_t worst = 2 * (headerLength + length + sizeof(trailer)) + 2;
+
+	if (ringSpace(ring) < worst && (!pmppFlush(link) || ringSpace(ring) < worst))
+	{
+		link->statistics.outDiscards++;
+		return false;
+	}
+
+	uint8_t *const start = at(ring, ring->head);
+	uint8_t       *out   = start;
+
+	*out++ = PMPP_FLAG;
+	out    = stuff(out, header, headerLength);
+	out    = stuff(out, information, length);
+	out    = stuff(out, trailer, sizeof(trailer));
+	*out++ = PMPP_FLAG;
+
+	ring->head += (size_t) (out - start);
+	link->statistics.outFrames++;
+
+	return pmppFlush(link);
+}
+
+bool pmppFlush (PMPPLink *const link)
+{
+	PMPPRing *const ring = &link->transmit;
+
+	while (ring->tail < ring->head)
+	{
+		const ssize_t written = write(link->fd, at(ring, ring->tail),
+		                              (size_t) (ring->head - ring->tail));
+
+		if (written < 0)
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+
+		ring->tail += (size_t) written;
+	}
+
+	return true;
+}
+
+bool pmppPending (const PMPPLink *const link)
+{
+	return link->transmit.tail != link->transmit.head;
+}
+
+static void answer (PMPPLink *const link, Agent *const agent,
+                    const PMPPFrame *const frame)
+{
+	const bool broadcast = frame->address == PMPP_BROADCAST_SHORT
+	                    || frame->address == PMPP_BROADCAST;
+
+	if (frame->address != link->address && !broadcast)
+	{
+		link->statistics.inOtherAddresses++;
+		return;
+	}
+
+	if (frame->protocol != PMPP_IPI_SNMP)
+	{
+		link->statistics.inUnknownProtocols++;
+		return;
+	}
+
+	/* The request is decoded where it was received, in the ring. */
+	const size_t length = agentProcess(agent, frame->information,
+	                                   frame->length, agent->output,
+	                                   sizeof(agent->output));
+
+	if (length != 0 && !broadcast)
+	{
+		pmppSend(link, link->address, PMPP_IPI_SNMP, agent->output, length);
+	}
+}
+
+bool pmppServe (PMPPLink *const link, Agent *const agent)
+{
+	uint64_t received;
+
+	do
+	{
+		PMPPFrame frame;
+
+		received = link->receive.head;
+
+		if (!pmppReceive(link))
+		{
+			return false;
+		}
+
+		while (pmppNextFrame(link, &frame))
+		{
+			answer(link, agent, &frame);
+		}
+	}
+	while (link->receive.head != received);
+
+	return pmppFlush(link);
+}
@@ -0,0 +1,65 @@
+#include <Period.h>
+
+#define SECONDS_PER_DAY 86400
+
+/* The first multiple of length into the local day after date, or the end
+ * of the day if length does not divide it.
+ */
+static int64_t endAfter (const CalendarTime *const date, const uint32_t length)
+{
+	const int64_t  start = date->local - date->secondOfDay;
+	const uint64_t next  = ((uint64_t) date->secondOfDay / length + 1) * length;
+
+	return start + (int64_t) MIN(next, (uint64_t) SECONDS_PER_DAY);
+}
+
+void periodStep (Period *const period)
+{
+	period->stepped = true;
+}
+
+PeriodEvent periodBegin (Period *const period, const uint32_t length,
+                         const CalendarTime *const date)
+{
+	PeriodEvent event = PERIOD_RUNNING;
+
+	if (length == 0)
+	{
+		period->length  = 0;
+		period->stepped = false;
+		return PERIOD_STOPPED;
+	}
+
+	/* A new length starts over; a step keeps what was counted. */
+	if (length != period->length)
+	{
+		period->length = length;
+		period->end    = endAfter(date, length);
+		event          = PERIOD_STARTED;
+	}
+	else if (period->stepped)
+	{
+		if (date->local >= period->end)
+		{
+			event = PERIOD_ENDED;
+		}
+
+		period->end = endAfter(date, length);
+	}
+
+	period->stepped = false;
+
+	return event;
+}
+
+bool periodEnd (Period *const period, const CalendarTime *const date)
+{
+	if (period->length == 0 || date->local < period->end)
+	{
+		return false;
+	}
+
+	period->end = endAfter(date, period->length);
+
+	return true;
+}
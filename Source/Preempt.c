@@ -0,0 +1,650 @@
+#include <Preempt.h>
+#include <Metrics.h>
+
+/* Stages of a preempt. A called preempt waits in STAGE_DELAY until it is
+ * serviced; STAGE_LOCKOUT holds one whose call outlasted its maximum
+ * presence until the call goes away.
+ */
+typedef enum Stage
+{
+	STAGE_IDLE        = 0,
+	STAGE_DELAY       = 1,
+	STAGE_ENTRY       = 2,
+	STAGE_TRACK       = 3,
+	STAGE_TRACK_CLEAR = 4,
+	STAGE_DWELL       = 5,
+	STAGE_LOCKOUT     = 6,
+	STAGE_COUNT       = 7
+} Stage;
+
+/* The masks of the phaseControlGroupTable a stage drives. */
+enum
+{
+	MASK_HOLD      = 0,
+	MASK_FORCE_OFF = 1,
+	MASK_OMIT      = 2,
+	MASK_COUNT     = 3
+};
+
+#define GROUPS CONFIG_GROUPS(UINT8_MAX)
+#define WORDS  ((UINT8_MAX + 64) / 64)
+
+#define NANOSECONDS_PER_DECISECOND (100 * NANOSECONDS_PER_MILLISECOND)
+
+/* A preempt as worked out from the database: the masks of each stage and
+ * how long it lasts at least.
+ */
+typedef struct Service
+{
+	uint8_t  masks[STAGE_COUNT][MASK_COUNT][GROUPS];
+	uint64_t durations[STAGE_COUNT];
+	uint64_t minimum;  /* From the start of entry to the earliest exit. */
+	uint64_t presence; /* Longest call taken, zero for no limit. */
+	uint8_t  link;
+	uint8_t  exitPhase;
+	bool     locking;
+	bool     remote;   /* Called through the preemptControlTable. */
+} Service;
+
+typedef struct Runtime
+{
+	Stage    stage;
+	uint64_t since;   /* Start of the stage. */
+	uint64_t entered; /* Start of entry. */
+	uint64_t present; /* Start of the call, zero without one. */
+	bool     ready;   /* Delay timed, waiting to be serviced. */
+	bool     linked;  /* Called by the link of another preempt. */
+} Runtime;
+
+static struct
+{
+	OBJECT_TABLE(Service, services, CONFIG_MAX_PREEMPTS);
+	OBJECT_TABLE(Runtime, runtimes, CONFIG_MAX_PREEMPTS);
+	size_t count;
+
+	/* Enabled phases, whose masks a serviced preempt owns. */
+	uint8_t enabled[GROUPS];
+
+	/* Preempt serviced, counted from zero, or -1; the stage whose masks
+	 * are in the table, and the phase called on exit, to be withdrawn on
+	 * the next tick.
+	 */
+	int32_t serviced;
+	Stage   applied;
+	uint8_t exitCall;
+} engine;
+
+static atomic_uint_fast64_t inputs[WORDS];
+static atomic_uint_fast64_t stamp; /* Oldest input not yet served. */
+static atomic_bool          active;
+static atomic_bool          running;
+static sem_t                wake;
+static thrd_t               thread;
+static pthread_mutex_t      lock;
+
+bool preemptInit (const DatabaseLimits *const limits)
+{
+	pthread_mutexattr_t attributes;
+
+	engine.count    = limits->maxPreempts;
+	engine.serviced = -1;
+	engine.exitCall = 0;
+	atomic_store(&active, false);
+
+	if (pthread_mutexattr_init(&attributes) != 0
+	 || pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT) != 0
+	 || pthread_mutex_init(&lock, &attributes) != 0)
+	{
+		return false;
+	}
+
+	pthread_mutexattr_destroy(&attributes);
+
+	if (!PROVIDE(engine.services, engine.count)
+	 || !PROVIDE(engine.runtimes, engine.count))
+	{
+		return false;
+	}
+
+	memset(engine.runtimes, 0, engine.count * sizeof(engine.runtimes[0]));
+	preemptInvalidate();
+
+	return sem_init(&wake, 0, 0) == 0;
+}
+
+void preemptFree (void)
+{
+	sem_destroy(&wake);
+	pthread_mutex_destroy(&lock);
+
+#ifndef STATIC_STORAGE
+	free(engine.services);
+	free(engine.runtimes);
+
+	engine.services = NULL;
+	engine.runtimes = NULL;
+#endif
+}
+
+void preemptLock (void)   { pthread_mutex_lock(&lock); }
+void preemptUnlock (void) { pthread_mutex_unlock(&lock); }
+
+bool preemptActive (void)
+{
+	return atomic_load_explicit(&active, memory_order_acquire);
+}
+
+void preemptInput (const uint8_t preempt, const bool active)
+{
+	if (preempt == 0)
+	{
+		return;
+	}
+
+	const uint64_t bit = UINT64_C(1) << (preempt % 64);
+
+	if (active)
+	{
+		atomic_fetch_or(&inputs[preempt / 64], bit);
+	}
+	else
+	{
+		atomic_fetch_and(&inputs[preempt / 64], ~bit);
+	}
+
+	uint_fast64_t none = 0;
+
+	atomic_compare_exchange_strong(&stamp, &none, clockMonotonic());
+	sem_post(&wake);
+}
+
+static void setBit (uint8_t groups[const GROUPS], const size_t phase)
+{
+	groups[phase / 8] |= (uint8_t) (1u << (phase % 8));
+}
+
+static bool hasBit (const uint8_t groups[const GROUPS], const size_t phase)
+{
+	return groups[phase / 8] & (1u << (phase % 8));
+}
+
+/* The enabled phases of a phase list. */
+static void phasesOf (const OctetText *const list,
+                      uint8_t groups[const GROUPS])
+{
+	const uint8_t *const phases = list->octets;
+
+	memset(groups, 0, GROUPS);
+
+	for (size_t index = 0; index < list->length; index++)
+	{
+		if (phases[index] != 0 && phases[index] <= asc.phase.maxPhases
+		 && hasBit(engine.enabled, phases[index] - 1u))
+		{
+			setBit(groups, phases[index] - 1u);
+		}
+	}
+}
+
+/* Longest yellow change and red clearance of the phases set in groups, in
+ * tenths of a second.
+ */
+static uint32_t clearanceOf (const uint8_t groups[const GROUPS])
+{
+	uint32_t longest = 0;
+
+	for (size_t phase = 0; phase < asc.phase.maxPhases; phase++)
+	{
+		const PhaseEntry *const entry = &asc.phase.phaseTable[phase];
+
+		if (hasBit(groups, phase))
+		{
+			longest = MAX(longest, (uint32_t) entry->phaseYellowChange
+			                     + entry->phaseRedClear);
+		}
+	}
+
+	return longest;
+}
+
+/* Works out the stages of one preempt. */
+static void prepare (const PreemptEntry *const entry, Service *const service)
+{
+	uint8_t track[GROUPS], dwell[GROUPS], others[GROUPS];
+	uint8_t notTrack[GROUPS], notDwell[GROUPS];
+
+	phasesOf(&entry->preemptTrackPhase, track);
+	phasesOf(&entry->preemptDwellPhase, dwell);
+
+	for (size_t group = 0; group < GROUPS; group++)
+	{
+		const uint8_t enabled = engine.enabled[group];
+
+		others[group]   = enabled & ~(track[group] | dwell[group]);
+		notTrack[group] = enabled & ~track[group];
+		notDwell[group] = enabled & ~dwell[group];
+	}
+
+	memset(service, 0, sizeof(*service));
+
+	/* Entry waits for the slowest terminating phase: its guaranteed green,
+	 * or walk and pedestrian clearance if it has a pedestrian movement,
+	 * then its clearance.
+	 */
+	uint32_t entryTime = 0;
+
+	for (size_t phase = 0; phase < asc.phase.maxPhases; phase++)
+	{
+		const PhaseEntry *const row = &asc.phase.phaseTable[phase];
+
+		if (!hasBit(others, phase))
+		{
+			continue;
+		}
+
+		uint32_t green = MIN(entry->preemptMinimumGreen,
+		                     row->phaseMinimumGreen) * 10u;
+
+		if (row->phaseWalk != 0)
+		{
+			green = MAX(green, (entry->preemptMinimumWalk
+			                    + entry->preemptEnterPedClear) * 10u);
+		}
+
+		entryTime = MAX(entryTime, green + row->phaseYellowChange
+		                                 + row->phaseRedClear);
+	}
+
+	const bool tracked = memcmp(track, (uint8_t [GROUPS]) { 0 }, GROUPS) != 0;
+
+	memcpy(service->masks[STAGE_ENTRY][MASK_FORCE_OFF], others, GROUPS);
+	memcpy(service->masks[STAGE_ENTRY][MASK_OMIT],      others, GROUPS);
+	memcpy(service->masks[STAGE_TRACK][MASK_HOLD],      track, GROUPS);
+	memcpy(service->masks[STAGE_TRACK][MASK_FORCE_OFF], notTrack, GROUPS);
+	memcpy(service->masks[STAGE_TRACK][MASK_OMIT],      notTrack, GROUPS);
+	memcpy(service->masks[STAGE_TRACK_CLEAR][MASK_FORCE_OFF], notDwell,
+	       GROUPS);
+	memcpy(service->masks[STAGE_TRACK_CLEAR][MASK_OMIT], notDwell, GROUPS);
+	memcpy(service->masks[STAGE_DWELL][MASK_HOLD],      dwell, GROUPS);
+	memcpy(service->masks[STAGE_DWELL][MASK_FORCE_OFF], notDwell, GROUPS);
+	memcpy(service->masks[STAGE_DWELL][MASK_OMIT],      notDwell, GROUPS);
+
+	service->durations[STAGE_DELAY]       = entry->preemptDelay * 10u;
+	service->durations[STAGE_ENTRY]       = entryTime;
+	service->durations[STAGE_TRACK]       =
+		tracked ? entry->preemptTrackGreen * 10u : 0;
+	service->durations[STAGE_TRACK_CLEAR] = tracked ? clearanceOf(track) : 0;
+	service->durations[STAGE_DWELL]       = entry->preemptDwellGreen * 10u;
+
+	for (size_t stage = 0; stage < STAGE_COUNT; stage++)
+	{
+		service->durations[stage] *= NANOSECONDS_PER_DECISECOND;
+	}
+
+	service->minimum   = entry->preemptMinimumDuration * NANOSECONDS_PER_SECOND;
+	service->presence  = entry->preemptMaximumPresence * NANOSECONDS_PER_SECOND;
+	service->link      = entry->preemptLink;
+	service->exitPhase = entry->preemptExitPhase;
+	service->locking   = !(entry->preemptControl & 1);
+}
+
+static void prepareAll (void)
+{
+	memset(engine.enabled, 0, sizeof(engine.enabled));
+
+	for (size_t phase = 0; phase < asc.phase.maxPhases; phase++)
+	{
+		if (asc.phase.phaseTable[phase].phaseOptions & 1)
+		{
+			setBit(engine.enabled, phase);
+		}
+	}
+
+	for (size_t preempt = 0; preempt < engine.count; preempt++)
+	{
+		prepare(&asc.preempt.preemptTable[preempt],
+		        &engine.services[preempt]);
+
+		engine.services[preempt].remote =
+			asc.preempt.preemptControlTable[preempt].preemptControlState != 0;
+	}
+}
+
+/* Copies the masks of stage over those of the enabled phases. */
+static void apply (const Service *const service, const Stage stage)
+{
+	PhaseControlGroupEntry *const groups = asc.phase.phaseControlGroupTable;
+
+	for (size_t group = 0; group < asc.phase.maxPhaseGroups; group++)
+	{
+		const uint8_t owned = engine.enabled[group];
+		uint8_t *const fields[MASK_COUNT] =
+		{
+			[MASK_HOLD]      = &groups[group].phaseControlGroupHold,
+			[MASK_FORCE_OFF] = &groups[group].phaseControlGroupForceOff,
+			[MASK_OMIT]      = &groups[group].phaseControlGroupPhaseOmit
+		};
+
+		for (size_t mask = 0; mask < MASK_COUNT; mask++)
+		{
+			const uint8_t level = service
+				? service->masks[stage][mask][group] : 0;
+
+			*fields[mask] = (uint8_t) ((*fields[mask] & ~owned) | level);
+		}
+	}
+
+	engine.applied = stage;
+}
+
+static void callExitPhase (const uint8_t phase, const bool call)
+{
+	if (phase == 0 || phase > asc.phase.maxPhases)
+	{
+		return;
+	}
+
+	uint8_t *const field = &asc.phase.phaseControlGroupTable[(phase - 1) / 8]
+		.phaseControlGroupVehCall;
+	const uint8_t  bit   = (uint8_t) (1u << ((phase - 1) % 8));
+
+	*field = call ? (uint8_t) (*field | bit) : (uint8_t) (*field & ~bit);
+}
+
+static bool called (const size_t preempt)
+{
+	const size_t number = preempt + 1;
+
+	return (atomic_load_explicit(&inputs[number / 64], memory_order_acquire)
+	        >> (number % 64)) & 1
+	    || engine.services[preempt].remote;
+}
+
+/* Ends the service of the preempt serviced, releasing the masks. */
+static void finish (const Stage next)
+{
+	Runtime *const runtime = &engine.runtimes[engine.serviced];
+	const Service *const service = &engine.services[engine.serviced];
+
+	apply(NULL, STAGE_IDLE);
+	callExitPhase(service->exitPhase, true);
+
+	engine.exitCall = service->exitPhase;
+	runtime->stage  = next;
+	runtime->ready  = false;
+	runtime->linked = false;
+
+	if (next == STAGE_IDLE && service->link != 0
+	 && service->link <= engine.count)
+	{
+		Runtime *const link = &engine.runtimes[service->link - 1];
+
+		if (link->stage == STAGE_IDLE)
+		{
+			link->stage  = STAGE_DELAY;
+			link->ready  = true;
+			link->linked = true;
+		}
+	}
+
+	engine.serviced = -1;
+}
+
+/* Times every preempt at now and drives the masks of the one serviced. */
+static void evaluate (const uint64_t now)
+{
+	int32_t chosen = -1;
+
+	for (size_t preempt = 0; preempt < engine.count; preempt++)
+	{
+		Runtime *const       runtime = &engine.runtimes[preempt];
+		const Service *const service = &engine.services[preempt];
+		const bool           call    = called(preempt) || runtime->linked;
+
+		if (!call)
+		{
+			runtime->present = 0;
+		}
+		else if (runtime->present == 0)
+		{
+			runtime->present = now;
+		}
+
+		if (runtime->stage == STAGE_IDLE && call)
+		{
+			runtime->stage = STAGE_DELAY;
+			runtime->since = now;
+			runtime->ready = false;
+		}
+
+		if (runtime->stage == STAGE_DELAY)
+		{
+			if (!call && !service->locking)
+			{
+				runtime->stage = STAGE_IDLE;
+			}
+			else if (now - runtime->since >= service->durations[STAGE_DELAY])
+			{
+				runtime->ready = true;
+			}
+		}
+		else if (runtime->stage == STAGE_LOCKOUT && !call)
+		{
+			runtime->stage = STAGE_IDLE;
+		}
+
+		if (call && service->presence != 0 && runtime->stage != STAGE_LOCKOUT
+		 && now - runtime->present >= service->presence)
+		{
+			if ((int32_t) preempt == engine.serviced)
+			{
+				finish(STAGE_LOCKOUT);
+			}
+
+			runtime->stage = STAGE_LOCKOUT;
+			runtime->ready = false;
+		}
+
+		if (chosen < 0
+		 && (runtime->ready || (int32_t) preempt == engine.serviced))
+		{
+			chosen = (int32_t) preempt;
+		}
+	}
+
+	/* A higher priority preempt takes over at entry; the one it displaces
+	 * waits for it if still called.
+	 */
+	if (chosen >= 0 && chosen != engine.serviced)
+	{
+		if (engine.serviced >= 0)
+		{
+			Runtime *const displaced = &engine.runtimes[engine.serviced];
+
+			displaced->stage = STAGE_DELAY;
+			displaced->ready = true;
+		}
+
+		Runtime *const runtime = &engine.runtimes[chosen];
+
+		engine.serviced  = chosen;
+		runtime->stage   = STAGE_ENTRY;
+		runtime->since   = now;
+		runtime->entered = now;
+		runtime->ready   = false;
+		apply(&engine.services[chosen], STAGE_ENTRY);
+	}
+
+	while (engine.serviced >= 0)
+	{
+		Runtime *const       runtime = &engine.runtimes[engine.serviced];
+		const Service *const service = &engine.services[engine.serviced];
+		const bool           call    = called((size_t) engine.serviced)
+		                            || runtime->linked;
+
+		if (now - runtime->since < service->durations[runtime->stage])
+		{
+			break;
+		}
+
+		if (runtime->stage == STAGE_DWELL)
+		{
+			if (!call && now - runtime->entered >= service->minimum)
+			{
+				finish(STAGE_IDLE);
+			}
+
+			/* A linked call is taken once the dwell green has timed. */
+			runtime->linked = false;
+			break;
+		}
+
+		runtime->stage++;
+		runtime->since = now;
+		apply(service, runtime->stage);
+	}
+
+	atomic_store_explicit(&active, engine.serviced >= 0,
+	                      memory_order_release);
+
+	for (size_t preempt = 0; preempt < engine.count; preempt++)
+	{
+		static const uint8_t states[STAGE_COUNT] =
+		{
+			[STAGE_IDLE]        = PREEMPT_STATE_NOT_ACTIVE,
+			[STAGE_DELAY]       = PREEMPT_STATE_NOT_ACTIVE_WITH_CALL,
+			[STAGE_ENTRY]       = PREEMPT_STATE_ENTRY_STARTED,
+			[STAGE_TRACK]       = PREEMPT_STATE_TRACK_SERVICE,
+			[STAGE_TRACK_CLEAR] = PREEMPT_STATE_TRACK_SERVICE,
+			[STAGE_DWELL]       = PREEMPT_STATE_DWELL,
+			[STAGE_LOCKOUT]     = PREEMPT_STATE_MAXIMUM_PRESENCE
+		};
+
+		asc.preempt.preemptTable[preempt].preemptState =
+			states[engine.runtimes[preempt].stage];
+	}
+}
+
+/* The stages are swapped in whole under the preempt lock, so the input
+ * thread never reads the database and never waits for a SET.
+ */
+void preemptInvalidate (void)
+{
+	preemptLock();
+	prepareAll();
+
+	if (engine.serviced >= 0)
+	{
+		apply(&engine.services[engine.serviced], engine.applied);
+	}
+
+	preemptUnlock();
+}
+
+void preemptTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	preemptLock();
+
+	/* The exit call lasts one tick. */
+	if (engine.exitCall != 0)
+	{
+		callExitPhase(engine.exitCall, false);
+		engine.exitCall = 0;
+	}
+
+	evaluate(now);
+	preemptUnlock();
+}
+
+static int run (void *const argument)
+{
+	(void) argument;
+
+	while (atomic_load_explicit(&running, memory_order_relaxed))
+	{
+		if (sem_wait(&wake) != 0)
+		{
+			continue;
+		}
+
+		preemptLock();
+		evaluate(clockMonotonic());
+		preemptUnlock();
+
+		const uint64_t input = atomic_exchange(&stamp, 0);
+
+		if (input != 0)
+		{
+			metricsRecord(METRIC_PREEMPT, clockMonotonic() - input);
+		}
+	}
+
+	return 0;
+}
+
+/* Applies the scheduling of the tick to the input thread, one priority
+ * higher. thrd_t is the pthread_t of the thread on glibc and musl.
+ */
+static bool schedule (const TickConfig *const config)
+{
+	const pthread_t handle = (pthread_t) thread;
+
+	if (config->cpu >= 0)
+	{
+		cpu_set_t cpus;
+
+		CPU_ZERO(&cpus);
+		CPU_SET(config->cpu, &cpus);
+
+		if (pthread_setaffinity_np(handle, sizeof(cpus), &cpus) != 0)
+		{
+			return false;
+		}
+	}
+
+	if (config->realTime)
+	{
+		const struct sched_param parameter =
+		{
+			.sched_priority = MIN(config->priority + 1,
+			                      sched_get_priority_max(SCHED_FIFO))
+		};
+
+		if (pthread_setschedparam(handle, SCHED_FIFO, &parameter) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool preemptStart (const TickConfig *const config)
+{
+	atomic_store(&running, true);
+
+	if (thrd_create(&thread, run, NULL) != thrd_success)
+	{
+		atomic_store(&running, false);
+		return false;
+	}
+
+	if (!schedule(config))
+	{
+		preemptStop();
+		return false;
+	}
+
+	return true;
+}
+
+void preemptStop (void)
+{
+	if (atomic_exchange(&running, false))
+	{
+		sem_post(&wake);
+		thrd_join(thread, NULL);
+	}
+}
@@ -0,0 +1,1860 @@
+#include <Registry.h>
+#include <Database.h>
+#include <Device.h>
+#include <Forward.h>
+#include <MIB.h>
+#include <Metrics.h>
+#include <Multi.h>
+#include <Sync.h>
+#include <Tick.h>
+#include <USM.h>
+
+/* Tree the object fields are read from and written to. The agent serves its
+ * own database; a manager thread selects the tree of each device it polls.
+ */
+static thread_local const ObjectTree *tree = &database;
+
+void registrySelect (const ObjectTree *const selected)
+{
+	tree = selected ? selected : &database;
+}
+
+/* Structures holding scalar objects. */
+static void *globalConfiguration (void)
+{
+	return &tree->global->globalConfiguration;
+}
+static void *globalDBManagement (void)
+{
+	return &tree->global->globalDBManagement;
+}
+static void *globalTimeManagement (void)
+{
+	return &tree->global->globalTimeManagement;
+}
+static void *timebase (void)
+{
+	return &tree->global->globalTimeManagement.timebase;
+}
+static void *daylightSavingNode (void)
+{
+	return &tree->global->globalTimeManagement.daylightSavingNode;
+}
+static void *auxIOv2 (void)  { return &tree->global->auxIOv2; }
+static void *phase (void)    { return &tree->asc->phase; }
+static void *detector (void) { return &tree->asc->detector; }
+static void *volumeOccupancyReport (void)
+{
+	return &tree->asc->detector.volumeOccupancyReport;
+}
+static void *unit (void)     { return &tree->asc->unit; }
+static void *coord (void)    { return &tree->asc->coord; }
+static void *timebaseAsc (void) { return &tree->asc->timebaseAsc; }
+static void *preempt (void)  { return &tree->asc->preempt; }
+
+/* Tables and their row counts. */
+static void *globalModuleTable (void)
+{
+	return tree->global->globalConfiguration.globalModuleTable;
+}
+static size_t globalModuleRows (void)
+{
+	return tree->global->globalConfiguration.globalMaxModules;
+}
+
+static void *timeBaseScheduleTable (void)
+{
+	return tree->global->globalTimeManagement.timebase.timeBaseScheduleTable;
+}
+static size_t timeBaseScheduleRows (void)
+{
+	return tree->global->globalTimeManagement.timebase
+		.maxTimeBaseScheduleEntries;
+}
+
+static void *timeBaseDayPlanTable (void)
+{
+	return tree->global->globalTimeManagement.timebase.timeBaseDayPlanTable;
+}
+static size_t timeBaseDayPlanRows (void)
+{
+	const Timebase *const timebase =
+		&tree->global->globalTimeManagement.timebase;
+
+	return (size_t) timebase->maxDayPlans * timebase->maxDayPlanEvents;
+}
+static size_t timeBaseDayPlanEvents (void)
+{
+	return tree->global->globalTimeManagement.timebase.maxDayPlanEvents;
+}
+
+static void *dstTable (void)
+{
+	return tree->global->globalTimeManagement.daylightSavingNode.dstTable;
+}
+static size_t dstRows (void)
+{
+	return tree->global->globalTimeManagement.daylightSavingNode
+		.maxDaylightSavingEntries;
+}
+
+static void *auxIOv2Table (void)
+{
+	return tree->global->auxIOv2.auxIOv2Table;
+}
+static size_t auxIOv2Rows (void)
+{
+	return (size_t) tree->global->auxIOv2.maxAuxIOv2TableNumDigitalPorts
+	     + tree->global->auxIOv2.maxAuxIOv2TableNumAnalogPorts;
+}
+
+/* The auxIOv2Table is indexed by auxIOv2PortType.auxIOv2PortNumber. Its
+ * digital ports come first in the table, but its analog ports sort first.
+ */
+static size_t auxIOv2Ports (const uint32_t type)
+{
+	const AuxIOv2 *const auxIOv2 = &tree->global->auxIOv2;
+
+	switch (type)
+	{
+		case PORT_TYPE_ANALOG:  return auxIOv2->maxAuxIOv2TableNumAnalogPorts;
+		case PORT_TYPE_DIGITAL: return auxIOv2->maxAuxIOv2TableNumDigitalPorts;
+		default:                return 0;
+	}
+}
+
+/* The row of a port of type, numbered from one. */
+static size_t auxIOv2Row (const uint32_t type, const size_t number)
+{
+	return type == PORT_TYPE_ANALOG
+	     ? auxIOv2Ports(PORT_TYPE_DIGITAL) + number - 1 : number - 1;
+}
+
+static bool auxIOv2Find (const uint32_t *const instance, const size_t length,
+                         size_t *const row)
+{
+	if (length != 2 || instance[1] == 0
+	 || instance[1] > auxIOv2Ports(instance[0]))
+	{
+		return false;
+	}
+
+	*row = auxIOv2Row(instance[0], instance[1]);
+	return true;
+}
+
+static bool auxIOv2Next (const uint32_t *const instance, const size_t length,
+                         size_t *const row)
+{
+	uint32_t type   = length > 0 ? instance[0] : 0;
+	size_t   number = length > 1 ? instance[1] : 0;
+
+	for (; type <= PORT_TYPE_DIGITAL; type++, number = 0)
+	{
+		if (number < auxIOv2Ports(type))
+		{
+			*row = auxIOv2Row(type, number + 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void auxIOv2Name (const size_t row, OID *const name)
+{
+	const AuxIOv2Entry *const entry = &tree->global->auxIOv2.auxIOv2Table[row];
+
+	oidAppend(name, entry->auxIOv2PortType);
+	oidAppend(name, entry->auxIOv2PortNumber);
+}
+
+static const RegistryInstances auxIOv2Instances =
+{
+	.find = auxIOv2Find,
+	.next = auxIOv2Next,
+	.name = auxIOv2Name
+};
+
+static void *phaseTable (void)  { return tree->asc->phase.phaseTable; }
+static size_t phaseRows (void)  { return tree->asc->phase.maxPhases; }
+
+static void *phaseStatusGroupTable (void)
+{
+	return tree->asc->phase.phaseStatusGroupTable;
+}
+static void *phaseControlGroupTable (void)
+{
+	return tree->asc->phase.phaseControlGroupTable;
+}
+static size_t phaseGroupRows (void)
+{
+	return tree->asc->phase.maxPhaseGroups;
+}
+
+static void *vehicleDetectorTable (void)
+{
+	return tree->asc->detector.vehicleDetectorTable;
+}
+static size_t vehicleDetectorRows (void)
+{
+	return tree->asc->detector.maxVehicleDetectors;
+}
+
+static void *vehicleDetectorStatusGroupTable (void)
+{
+	return tree->asc->detector.vehicleDetectorStatusGroupTable;
+}
+static size_t vehicleDetectorStatusGroupRows (void)
+{
+	return tree->asc->detector.maxVehicleDetectorStatusGroups;
+}
+
+static void *volumeOccupancyTable (void)
+{
+	return tree->asc->detector.volumeOccupancyReport.volumeOccupancyTable;
+}
+static size_t volumeOccupancyRows (void)
+{
+	return tree->asc->detector.volumeOccupancyReport
+		.activeVolumeOccupancyDetectors;
+}
+
+static void *pedestrianDetectorTable (void)
+{
+	return tree->asc->detector.pedestrianDetectorTable;
+}
+static size_t pedestrianDetectorRows (void)
+{
+	return tree->asc->detector.maxPedestrianDetectors;
+}
+
+static void *patternTable (void)
+{
+	return tree->asc->coord.patternTable;
+}
+static size_t patternRows (void) { return tree->asc->coord.maxPatterns; }
+
+static void *splitTable (void)   { return tree->asc->coord.splitTable; }
+static size_t splitRows (void)
+{
+	return (size_t) tree->asc->coord.maxSplits * tree->asc->phase.maxPhases;
+}
+
+static void *timebaseAscActionTable (void)
+{
+	return tree->asc->timebaseAsc.timebaseAscActionTable;
+}
+static size_t timebaseAscActionRows (void)
+{
+	return tree->asc->timebaseAsc.maxTimebaseAscActions;
+}
+
+static void *preemptTable (void)
+{
+	return tree->asc->preempt.preemptTable;
+}
+static void *preemptControlTable (void)
+{
+	return tree->asc->preempt.preemptControlTable;
+}
+static size_t preemptRows (void) { return tree->asc->preempt.maxPreempts; }
+
+static void *dmsSignCfg (void)     { return &tree->dms->dmsSignCfg; }
+static void *vmsCfg (void)         { return &tree->dms->vmsCfg; }
+static void *fontDefinition (void) { return &tree->dms->fontDefinition; }
+static void *multiCfg (void)       { return &tree->dms->multiCfg; }
+static void *dmsMessage (void)     { return &tree->dms->dmsMessage; }
+static void *signControl (void)    { return &tree->dms->signControl; }
+
+static void *fontTable (void)  { return tree->dms->fontDefinition.fontTable; }
+static size_t fontRows (void)  { return tree->dms->fontDefinition.numFonts; }
+
+static void *characterTable (void)
+{
+	return tree->dms->fontDefinition.characterTable;
+}
+static size_t characterRows (void)
+{
+	const FontDefinition *const fonts = &tree->dms->fontDefinition;
+
+	return (size_t) fonts->numFonts * fonts->maxFontCharacters;
+}
+static size_t fontCharacters (void)
+{
+	return tree->dms->fontDefinition.maxFontCharacters;
+}
+
+static void *dmsMessageTable (void)
+{
+	return tree->dms->dmsMessage.dmsMessageTable;
+}
+static size_t dmsMessageRows (void)
+{
+	return (size_t) MEMORY_TYPE_CHANGEABLE
+	     * tree->dms->dmsMessage.dmsMaxChangeableMsg;
+}
+static size_t dmsMessageNumbers (void)
+{
+	return tree->dms->dmsMessage.dmsMaxChangeableMsg;
+}
+
+static void *essNtcip (void)       { return &tree->ess->essNtcip; }
+static void *essLocation (void)    { return &tree->ess->essLocation; }
+static void *essAtmosphere (void)  { return &tree->ess->essAtmosphere; }
+static void *essTemperature (void) { return &tree->ess->essTemperature; }
+static void *essPavement (void)    { return &tree->ess->essPavement; }
+
+static void *essTemperatureSensorTable (void)
+{
+	return tree->ess->essTemperature.essTemperatureSensorTable;
+}
+static size_t essTemperatureSensorRows (void)
+{
+	return tree->ess->essTemperature.essNumTemperatureSensors;
+}
+
+static void *essPavementSensorTable (void)
+{
+	return tree->ess->essPavement.essPavementSensorTable;
+}
+static size_t essPavementSensorRows (void)
+{
+	return tree->ess->essPavement.numEssPavementSensors;
+}
+
+static void *sensorZones (void)    { return &tree->tss->sensorZones; }
+static void *vehicleClasses (void) { return &tree->tss->vehicleClasses; }
+static void *sampleData (void)     { return &tree->tss->sampleData; }
+
+static void *sensorZoneTable (void)
+{
+	return tree->tss->sensorZones.sensorZoneTable;
+}
+static void *zoneSampleTable (void)
+{
+	return tree->tss->sampleData.zoneSampleTable;
+}
+static size_t sensorZoneRows (void)
+{
+	return tree->tss->sensorZones.numSensorZones;
+}
+
+static void *vehicleClassTable (void)
+{
+	return tree->tss->vehicleClasses.vehicleClassTable;
+}
+static size_t vehicleClassRows (void)
+{
+	return tree->tss->vehicleClasses.numVehicleClasses;
+}
+
+static void *zoneClassTable (void)
+{
+	return tree->tss->sampleData.zoneClassTable;
+}
+static size_t zoneClassRows (void)
+{
+	return (size_t) tree->tss->sensorZones.numSensorZones
+	     * tree->tss->vehicleClasses.numVehicleClasses;
+}
+
+static void *rmcGeneralConfiguration (void)
+{
+	return &tree->rmc->rmcGeneralConfiguration;
+}
+static void *rmcMainline (void)    { return &tree->rmc->rmcMainline; }
+static void *rmcMeteredLane (void) { return &tree->rmc->rmcMeteredLane; }
+static void *rmcTrafficResponsive (void)
+{
+	return &tree->rmc->rmcTrafficResponsive;
+}
+
+static void *rmcMainlineLaneTable (void)
+{
+	return tree->rmc->rmcMainline.rmcMainlineLaneTable;
+}
+static size_t rmcMainlineLaneRows (void)
+{
+	return tree->rmc->rmcMainline.rmcMaxNumMainlineLanes;
+}
+
+static void *rmcMeteredLaneTable (void)
+{
+	return tree->rmc->rmcMeteredLane.rmcMeteredLaneTable;
+}
+static size_t rmcMeteredLaneRows (void)
+{
+	return tree->rmc->rmcMeteredLane.rmcMaxNumMeteredLanes;
+}
+
+static void *rmcTRLevelTable (void)
+{
+	return tree->rmc->rmcTrafficResponsive.rmcTRLevelTable;
+}
+static size_t rmcTRLevelRows (void)
+{
+	return tree->rmc->rmcTrafficResponsive.rmcMaxNumTRLevels;
+}
+
+static void *rsuSysDescription (void) { return &tree->rsu->rsuSysDescription; }
+static void *rsuIFM (void)            { return &tree->rsu->rsuIFM; }
+
+static void *rsuIFMTable (void)  { return tree->rsu->rsuIFM.rsuIFMTable; }
+static size_t rsuIFMRows (void)  { return tree->rsu->rsuIFM.maxRsuIFMs; }
+
+static void *snmpEngine (void) { return usmEngine(); }
+static void *usmStats (void)   { return &usmStatistics; }
+
+static void *tickMonitor (void) { return &tickStatus; }
+static void *forwardMonitor (void) { return &forwardStatus; }
+
+/* Agent instrumentation, aggregated when read. */
+static void *metricTable (void)
+{
+	return (void *) metricsSnapshot()->metricTable;
+}
+static size_t metricRows (void) { return METRIC_COUNT; }
+
+static void *metricBucketTable (void)
+{
+	return (void *) metricsSnapshot()->metricBucketTable;
+}
+static size_t metricBucketRows (void)
+{
+	return METRIC_COUNT * METRICS_BUCKETS;
+}
+static size_t metricBuckets (void) { return METRICS_BUCKETS; }
+
+/* Sync manifest of the database, rebuilt when read after a change. */
+static void *syncTable (void)
+{
+	return (void *) syncManifest()->syncTable;
+}
+static size_t syncTableRows (void) { return SYNC_TABLE_COUNT; }
+
+static void *syncPhaseHashes (void)
+{
+	return (void *) syncManifest()->syncPhaseHashes;
+}
+static void *syncVehicleDetectorHashes (void)
+{
+	return (void *) syncManifest()->syncVehicleDetectorHashes;
+}
+static void *syncTimeBaseScheduleHashes (void)
+{
+	return (void *) syncManifest()->syncTimeBaseScheduleHashes;
+}
+static void *syncDayPlanHashes (void)
+{
+	return (void *) syncManifest()->syncDayPlanHashes;
+}
+static void *syncDSTHashes (void)
+{
+	return (void *) syncManifest()->syncDSTHashes;
+}
+
+/* Writable objects are either database objects, which make up the
+ * configuration of the device and are buffered while a transaction is open,
+ * or control objects, which take effect as soon as they are written.
+ */
+enum
+{
+	READ_ONLY  = 0,
+	READ_WRITE = 1,
+	CONTROL    = 2
+};
+
+#define FIELD(Type, field, syntax_, access, minimum_, maximum_)                \
+	.syntax   = (syntax_),                                                     \
+	.writable = (access) != READ_ONLY,                                         \
+	.database = (access) == READ_WRITE,                                        \
+	.kind     = FIELD_KIND(((Type *) 0)->field),                               \
+	.width    = sizeof(((Type *) 0)->field),                                   \
+	.offset   = offsetof(Type, field),                                         \
+	.minimum  = (minimum_),                                                    \
+	.maximum  = (maximum_)
+
+#define SCALAR(group, Type, field, syntax, access, minimum, maximum, ...)      \
+	{                                                                          \
+		.oid  = __VA_ARGS__,                                                   \
+		.base = (group),                                                       \
+		FIELD(Type, field, syntax, access, minimum, maximum)                   \
+	}
+
+#define COLUMN(table, count, Type, field, syntax, access, minimum, maximum,  \
+               ...)                                                            \
+	{                                                                          \
+		.oid    = __VA_ARGS__,                                                 \
+		.base   = (table),                                                     \
+		.rows   = (count),                                                     \
+		.stride = sizeof(Type),                                                \
+		FIELD(Type, field, syntax, access, minimum, maximum)                   \
+	}
+
+#define INTEGER      BER_INTEGER
+#define COUNTER      BER_COUNTER32
+#define GAUGE        BER_GAUGE32
+#define COUNTER64    BER_COUNTER64
+#define STRING       BER_OCTET_STRING
+#define IDENTIFIER   BER_OID
+
+/* Shorthands for the columns of each table. */
+#define MODULE(field, syntax, access, minimum, maximum, column)                \
+	COLUMN(globalModuleTable, globalModuleRows, ModuleTableEntry, field,       \
+	       syntax, access, minimum, maximum, GLOBAL_OID(1, 3, 1, column))
+
+#define SCHEDULE(field, access, minimum, maximum, column)                      \
+	COLUMN(timeBaseScheduleTable, timeBaseScheduleRows,                        \
+	       TimeBaseScheduleEntry, field, INTEGER, access, minimum, maximum,    \
+	       GLOBAL_OID(3, 3, 2, 1, column))
+
+/* The day plan table is indexed by dayPlanNumber.dayPlanEventNumber. */
+#define DAY_PLAN(field, syntax, access, minimum, maximum, column)              \
+	{                                                                          \
+		.oid    = GLOBAL_OID(3, 3, 5, 1, column),                              \
+		.base   = timeBaseDayPlanTable,                                        \
+		.rows   = timeBaseDayPlanRows,                                         \
+		.inner  = timeBaseDayPlanEvents,                                       \
+		.stride = sizeof(TimeBaseDayPlanEntry),                                \
+		FIELD(TimeBaseDayPlanEntry, field, syntax, access, minimum, maximum)   \
+	}
+
+#define DST(field, minimum, maximum, column)                                   \
+	COLUMN(dstTable, dstRows, DSTEntry, field, INTEGER,                        \
+	       column == 1 ? READ_ONLY : READ_WRITE, minimum, maximum,             \
+	       GLOBAL_OID(3, 7, 2, 1, column))
+
+#define AUX_IO(field, syntax, access, minimum, maximum, column)                \
+	{                                                                          \
+		.oid       = GLOBAL_OID(7, 3, 1, column),                              \
+		.base      = auxIOv2Table,                                             \
+		.rows      = auxIOv2Rows,                                              \
+		.instances = &auxIOv2Instances,                                        \
+		.stride    = sizeof(AuxIOv2Entry),                                     \
+		FIELD(AuxIOv2Entry, field, syntax, access, minimum, maximum)           \
+	}
+
+#define PHASE(field, access, minimum, maximum, column)                         \
+	COLUMN(phaseTable, phaseRows, PhaseEntry, field, INTEGER, access,          \
+	       minimum, maximum, ASC_OID(1, 2, 1, column))
+
+#define PHASE_STATUS(field, column)                                            \
+	COLUMN(phaseStatusGroupTable, phaseGroupRows, PhaseStatusGroupEntry,       \
+	       field, INTEGER, READ_ONLY, 0, UINT8_MAX, ASC_OID(1, 4, 1, column))
+
+#define PHASE_CONTROL(field, column)                                           \
+	COLUMN(phaseControlGroupTable, phaseGroupRows, PhaseControlGroupEntry,     \
+	       field, INTEGER, column == 1 ? READ_ONLY : CONTROL, 0, UINT8_MAX,    \
+	       ASC_OID(1, 5, 1, column))
+
+#define VEHICLE_DETECTOR(field, access, column)                                \
+	COLUMN(vehicleDetectorTable, vehicleDetectorRows, VehicleDetectorEntry,    \
+	       field, INTEGER, access, 0, UINT8_MAX, ASC_OID(2, 2, 1, column))
+
+#define PEDESTRIAN_DETECTOR(field, access, column)                             \
+	COLUMN(pedestrianDetectorTable, pedestrianDetectorRows,                    \
+	       PedestrianDetectorEntry, field, INTEGER, access, 0, UINT8_MAX,      \
+	       ASC_OID(2, 7, 1, column))
+
+#define PATTERN(field, access, minimum, maximum, column)                       \
+	COLUMN(patternTable, patternRows, PatternEntry, field, INTEGER, access,    \
+	       minimum, maximum, ASC_OID(4, 7, 1, column))
+
+/* The split table is indexed by splitNumber.splitPhase. */
+#define SPLIT(field, access, minimum, maximum, column)                         \
+	{                                                                          \
+		.oid    = ASC_OID(4, 9, 1, column),                                    \
+		.base   = splitTable,                                                  \
+		.rows   = splitRows,                                                   \
+		.inner  = phaseRows,                                                   \
+		.stride = sizeof(SplitEntry),                                          \
+		FIELD(SplitEntry, field, INTEGER, access, minimum, maximum)            \
+	}
+
+#define COORD(field, access, minimum, maximum, ...)                            \
+	SCALAR(coord, Coord, field, INTEGER, access, minimum, maximum,             \
+	       ASC_OID(4, __VA_ARGS__))
+
+#define TIMEBASE_ASC_ACTION(field, access, column)                             \
+	COLUMN(timebaseAscActionTable, timebaseAscActionRows,                      \
+	       TimebaseAscActionEntry, field, INTEGER, access, 0, UINT8_MAX,       \
+	       ASC_OID(5, 3, 1, column))
+
+#define PREEMPT(field, syntax, access, minimum, maximum, column)               \
+	COLUMN(preemptTable, preemptRows, PreemptEntry, field, syntax, access,     \
+	       minimum, maximum, ASC_OID(6, 2, 1, column))
+
+#define FONT(field, syntax, access, minimum, maximum, column)                  \
+	COLUMN(fontTable, fontRows, FontEntry, field, syntax, access, minimum,     \
+	       maximum, DMS_OID(3, 2, 1, column))
+
+/* The character table is indexed by fontIndex.characterNumber. */
+#define CHARACTER(field, syntax, access, minimum, maximum, column)             \
+	{                                                                          \
+		.oid    = DMS_OID(3, 4, 1, column),                                    \
+		.base   = characterTable,                                              \
+		.rows   = characterRows,                                               \
+		.inner  = fontCharacters,                                              \
+		.stride = sizeof(CharacterEntry),                                      \
+		FIELD(CharacterEntry, field, syntax, access, minimum, maximum)         \
+	}
+
+#define MULTI_DEFAULT(field, minimum, maximum, column)                         \
+	SCALAR(multiCfg, MultiCfg, field, INTEGER, READ_WRITE, minimum, maximum,   \
+	       DMS_OID(4, column))
+
+/* The message table is indexed by dmsMessageMemoryType.dmsMessageNumber. */
+#define MESSAGE(field, syntax, access, minimum, maximum, column)               \
+	{                                                                          \
+		.oid    = DMS_OID(5, 8, 1, column),                                    \
+		.base   = dmsMessageTable,                                             \
+		.rows   = dmsMessageRows,                                              \
+		.inner  = dmsMessageNumbers,                                           \
+		.stride = sizeof(DmsMessageEntry),                                     \
+		FIELD(DmsMessageEntry, field, syntax, access, minimum, maximum)        \
+	}
+
+#define SIGN_CONTROL(field, syntax, access, minimum, maximum, column)          \
+	SCALAR(signControl, SignControl, field, syntax, access, minimum, maximum,  \
+	       DMS_OID(6, column))
+
+#define ATMOSPHERE(field, syntax, minimum, maximum, ...)                      \
+	SCALAR(essAtmosphere, EssAtmosphere, field, syntax, READ_ONLY, minimum,    \
+	       maximum, ESS_OID(1, __VA_ARGS__))
+
+#define TEMPERATURE_SENSOR(field, access, minimum, maximum, column)            \
+	COLUMN(essTemperatureSensorTable, essTemperatureSensorRows,                \
+	       EssTemperatureSensorEntry, field, INTEGER, access, minimum,         \
+	       maximum, ESS_OID(5, 2, 1, column))
+
+#define PAVEMENT_SENSOR(field, syntax, access, minimum, maximum, column)       \
+	COLUMN(essPavementSensorTable, essPavementSensorRows,                      \
+	       EssPavementSensorEntry, field, syntax, access, minimum, maximum,    \
+	       ESS_OID(6, 3, 1, column))
+
+#define SENSOR_ZONE(field, syntax, access, minimum, maximum, column)          \
+	COLUMN(sensorZoneTable, sensorZoneRows, SensorZoneEntry, field, syntax,    \
+	       access, minimum, maximum, TSS_OID(2, 1, column))
+
+#define VEHICLE_CLASS(field, syntax, access, minimum, maximum, column)        \
+	COLUMN(vehicleClassTable, vehicleClassRows, VehicleClassEntry, field,      \
+	       syntax, access, minimum, maximum, TSS_OID(4, 1, column))
+
+#define ZONE_SAMPLE(field, maximum, column)                                    \
+	COLUMN(zoneSampleTable, sensorZoneRows, ZoneSampleEntry, field, INTEGER,   \
+	       READ_ONLY, 0, maximum, TSS_OID(5, 3, 1, column))
+
+/* The zone class table is indexed by zoneSampleNumber.vehicleClassNumber. */
+#define ZONE_CLASS(field, column)                                              \
+	{                                                                          \
+		.oid    = TSS_OID(5, 4, 1, column),                                    \
+		.base   = zoneClassTable,                                              \
+		.rows   = zoneClassRows,                                               \
+		.inner  = vehicleClassRows,                                            \
+		.stride = sizeof(ZoneClassEntry),                                      \
+		FIELD(ZoneClassEntry, field, INTEGER, READ_ONLY, 0, UINT16_MAX)        \
+	}
+
+#define MAINLINE_LANE(field, access, minimum, maximum, column)                 \
+	COLUMN(rmcMainlineLaneTable, rmcMainlineLaneRows, RmcMainlineLaneEntry,    \
+	       field, INTEGER, access, minimum, maximum, RMC_OID(2, 2, 1, column))
+
+#define METERED_LANE(field, access, minimum, maximum, column)                  \
+	COLUMN(rmcMeteredLaneTable, rmcMeteredLaneRows, RmcMeteredLaneEntry,       \
+	       field, INTEGER, access, minimum, maximum, RMC_OID(3, 2, 1, column))
+
+#define TR_LEVEL(field, access, minimum, maximum, column)                      \
+	COLUMN(rmcTRLevelTable, rmcTRLevelRows, RmcTRLevelEntry, field, INTEGER,   \
+	       access, minimum, maximum, RMC_OID(4, 2, 1, column))
+
+#define RSU_DESCRIPTION(field, access, column)                                 \
+	SCALAR(rsuSysDescription, RsuSysDescription, field, STRING, access, 0,     \
+	       UINT8_MAX, RSU_OID(13, column))
+
+#define RSU_IFM(field, syntax, minimum, maximum, column)                       \
+	COLUMN(rsuIFMTable, rsuIFMRows, RsuIFMEntry, field, syntax, CONTROL,       \
+	       minimum, maximum, RSU_OID(4, 2, 1, column))
+
+#define SNMP_ENGINE(field, syntax, column)                                     \
+	SCALAR(snmpEngine, USMEngine, field, syntax, READ_ONLY, 0, 0,              \
+	       SNMP_ENGINE_OID(column))
+
+#define USM_STATS(field, column)                                               \
+	SCALAR(usmStats, USMStatistics, field, COUNTER, READ_ONLY, 0, 0,           \
+	       USM_STATS_OID(column))
+
+#define FORWARD_MONITOR(field, column)                                         \
+	SCALAR(forwardMonitor, ForwardStatus, field, COUNTER, READ_ONLY, 0, 0,     \
+	       PRIVATE_OID(1, 4, column))
+
+/* Every object the agent serves. registryInit() sorts this table, after which
+ * lookups are binary searches and GETNEXT walks it in order.
+ */
+#define METRIC(field, syntax, column)                                          \
+	COLUMN(metricTable, metricRows, MetricEntry, field, syntax, READ_ONLY,     \
+	       0, 0, PRIVATE_OID(1, 1, 1, 1, column))
+
+/* The bucket table is indexed by metricIndex.metricBucketIndex. */
+#define METRIC_BUCKET(field, syntax, column)                                   \
+	{                                                                          \
+		.oid    = PRIVATE_OID(1, 1, 2, 1, column),                             \
+		.base   = metricBucketTable,                                           \
+		.rows   = metricBucketRows,                                            \
+		.inner  = metricBuckets,                                               \
+		.stride = sizeof(MetricBucketEntry),                                   \
+		FIELD(MetricBucketEntry, field, syntax, READ_ONLY, 0, 0)               \
+	}
+
+#define SYNC_TABLE(field, syntax, column)                                      \
+	COLUMN(syncTable, syncTableRows, SyncTableEntry, field, syntax, READ_ONLY, \
+	       0, 0, PRIVATE_OID(1, 3, 1, 1, column))
+
+/* Each row hash column is indexed like the table it covers. */
+#define SYNC_ROW_HASH(hashes, count, column)                                   \
+	COLUMN(hashes, count, SyncRowHash, syncRowHash, GAUGE, READ_ONLY, 0, 0,    \
+	       PRIVATE_OID(1, 3, 2, column))
+
+static RegistryObject objects[] =
+{
+	/* NTCIP 1201 globalConfiguration */
+	SCALAR(globalConfiguration, GlobalConfiguration, globalSetIDParameter,
+	       INTEGER, READ_ONLY, 0, UINT16_MAX, GLOBAL_OID(1, 1)),
+	SCALAR(globalConfiguration, GlobalConfiguration, globalMaxModules,
+	       INTEGER, READ_ONLY, 1, UINT8_MAX, GLOBAL_OID(1, 2)),
+	MODULE(moduleNumber,     INTEGER,    READ_ONLY, 1, UINT8_MAX, 1),
+	MODULE(moduleDeviceNode, IDENTIFIER, READ_ONLY, 0, 0,         2),
+	MODULE(moduleMake,       STRING,     READ_ONLY, 0, 0,         3),
+	MODULE(moduleModel,      STRING,     READ_ONLY, 0, 0,         4),
+	MODULE(moduleVersion,    STRING,     READ_ONLY, 0, 0,         5),
+	MODULE(moduleType,       INTEGER,    READ_ONLY, 1, 3,         6),
+	SCALAR(globalConfiguration, GlobalConfiguration, controllerBaseStandards,
+	       STRING, READ_ONLY, 0, 0, GLOBAL_OID(1, 4)),
+
+	/* NTCIP 1201 globalDBManagement */
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbCreateTransaction,
+	       INTEGER, CONTROL, 1, 6, GLOBAL_OID(2, 1)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbErrorType,
+	       INTEGER, READ_ONLY, 1, 7, GLOBAL_OID(2, 2)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbErrorID,
+	       STRING, READ_ONLY, 0, 0, GLOBAL_OID(2, 3)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbTransactionID,
+	       STRING, READ_ONLY, 0, 0, GLOBAL_OID(2, 4)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbMakeID,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(2, 5)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbVerifyStatus,
+	       INTEGER, READ_ONLY, 1, 3, GLOBAL_OID(2, 6)),
+	SCALAR(globalDBManagement, GlobalDatabaseManagement, dbVerifyError,
+	       STRING, READ_ONLY, 0, 0, GLOBAL_OID(2, 7)),
+
+	/* NTCIP 1201 globalTimeManagement */
+	SCALAR(globalTimeManagement, GlobalTimeManagement, globalTime,
+	       COUNTER, CONTROL, 0, UINT32_MAX, GLOBAL_OID(3, 1)),
+	SCALAR(globalTimeManagement, GlobalTimeManagement, globalDaylightSaving,
+	       INTEGER, READ_WRITE, 1, 20, GLOBAL_OID(3, 2)),
+	SCALAR(timebase, Timebase, maxTimeBaseScheduleEntries,
+	       INTEGER, READ_ONLY, 0, UINT16_MAX, GLOBAL_OID(3, 3, 1)),
+	SCHEDULE(timeBaseScheduleNumber,  READ_ONLY,  1, UINT16_MAX, 1),
+	SCHEDULE(timeBaseScheduleMonth,   READ_WRITE, 0, 0x1FFE,     2),
+	SCHEDULE(timeBaseScheduleDay,     READ_WRITE, 0, 0xFE,       3),
+	SCHEDULE(timeBaseScheduleDate,    READ_WRITE, 0, 0xFFFFFFFE, 4),
+	SCHEDULE(timeBaseScheduleDayPlan, READ_WRITE, 0, UINT8_MAX,  5),
+	SCALAR(timebase, Timebase, maxDayPlans,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(3, 3, 3)),
+	SCALAR(timebase, Timebase, maxDayPlanEvents,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(3, 3, 4)),
+	DAY_PLAN(dayPlanNumber,          INTEGER,    READ_ONLY,  1, UINT8_MAX, 1),
+	DAY_PLAN(dayPlanEventNumber,     INTEGER,    READ_ONLY,  1, UINT8_MAX, 2),
+	DAY_PLAN(dayPlanHourNumber,      INTEGER,    READ_WRITE, 0, 23,        3),
+	DAY_PLAN(dayPlanMinuteNumber,    INTEGER,    READ_WRITE, 0, 59,        4),
+	{
+		.oid       = GLOBAL_OID(3, 3, 5, 1, 5),
+		.base      = timeBaseDayPlanTable,
+		.rows      = timeBaseDayPlanRows,
+		.inner     = timeBaseDayPlanEvents,
+		.stride    = sizeof(TimeBaseDayPlanEntry),
+		.reference = &(const OID) ASC_OID(5, 3, 1, 1),
+		FIELD(TimeBaseDayPlanEntry, dayPlanActionNumberOID, IDENTIFIER,
+		      READ_WRITE, 0, UINT8_MAX)
+	},
+	SCALAR(timebase, Timebase, dayPlanStatus,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(3, 3, 6)),
+	SCALAR(timebase, Timebase, timeBaseScheduleTableStatus,
+	       INTEGER, READ_ONLY, 0, UINT16_MAX, GLOBAL_OID(3, 3, 7)),
+	SCALAR(globalTimeManagement, GlobalTimeManagement,
+	       globalLocationTimeDifferential, INTEGER, READ_WRITE, -43200, 43200,
+	       GLOBAL_OID(3, 4)),
+	SCALAR(globalTimeManagement, GlobalTimeManagement,
+	       controllerStandardTimeZone, INTEGER, READ_WRITE, -43200, 43200,
+	       GLOBAL_OID(3, 5)),
+	SCALAR(globalTimeManagement, GlobalTimeManagement, controllerLocalTime,
+	       COUNTER, READ_ONLY, 0, UINT32_MAX, GLOBAL_OID(3, 6)),
+	SCALAR(daylightSavingNode, DaylightSavingNode, maxDaylightSavingEntries,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(3, 7, 1)),
+	DST(dstEntryNumber,              1, UINT8_MAX,  1),
+	DST(dstBeginMonth,               1, 14,         2),
+	DST(dstBeginOccurrences,         1, 9,          3),
+	DST(dstBeginDayOfWeek,           1, 7,          4),
+	DST(dstBeginDayOfMonth,          1, 31,         5),
+	DST(dstBeginSecondsToTransition, 0, UINT32_MAX, 6),
+	DST(dstEndMonth,                 1, 14,         7),
+	DST(dstEndOccurrences,           1, 9,          8),
+	DST(dstEndDayOfWeek,             1, 7,          9),
+	DST(dstEndDayOfMonth,            1, 31,         10),
+	DST(dstEndSecondsToTransition,   0, UINT32_MAX, 11),
+	DST(dstSecondsToAdjust,          0, 21600,      12),
+
+	/* NTCIP 1201 auxIOv2 */
+	SCALAR(auxIOv2, AuxIOv2, maxAuxIOv2TableNumDigitalPorts,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(7, 1)),
+	SCALAR(auxIOv2, AuxIOv2, maxAuxIOv2TableNumAnalogPorts,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, GLOBAL_OID(7, 2)),
+	AUX_IO(auxIOv2PortType,               INTEGER, READ_ONLY, 1, 3,         1),
+	AUX_IO(auxIOv2PortNumber,             INTEGER, READ_ONLY, 1, UINT8_MAX, 2),
+	AUX_IO(auxIOv2PortDescription,        STRING,  READ_ONLY, 0, UINT8_MAX, 3),
+	AUX_IO(auxIOv2PortResolution,         INTEGER, READ_ONLY, 1, 32,        4),
+	AUX_IO(auxIOv2PortValue,              INTEGER, CONTROL,   0, INT32_MAX, 5),
+	AUX_IO(auxIOv2PortDirection,          INTEGER, READ_ONLY, 1, 3,         6),
+	AUX_IO(auxIOv2PortLastCommandedState, INTEGER, CONTROL,   0, INT32_MAX, 7),
+
+	/* NTCIP 1202 phase */
+	SCALAR(phase, Phase, maxPhases, INTEGER, READ_ONLY, 2, UINT8_MAX,
+	       ASC_OID(1, 1)),
+	PHASE(phaseNumber,              READ_ONLY,  1, UINT8_MAX,  1),
+	PHASE(phaseWalk,                READ_WRITE, 0, UINT8_MAX,  2),
+	PHASE(phasePedestrianClear,     READ_WRITE, 0, UINT8_MAX,  3),
+	PHASE(phaseMinimumGreen,        READ_WRITE, 0, UINT8_MAX,  4),
+	PHASE(phasePassage,             READ_WRITE, 0, UINT8_MAX,  5),
+	PHASE(phaseMaximum1,            READ_WRITE, 0, UINT8_MAX,  6),
+	PHASE(phaseMaximum2,            READ_WRITE, 0, UINT8_MAX,  7),
+	PHASE(phaseYellowChange,        READ_WRITE, 0, UINT8_MAX,  8),
+	PHASE(phaseRedClear,            READ_WRITE, 0, UINT8_MAX,  9),
+	PHASE(phaseRedRevert,           READ_WRITE, 0, UINT8_MAX,  10),
+	PHASE(phaseAddedInitial,        READ_WRITE, 0, UINT8_MAX,  11),
+	PHASE(phaseMaximumInitial,      READ_WRITE, 0, UINT8_MAX,  12),
+	PHASE(phaseTimeBeforeReduction, READ_WRITE, 0, UINT8_MAX,  13),
+	PHASE(phaseCarsBeforeReduction, READ_WRITE, 0, UINT8_MAX,  14),
+	PHASE(phaseTimeToReduce,        READ_WRITE, 0, UINT8_MAX,  15),
+	PHASE(phaseReduceBy,            READ_WRITE, 0, UINT8_MAX,  16),
+	PHASE(phaseMinimumGap,          READ_WRITE, 0, UINT8_MAX,  17),
+	PHASE(phaseDynamicMaxLimit,     READ_WRITE, 0, UINT8_MAX,  18),
+	PHASE(phaseDynamicMaxStep,      READ_WRITE, 0, UINT8_MAX,  19),
+	PHASE(phaseStartup,             READ_WRITE, 1, 6,          20),
+	PHASE(phaseOptions,             READ_WRITE, 0, UINT16_MAX, 21),
+	PHASE(phaseRing,                READ_WRITE, 0, UINT8_MAX,  22),
+	COLUMN(phaseTable, phaseRows, PhaseEntry, phaseConcurrency, STRING,
+	       READ_WRITE, 0, UINT8_MAX, ASC_OID(1, 2, 1, 23)),
+	SCALAR(phase, Phase, maxPhaseGroups, INTEGER, READ_ONLY, 1, UINT8_MAX,
+	       ASC_OID(1, 3)),
+	PHASE_STATUS(phaseStatusGroupNumber,     1),
+	PHASE_STATUS(phaseStatusGroupReds,       2),
+	PHASE_STATUS(phaseStatusGroupYellows,    3),
+	PHASE_STATUS(phaseStatusGroupGreens,     4),
+	PHASE_STATUS(phaseStatusGroupDontWalks,  5),
+	PHASE_STATUS(phaseStatusGroupPedClears,  6),
+	PHASE_STATUS(phaseStatusGroupWalks,      7),
+	PHASE_STATUS(phaseStatusGroupVehCalls,   8),
+	PHASE_STATUS(phaseStatusGroupPedCalls,   9),
+	PHASE_STATUS(phaseStatusGroupPhaseOns,   10),
+	PHASE_STATUS(phaseStatusGroupPhaseNexts, 11),
+	PHASE_CONTROL(phaseControlGroupNumber,   1),
+	PHASE_CONTROL(phaseControlGroupPhaseOmit, 2),
+	PHASE_CONTROL(phaseControlGroupPedOmit,  3),
+	PHASE_CONTROL(phaseControlGroupHold,     4),
+	PHASE_CONTROL(phaseControlGroupForceOff, 5),
+	PHASE_CONTROL(phaseControlGroupVehCall,  6),
+	PHASE_CONTROL(phaseControlGroupPedCall,  7),
+
+	/* NTCIP 1202 detector */
+	SCALAR(detector, Detector, maxVehicleDetectors, INTEGER, READ_ONLY,
+	       1, UINT8_MAX, ASC_OID(2, 1)),
+	VEHICLE_DETECTOR(vehicleDetectorNumber,         READ_ONLY,  1),
+	VEHICLE_DETECTOR(vehicleDetectorOptions,        READ_WRITE, 2),
+	VEHICLE_DETECTOR(vehicleDetectorCallPhase,      READ_WRITE, 3),
+	VEHICLE_DETECTOR(vehicleDetectorSwitchPhase,    READ_WRITE, 4),
+	VEHICLE_DETECTOR(vehicleDetectorDelay,          READ_WRITE, 5),
+	VEHICLE_DETECTOR(vehicleDetectorExtend,         READ_WRITE, 6),
+	VEHICLE_DETECTOR(vehicleDetectorQueueLimit,     READ_WRITE, 7),
+	VEHICLE_DETECTOR(vehicleDetectorNoActivity,     READ_WRITE, 8),
+	VEHICLE_DETECTOR(vehicleDetectorMaxPresence,    READ_WRITE, 9),
+	VEHICLE_DETECTOR(vehicleDetectorErraticCounts,  READ_WRITE, 10),
+	VEHICLE_DETECTOR(vehicleDetectorFailTime,       READ_WRITE, 11),
+	VEHICLE_DETECTOR(vehicleDetectorAlarms,         READ_ONLY,  12),
+	VEHICLE_DETECTOR(vehicleDetectorReportedAlarms, READ_ONLY,  13),
+	VEHICLE_DETECTOR(vehicleDetectorReset,          CONTROL,    14),
+	SCALAR(detector, Detector, maxVehicleDetectorStatusGroups, INTEGER,
+	       READ_ONLY, 1, UINT8_MAX, ASC_OID(2, 3)),
+	COLUMN(vehicleDetectorStatusGroupTable, vehicleDetectorStatusGroupRows,
+	       VehicleDetectorStatusGroupEntry, vehicleDetectorStatusGroupNumber,
+	       INTEGER, READ_ONLY, 1, UINT8_MAX, ASC_OID(2, 4, 1, 1)),
+	COLUMN(vehicleDetectorStatusGroupTable, vehicleDetectorStatusGroupRows,
+	       VehicleDetectorStatusGroupEntry, vehicleDetectorStatusGroupActive,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, ASC_OID(2, 4, 1, 2)),
+	COLUMN(vehicleDetectorStatusGroupTable, vehicleDetectorStatusGroupRows,
+	       VehicleDetectorStatusGroupEntry, vehicleDetectorStatusGroupAlarms,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, ASC_OID(2, 4, 1, 3)),
+	SCALAR(volumeOccupancyReport, VolumeOccupancyReport,
+	       volumeOccupancySequence, INTEGER, READ_ONLY, 0, UINT8_MAX,
+	       ASC_OID(2, 5, 1)),
+	SCALAR(volumeOccupancyReport, VolumeOccupancyReport,
+	       volumeOccupancyPeriod, INTEGER, READ_WRITE, 0, UINT8_MAX,
+	       ASC_OID(2, 5, 2)),
+	SCALAR(volumeOccupancyReport, VolumeOccupancyReport,
+	       activeVolumeOccupancyDetectors, INTEGER, READ_ONLY, 0, UINT8_MAX,
+	       ASC_OID(2, 5, 3)),
+	COLUMN(volumeOccupancyTable, volumeOccupancyRows, VolumeOccupancyEntry,
+	       detectorVolume, INTEGER, READ_ONLY, 0, UINT8_MAX,
+	       ASC_OID(2, 5, 4, 1, 1)),
+	COLUMN(volumeOccupancyTable, volumeOccupancyRows, VolumeOccupancyEntry,
+	       detectorOccupancy, INTEGER, READ_ONLY, 0, UINT8_MAX,
+	       ASC_OID(2, 5, 4, 1, 2)),
+	SCALAR(detector, Detector, maxPedestrianDetectors, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, ASC_OID(2, 6)),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorNumber,        READ_ONLY,  1),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorCallPhase,     READ_WRITE, 2),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorNoActivity,    READ_WRITE, 3),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorMaxPresence,   READ_WRITE, 4),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorErraticCounts, READ_WRITE, 5),
+	PEDESTRIAN_DETECTOR(pedestrianDetectorAlarms,        READ_ONLY,  6),
+
+	/* NTCIP 1202 unit */
+	SCALAR(unit, Unit, unitStartUpFlash, INTEGER, READ_WRITE, 0, UINT8_MAX,
+	       ASC_OID(3, 1)),
+
+	/* NTCIP 1202 coord */
+	COORD(coordOperationalMode, CONTROL,    0, UINT8_MAX,  1),
+	COORD(coordCorrectionMode,  READ_WRITE, 1, 4,          2),
+	COORD(coordMaximumMode,     READ_WRITE, 1, 4,          3),
+	COORD(coordForceMode,       READ_WRITE, 1, 3,          4),
+	COORD(maxPatterns,          READ_ONLY,  0, UINT8_MAX,  5),
+	COORD(patternTableType,     READ_ONLY,  1, 4,          6),
+	PATTERN(patternNumber,         READ_ONLY,  1, UINT8_MAX, 1),
+	PATTERN(patternCycleTime,      READ_WRITE, 0, UINT8_MAX, 2),
+	PATTERN(patternOffsetTime,     READ_WRITE, 0, UINT8_MAX, 3),
+	PATTERN(patternSplitNumber,    READ_WRITE, 0, UINT8_MAX, 4),
+	PATTERN(patternSequenceNumber, READ_WRITE, 0, UINT8_MAX, 5),
+	COORD(maxSplits,            READ_ONLY,  0, UINT8_MAX,  8),
+	SPLIT(splitNumber,     READ_ONLY,  1, UINT8_MAX, 1),
+	SPLIT(splitPhase,      READ_ONLY,  1, UINT8_MAX, 2),
+	SPLIT(splitTime,       READ_WRITE, 0, UINT8_MAX, 3),
+	SPLIT(splitMode,       READ_WRITE, 1, 7,         4),
+	SPLIT(splitCoordPhase, READ_WRITE, 0, 1,         5),
+	COORD(coordPatternStatus,   READ_ONLY,  0, UINT8_MAX,  10),
+	COORD(localFreeStatus,      READ_ONLY,  1, 11,         11),
+	COORD(coordCycleStatus,     READ_ONLY,  0, UINT16_MAX, 12),
+	COORD(coordSyncStatus,      READ_ONLY,  0, UINT16_MAX, 13),
+	COORD(systemPatternControl, CONTROL,    0, UINT8_MAX,  14),
+	COORD(systemSyncControl,    CONTROL,    0, UINT8_MAX,  15),
+
+	/* NTCIP 1202 timebaseAsc */
+	SCALAR(timebaseAsc, TimebaseAsc, timebaseAscPatternSync, INTEGER,
+	       READ_WRITE, 0, UINT16_MAX, ASC_OID(5, 1)),
+	SCALAR(timebaseAsc, TimebaseAsc, maxTimebaseAscActions, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, ASC_OID(5, 2)),
+	TIMEBASE_ASC_ACTION(timebaseAscActionNumber,      READ_ONLY,  1),
+	TIMEBASE_ASC_ACTION(timebaseAscPattern,           READ_WRITE, 2),
+	TIMEBASE_ASC_ACTION(timebaseAscAuxillaryFunction, READ_WRITE, 3),
+	TIMEBASE_ASC_ACTION(timebaseAscSpecialFunction,   READ_WRITE, 4),
+	SCALAR(timebaseAsc, TimebaseAsc, timebaseAscActionStatus, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, ASC_OID(5, 4)),
+
+	/* NTCIP 1202 preempt */
+	SCALAR(preempt, Preempt, maxPreempts, INTEGER, READ_ONLY, 0, UINT8_MAX,
+	       ASC_OID(6, 1)),
+	PREEMPT(preemptNumber,          INTEGER, READ_ONLY,  1, UINT8_MAX,  1),
+	PREEMPT(preemptControl,         INTEGER, READ_WRITE, 0, UINT8_MAX,  2),
+	PREEMPT(preemptLink,            INTEGER, READ_WRITE, 0, UINT8_MAX,  3),
+	PREEMPT(preemptDelay,           INTEGER, READ_WRITE, 0, 600,        4),
+	PREEMPT(preemptMinimumDuration, INTEGER, READ_WRITE, 0, UINT16_MAX, 5),
+	PREEMPT(preemptMinimumGreen,    INTEGER, READ_WRITE, 0, UINT8_MAX,  6),
+	PREEMPT(preemptMinimumWalk,     INTEGER, READ_WRITE, 0, UINT8_MAX,  7),
+	PREEMPT(preemptEnterPedClear,   INTEGER, READ_WRITE, 0, UINT8_MAX,  8),
+	PREEMPT(preemptTrackGreen,      INTEGER, READ_WRITE, 0, UINT8_MAX,  9),
+	PREEMPT(preemptDwellGreen,      INTEGER, READ_WRITE, 0, UINT8_MAX,  10),
+	PREEMPT(preemptMaximumPresence, INTEGER, READ_WRITE, 0, UINT16_MAX, 11),
+	PREEMPT(preemptTrackPhase,      STRING,  READ_WRITE, 0, UINT8_MAX,  12),
+	PREEMPT(preemptDwellPhase,      STRING,  READ_WRITE, 0, UINT8_MAX,  13),
+	PREEMPT(preemptDwellPed,        STRING,  READ_WRITE, 0, UINT8_MAX,  14),
+	PREEMPT(preemptExitPhase,       INTEGER, READ_WRITE, 0, UINT8_MAX,  15),
+	PREEMPT(preemptState,           INTEGER, READ_ONLY,  1, 9,          16),
+	COLUMN(preemptControlTable, preemptRows, PreemptControlEntry,
+	       preemptControlNumber, INTEGER, READ_ONLY, 1, UINT8_MAX,
+	       ASC_OID(6, 3, 1, 1)),
+	COLUMN(preemptControlTable, preemptRows, PreemptControlEntry,
+	       preemptControlState, INTEGER, CONTROL, 0, 1,
+	       ASC_OID(6, 3, 1, 2)),
+
+	/* NTCIP 1207 rmcGeneralConfiguration */
+	SCALAR(rmcGeneralConfiguration, RmcGeneralConfiguration, rmcCalcInterval,
+	       INTEGER, READ_WRITE, 1, RMC_MAX_CALC_INTERVAL, RMC_OID(1, 1)),
+
+	/* NTCIP 1207 rmcMainline */
+	SCALAR(rmcMainline, RmcMainline, rmcMaxNumMainlineLanes, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, RMC_OID(2, 1)),
+	MAINLINE_LANE(rmcMainlineLaneIndex,    READ_ONLY,  1, UINT8_MAX, 1),
+	MAINLINE_LANE(rmcMainlineLaneDetector, READ_WRITE, 0, UINT8_MAX, 2),
+	SCALAR(rmcMainline, RmcMainline, rmcMainlineOccupancy, INTEGER,
+	       READ_ONLY, 0, RMC_OCCUPANCY_FULL, RMC_OID(2, 3)),
+	SCALAR(rmcMainline, RmcMainline, rmcMainlineFlowRate, INTEGER,
+	       READ_ONLY, 0, UINT16_MAX, RMC_OID(2, 4)),
+
+	/* NTCIP 1207 rmcMeteredLane */
+	SCALAR(rmcMeteredLane, RmcMeteredLane, rmcMaxNumMeteredLanes, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, RMC_OID(3, 1)),
+	METERED_LANE(rmcMeteredLaneIndex,  READ_ONLY,  1, UINT8_MAX,  1),
+	METERED_LANE(rmcMeterMode,         READ_WRITE, 1, 3,          2),
+	METERED_LANE(rmcCmdRate,           READ_WRITE, 0, UINT16_MAX, 3),
+	METERED_LANE(rmcMinMeterRate,      READ_WRITE, 0, UINT16_MAX, 4),
+	METERED_LANE(rmcMaxMeterRate,      READ_WRITE, 0, UINT16_MAX, 5),
+	METERED_LANE(rmcQueueDetector,     READ_WRITE, 0, UINT8_MAX,  6),
+	METERED_LANE(rmcQueueOccupiedTime, READ_WRITE, 0, UINT16_MAX, 7),
+	METERED_LANE(rmcMeterRate,         READ_ONLY,  0, UINT16_MAX, 8),
+	METERED_LANE(rmcMeterLevel,        READ_ONLY,  0, UINT8_MAX,  9),
+	METERED_LANE(rmcQueueActive,       READ_ONLY,  0, 1,          10),
+	METERED_LANE(rmcReleaseInterval,   READ_ONLY,  0, UINT16_MAX, 11),
+
+	/* NTCIP 1207 rmcTrafficResponsive */
+	SCALAR(rmcTrafficResponsive, RmcTrafficResponsive, rmcMaxNumTRLevels,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, RMC_OID(4, 1)),
+	TR_LEVEL(rmcTRLevelIndex,     READ_ONLY,  1, UINT8_MAX,          1),
+	TR_LEVEL(rmcTRLevelRate,      READ_WRITE, 0, UINT16_MAX,         2),
+	TR_LEVEL(rmcTRLevelOccupancy, READ_WRITE, 0, RMC_OCCUPANCY_FULL, 3),
+	TR_LEVEL(rmcTRLevelFlowRate,  READ_WRITE, 0, UINT16_MAX,         4),
+
+	/* NTCIP 1203 dmsSignCfg */
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsSignAccess, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(1, 1)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsSignType, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(1, 2)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsSignHeight, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(1, 3)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsSignWidth, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(1, 4)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsHorizontalBorder, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(1, 5)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsVerticalBorder, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(1, 6)),
+	SCALAR(dmsSignCfg, DmsSignCfg, dmsSignTechnology, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(1, 9)),
+
+	/* NTCIP 1203 vmsCfg */
+	SCALAR(vmsCfg, VmsCfg, vmsCharacterHeightPixels, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(2, 1)),
+	SCALAR(vmsCfg, VmsCfg, vmsCharacterWidthPixels, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(2, 2)),
+	SCALAR(vmsCfg, VmsCfg, vmsSignHeightPixels, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(2, 3)),
+	SCALAR(vmsCfg, VmsCfg, vmsSignWidthPixels, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(2, 4)),
+	SCALAR(vmsCfg, VmsCfg, vmsHorizontalPitch, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(2, 5)),
+	SCALAR(vmsCfg, VmsCfg, vmsVerticalPitch, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(2, 6)),
+	SCALAR(vmsCfg, VmsCfg, monochromeColor, STRING, READ_ONLY, 0, 0,
+	       DMS_OID(2, 7)),
+
+	/* NTCIP 1203 fontDefinition */
+	SCALAR(fontDefinition, FontDefinition, numFonts, INTEGER, READ_ONLY,
+	       0, UINT8_MAX, DMS_OID(3, 1)),
+	FONT(fontIndex,       INTEGER, READ_ONLY,  1, UINT8_MAX,  1),
+	FONT(fontNumber,      INTEGER, READ_WRITE, 1, UINT8_MAX,  2),
+	FONT(fontName,        STRING,  READ_WRITE, 0, 64,         3),
+	FONT(fontHeight,      INTEGER, READ_WRITE, 0, UINT8_MAX,  4),
+	FONT(fontCharSpacing, INTEGER, READ_WRITE, 0, UINT8_MAX,  5),
+	FONT(fontLineSpacing, INTEGER, READ_WRITE, 0, UINT8_MAX,  6),
+	FONT(fontVersionID,   INTEGER, READ_ONLY,  0, UINT16_MAX, 7),
+	FONT(fontStatus,      INTEGER, READ_WRITE, 1, 11,         8),
+	SCALAR(fontDefinition, FontDefinition, maxFontCharacters, INTEGER,
+	       READ_ONLY, 0, UINT16_MAX, DMS_OID(3, 3)),
+	CHARACTER(characterNumber, INTEGER, READ_ONLY,  1, UINT16_MAX, 1),
+	CHARACTER(characterWidth,  INTEGER, READ_WRITE, 0, UINT8_MAX,  2),
+	CHARACTER(characterBitmap, STRING,  READ_WRITE, 0, UINT8_MAX,  3),
+	SCALAR(fontDefinition, FontDefinition, fontMaxCharacterSize, INTEGER,
+	       READ_ONLY, 0, UINT16_MAX, DMS_OID(3, 5)),
+
+	/* NTCIP 1203 multiCfg */
+	MULTI_DEFAULT(defaultBackgroundColor,   0, UINT8_MAX, 1),
+	MULTI_DEFAULT(defaultForegroundColor,   0, UINT8_MAX, 2),
+	MULTI_DEFAULT(defaultFlashOn,           0, UINT8_MAX, 3),
+	MULTI_DEFAULT(defaultFlashOff,          0, UINT8_MAX, 4),
+	MULTI_DEFAULT(defaultFont,              1, UINT8_MAX, 5),
+	MULTI_DEFAULT(defaultJustificationLine, 2, 5,         6),
+	MULTI_DEFAULT(defaultJustificationPage, 2, 4,         7),
+	MULTI_DEFAULT(defaultPageOnTime,        0, 100,       8),
+	MULTI_DEFAULT(defaultPageOffTime,       0, 100,       9),
+	MULTI_DEFAULT(defaultCharacterSet,      1, 2,         10),
+
+	/* NTCIP 1203 dmsMessage */
+	SCALAR(dmsMessage, DmsMessage, dmsNumPermanentMsg, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(5, 1)),
+	SCALAR(dmsMessage, DmsMessage, dmsNumChangeableMsg, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(5, 2)),
+	SCALAR(dmsMessage, DmsMessage, dmsMaxChangeableMsg, INTEGER, READ_ONLY,
+	       0, UINT16_MAX, DMS_OID(5, 3)),
+	SCALAR(dmsMessage, DmsMessage, dmsFreeChangeableMemory, GAUGE,
+	       READ_ONLY, 0, UINT32_MAX, DMS_OID(5, 4)),
+	MESSAGE(dmsMessageMemoryType,      INTEGER, READ_ONLY, 1, 7,         1),
+	MESSAGE(dmsMessageNumber,          INTEGER, READ_ONLY, 1, UINT16_MAX, 2),
+	MESSAGE(dmsMessageMultiString,     STRING,  CONTROL,   0, MULTI_MAX_LENGTH,
+	        3),
+	MESSAGE(dmsMessageOwner,           STRING,  CONTROL,   0, 127,       4),
+	MESSAGE(dmsMessageCRC,             INTEGER, READ_ONLY, 0, UINT16_MAX, 5),
+	MESSAGE(dmsMessageBeacon,          INTEGER, CONTROL,   0, 1,         6),
+	MESSAGE(dmsMessagePixelService,    INTEGER, CONTROL,   0, 1,         7),
+	MESSAGE(dmsMessageRunTimePriority, INTEGER, CONTROL,   1, UINT8_MAX, 8),
+	MESSAGE(dmsMessageStatus,          INTEGER, CONTROL,   1, 8,         9),
+	SCALAR(dmsMessage, DmsMessage, dmsValidateMessageError, INTEGER,
+	       READ_ONLY, 1, 5, DMS_OID(5, 9)),
+
+	/* NTCIP 1203 signControl */
+	SIGN_CONTROL(dmsControlMode,              INTEGER, CONTROL,   2, 5,   1),
+	SIGN_CONTROL(dmsActivateMessage,          STRING,  CONTROL,   12, 12, 3),
+	SIGN_CONTROL(dmsMessageTimeRemaining,     INTEGER, READ_ONLY, 0,
+	             UINT16_MAX, 4),
+	SIGN_CONTROL(dmsMsgTableSource,           STRING,  READ_ONLY, 0, 0,   5),
+	SIGN_CONTROL(dmsActivateMsgError,         INTEGER, READ_ONLY, 1, 9,   17),
+	SIGN_CONTROL(dmsMultiSyntaxError,         INTEGER, READ_ONLY, 1, 15,  18),
+	SIGN_CONTROL(dmsMultiSyntaxErrorPosition, INTEGER, READ_ONLY, 0,
+	             UINT16_MAX, 19),
+
+	/* NTCIP 1204 essBufr */
+	SCALAR(essLocation, EssLocation, essLatitude, INTEGER, READ_WRITE,
+	       -90000000, 90000001, ESS_OID(1, 5, 2)),
+	SCALAR(essLocation, EssLocation, essLongitude, INTEGER, READ_WRITE,
+	       -180000000, 180000001, ESS_OID(1, 6, 2)),
+	SCALAR(essLocation, EssLocation, essReferenceHeight, INTEGER, READ_WRITE,
+	       -400, 8001, ESS_OID(1, 7, 1)),
+	ATMOSPHERE(essAtmosphericPressure, INTEGER, 0, UINT16_MAX, 10, 4),
+	ATMOSPHERE(essAvgWindDirection,    INTEGER, 0, 361,        11, 1),
+	ATMOSPHERE(essAvgWindSpeed,        INTEGER, 0, UINT16_MAX, 11, 2),
+	ATMOSPHERE(essMaxWindGustSpeed,    INTEGER, 0, UINT16_MAX, 11, 41),
+	ATMOSPHERE(essMaxWindGustDir,      INTEGER, 0, 361,        11, 43),
+	ATMOSPHERE(essMaxTemp,             INTEGER, -1000, 1001,   12, 14),
+	ATMOSPHERE(essMinTemp,             INTEGER, -1000, 1001,   12, 15),
+	ATMOSPHERE(essRelativeHumidity,    INTEGER, 0, 101,        13, 3),
+	ATMOSPHERE(essVisibility,          INTEGER, 0, 1000001,    20, 1),
+
+	/* NTCIP 1204 essNtcip */
+	SCALAR(essNtcip, EssNtcip, essNtcipCategory, INTEGER, READ_WRITE, 1, 3,
+	       ESS_OID(2, 1)),
+	SCALAR(essNtcip, EssNtcip, essNtcipSiteDescription, STRING, READ_WRITE,
+	       0, UINT8_MAX, ESS_OID(2, 2)),
+	SCALAR(essNtcip, EssNtcip, essTypeofStation, INTEGER, READ_WRITE, 1, 5,
+	       ESS_OID(2, 3)),
+
+	/* NTCIP 1204 wind */
+	SCALAR(essAtmosphere, EssAtmosphere, essSpotWindDirection, INTEGER,
+	       READ_ONLY, 0, 361, ESS_OID(4, 2)),
+	SCALAR(essAtmosphere, EssAtmosphere, essSpotWindSpeed, INTEGER,
+	       READ_ONLY, 0, UINT16_MAX, ESS_OID(4, 3)),
+
+	/* NTCIP 1204 temperature */
+	SCALAR(essTemperature, EssTemperature, essNumTemperatureSensors,
+	       INTEGER, READ_ONLY, 0, UINT8_MAX, ESS_OID(5, 1)),
+	TEMPERATURE_SENSOR(essTemperatureSensorIndex,  READ_ONLY,  1, UINT8_MAX,
+	                   1),
+	TEMPERATURE_SENSOR(essTemperatureSensorHeight, READ_WRITE, 0, UINT8_MAX,
+	                   2),
+	TEMPERATURE_SENSOR(essAirTemperature,          READ_ONLY,  -1000, 1001,
+	                   3),
+
+	/* NTCIP 1204 pavement */
+	SCALAR(essPavement, EssPavement, numEssPavementSensors, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, ESS_OID(6, 1)),
+	PAVEMENT_SENSOR(essPavementSensorIndex,    INTEGER, READ_ONLY,  1,
+	                UINT8_MAX, 1),
+	PAVEMENT_SENSOR(essPavementSensorLocation, STRING,  READ_WRITE, 0,
+	                UINT8_MAX, 2),
+	PAVEMENT_SENSOR(essSurfaceTemperature,     INTEGER, READ_ONLY,  -1000,
+	                1001, 8),
+	PAVEMENT_SENSOR(essPavementTemperature,    INTEGER, READ_ONLY,  -1000,
+	                1001, 9),
+
+	/* NTCIP 1209 sensorZones */
+	SCALAR(sensorZones, SensorZones, numSensorZones, INTEGER, READ_ONLY, 0,
+	       UINT16_MAX, TSS_OID(1)),
+	SENSOR_ZONE(sensorZoneNumber, INTEGER, READ_ONLY,  1, UINT16_MAX, 1),
+	SENSOR_ZONE(sensorZoneLabel,  STRING,  READ_WRITE, 0, UINT8_MAX,  2),
+	SENSOR_ZONE(sensorZoneEnable, INTEGER, READ_WRITE, 0, 1,          3),
+
+	/* NTCIP 1209 vehicleClasses */
+	SCALAR(vehicleClasses, VehicleClasses, numVehicleClasses, INTEGER,
+	       READ_ONLY, 0, UINT8_MAX, TSS_OID(3)),
+	VEHICLE_CLASS(vehicleClassNumber, INTEGER, READ_ONLY,  1, UINT8_MAX, 1),
+	VEHICLE_CLASS(vehicleClassLabel,  STRING,  READ_WRITE, 0, UINT8_MAX, 2),
+
+	/* NTCIP 1209 sampleData */
+	SCALAR(sampleData, SampleData, samplePeriod, INTEGER, READ_WRITE, 0,
+	       3600, TSS_OID(5, 1)),
+	SCALAR(sampleData, SampleData, sampleSequence, INTEGER, READ_ONLY, 0,
+	       UINT8_MAX, TSS_OID(5, 2)),
+	ZONE_SAMPLE(zoneSampleNumber,    UINT16_MAX,         1),
+	ZONE_SAMPLE(zoneSampleVolume,    UINT16_MAX,         2),
+	ZONE_SAMPLE(zoneSampleOccupancy, TSS_OCCUPANCY_FULL, 3),
+	ZONE_SAMPLE(zoneSampleSpeed,     UINT8_MAX,          4),
+	ZONE_CLASS(zoneClassVolume, 1),
+
+	/* NTCIP 1218 rsuIFM */
+	SCALAR(rsuIFM, RsuIFM, maxRsuIFMs, INTEGER, READ_ONLY, 0, UINT16_MAX,
+	       RSU_OID(4, 1)),
+	RSU_IFM(rsuIFMIndex,     INTEGER, 1, UINT16_MAX,      1),
+	RSU_IFM(rsuIFMPsid,      STRING,  1, 4,               2),
+	RSU_IFM(rsuIFMTxChannel, INTEGER, 0, UINT8_MAX,       3),
+	RSU_IFM(rsuIFMEnable,    INTEGER, 0, 1,               4),
+	RSU_IFM(rsuIFMStatus,    INTEGER, 1, 6,               5),
+	RSU_IFM(rsuIFMPriority,  INTEGER, 0, 63,              6),
+	RSU_IFM(rsuIFMOptions,   INTEGER, 0, UINT8_MAX,       7),
+	RSU_IFM(rsuIFMPayload,   STRING,  0, RSU_MAX_PAYLOAD, 8),
+
+	/* NTCIP 1218 rsuSysDescription */
+	RSU_DESCRIPTION(rsuMibVersion,      READ_ONLY,  1),
+	RSU_DESCRIPTION(rsuFirmwareVersion, READ_ONLY,  2),
+	RSU_DESCRIPTION(rsuLocationDesc,    READ_WRITE, 3),
+	RSU_DESCRIPTION(rsuID,              READ_WRITE, 4),
+
+	/* Agent tick monitor */
+	SCALAR(tickMonitor, TickStatus, tickRealTime, INTEGER, READ_ONLY, 1, 2,
+	       PRIVATE_OID(1, 2, 1)),
+	SCALAR(tickMonitor, TickStatus, tickCount, COUNTER64, READ_ONLY, 0, 0,
+	       PRIVATE_OID(1, 2, 2)),
+	SCALAR(tickMonitor, TickStatus, tickOverruns, COUNTER, READ_ONLY, 0, 0,
+	       PRIVATE_OID(1, 2, 3)),
+	SCALAR(tickMonitor, TickStatus, tickLastLateness, GAUGE, READ_ONLY, 0, 0,
+	       PRIVATE_OID(1, 2, 4)),
+	SCALAR(tickMonitor, TickStatus, tickWorstLateness, GAUGE, READ_ONLY, 0, 0,
+	       PRIVATE_OID(1, 2, 5)),
+
+	/* Agent forwarding queue */
+	FORWARD_MONITOR(forwardMessages,  1),
+	FORWARD_MONITOR(forwardSpats,     2),
+	FORWARD_MONITOR(forwardOverflows, 3),
+	FORWARD_MONITOR(forwardErrors,    4),
+
+	/* Agent metrics */
+	METRIC(metricIndex,   INTEGER,   1),
+	METRIC(metricName,    STRING,    2),
+	METRIC(metricCount,   COUNTER64, 3),
+	METRIC(metricTotal,   COUNTER64, 4),
+	METRIC(metricMaximum, GAUGE,     5),
+	METRIC(metricP50,     GAUGE,     6),
+	METRIC(metricP99,     GAUGE,     7),
+	METRIC(metricP999,    GAUGE,     8),
+	METRIC_BUCKET(metricBucketIndex,      INTEGER,   1),
+	METRIC_BUCKET(metricBucketLowerBound, GAUGE,     2),
+	METRIC_BUCKET(metricBucketCount,      COUNTER64, 3),
+
+	/* Configuration sync manifest */
+	SYNC_TABLE(syncTableIndex, INTEGER, 1),
+	SYNC_TABLE(syncTableRows,  GAUGE,   2),
+	SYNC_TABLE(syncTableHash,  GAUGE,   3),
+	SYNC_ROW_HASH(syncPhaseHashes,            phaseRows,            1),
+	SYNC_ROW_HASH(syncVehicleDetectorHashes,  vehicleDetectorRows,  2),
+	SYNC_ROW_HASH(syncTimeBaseScheduleHashes, timeBaseScheduleRows, 3),
+	{
+		.oid    = PRIVATE_OID(1, 3, 2, 4),
+		.base   = syncDayPlanHashes,
+		.rows   = timeBaseDayPlanRows,
+		.inner  = timeBaseDayPlanEvents,
+		.stride = sizeof(SyncRowHash),
+		FIELD(SyncRowHash, syncRowHash, GAUGE, READ_ONLY, 0, 0)
+	},
+	SYNC_ROW_HASH(syncDSTHashes,              dstRows,              5),
+
+	/* SNMP-FRAMEWORK-MIB snmpEngine */
+	SNMP_ENGINE(snmpEngineID,             STRING,  1),
+	SNMP_ENGINE(snmpEngineBoots,          INTEGER, 2),
+	SNMP_ENGINE(snmpEngineTime,           INTEGER, 3),
+	SNMP_ENGINE(snmpEngineMaxMessageSize, INTEGER, 4),
+
+	/* SNMP-USER-BASED-SM-MIB usmStats */
+	USM_STATS(usmStatsUnsupportedSecLevels, 1),
+	USM_STATS(usmStatsNotInTimeWindows,     2),
+	USM_STATS(usmStatsUnknownUserNames,     3),
+	USM_STATS(usmStatsUnknownEngineIDs,     4),
+	USM_STATS(usmStatsWrongDigests,         5),
+	USM_STATS(usmStatsDecryptionErrors,     6)
+};
+
+static size_t objectCount = sizeof(objects) / sizeof(objects[0]);
+
+static_assert(sizeof(objects) / sizeof(objects[0]) <= REGISTRY_MAX_OBJECTS,
+              "REGISTRY_MAX_OBJECTS is too small for the object table");
+
+static int compareObjects (const void *const left, const void *const right)
+{
+	return oidCompare(&((const RegistryObject *) left)->oid,
+	                  &((const RegistryObject *) right)->oid);
+}
+
+void registryInit (void)
+{
+	size_t kept = 0;
+
+	for (size_t index = 0; index < objectCount; index++)
+	{
+		objects[index].device = deviceResolve(&objects[index].oid);
+
+		if (objects[index].device != DEVICE_ABSENT)
+		{
+			objects[kept++] = objects[index];
+		}
+	}
+
+	objectCount = kept;
+	qsort(objects, objectCount, sizeof(objects[0]), compareObjects);
+
+	for (size_t index = 0; index < objectCount; index++)
+	{
+		objects[index].index = (uint16_t) index;
+	}
+}
+
+/* Number of objects whose identifier sorts at or before name. The object
+ * that could contain name as an instance is the last of those.
+ */
+static size_t upperBound (const OID *const name)
+{
+	size_t low = 0, high = objectCount;
+
+	while (low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+
+		if (oidCompare(&objects[middle].oid, name) <= 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+/* The instance of name below object, i.e. the arcs after the object OID. */
+static const uint32_t *instanceOf (const RegistryObject *const object,
+                                   const OID *const name, size_t *const length)
+{
+	*length = name->length - object->oid.length;
+
+	return name->arcs + object->oid.length;
+}
+
+RegistryLookup registryFind (const OID *const name,
+                             const RegistryObject **const found,
+                             size_t *const row)
+{
+	const size_t position = upperBound(name);
+
+	if (position == 0 || !oidIsPrefix(&objects[position - 1].oid, name))
+	{
+		return REGISTRY_NO_OBJECT;
+	}
+
+	const RegistryObject *const object = &objects[position - 1];
+	size_t length;
+	const uint32_t *const instance = instanceOf(object, name, &length);
+
+	*found = object;
+
+	if (!object->rows)
+	{
+		*row = 0;
+		return length == 1 && instance[0] == 0 ? REGISTRY_FOUND
+		                                       : REGISTRY_NO_INSTANCE;
+	}
+
+	if (object->instances)
+	{
+		return object->instances->find(instance, length, row)
+		     ? REGISTRY_FOUND : REGISTRY_NO_INSTANCE;
+	}
+
+	const size_t rows = object->rows();
+
+	if (!object->inner)
+	{
+		if (length != 1 || instance[0] == 0 || instance[0] > rows)
+		{
+			return REGISTRY_NO_INSTANCE;
+		}
+
+		*row = instance[0] - 1;
+		return REGISTRY_FOUND;
+	}
+
+	const size_t inner = object->inner();
+
+	if (length != 2 || inner == 0 || instance[0] == 0 || instance[1] == 0
+	 || instance[0] > rows / inner || instance[1] > inner)
+	{
+		return REGISTRY_NO_INSTANCE;
+	}
+
+	*row = (instance[0] - 1) * inner + instance[1] - 1;
+	return REGISTRY_FOUND;
+}
+
+/* Finds the first row whose instance follows the given instance arcs. */
+static bool nextRow (const RegistryObject *const object,
+                     const uint32_t *const instance, const size_t length,
+                     size_t *const row)
+{
+	if (!object->rows)
+	{
+		*row = 0;
+		return length == 0;
+	}
+
+	if (object->instances)
+	{
+		return object->instances->next(instance, length, row);
+	}
+
+	const size_t rows = object->rows();
+	uint64_t candidate;
+
+	if (length == 0)
+	{
+		candidate = 0;
+	}
+	else if (!object->inner)
+	{
+		/* Row r (instance r + 1) is the first to sort after any instance
+		 * starting with r.
+		 */
+		candidate = instance[0];
+	}
+	else
+	{
+		const uint64_t inner = object->inner();
+
+		if (inner == 0)
+		{
+			return false;
+		}
+
+		if (instance[0] == 0)
+		{
+			candidate = 0;
+		}
+		else if (length == 1)
+		{
+			candidate = (instance[0] - 1) * inner;
+		}
+		else if (instance[1] < inner)
+		{
+			candidate = (instance[0] - 1) * inner + instance[1];
+		}
+		else
+		{
+			candidate = instance[0] * inner;
+		}
+	}
+
+	*row = candidate;
+	return candidate < rows;
+}
+
+static void instanceName (const RegistryObject *const object, const size_t row,
+                          OID *const name)
+{
+	*name = object->oid;
+
+	if (!object->rows)
+	{
+		oidAppend(name, 0);
+	}
+	else if (object->instances)
+	{
+		object->instances->name(row, name);
+	}
+	else if (!object->inner)
+	{
+		oidAppend(name, (uint32_t) row + 1);
+	}
+	else
+	{
+		const size_t inner = object->inner();
+
+		oidAppend(name, (uint32_t) (row / inner) + 1);
+		oidAppend(name, (uint32_t) (row % inner) + 1);
+	}
+}
+
+bool registryNext (const OID *const name, const RegistryView *const view,
+                   const RegistryObject **const found, size_t *const row,
+                   OID *const next)
+{
+	size_t position = upperBound(name);
+
+	if (position > 0 && oidIsPrefix(&objects[position - 1].oid, name)
+	 && (!view || registryInView(view, &objects[position - 1])))
+	{
+		const RegistryObject *const object = &objects[position - 1];
+		size_t length;
+		const uint32_t *const instance = instanceOf(object, name, &length);
+
+		if (nextRow(object, instance, length, row))
+		{
+			*found = object;
+			instanceName(object, *row, next);
+			return true;
+		}
+	}
+
+	for (; position < objectCount; position++)
+	{
+		const RegistryObject *const object = &objects[position];
+
+		if ((!view || registryInView(view, object))
+		 && nextRow(object, NULL, 0, row))
+		{
+			*found = object;
+			instanceName(object, *row, next);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void registryViewSet (RegistryView *const view, const OID *const subtree,
+                      const bool included)
+{
+	size_t position = upperBound(subtree);
+
+	if (position > 0 && oidCompare(&objects[position - 1].oid, subtree) == 0)
+	{
+		position--;
+	}
+
+	for (; position < objectCount
+	     && oidIsPrefix(subtree, &objects[position].oid); position++)
+	{
+		const uint64_t bit = UINT64_C(1) << (position % 64);
+
+		if (included)
+		{
+			view->bits[position / 64] |= bit;
+		}
+		else
+		{
+			view->bits[position / 64] &= ~bit;
+		}
+	}
+}
+
+size_t registryColumns (const OID *const prefix,
+                        const RegistryObject *columns[const],
+                        const size_t capacity)
+{
+	size_t count = 0;
+
+	for (size_t position = upperBound(prefix); position < objectCount
+	     && oidIsPrefix(prefix, &objects[position].oid); position++)
+	{
+		if (count < capacity)
+		{
+			columns[count] = &objects[position];
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+void registryCopy (const ObjectTree *const from, const ObjectTree *const to)
+{
+	const ObjectTree *const selected = tree;
+
+	for (size_t index = 0; index < objectCount; index++)
+	{
+		const RegistryObject *const object = &objects[index];
+
+		if (!object->database)
+		{
+			continue;
+		}
+
+		tree = from;
+
+		const uint8_t *const source = object->base();
+		const size_t         rows   = object->rows ? object->rows() : 1;
+
+		tree = to;
+
+		uint8_t *const target = object->base();
+
+		for (size_t row = 0; row < rows; row++)
+		{
+			const size_t offset = row * object->stride + object->offset;
+
+			memcpy(target + offset, source + offset, object->width);
+		}
+	}
+
+	tree = selected;
+}
+
+void registryName (const RegistryObject *const object, const size_t row,
+                   OID *const name)
+{
+	instanceName(object, row, name);
+}
+
+static uint8_t *fieldOf (const RegistryObject *const object, const size_t row)
+{
+	return (uint8_t *) object->base() + row * object->stride + object->offset;
+}
+
+void registryGet (const RegistryObject *const object, const size_t row,
+                  VarBind *const varbind)
+{
+	const uint8_t *const field = fieldOf(object, row);
+
+	varbind->type = object->syntax;
+
+	if (object->reference)
+	{
+		const uint8_t number = *field;
+
+		varbind->value.oid = (OID) OID_INIT(0, 0);
+
+		if (number != 0)
+		{
+			varbind->value.oid = *object->reference;
+			oidAppend(&varbind->value.oid, number);
+		}
+
+		return;
+	}
+
+	if (object->kind == FIELD_OCTETS)
+	{
+		varbind->value.string.data =
+			octetStringData((const OctetString *) field,
+			                &varbind->value.string.length);
+		return;
+	}
+
+	if (object->kind == FIELD_BUFFER)
+	{
+		varbind->value.string.data =
+			octetBufferData(field, &varbind->value.string.length);
+		return;
+	}
+
+	if (object->kind == FIELD_STRING)
+	{
+		const char *string;
+
+		memcpy(&string, field, sizeof(string));
+
+		if (!string)
+		{
+			string = "";
+		}
+
+		if (object->syntax == BER_OID)
+		{
+			if (!oidParse(string, &varbind->value.oid))
+			{
+				varbind->value.oid = (OID) OID_INIT(0, 0);
+			}
+		}
+		else
+		{
+			varbind->value.string.data   = (const uint8_t *) string;
+			varbind->value.string.length = strlen(string);
+		}
+
+		return;
+	}
+
+	int64_t value;
+
+	switch (object->width)
+	{
+		case 1:
+		{
+			uint8_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			value = object->kind == FIELD_SIGNED ? (int8_t) raw : raw;
+			break;
+		}
+
+		case 2:
+		{
+			uint16_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			value = object->kind == FIELD_SIGNED ? (int16_t) raw : raw;
+			break;
+		}
+
+		case 4:
+		{
+			uint32_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			value = object->kind == FIELD_SIGNED ? (int64_t) (int32_t) raw
+			                                     : (int64_t) raw;
+			break;
+		}
+
+		default:
+		{
+			uint64_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			value = (int64_t) raw;
+			break;
+		}
+	}
+
+	if (object->syntax == BER_INTEGER)
+	{
+		varbind->value.integer = value;
+	}
+	else
+	{
+		varbind->value.counter = (uint64_t) value;
+	}
+}
+
+SNMPError registryCheck (const RegistryObject *const object,
+                         const VarBind *const varbind)
+{
+	if (!object->writable)
+	{
+		return SNMP_NOT_WRITABLE;
+	}
+
+	if (varbind->type != object->syntax)
+	{
+		return SNMP_WRONG_TYPE;
+	}
+
+	if (object->reference)
+	{
+		const OID *const name = &varbind->value.oid;
+
+		if (oidCompare(name, &(const OID) OID_INIT(0, 0)) == 0)
+		{
+			return SNMP_NO_ERROR;
+		}
+
+		if (name->length != object->reference->length + 1
+		 || !oidIsPrefix(object->reference, name)
+		 || name->arcs[name->length - 1] == 0
+		 || name->arcs[name->length - 1] > object->maximum)
+		{
+			return SNMP_WRONG_VALUE;
+		}
+
+		return SNMP_NO_ERROR;
+	}
+
+	/* The range of an OCTET STRING bounds its length, and a buffer holds
+	 * no more than its capacity.
+	 */
+	if (object->kind == FIELD_OCTETS || object->kind == FIELD_BUFFER)
+	{
+		const size_t length = varbind->value.string.length;
+
+		if ((int64_t) length < object->minimum
+		 || (int64_t) length > object->maximum
+		 || (object->kind == FIELD_BUFFER
+		  && length > object->width - OCTET_BUFFER_OFFSET))
+		{
+			return SNMP_WRONG_LENGTH;
+		}
+
+		return SNMP_NO_ERROR;
+	}
+
+	const int64_t value = object->syntax == BER_INTEGER
+	                    ? varbind->value.integer
+	                    : (int64_t) MIN(varbind->value.counter,
+	                                    (uint64_t) INT64_MAX);
+
+	if (value < object->minimum || value > object->maximum)
+	{
+		return SNMP_WRONG_VALUE;
+	}
+
+	return SNMP_NO_ERROR;
+}
+
+bool registryReserve (const RegistryObject *const object,
+                      const VarBind *const varbind)
+{
+	return object->kind != FIELD_OCTETS
+	    || octetStringReserve(varbind->value.string.data,
+	                          varbind->value.string.length);
+}
+
+bool registryStore (const RegistryObject *const object, const size_t row,
+                    const VarBind *const varbind)
+{
+	uint8_t *const field = fieldOf(object, row);
+
+	if (object->reference)
+	{
+		const OID *const name = &varbind->value.oid;
+
+		/* 0.0 is not an instance of the reference and clears the field. */
+		*field = oidIsPrefix(object->reference, name)
+		       ? (uint8_t) name->arcs[name->length - 1] : 0;
+		return true;
+	}
+
+	if (object->kind == FIELD_OCTETS)
+	{
+		return octetStringSet((OctetString *) field,
+		                      varbind->value.string.data,
+		                      varbind->value.string.length);
+	}
+
+	if (object->kind == FIELD_BUFFER)
+	{
+		return octetBufferSet(field, object->width - OCTET_BUFFER_OFFSET,
+		                      varbind->value.string.data,
+		                      varbind->value.string.length);
+	}
+
+	const uint64_t value = object->syntax == BER_INTEGER
+	                     ? (uint64_t) varbind->value.integer
+	                     : varbind->value.counter;
+
+	switch (object->width)
+	{
+		case 1:
+		{
+			const uint8_t raw = (uint8_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		case 2:
+		{
+			const uint16_t raw = (uint16_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		case 4:
+		{
+			const uint32_t raw = (uint32_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		default:
+			memcpy(field, &value, sizeof(value));
+			break;
+	}
+
+	return true;
+}
@@ -0,0 +1,223 @@
+#include <SNMP.h>
+
+static bool decodeValue (const uint8_t tag, const uint8_t *const data,
+                         const size_t length, VarBind *const varbind)
+{
+	varbind->type = tag;
+
+	switch (tag)
+	{
+		case BER_INTEGER:
+			return berDecodeInteger(data, length, &varbind->value.integer);
+
+		case BER_COUNTER32:
+		case BER_GAUGE32:
+		case BER_TIMETICKS:
+		case BER_COUNTER64:
+			return berDecodeUnsigned(data, length, &varbind->value.counter);
+
+		case BER_OCTET_STRING:
+		case BER_IP_ADDRESS:
+		case BER_OPAQUE:
+			varbind->value.string.data   = data;
+			varbind->value.string.length = length;
+			return true;
+
+		case BER_OID:
+			return berDecodeOID(data, length, &varbind->value.oid);
+
+		case BER_NULL:
+		case BER_NO_SUCH_OBJECT:
+		case BER_NO_SUCH_INSTANCE:
+		case BER_END_OF_MIB_VIEW:
+			return length == 0;
+
+		default:
+			return false;
+	}
+}
+
+bool snmpDecodeVarBinds (BERReader *const reader, SNMPPDU *const pdu)
+{
+	BERReader list;
+
+	if (!berEnter(reader, BER_SEQUENCE, &list))
+	{
+		return false;
+	}
+
+	pdu->count = 0;
+
+	while (!berReaderAtEnd(&list))
+	{
+		BERReader entry;
+		uint8_t   tag;
+		size_t    length;
+
+		if (pdu->count == SNMP_MAX_VARBINDS)
+		{
+			return false;
+		}
+
+		VarBind *const varbind = &pdu->varbinds[pdu->count++];
+
+		if (!berEnter(&list, BER_SEQUENCE, &entry)
+		 || !berReadOID(&entry, &varbind->name)
+		 || !berReadHeader(&entry, &tag, &length)
+		 || !decodeValue(tag, entry.data + entry.offset, length, varbind))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32_t snmpVersion (const uint8_t *const data, const size_t length)
+{
+	BERReader reader, contents;
+	int64_t   version;
+
+	berReaderInit(&reader, data, length);
+
+	if (!berEnter(&reader, BER_SEQUENCE, &contents)
+	 || !berReadInteger(&contents, BER_INTEGER, &version)
+	 || version < 0 || version > INT32_MAX)
+	{
+		return -1;
+	}
+
+	return (int32_t) version;
+}
+
+bool snmpDecodePDU (BERReader *const reader, SNMPPDU *const pdu)
+{
+	BERReader contents;
+	int64_t   requestID, errorStatus, errorIndex;
+	uint8_t   tag;
+	size_t    length;
+
+	if (!berReadHeader(reader, &tag, &length))
+	{
+		return false;
+	}
+
+	berReaderInit(&contents, reader->data + reader->offset, length);
+	reader->offset += length;
+
+	if (!berReadInteger(&contents, BER_INTEGER, &requestID)
+	 || !berReadInteger(&contents, BER_INTEGER, &errorStatus)
+	 || !berReadInteger(&contents, BER_INTEGER, &errorIndex)
+	 || !snmpDecodeVarBinds(&contents, pdu))
+	{
+		return false;
+	}
+
+	pdu->type        = tag;
+	pdu->requestID   = (int32_t) requestID;
+	pdu->errorStatus = (int32_t) errorStatus;
+	pdu->errorIndex  = (int32_t) errorIndex;
+
+	return true;
+}
+
+bool snmpDecode (const uint8_t *const data, const size_t length,
+                 SNMPMessage *const message)
+{
+	BERReader reader, contents;
+	int64_t   version;
+
+	berReaderInit(&reader, data, length);
+
+	if (!berEnter(&reader, BER_SEQUENCE, &contents)
+	 || !berReadInteger(&contents, BER_INTEGER, &version)
+	 || !berReadOctetString(&contents, &message->community,
+	                        &message->communityLength)
+	 || !snmpDecodePDU(&contents, &message->pdu))
+	{
+		return false;
+	}
+
+	message->version = (int32_t) version;
+
+	return true;
+}
+
+void snmpWriteVarBind (BERWriter *const writer, const VarBind *const varbind)
+{
+	const size_t mark = berWriterLength(writer);
+
+	switch (varbind->type)
+	{
+		case BER_INTEGER:
+			berWriteInteger(writer, BER_INTEGER, varbind->value.integer);
+			break;
+
+		case BER_COUNTER32:
+		case BER_GAUGE32:
+		case BER_TIMETICKS:
+		case BER_COUNTER64:
+			berWriteUnsigned(writer, varbind->type, varbind->value.counter);
+			break;
+
+		case BER_OCTET_STRING:
+		case BER_IP_ADDRESS:
+		case BER_OPAQUE:
+			berWriteBytes(writer, varbind->value.string.data,
+			              varbind->value.string.length);
+			berWriteHeader(writer, varbind->type,
+			               varbind->value.string.length);
+			break;
+
+		case BER_OID:
+			berWriteOID(writer, &varbind->value.oid);
+			break;
+
+		default:
+			berWriteNull(writer, varbind->type);
+			break;
+	}
+
+	berWriteOID(writer, &varbind->name);
+	berWriteConstructed(writer, BER_SEQUENCE, mark);
+}
+
+void snmpWritePDU (BERWriter *const writer, const SNMPPDU *const pdu)
+{
+	const size_t mark = berWriterLength(writer);
+
+	for (size_t index = pdu->count; index > 0; index--)
+	{
+		snmpWriteVarBind(writer, &pdu->varbinds[index - 1]);
+	}
+
+	berWriteConstructed(writer, BER_SEQUENCE, mark);
+	berWriteInteger(writer, BER_INTEGER, pdu->errorIndex);
+	berWriteInteger(writer, BER_INTEGER, pdu->errorStatus);
+	berWriteInteger(writer, BER_INTEGER, pdu->requestID);
+	berWriteConstructed(writer, pdu->type, mark);
+}
+
+size_t snmpEncode (const SNMPMessage *const message, uint8_t *const buffer,
+                   const size_t capacity)
+{
+	BERWriter writer;
+
+	berWriterInit(&writer, buffer, capacity);
+	snmpWritePDU(&writer, &message->pdu);
+	berWriteOctetString(&writer, message->community,
+	                    message->communityLength);
+	berWriteInteger(&writer, BER_INTEGER, message->version);
+	berWriteConstructed(&writer, BER_SEQUENCE, 0);
+
+	if (writer.overflow)
+	{
+		return 0;
+	}
+
+	const size_t length = berWriterLength(&writer);
+
+	memmove(buffer, berWriterData(&writer), length);
+
+	return length;
+}
@@ -0,0 +1,536 @@
+#include <Sign.h>
+#include <Clock.h>
+#include <Device.h>
+#include <MIB.h>
+#include <PMPP.h>
+
+#define NANOSECONDS_PER_MINUTE (60 * NANOSECONDS_PER_SECOND)
+#define NANOSECONDS_PER_TENTH  (NANOSECONDS_PER_SECOND / 10)
+
+/* dmsValidateMessageError */
+#define VALIDATE_ERROR_NONE   2
+#define VALIDATE_ERROR_SYNTAX 5
+
+/* dmsControlMode */
+#define CONTROL_MODE_LOCAL 2
+
+/* Octets of dmsActivateMessage and of dmsMsgTableSource. */
+#define ACTIVATION_OCTETS 12
+#define SOURCE_OCTETS     5
+
+static const OID activate     = DMS_OID(6, 3);
+static const OID messageEntry = DMS_OID(5, 8, 1);
+static const OID statusColumn = DMS_OID(5, 8, 1, 9);
+
+typedef struct Activation
+{
+	uint16_t duration;
+	uint8_t  priority;
+	uint8_t  memoryType;
+	uint16_t number;
+	uint16_t crc;
+} Activation;
+
+typedef struct CacheEntry
+{
+	uint32_t     generation; /* Zero while unused. */
+	uint32_t     used;
+	uint16_t     crc;
+	MultiText    multi;
+	MultiMessage message;
+} CacheEntry;
+
+/* A message handed to the tick. */
+typedef struct Display
+{
+	MultiMessage message;
+	bool         blank;
+	uint16_t     duration;
+	uint8_t      source[SOURCE_OCTETS];
+} Display;
+
+/* Owned by the agent thread. */
+static CacheEntry cache[SIGN_CACHE_ENTRIES];
+static uint32_t   generation = 1;
+static uint32_t   uses;
+static uint8_t    activePriority;
+static uint64_t   activeUntil;
+
+/* The tick takes the pending display in exchange for the one it shows. */
+static Display          displays[2];
+static Display         *pending = &displays[0];
+static Display         *showing = &displays[1];
+static bool             fresh;
+static pthread_mutex_t  lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Owned by the tick thread. */
+static uint64_t         shownAt;
+static const MultiPage *page;
+
+static const uint8_t blankSource[SOURCE_OCTETS] =
+{
+	MEMORY_TYPE_BLANK, 0, 1, 0, 0
+};
+
+static DmsMessageEntry *changeable (const uint16_t number)
+{
+	DmsMessage *const messages = &dms.dmsMessage;
+
+	return &messages->dmsMessageTable[(MEMORY_TYPE_CHANGEABLE - 1)
+	                                  * messages->dmsMaxChangeableMsg
+	                                  + number - 1];
+}
+
+static Activation decodeActivation (const uint8_t *const data)
+{
+	return (Activation)
+	{
+		.duration   = (uint16_t) (data[0] << 8 | data[1]),
+		.priority   = data[2],
+		.memoryType = data[3],
+		.number     = (uint16_t) (data[4] << 8 | data[5]),
+		.crc        = (uint16_t) (data[6] << 8 | data[7])
+	};
+}
+
+/* CRC-16 of the MULTI string, beacon and pixel service of a message. */
+static uint16_t messageCRC (const DmsMessageEntry *const entry)
+{
+	const uint8_t flags[2] =
+	{
+		entry->dmsMessageBeacon, entry->dmsMessagePixelService
+	};
+	const MultiText *const multi = &entry->dmsMessageMultiString;
+
+	uint16_t fcs = pmppFCS(PMPP_FCS_INIT, multi->octets, multi->length);
+
+	return (uint16_t) ~pmppFCS(fcs, flags, sizeof(flags));
+}
+
+/* Counts the changeable messages in use and the memory they take. */
+static void recount (void)
+{
+	DmsMessage *const messages = &dms.dmsMessage;
+	uint16_t          used     = 0;
+	uint32_t          octets   = 0;
+
+	for (uint16_t number = 1; number <= messages->dmsMaxChangeableMsg;
+	     number++)
+	{
+		const DmsMessageEntry *const entry = changeable(number);
+
+		if (entry->dmsMessageStatus != MESSAGE_STATUS_NOT_USED)
+		{
+			octets += entry->dmsMessageMultiString.length;
+			used++;
+		}
+	}
+
+	messages->dmsNumChangeableMsg     = used;
+	messages->dmsFreeChangeableMemory =
+		(uint32_t) messages->dmsMaxChangeableMsg * MULTI_MAX_LENGTH - octets;
+}
+
+bool signInit (void)
+{
+	SignControl *const control = &dms.signControl;
+
+	pending->blank = true;
+	showing->blank = true;
+
+	control->dmsActivateMsgError          = ACTIVATE_ERROR_NONE;
+	control->dmsMultiSyntaxError          = MULTI_SYNTAX_NONE;
+	dms.dmsMessage.dmsValidateMessageError = VALIDATE_ERROR_NONE;
+
+	recount();
+
+	return octetStringSet(&control->dmsMsgTableSource, blankSource,
+	                      sizeof(blankSource));
+}
+
+void signInvalidate (void)
+{
+	if (++generation == 0)
+	{
+		generation = 1;
+	}
+}
+
+const MultiMessage *signRender (const MultiText *const multi,
+                                const uint16_t crc,
+                                enum MultiSyntaxError *const error,
+                                size_t *const position)
+{
+	const uint8_t *const data   = multi->octets;
+	const size_t         length = multi->length;
+	CacheEntry          *victim = &cache[0];
+
+	uses++;
+
+	for (size_t index = 0; index < SIGN_CACHE_ENTRIES; index++)
+	{
+		CacheEntry *const entry = &cache[index];
+
+		if (entry->generation == generation && entry->crc == crc)
+		{
+			if (entry->multi.length == length
+			 && memcmp(entry->multi.octets, data, length) == 0)
+			{
+				entry->used = uses;
+				*error      = MULTI_SYNTAX_NONE;
+				return &entry->message;
+			}
+		}
+
+		/* Stale entries go first, then the least recently used. */
+		if (victim->generation == generation
+		 && (entry->generation != generation || entry->used < victim->used))
+		{
+			victim = entry;
+		}
+	}
+
+	*error = multiRender(&dms, data, length, &victim->message, position);
+
+	if (*error != MULTI_SYNTAX_NONE)
+	{
+		victim->generation = 0;
+		return NULL;
+	}
+
+	victim->generation = generation;
+	victim->used       = uses;
+	victim->crc        = crc;
+	victim->multi      = *multi;
+
+	return &victim->message;
+}
+
+static SNMPError checkActivation (const Activation *const activation)
+{
+	SignControl *const control = &dms.signControl;
+	const bool         expired = clockMonotonic() >= activeUntil;
+	uint8_t            error   = ACTIVATE_ERROR_NONE;
+
+	if (control->dmsControlMode == CONTROL_MODE_LOCAL)
+	{
+		error = ACTIVATE_ERROR_LOCAL_MODE;
+	}
+	else if (activation->memoryType != MEMORY_TYPE_CHANGEABLE
+	      && activation->memoryType != MEMORY_TYPE_BLANK)
+	{
+		error = ACTIVATE_ERROR_MESSAGE_MEMORY_TYPE;
+	}
+	else if (activation->memoryType == MEMORY_TYPE_CHANGEABLE
+	      && (activation->number == 0
+	       || activation->number > dms.dmsMessage.dmsMaxChangeableMsg))
+	{
+		error = ACTIVATE_ERROR_MESSAGE_NUMBER;
+	}
+	else if (!expired && activation->priority < activePriority)
+	{
+		error = ACTIVATE_ERROR_PRIORITY;
+	}
+	else if (activation->memoryType == MEMORY_TYPE_CHANGEABLE)
+	{
+		const DmsMessageEntry *const entry = changeable(activation->number);
+		enum MultiSyntaxError        syntax;
+		size_t                       position = 0;
+
+		if (entry->dmsMessageStatus != MESSAGE_STATUS_VALID)
+		{
+			error = ACTIVATE_ERROR_MESSAGE_STATUS;
+		}
+		else if (entry->dmsMessageCRC != activation->crc)
+		{
+			error = ACTIVATE_ERROR_MESSAGE_CRC;
+		}
+		else if (!signRender(&entry->dmsMessageMultiString, activation->crc,
+		                     &syntax, &position))
+		{
+			error                                = ACTIVATE_ERROR_SYNTAX_MULTI;
+			control->dmsMultiSyntaxError         = syntax;
+			control->dmsMultiSyntaxErrorPosition = (uint16_t) position;
+		}
+	}
+
+	control->dmsActivateMsgError = error;
+
+	return error == ACTIVATE_ERROR_NONE ? SNMP_NO_ERROR : SNMP_GEN_ERR;
+}
+
+SNMPError signCheck (const RegistryObject *const object, const size_t row,
+                     const VarBind *const varbind)
+{
+	if (oidCompare(&object->oid, &activate) == 0)
+	{
+		const Activation activation =
+			decodeActivation(varbind->value.string.data);
+
+		return checkActivation(&activation);
+	}
+
+	if (!oidIsPrefix(&messageEntry, &object->oid))
+	{
+		return SNMP_NO_ERROR;
+	}
+
+	const DmsMessageEntry *const entry = &dms.dmsMessage.dmsMessageTable[row];
+
+	if (entry->dmsMessageMemoryType != MEMORY_TYPE_CHANGEABLE)
+	{
+		return SNMP_NOT_WRITABLE;
+	}
+
+	if (oidCompare(&object->oid, &statusColumn) != 0)
+	{
+		/* A message is edited in the modifying state only. */
+		return entry->dmsMessageStatus == MESSAGE_STATUS_MODIFYING
+		     ? SNMP_NO_ERROR : SNMP_GEN_ERR;
+	}
+
+	switch (varbind->value.integer)
+	{
+		case MESSAGE_STATUS_MODIFY_REQ:
+		case MESSAGE_STATUS_NOT_USED_REQ:
+			return SNMP_NO_ERROR;
+
+		case MESSAGE_STATUS_VALIDATE_REQ:
+			return entry->dmsMessageStatus == MESSAGE_STATUS_MODIFYING
+			     ? SNMP_NO_ERROR : SNMP_GEN_ERR;
+
+		default:
+			return SNMP_WRONG_VALUE;
+	}
+}
+
+static void validate (DmsMessageEntry *const entry)
+{
+	DmsMessage  *const messages = &dms.dmsMessage;
+	SignControl *const control  = &dms.signControl;
+
+	enum MultiSyntaxError error;
+	size_t                position = 0;
+	const uint16_t        crc      = messageCRC(entry);
+
+	entry->dmsMessageCRC = crc;
+
+	if (signRender(&entry->dmsMessageMultiString, crc, &error, &position))
+	{
+		entry->dmsMessageStatus           = MESSAGE_STATUS_VALID;
+		messages->dmsValidateMessageError = VALIDATE_ERROR_NONE;
+	}
+	else
+	{
+		entry->dmsMessageStatus              = MESSAGE_STATUS_ERROR;
+		messages->dmsValidateMessageError    = VALIDATE_ERROR_SYNTAX;
+		control->dmsMultiSyntaxError         = error;
+		control->dmsMultiSyntaxErrorPosition = (uint16_t) position;
+	}
+}
+
+static void activateStored (void)
+{
+	size_t               length;
+	const uint8_t *const data =
+		octetStringData(&dms.signControl.dmsActivateMessage, &length);
+	const Activation     activation = decodeActivation(data);
+	const bool           blank      =
+		activation.memoryType == MEMORY_TYPE_BLANK;
+
+	const MultiMessage *message = NULL;
+
+	if (!blank)
+	{
+		const DmsMessageEntry *const entry = changeable(activation.number);
+		enum MultiSyntaxError        error;
+		size_t                       position;
+
+		/* Rendered by signCheck(), so this is a lookup. */
+		message = signRender(&entry->dmsMessageMultiString, activation.crc,
+		                     &error, &position);
+		activePriority = entry->dmsMessageRunTimePriority;
+	}
+	else
+	{
+		activePriority = 0;
+	}
+
+	activeUntil = activation.duration == SIGN_DURATION_INFINITE
+	            ? UINT64_MAX
+	            : clockMonotonic()
+	              + activation.duration * NANOSECONDS_PER_MINUTE;
+
+	pthread_mutex_lock(&lock);
+
+	pending->blank    = blank || !message;
+	pending->duration = activation.duration;
+	memcpy(pending->source, data + 3, sizeof(pending->source));
+
+	if (message)
+	{
+		memcpy(&pending->message, message, sizeof(*message));
+	}
+
+	fresh = true;
+
+	pthread_mutex_unlock(&lock);
+}
+
+void signStore (const RegistryObject *const object, const size_t row)
+{
+	if (oidCompare(&object->oid, &activate) == 0)
+	{
+		activateStored();
+		return;
+	}
+
+	if (oidCompare(&object->oid, &statusColumn) != 0)
+	{
+		return;
+	}
+
+	DmsMessageEntry *const entry = &dms.dmsMessage.dmsMessageTable[row];
+
+	switch (entry->dmsMessageStatus)
+	{
+		case MESSAGE_STATUS_MODIFY_REQ:
+			entry->dmsMessageStatus = MESSAGE_STATUS_MODIFYING;
+			break;
+
+		case MESSAGE_STATUS_VALIDATE_REQ:
+			validate(entry);
+			break;
+
+		default:
+			*entry = (DmsMessageEntry)
+			{
+				.dmsMessageMemoryType = entry->dmsMessageMemoryType,
+				.dmsMessageNumber     = entry->dmsMessageNumber,
+				.dmsMessageStatus     = MESSAGE_STATUS_NOT_USED
+			};
+			break;
+	}
+
+	recount();
+}
+
+void signTick (const uint64_t deadline, const uint64_t now)
+{
+	SignControl *const control = &dms.signControl;
+
+	(void) deadline;
+
+	pthread_mutex_lock(&lock);
+
+	if (fresh)
+	{
+		Display *const taken = pending;
+
+		pending = showing;
+		showing = taken;
+		fresh   = false;
+		shownAt = now;
+
+		octetStringSet(&control->dmsMsgTableSource, showing->source,
+		               sizeof(showing->source));
+	}
+
+	pthread_mutex_unlock(&lock);
+
+	const uint64_t elapsed = now - shownAt;
+	const uint64_t end     = showing->duration * NANOSECONDS_PER_MINUTE;
+
+	if (!showing->blank && showing->duration != SIGN_DURATION_INFINITE
+	 && elapsed >= end)
+	{
+		showing->blank = true;
+		octetStringSet(&control->dmsMsgTableSource, blankSource,
+		               sizeof(blankSource));
+	}
+
+	if (showing->blank)
+	{
+		control->dmsMessageTimeRemaining = 0;
+		page                             = NULL;
+		return;
+	}
+
+	control->dmsMessageTimeRemaining =
+		showing->duration == SIGN_DURATION_INFINITE
+		? SIGN_DURATION_INFINITE
+		: (uint16_t) ((end - elapsed + NANOSECONDS_PER_MINUTE - 1)
+		              / NANOSECONDS_PER_MINUTE);
+
+	/* A single page stays lit; pages of a longer message take turns, each
+	 * for its on time and then dark for its off time.
+	 */
+	const MultiMessage *const message = &showing->message;
+	uint64_t                  cycle   = 0;
+
+	for (size_t index = 0; index < message->pageCount; index++)
+	{
+		cycle += message->pages[index].onTime + message->pages[index].offTime;
+	}
+
+	if (message->pageCount == 1 || cycle == 0)
+	{
+		page = &message->pages[0];
+		return;
+	}
+
+	uint64_t tenth = elapsed / NANOSECONDS_PER_TENTH % cycle;
+
+	page = NULL;
+
+	for (size_t index = 0; index < message->pageCount; index++)
+	{
+		const MultiPage *const candidate = &message->pages[index];
+
+		if (tenth < candidate->onTime)
+		{
+			page = candidate;
+			return;
+		}
+
+		tenth -= candidate->onTime;
+
+		if (tenth < candidate->offTime)
+		{
+			return;
+		}
+
+		tenth -= candidate->offTime;
+	}
+}
+
+const MultiPage *signPage (void)
+{
+	return page;
+}
+
+static bool dmsInit (const DatabaseLimits *const limits)
+{
+	(void) limits;
+
+	return signInit();
+}
+
+static void dmsInvalidate (const bool database)
+{
+	if (database)
+	{
+		signInvalidate();
+	}
+}
+
+const Device dmsDevice =
+{
+	.name       = "dms",
+	.subtree    = DMS_OID(),
+	.init       = dmsInit,
+	.check      = signCheck,
+	.store      = signStore,
+	.invalidate = dmsInvalidate,
+	.ticks      = { signTick }
+};
@@ -0,0 +1,453 @@
+#include <Snapshot.h>
+#include <MIB.h>
+#include <Registry.h>
+
+/* Upper bound on the objects a snapshot covers. */
+#define SNAPSHOT_MAX_OBJECTS 1024
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME  16777619u
+
+static const uint8_t magic[4] = { 'N', 'T', 'S', 'S' };
+
+static const OID devices = DEVICES_NODE_OID;
+
+typedef struct Writer
+{
+	SnapshotSink sink;
+	void        *context;
+	uint8_t      buffer[SNAPSHOT_BUFFER];
+	size_t       used;
+	uint32_t     check;
+	bool         failed;
+} Writer;
+
+typedef struct Reader
+{
+	SnapshotSource source;
+	void          *context;
+	uint8_t        buffer[SNAPSHOT_BUFFER];
+	size_t         used;
+	size_t         length;
+	uint32_t       check;
+	bool           failed;
+} Reader;
+
+static uint32_t mix (uint32_t hash, const uint8_t *const data,
+                     const size_t length)
+{
+	for (size_t index = 0; index < length; index++)
+	{
+		hash = (hash ^ data[index]) * FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/* The objects of the device MIBs, in OID order. */
+static size_t objectsOf (const RegistryObject *objects[const])
+{
+	const size_t count = registryColumns(&devices, objects,
+	                                     SNAPSHOT_MAX_OBJECTS);
+
+	return MIN(count, (size_t) SNAPSHOT_MAX_OBJECTS);
+}
+
+uint32_t snapshotSchema (void)
+{
+	static const RegistryObject *objects[SNAPSHOT_MAX_OBJECTS];
+	const size_t                 count = objectsOf(objects);
+	uint32_t                     hash  = FNV_OFFSET;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		const RegistryObject *const object = objects[index];
+		const uint8_t layout[] =
+		{
+			object->syntax, (uint8_t) object->kind,
+			(uint8_t) (object->width >> 8), (uint8_t) object->width,
+			object->rows != NULL, object->inner != NULL,
+			object->reference != NULL
+		};
+
+		hash = mix(hash, (const uint8_t *) object->oid.arcs,
+		           object->oid.length * sizeof(object->oid.arcs[0]));
+		hash = mix(hash, layout, sizeof(layout));
+	}
+
+	return hash;
+}
+
+static void flush (Writer *const writer)
+{
+	if (writer->used != 0 && !writer->failed)
+	{
+		writer->failed = !writer->sink(writer->context, writer->buffer,
+		                               writer->used);
+	}
+
+	writer->used = 0;
+}
+
+static void put (Writer *const writer, const uint8_t *const data,
+                 const size_t length)
+{
+	writer->check = mix(writer->check, data, length);
+
+	for (size_t done = 0; done < length;)
+	{
+		const size_t part = MIN(length - done,
+		                        sizeof(writer->buffer) - writer->used);
+
+		memcpy(writer->buffer + writer->used, data + done, part);
+		writer->used += part;
+		done         += part;
+
+		if (writer->used == sizeof(writer->buffer))
+		{
+			flush(writer);
+		}
+	}
+}
+
+static void putVarint (Writer *const writer, uint64_t value)
+{
+	uint8_t octets[10];
+	size_t  length = 0;
+
+	do
+	{
+		const uint8_t more = value > 0x7F ? 0x80 : 0;
+
+		octets[length++] = (uint8_t) ((value & 0x7F) | more);
+		value >>= 7;
+	}
+	while (value != 0);
+
+	put(writer, octets, length);
+}
+
+static void putWord (Writer *const writer, const uint32_t value)
+{
+	const uint8_t octets[4] =
+	{
+		(uint8_t) value, (uint8_t) (value >> 8), (uint8_t) (value >> 16),
+		(uint8_t) (value >> 24)
+	};
+
+	put(writer, octets, sizeof(octets));
+}
+
+static bool take (Reader *const reader, uint8_t *const data,
+                  const size_t length, const bool checked)
+{
+	for (size_t done = 0; done < length;)
+	{
+		if (reader->used == reader->length)
+		{
+			reader->used   = 0;
+			reader->length = reader->source(reader->context, reader->buffer,
+			                                sizeof(reader->buffer));
+
+			if (reader->length == 0)
+			{
+				reader->failed = true;
+				return false;
+			}
+		}
+
+		const size_t part = MIN(length - done, reader->length - reader->used);
+
+		memcpy(data + done, reader->buffer + reader->used, part);
+		reader->used += part;
+		done         += part;
+	}
+
+	if (checked)
+	{
+		reader->check = mix(reader->check, data, length);
+	}
+
+	return true;
+}
+
+static uint64_t takeVarint (Reader *const reader)
+{
+	uint64_t value = 0;
+
+	for (uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		uint8_t octet;
+
+		if (!take(reader, &octet, 1, true))
+		{
+			return 0;
+		}
+
+		value |= (uint64_t) (octet & 0x7F) << shift;
+
+		if (!(octet & 0x80))
+		{
+			return value;
+		}
+	}
+
+	reader->failed = true;
+	return 0;
+}
+
+static uint32_t takeWord (Reader *const reader, const bool checked)
+{
+	uint8_t octets[4] = { 0 };
+
+	take(reader, octets, sizeof(octets), checked);
+
+	return (uint32_t) octets[0] | (uint32_t) octets[1] << 8
+	     | (uint32_t) octets[2] << 16 | (uint32_t) octets[3] << 24;
+}
+
+static uint64_t zigzag (const uint64_t delta)
+{
+	return (delta << 1) ^ (uint64_t) ((int64_t) delta >> 63);
+}
+
+static uint64_t unzigzag (const uint64_t value)
+{
+	return (value >> 1) ^ (uint64_t) -(int64_t) (value & 1);
+}
+
+static uint8_t *fieldOf (const RegistryObject *const object, const size_t row)
+{
+	return (uint8_t *) object->base() + row * object->stride + object->offset;
+}
+
+/* A numeric field, sign extended if signed. */
+static uint64_t load (const RegistryObject *const object,
+                      const uint8_t *const field)
+{
+	const bool signedField = object->kind == FIELD_SIGNED;
+
+	switch (object->width)
+	{
+		case 1:
+		{
+			uint8_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			return signedField ? (uint64_t) (int8_t) raw : raw;
+		}
+
+		case 2:
+		{
+			uint16_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			return signedField ? (uint64_t) (int16_t) raw : raw;
+		}
+
+		case 4:
+		{
+			uint32_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			return signedField ? (uint64_t) (int32_t) raw : raw;
+		}
+
+		default:
+		{
+			uint64_t raw;
+			memcpy(&raw, field, sizeof(raw));
+			return raw;
+		}
+	}
+}
+
+static void store (const RegistryObject *const object, uint8_t *const field,
+                   const uint64_t value)
+{
+	switch (object->width)
+	{
+		case 1:
+		{
+			const uint8_t raw = (uint8_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		case 2:
+		{
+			const uint16_t raw = (uint16_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		case 4:
+		{
+			const uint32_t raw = (uint32_t) value;
+			memcpy(field, &raw, sizeof(raw));
+			break;
+		}
+
+		default:
+			memcpy(field, &value, sizeof(value));
+			break;
+	}
+}
+
+static void writeObject (Writer *const writer,
+                         const RegistryObject *const object)
+{
+	const size_t rows     = object->rows ? object->rows() : 1;
+	uint64_t     previous = 0;
+
+	putVarint(writer, rows);
+
+	for (size_t row = 0; row < rows; row++)
+	{
+		const uint8_t *const field = fieldOf(object, row);
+
+		if (object->kind == FIELD_OCTETS || object->kind == FIELD_BUFFER)
+		{
+			size_t               length;
+			const uint8_t *const data = object->kind == FIELD_OCTETS
+				? octetStringData((const OctetString *) field, &length)
+				: octetBufferData(field, &length);
+
+			putVarint(writer, length);
+			put(writer, data, length);
+		}
+		else if (object->kind == FIELD_STRING)
+		{
+			const char *string;
+
+			memcpy(&string, field, sizeof(string));
+
+			const size_t length = string ? strlen(string) : 0;
+
+			putVarint(writer, length);
+			put(writer, (const uint8_t *) string, length);
+		}
+		else
+		{
+			const uint64_t value = load(object, field);
+
+			putVarint(writer, zigzag(value - previous));
+			previous = value;
+		}
+	}
+}
+
+bool snapshotWrite (const ObjectTree *const tree, const SnapshotSink sink,
+                    void *const context)
+{
+	static const RegistryObject *objects[SNAPSHOT_MAX_OBJECTS];
+	static Writer                writer;
+
+	const size_t count = objectsOf(objects);
+
+	writer = (Writer) { .sink = sink, .context = context, .check = FNV_OFFSET };
+
+	registrySelect(tree);
+
+	put(&writer, magic, sizeof(magic));
+	putVarint(&writer, SNAPSHOT_VERSION);
+	putWord(&writer, snapshotSchema());
+	putVarint(&writer, count);
+
+	for (size_t index = 0; index < count && !writer.failed; index++)
+	{
+		writeObject(&writer, objects[index]);
+	}
+
+	registrySelect(NULL);
+
+	const uint32_t check = writer.check;
+
+	putWord(&writer, check);
+	flush(&writer);
+
+	return !writer.failed;
+}
+
+static bool readObject (Reader *const reader,
+                        const RegistryObject *const object)
+{
+	const size_t rows     = object->rows ? object->rows() : 1;
+	uint64_t     previous = 0;
+
+	if (takeVarint(reader) != rows)
+	{
+		return false;
+	}
+
+	for (size_t row = 0; row < rows && !reader->failed; row++)
+	{
+		uint8_t *const field = fieldOf(object, row);
+
+		if (object->kind == FIELD_OCTETS || object->kind == FIELD_BUFFER
+		 || object->kind == FIELD_STRING)
+		{
+			static uint8_t data[UINT16_MAX];
+			const uint64_t length = takeVarint(reader);
+
+			if (length > sizeof(data) || !take(reader, data, length, true))
+			{
+				return false;
+			}
+
+			if (object->kind == FIELD_OCTETS
+			 && !octetStringSet((OctetString *) field, data, length))
+			{
+				return false;
+			}
+
+			if (object->kind == FIELD_BUFFER
+			 && !octetBufferSet(field, object->width - OCTET_BUFFER_OFFSET,
+			                    data, length))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			previous += unzigzag(takeVarint(reader));
+			store(object, field, previous);
+		}
+	}
+
+	return !reader->failed;
+}
+
+bool snapshotRead (const ObjectTree *const tree, const SnapshotSource source,
+                   void *const context)
+{
+	static const RegistryObject *objects[SNAPSHOT_MAX_OBJECTS];
+	static Reader                reader;
+
+	const size_t count = objectsOf(objects);
+	uint8_t      header[sizeof(magic)];
+
+	reader = (Reader) { .source = source, .context = context,
+	                    .check = FNV_OFFSET };
+
+	if (!take(&reader, header, sizeof(header), true)
+	 || memcmp(header, magic, sizeof(magic)) != 0
+	 || takeVarint(&reader) != SNAPSHOT_VERSION
+	 || takeWord(&reader, true) != snapshotSchema()
+	 || takeVarint(&reader) != count)
+	{
+		return false;
+	}
+
+	registrySelect(tree);
+
+	bool ok = true;
+
+	for (size_t index = 0; index < count && ok; index++)
+	{
+		ok = readObject(&reader, objects[index]);
+	}
+
+	registrySelect(NULL);
+
+	const uint32_t check = reader.check;
+
+	return ok && takeWord(&reader, false) == check && !reader.failed;
+}
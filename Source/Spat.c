@@ -0,0 +1,730 @@
+#include <Spat.h>
+#include <Change.h>
+#include <Clock.h>
+#include <Preempt.h>
+#include <Tick.h>
+
+#define SECONDS_PER_DAY   86400
+#define MINUTES_PER_DAY   1440
+#define TENTHS_PER_SECOND 10
+#define TENTHS_PER_HOUR   36000
+
+#define GROUPS CONFIG_GROUPS(CONFIG_MAX_PHASES)
+
+/* Bits of the IntersectionStatusObject, bit 0 the most significant. */
+#define STATUS_BIT(bit) ((uint16_t) (0x8000 >> (bit)))
+#define STATUS_PREEMPT_ACTIVE STATUS_BIT(3)
+
+/* A time not known. Larger than any other, so MAX() keeps it. */
+#define UNKNOWN UINT64_MAX
+
+#define NO_RING  UINT8_MAX
+#define NO_PHASE SIZE_MAX
+
+/* The phaseTable columns the rings are laid out from: phaseOptions,
+ * phaseRing and phaseConcurrency.
+ */
+#define LAYOUT (CHANGE_COLUMN(21) | CHANGE_COLUMN(22) | CHANGE_COLUMN(23))
+
+/* Times are tenths of a second on the monotonic clock, counted in ticks. */
+typedef struct Prediction
+{
+	enum MovementPhaseState state;
+	uint8_t                 ring;    /* Slot in rings, or NO_RING. */
+	bool                    dirty;
+	uint64_t                onset;   /* Of the state, UNKNOWN if not seen. */
+	uint64_t                gapFrom; /* Last restart of the gap timer. */
+	uint64_t                maxFrom; /* Start of the maximum timer. */
+	uint64_t                minEnd;
+	uint64_t                maxEnd;
+} Prediction;
+
+typedef struct Ring
+{
+	size_t   first;  /* Of its phases in order. */
+	size_t   count;
+	size_t   active; /* Timing or clearing, NO_PHASE until seen. */
+	uint64_t clearMin;
+	uint64_t clearMax;
+} Ring;
+
+/* Owned by the tick thread. */
+static struct
+{
+	OBJECT_TABLE(Prediction, phases, CONFIG_MAX_PHASES);
+	OBJECT_TABLE(Ring, rings, CONFIG_MAX_PHASES);
+
+	/* Phases by ring, then phase number, and where each phase is in it. */
+	OBJECT_TABLE(uint8_t, order, CONFIG_MAX_PHASES);
+	OBJECT_TABLE(uint8_t, position, CONFIG_MAX_PHASES);
+
+	/* One bitmap of the phases concurrent with it per phase. */
+	OBJECT_TABLE(uint8_t, concurrent, CONFIG_MAX_PHASES * GROUPS);
+
+	/* The phaseStatusGroupTable as of the last tick. */
+	OBJECT_TABLE(PhaseStatusGroupEntry, seen, GROUPS);
+
+	size_t   count;
+	size_t   groups;
+	size_t   ringCount;
+	uint64_t tenth; /* Of the last tick. */
+	bool     primed;
+} predictor;
+
+static atomic_bool      stale = true;
+static ChangeSubscriber changes; /* Owned by the tick thread. */
+
+/* Of a phase outside the predictor. */
+static const Prediction unknown = { .minEnd = UNKNOWN, .maxEnd = UNKNOWN };
+
+/* Owned by the thread that encodes, the tick. */
+static uint8_t revision;
+
+bool spatInit (const DatabaseLimits *const limits)
+{
+	const size_t count  = limits->maxPhases;
+	const size_t groups = CONFIG_GROUPS(count);
+
+	predictor.count     = count;
+	predictor.groups    = groups;
+	predictor.ringCount = 0;
+	predictor.primed    = false;
+	atomic_store(&stale, true);
+
+	return PROVIDE(predictor.phases, count)
+	    && PROVIDE(predictor.rings, count)
+	    && PROVIDE(predictor.order, count)
+	    && PROVIDE(predictor.position, count)
+	    && PROVIDE(predictor.concurrent, count * groups)
+	    && PROVIDE(predictor.seen, groups)
+	    && changeSubscribe(&changes);
+}
+
+void spatFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(predictor.phases);
+	free(predictor.rings);
+	free(predictor.order);
+	free(predictor.position);
+	free(predictor.concurrent);
+	free(predictor.seen);
+
+	predictor.phases     = NULL;
+	predictor.rings      = NULL;
+	predictor.order      = NULL;
+	predictor.position   = NULL;
+	predictor.concurrent = NULL;
+	predictor.seen       = NULL;
+#endif
+
+	changeUnsubscribe(&changes);
+
+	predictor.count = 0;
+}
+
+void spatInvalidate (void)
+{
+	atomic_store_explicit(&stale, true, memory_order_release);
+}
+
+static bool concurrentWith (const size_t phase, const size_t other)
+{
+	return (predictor.concurrent[phase * predictor.groups + other / 8]
+	        >> (other % 8)) & 1;
+}
+
+static enum MovementPhaseState movementState (const size_t phase)
+{
+	const PhaseStatusGroupEntry *const group =
+		&asc.phase.phaseStatusGroupTable[phase / 8];
+	const uint8_t bit = (uint8_t) (1u << (phase % 8));
+
+	if (group->phaseStatusGroupGreens & bit)
+	{
+		return MOVEMENT_PROTECTED_ALLOWED;
+	}
+
+	if (group->phaseStatusGroupYellows & bit)
+	{
+		return MOVEMENT_PROTECTED_CLEARANCE;
+	}
+
+	if (group->phaseStatusGroupReds & bit)
+	{
+		return MOVEMENT_STOP_AND_REMAIN;
+	}
+
+	return MOVEMENT_DARK;
+}
+
+static bool timing (const enum MovementPhaseState state)
+{
+	return state == MOVEMENT_PROTECTED_ALLOWED
+	    || state == MOVEMENT_PROTECTED_CLEARANCE;
+}
+
+static int compareRings (const void *const left, const void *const right)
+{
+	const PhaseEntry *const phases = asc.phase.phaseTable;
+	const uint8_t a = *(const uint8_t *) left;
+	const uint8_t b = *(const uint8_t *) right;
+
+	if (phases[a].phaseRing != phases[b].phaseRing)
+	{
+		return phases[a].phaseRing - phases[b].phaseRing;
+	}
+
+	return a - b;
+}
+
+/* Lays out the rings and the concurrency of the phase table. */
+static void rebuild (void)
+{
+	const PhaseEntry *const phases = asc.phase.phaseTable;
+	const size_t count = predictor.count;
+	size_t ordered = 0;
+
+	memset(predictor.concurrent, 0,
+	       count * predictor.groups * sizeof(predictor.concurrent[0]));
+
+	for (size_t phase = 0; phase < count; phase++)
+	{
+		const OctetText *const numbers = &phases[phase].phaseConcurrency;
+
+		for (size_t index = 0; index < numbers->length; index++)
+		{
+			const size_t other = (size_t) numbers->octets[index] - 1;
+
+			if (other < count)
+			{
+				predictor.concurrent[phase * predictor.groups + other / 8] |=
+					(uint8_t) (1u << (other % 8));
+			}
+		}
+
+		predictor.phases[phase].ring  = NO_RING;
+		predictor.phases[phase].dirty = true;
+
+		if ((phases[phase].phaseOptions & 1) && phases[phase].phaseRing != 0)
+		{
+			predictor.order[ordered++] = (uint8_t) phase;
+		}
+	}
+
+	qsort(predictor.order, ordered, sizeof(predictor.order[0]),
+	      compareRings);
+
+	predictor.ringCount = 0;
+
+	for (size_t index = 0; index < ordered; index++)
+	{
+		const size_t phase = predictor.order[index];
+
+		if (index == 0 || phases[phase].phaseRing
+		               != phases[predictor.order[index - 1]].phaseRing)
+		{
+			predictor.rings[predictor.ringCount++] = (Ring)
+			{
+				.first    = index,
+				.active   = NO_PHASE,
+				.clearMin = UNKNOWN,
+				.clearMax = UNKNOWN
+			};
+		}
+
+		Ring *const ring = &predictor.rings[predictor.ringCount - 1];
+
+		ring->count++;
+		predictor.position[phase]    = (uint8_t) (index - ring->first);
+		predictor.phases[phase].ring = (uint8_t) (predictor.ringCount - 1);
+
+		if (timing(predictor.phases[phase].state))
+		{
+			ring->active = phase;
+		}
+	}
+}
+
+/* Follows the changes of the phase states, and of the calls and detectors
+ * the green timers depend on, since the last tick.
+ */
+static void observe (void)
+{
+	const PhaseStatusGroupEntry *const groups =
+		asc.phase.phaseStatusGroupTable;
+	const uint64_t tenth = predictor.tenth;
+
+	for (size_t group = 0; group < predictor.groups; group++)
+	{
+		const PhaseStatusGroupEntry *const now  = &groups[group];
+		PhaseStatusGroupEntry *const       seen = &predictor.seen[group];
+		uint32_t changed = (now->phaseStatusGroupGreens
+		                    ^ seen->phaseStatusGroupGreens)
+		                 | (now->phaseStatusGroupYellows
+		                    ^ seen->phaseStatusGroupYellows)
+		                 | (now->phaseStatusGroupReds
+		                    ^ seen->phaseStatusGroupReds);
+
+		if (!predictor.primed)
+		{
+			changed = UINT8_MAX;
+		}
+
+		*seen = *now;
+
+		for (; changed != 0; changed &= changed - 1)
+		{
+			const size_t phase = group * 8 + __builtin_ctz(changed);
+
+			if (phase >= predictor.count)
+			{
+				break;
+			}
+
+			Prediction *const prediction = &predictor.phases[phase];
+			const enum MovementPhaseState state = movementState(phase);
+
+			if (state == prediction->state && predictor.primed)
+			{
+				continue;
+			}
+
+			prediction->state   = state;
+			prediction->onset   = predictor.primed ? tenth : UNKNOWN;
+			prediction->gapFrom = tenth;
+			prediction->maxFrom = UNKNOWN;
+			prediction->dirty   = true;
+
+			if (timing(state) && prediction->ring != NO_RING)
+			{
+				predictor.rings[prediction->ring].active = phase;
+			}
+		}
+	}
+
+	predictor.primed = true;
+
+	/* Presence on a detector calling a green restarts its gap. */
+	const VehicleDetectorEntry *const detectors =
+		asc.detector.vehicleDetectorTable;
+	const VehicleDetectorStatusGroupEntry *const active =
+		asc.detector.vehicleDetectorStatusGroupTable;
+
+	for (size_t group = 0;
+	     group < asc.detector.maxVehicleDetectorStatusGroups; group++)
+	{
+		for (uint32_t bits = active[group].vehicleDetectorStatusGroupActive;
+		     bits != 0; bits &= bits - 1)
+		{
+			const size_t detector = group * 8 + __builtin_ctz(bits);
+
+			if (detector >= asc.detector.maxVehicleDetectors)
+			{
+				break;
+			}
+
+			const size_t phase =
+				(size_t) detectors[detector].vehicleDetectorCallPhase - 1;
+
+			if (phase < predictor.count
+			 && predictor.phases[phase].state == MOVEMENT_PROTECTED_ALLOWED)
+			{
+				predictor.phases[phase].gapFrom = tenth;
+				predictor.phases[phase].dirty   = true;
+			}
+		}
+	}
+
+	/* The maximum timer of a green starts with a conflicting call. */
+	for (size_t slot = 0; slot < predictor.ringCount; slot++)
+	{
+		const size_t phase = predictor.rings[slot].active;
+
+		if (phase == NO_PHASE)
+		{
+			continue;
+		}
+
+		Prediction *const prediction = &predictor.phases[phase];
+
+		if (prediction->state != MOVEMENT_PROTECTED_ALLOWED)
+		{
+			continue;
+		}
+
+		if (prediction->minEnd <= tenth)
+		{
+			prediction->dirty = true;
+		}
+
+		if (prediction->maxFrom != UNKNOWN)
+		{
+			continue;
+		}
+
+		for (size_t group = 0; group < predictor.groups; group++)
+		{
+			uint8_t calls = groups[group].phaseStatusGroupVehCalls
+			              | groups[group].phaseStatusGroupPedCalls;
+
+			calls &= (uint8_t)
+				~predictor.concurrent[phase * predictor.groups + group];
+
+			if (group == phase / 8)
+			{
+				calls &= (uint8_t) ~(1u << (phase % 8));
+			}
+
+			if (calls != 0)
+			{
+				prediction->maxFrom = tenth;
+				prediction->dirty   = true;
+				break;
+			}
+		}
+	}
+}
+
+static uint64_t after (const uint64_t time, const uint64_t tenths)
+{
+	return time == UNKNOWN ? UNKNOWN : time + tenths;
+}
+
+/* The gap of a green elapsed tenths into it, the passage reduced by gap
+ * reduction toward the minimum gap once the time before reduction is over.
+ */
+static uint64_t gap (const PhaseEntry *const entry, const uint64_t elapsed)
+{
+	const uint64_t before = (uint64_t) entry->phaseTimeBeforeReduction
+	                      * TENTHS_PER_SECOND;
+	const uint64_t reduce = (uint64_t) entry->phaseTimeToReduce
+	                      * TENTHS_PER_SECOND;
+	const uint64_t passage = entry->phasePassage;
+	const uint64_t minimum = MIN(entry->phaseMinimumGap, passage);
+
+	if (elapsed <= before)
+	{
+		return passage;
+	}
+
+	if (elapsed - before >= reduce)
+	{
+		return minimum;
+	}
+
+	return passage - (passage - minimum) * (elapsed - before) / reduce;
+}
+
+static void predictTiming (const size_t phase)
+{
+	const PhaseEntry *const entry = &asc.phase.phaseTable[phase];
+	Prediction *const prediction  = &predictor.phases[phase];
+	const uint64_t onset = prediction->onset;
+
+	if (onset == UNKNOWN)
+	{
+		prediction->minEnd = UNKNOWN;
+		prediction->maxEnd = UNKNOWN;
+	}
+	else if (prediction->state == MOVEMENT_PROTECTED_CLEARANCE)
+	{
+		prediction->minEnd = onset + entry->phaseYellowChange;
+		prediction->maxEnd = prediction->minEnd;
+	}
+	else
+	{
+		const uint64_t minimum = onset + (uint64_t) entry->phaseMinimumGreen
+		                                 * TENTHS_PER_SECOND;
+		const uint64_t gapOut  = prediction->gapFrom
+		                       + gap(entry, predictor.tenth - onset);
+
+		prediction->minEnd = MAX(MAX(minimum, gapOut), predictor.tenth);
+		prediction->maxEnd = MAX(after(prediction->maxFrom,
+		                               (uint64_t) entry->phaseMaximum1
+		                               * TENTHS_PER_SECOND),
+		                         prediction->minEnd);
+	}
+
+	prediction->dirty = false;
+}
+
+/* Works out when the phase active in each ring will have cleared. Returns
+ * true if that moved for any ring.
+ */
+static bool clearances (void)
+{
+	const PhaseEntry *const phases = asc.phase.phaseTable;
+	bool moved = false;
+
+	for (size_t slot = 0; slot < predictor.ringCount; slot++)
+	{
+		Ring *const ring = &predictor.rings[slot];
+		uint64_t minimum = UNKNOWN;
+		uint64_t maximum = UNKNOWN;
+
+		if (ring->active != NO_PHASE)
+		{
+			const Prediction *const active = &predictor.phases[ring->active];
+			const PhaseEntry *const entry  = &phases[ring->active];
+			const uint64_t red = entry->phaseRedClear;
+
+			switch (active->state)
+			{
+				case MOVEMENT_PROTECTED_ALLOWED:
+					minimum = after(active->minEnd,
+					                entry->phaseYellowChange + red);
+					maximum = after(active->maxEnd,
+					                entry->phaseYellowChange + red);
+					break;
+
+				case MOVEMENT_PROTECTED_CLEARANCE:
+					minimum = after(active->minEnd, red);
+					maximum = minimum;
+					break;
+
+				case MOVEMENT_STOP_AND_REMAIN:
+					minimum = after(active->onset, red);
+					maximum = minimum;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		moved |= minimum != ring->clearMin || maximum != ring->clearMax;
+		ring->clearMin = minimum;
+		ring->clearMax = maximum;
+	}
+
+	return moved;
+}
+
+/* Longest a phase can take to be served and cleared. */
+static uint64_t service (const size_t phase)
+{
+	const PhaseEntry *const entry = &asc.phase.phaseTable[phase];
+
+	return (uint64_t) MAX(entry->phaseMinimumGreen, entry->phaseMaximum1)
+	     * TENTHS_PER_SECOND + entry->phaseYellowChange + entry->phaseRedClear;
+}
+
+/* Longest the phases of a ring after its active phase take before the
+ * first one concurrent with phase, or before phase itself in its own ring.
+ */
+static uint64_t ahead (const Ring *const ring, const size_t phase,
+                       const bool own)
+{
+	uint64_t total = 0;
+
+	for (size_t step = 1; step < ring->count; step++)
+	{
+		const size_t next = predictor.order[ring->first
+		                  + (predictor.position[ring->active] + step)
+		                  % ring->count];
+
+		if (own ? next == phase : concurrentWith(phase, next))
+		{
+			break;
+		}
+
+		total += service(next);
+	}
+
+	return total;
+}
+
+static void predictRed (const size_t phase)
+{
+	Prediction *const prediction = &predictor.phases[phase];
+
+	prediction->dirty  = false;
+	prediction->minEnd = UNKNOWN;
+	prediction->maxEnd = UNKNOWN;
+
+	if (prediction->state != MOVEMENT_STOP_AND_REMAIN
+	 || prediction->ring == NO_RING)
+	{
+		return;
+	}
+
+	const Ring *const own = &predictor.rings[prediction->ring];
+
+	if (own->active == NO_PHASE)
+	{
+		return;
+	}
+
+	uint64_t minimum = own->clearMin;
+	uint64_t maximum = after(own->clearMax, ahead(own, phase, true));
+
+	for (size_t slot = 0; slot < predictor.ringCount; slot++)
+	{
+		const Ring *const ring = &predictor.rings[slot];
+
+		if (slot == prediction->ring || ring->active == NO_PHASE
+		 || concurrentWith(phase, ring->active)
+		 || (!timing(predictor.phases[ring->active].state)
+		     && ring->clearMin <= predictor.tenth))
+		{
+			continue;
+		}
+
+		/* Across the barrier. */
+		minimum = MAX(minimum, ring->clearMin);
+		maximum = MAX(maximum, after(ring->clearMax,
+		                             ahead(ring, phase, false)));
+	}
+
+	prediction->minEnd = minimum;
+	prediction->maxEnd = maximum;
+}
+
+void spatTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) now;
+
+	predictor.tenth = deadline / TICK_PERIOD;
+
+	bool      invalid = atomic_exchange_explicit(&stale, false,
+	                                           memory_order_acquire);
+	ChangeRow change;
+
+	invalid |= !changeDrain(&changes);
+
+	/* A SET of the phaseTable predicts the phases it changed again, and
+	 * rebuilds the rings only if it moved them.
+	 */
+	while (changeNext(&changes, &change))
+	{
+		if (change.table == CHANGE_PHASE && change.row < predictor.count)
+		{
+			invalid |= (change.columns & LAYOUT) != 0;
+			predictor.phases[change.row].dirty = true;
+		}
+	}
+
+	if (invalid)
+	{
+		rebuild();
+	}
+
+	observe();
+
+	for (size_t phase = 0; phase < predictor.count; phase++)
+	{
+		if (predictor.phases[phase].dirty
+		 && timing(predictor.phases[phase].state))
+		{
+			predictTiming(phase);
+		}
+	}
+
+	const bool moved = clearances();
+
+	for (size_t phase = 0; phase < predictor.count; phase++)
+	{
+		if ((moved || predictor.phases[phase].dirty)
+		 && !timing(predictor.phases[phase].state))
+		{
+			predictRed(phase);
+		}
+	}
+}
+
+static uint8_t *put16 (uint8_t *const out, const uint16_t value)
+{
+	out[0] = (uint8_t) (value >> 8);
+	out[1] = (uint8_t) value;
+
+	return out + 2;
+}
+
+static uint8_t *put32 (uint8_t *const out, const uint32_t value)
+{
+	out[0] = (uint8_t) (value >> 24);
+	out[1] = (uint8_t) (value >> 16);
+	out[2] = (uint8_t) (value >> 8);
+	out[3] = (uint8_t) value;
+
+	return out + 4;
+}
+
+/* A predicted time as a TimeMark, given the tenths of the UTC hour as of
+ * the last tick. An earliest end already passed is now.
+ */
+static uint16_t timeMark (const uint64_t time, const uint64_t hour)
+{
+	if (time == UNKNOWN)
+	{
+		return SPAT_TIME_UNKNOWN;
+	}
+
+	const uint64_t ahead = time > predictor.tenth ? time - predictor.tenth : 0;
+
+	return (uint16_t) ((hour + ahead) % TENTHS_PER_HOUR);
+}
+
+size_t spatEncode (uint8_t buffer[const], const size_t capacity,
+                   const CalendarTime *const date)
+{
+	const Phase *const phases = &asc.phase;
+	size_t movements = 0;
+
+	for (size_t phase = 0; phase < phases->maxPhases; phase++)
+	{
+		movements += phases->phaseTable[phase].phaseOptions & 1;
+	}
+
+	const size_t length = SPAT_HEADER_OCTETS
+	                    + movements * SPAT_MOVEMENT_OCTETS;
+
+	if (length > capacity)
+	{
+		return 0;
+	}
+
+	/* The clock is set to a date after the epoch, so the divisions of utc
+	 * round down.
+	 */
+	const int64_t  days   = date->utc / SECONDS_PER_DAY;
+	const uint32_t second = (uint32_t) (date->utc % SECONDS_PER_DAY);
+	const uint32_t minute = (calendarDayOfYear(days) - 1u) * MINUTES_PER_DAY
+	                      + second / 60;
+	const uint16_t milliseconds = (uint16_t) (second % 60 * 1000
+		+ date->nanoseconds / NANOSECONDS_PER_MILLISECOND);
+
+	const uint64_t hour = (uint64_t) (date->utc % 3600) * TENTHS_PER_SECOND
+	                    + date->nanoseconds
+	                      / (NANOSECONDS_PER_SECOND / TENTHS_PER_SECOND);
+
+	uint8_t *out = buffer;
+
+	out    = put16(out, CONFIG_INTERSECTION_ID);
+	*out++ = revision;
+	out    = put16(out, preemptActive() ? STATUS_PREEMPT_ACTIVE : 0);
+	out    = put32(out, minute);
+	out    = put16(out, milliseconds);
+	*out++ = (uint8_t) movements;
+
+	revision = (revision + 1) % 128;
+
+	for (size_t phase = 0; phase < phases->maxPhases; phase++)
+	{
+		if (!(phases->phaseTable[phase].phaseOptions & 1))
+		{
+			continue;
+		}
+
+		const Prediction *const prediction =
+			phase < predictor.count ? &predictor.phases[phase] : &unknown;
+
+		*out++ = phases->phaseTable[phase].phaseNumber;
+		*out++ = (uint8_t) movementState(phase);
+		out    = put16(out, timeMark(prediction->minEnd, hour));
+		out    = put16(out, timeMark(prediction->maxEnd, hour));
+	}
+
+	return length;
+}
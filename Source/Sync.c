@@ -0,0 +1,982 @@
+#include <Sync.h>
+#include <Change.h>
+#include <MIB.h>
+
+/* Entries of the covered tables, in SyncTable order. */
+static const OID entries[SYNC_TABLE_COUNT] =
+{
+	ASC_OID(1, 2, 1),
+	ASC_OID(2, 2, 1),
+	GLOBAL_OID(3, 3, 2, 1),
+	GLOBAL_OID(3, 3, 5, 1),
+	GLOBAL_OID(3, 7, 2, 1)
+};
+
+static const OID tableEntry = PRIVATE_OID(1, 3, 1, 1);
+static const OID rowHashes  = PRIVATE_OID(1, 3, 2);
+
+static const OID createTransaction = GLOBAL_OID(2, 1, 0);
+static const OID verifyStatus      = GLOBAL_OID(2, 6, 0);
+
+/* The SyncTable of each tracked table, SYNC_TABLE_COUNT if it has none. */
+static const SyncTable tables[CHANGE_TABLE_COUNT] =
+{
+	[CHANGE_PHASE]               = SYNC_PHASE,
+	[CHANGE_VEHICLE_DETECTOR]    = SYNC_VEHICLE_DETECTOR,
+	[CHANGE_PEDESTRIAN_DETECTOR] = SYNC_TABLE_COUNT,
+	[CHANGE_TIME_BASE_SCHEDULE]  = SYNC_TIME_BASE_SCHEDULE,
+	[CHANGE_DAY_PLAN]            = SYNC_DAY_PLAN,
+	[CHANGE_DST]                 = SYNC_DST,
+	[CHANGE_TIMEBASE_ACTION]     = SYNC_TABLE_COUNT,
+	[CHANGE_MODULE]              = SYNC_TABLE_COUNT
+};
+
+static SyncManifest     manifest;
+static ChangeSubscriber changes;
+
+/* 32-bit FNV-1a. Values are fed least significant octet first, so that both
+ * ends agree whatever their byte order.
+ */
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME  16777619u
+
+static uint32_t mix (uint32_t hash, const uint64_t value)
+{
+	for (size_t octet = 0; octet < sizeof(value); octet++)
+	{
+		hash ^= (uint8_t) (value >> (octet * 8));
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+bool syncManifestInit (SyncManifest *const manifest,
+                       const DatabaseLimits *const limits)
+{
+	const size_t rows[SYNC_TABLE_COUNT] =
+	{
+		[SYNC_PHASE]              = limits->maxPhases,
+		[SYNC_VEHICLE_DETECTOR]   = limits->maxVehicleDetectors,
+		[SYNC_TIME_BASE_SCHEDULE] = limits->maxTimeBaseScheduleEntries,
+		[SYNC_DAY_PLAN]           = (size_t) limits->maxDayPlans
+		                          * limits->maxDayPlanEvents,
+		[SYNC_DST]                = limits->maxDaylightSavingEntries
+	};
+
+	memset(manifest->syncTable, 0, sizeof(manifest->syncTable));
+	memcpy(manifest->capacity, rows, sizeof(rows));
+
+	manifest->dayPlanEvents = limits->maxDayPlanEvents;
+
+	return PROVIDE(manifest->syncPhaseHashes, rows[SYNC_PHASE])
+	    && PROVIDE(manifest->syncVehicleDetectorHashes,
+	               rows[SYNC_VEHICLE_DETECTOR])
+	    && PROVIDE(manifest->syncTimeBaseScheduleHashes,
+	               rows[SYNC_TIME_BASE_SCHEDULE])
+	    && PROVIDE(manifest->syncDayPlanHashes, rows[SYNC_DAY_PLAN])
+	    && PROVIDE(manifest->syncDSTHashes, rows[SYNC_DST]);
+}
+
+void syncManifestFree (SyncManifest *const manifest)
+{
+#ifdef STATIC_STORAGE
+	(void) manifest;
+#else
+	free(manifest->syncPhaseHashes);
+	free(manifest->syncVehicleDetectorHashes);
+	free(manifest->syncTimeBaseScheduleHashes);
+	free(manifest->syncDayPlanHashes);
+	free(manifest->syncDSTHashes);
+#endif
+}
+
+static SyncRowHash *hashesOf (const SyncManifest *const manifest,
+                              const SyncTable table)
+{
+	switch (table)
+	{
+		case SYNC_PHASE:
+			return (SyncRowHash *) manifest->syncPhaseHashes;
+
+		case SYNC_VEHICLE_DETECTOR:
+			return (SyncRowHash *) manifest->syncVehicleDetectorHashes;
+
+		case SYNC_TIME_BASE_SCHEDULE:
+			return (SyncRowHash *) manifest->syncTimeBaseScheduleHashes;
+
+		case SYNC_DAY_PLAN:
+			return (SyncRowHash *) manifest->syncDayPlanHashes;
+
+		default:
+			return (SyncRowHash *) manifest->syncDSTHashes;
+	}
+}
+
+/* The numeric database objects of a table, which are what a row hash
+ * covers and what the diff writes.
+ */
+static size_t columnsOf (const SyncTable table,
+                         const RegistryObject *columns[const])
+{
+	const RegistryObject *all[SYNC_MAX_COLUMNS];
+	const size_t total = MIN(registryColumns(&entries[table], all,
+	                                         SYNC_MAX_COLUMNS),
+	                         (size_t) SYNC_MAX_COLUMNS);
+	size_t count = 0;
+
+	for (size_t index = 0; index < total; index++)
+	{
+		if (all[index]->database && (all[index]->kind == FIELD_UNSIGNED
+		                          || all[index]->kind == FIELD_SIGNED))
+		{
+			columns[count++] = all[index];
+		}
+	}
+
+	return count;
+}
+
+/* Value of an instance in the selected tree, as an unsigned bit pattern. */
+static uint64_t valueOf (const RegistryObject *const object, const size_t row)
+{
+	VarBind varbind;
+
+	registryGet(object, row, &varbind);
+
+	/* A row reference hashes as the number of the row, its last arc. */
+	if (object->syntax == BER_OID)
+	{
+		return varbind.value.oid.arcs[varbind.value.oid.length - 1];
+	}
+
+	return object->syntax == BER_INTEGER ? (uint64_t) varbind.value.integer
+	                                     : varbind.value.counter;
+}
+
+static uint32_t hashRow (const RegistryObject *const columns[const],
+                         const size_t count, const size_t row)
+{
+	uint32_t hash = FNV_OFFSET;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		const OID *const name = &columns[index]->oid;
+
+		hash = mix(hash, name->arcs[name->length - 1]);
+		hash = mix(hash, valueOf(columns[index], row));
+	}
+
+	return hash;
+}
+
+uint32_t syncRowHash (const ObjectTree *const tree, const SyncTable table,
+                      const size_t row)
+{
+	const RegistryObject *columns[SYNC_MAX_COLUMNS];
+	const size_t          count = columnsOf(table, columns);
+
+	registrySelect(tree);
+
+	const uint32_t hash = hashRow(columns, count, row);
+
+	registrySelect(NULL);
+
+	return hash;
+}
+
+/* Folds the row hashes of a table into its entry. */
+static void hashTable (SyncManifest *const manifest, const SyncTable table,
+                       const size_t rows)
+{
+	const SyncRowHash *const hashes = hashesOf(manifest, table);
+	uint32_t                 hash   = mix(FNV_OFFSET, rows);
+
+	for (size_t row = 0; row < rows; row++)
+	{
+		hash = mix(hash, hashes[row].syncRowHash);
+	}
+
+	manifest->syncTable[table] = (SyncTableEntry)
+	{
+		.syncTableIndex = table + 1,
+		.syncTableRows  = (uint32_t) rows,
+		.syncTableHash  = hash
+	};
+}
+
+/* Rows of a table in the selected tree that a manifest has room for. */
+static size_t rowsOf (const SyncManifest *const manifest,
+                      const SyncTable table,
+                      const RegistryObject *const columns[const],
+                      const size_t count)
+{
+	return count == 0 ? 0 : MIN(columns[0]->rows(), manifest->capacity[table]);
+}
+
+void syncManifestBuild (SyncManifest *const manifest,
+                        const ObjectTree *const tree)
+{
+	registrySelect(tree);
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		const RegistryObject *columns[SYNC_MAX_COLUMNS];
+		const size_t          count  = columnsOf(table, columns);
+		SyncRowHash    *const hashes = hashesOf(manifest, table);
+		const size_t          rows   = rowsOf(manifest, table, columns,
+		                                      count);
+
+		for (size_t row = 0; row < rows; row++)
+		{
+			hashes[row].syncRowHash = hashRow(columns, count, row);
+		}
+
+		hashTable(manifest, table, rows);
+	}
+
+	manifest->dayPlanEvents =
+		tree->global->globalTimeManagement.timebase.maxDayPlanEvents;
+
+	registrySelect(NULL);
+}
+
+/* globalSetIDParameter folds the table hashes into 16 bits. */
+static void identify (void)
+{
+	uint32_t hash = FNV_OFFSET;
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		hash = mix(hash, manifest.syncTable[table].syncTableHash);
+	}
+
+	database.global->globalConfiguration.globalSetIDParameter =
+		(uint16_t) (hash ^ hash >> 16);
+}
+
+bool syncInit (const DatabaseLimits *const limits)
+{
+	if (!syncManifestInit(&manifest, limits) || !changeSubscribe(&changes))
+	{
+		return false;
+	}
+
+	syncManifestBuild(&manifest, &database);
+	identify();
+
+	return true;
+}
+
+/* Rehashes the rows that changed, and folds the tables they are in. The
+ * fold is over the row hashes, so a table costs its rows in words whatever
+ * its columns.
+ */
+static void rehash (void)
+{
+	bool      dirty[SYNC_TABLE_COUNT] = { false };
+	ChangeRow change;
+
+	registrySelect(&database);
+
+	while (changeNext(&changes, &change))
+	{
+		const SyncTable table = tables[change.table];
+
+		if (table == SYNC_TABLE_COUNT
+		 || change.row >= manifest.capacity[table])
+		{
+			continue;
+		}
+
+		const RegistryObject *columns[SYNC_MAX_COLUMNS];
+		const size_t          count = columnsOf(table, columns);
+
+		hashesOf(&manifest, table)[change.row].syncRowHash =
+			hashRow(columns, count, change.row);
+		dirty[table] = true;
+	}
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		if (dirty[table])
+		{
+			const RegistryObject *columns[SYNC_MAX_COLUMNS];
+			const size_t          count = columnsOf(table, columns);
+
+			hashTable(&manifest, table,
+			          rowsOf(&manifest, table, columns, count));
+		}
+	}
+
+	registrySelect(NULL);
+}
+
+void syncRefresh (void)
+{
+	if (changeDrain(&changes))
+	{
+		rehash();
+	}
+	else
+	{
+		syncManifestBuild(&manifest, &database);
+	}
+
+	identify();
+}
+
+const SyncManifest *syncManifest (void)
+{
+	return &manifest;
+}
+
+bool syncManifestStore (SyncManifest *const manifest,
+                        const VarBind *const varbind)
+{
+	const OID      *const name  = &varbind->name;
+	const uint32_t *const arcs  = name->arcs;
+	const uint32_t        value = (uint32_t) varbind->value.counter;
+
+	if (varbind->type != BER_GAUGE32)
+	{
+		return false;
+	}
+
+	if (oidIsPrefix(&tableEntry, name)
+	 && name->length == tableEntry.length + 2)
+	{
+		const uint32_t column = arcs[tableEntry.length];
+		const uint32_t index  = arcs[tableEntry.length + 1];
+
+		if (index == 0 || index > SYNC_TABLE_COUNT)
+		{
+			return false;
+		}
+
+		SyncTableEntry *const entry = &manifest->syncTable[index - 1];
+
+		entry->syncTableIndex = index;
+
+		switch (column)
+		{
+			case 2:
+				entry->syncTableRows = value;
+				return true;
+
+			case 3:
+				entry->syncTableHash = value;
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	if (!oidIsPrefix(&rowHashes, name) || name->length < rowHashes.length + 2)
+	{
+		return false;
+	}
+
+	const uint32_t  column   = arcs[rowHashes.length];
+	const uint32_t *instance = &arcs[rowHashes.length + 1];
+	const size_t    length   = name->length - rowHashes.length - 1;
+	size_t          row;
+
+	if (column == 0 || column > SYNC_TABLE_COUNT)
+	{
+		return false;
+	}
+
+	const SyncTable table = column - 1;
+
+	if (table == SYNC_DAY_PLAN)
+	{
+		if (length != 2 || instance[0] == 0 || instance[1] == 0
+		 || instance[1] > manifest->dayPlanEvents)
+		{
+			return false;
+		}
+
+		row = (size_t) (instance[0] - 1) * manifest->dayPlanEvents
+		    + instance[1] - 1;
+	}
+	else
+	{
+		if (length != 1 || instance[0] == 0)
+		{
+			return false;
+		}
+
+		row = instance[0] - 1;
+	}
+
+	if (row >= manifest->capacity[table])
+	{
+		return false;
+	}
+
+	hashesOf(manifest, table)[row].syncRowHash = value;
+
+	return true;
+}
+
+static bool equal (const ObjectTree *const desired,
+                   const ObjectTree *const image,
+                   const RegistryObject *const object, const size_t row)
+{
+	registrySelect(desired);
+
+	const uint64_t wanted = valueOf(object, row);
+
+	registrySelect(image);
+
+	const uint64_t held = valueOf(object, row);
+
+	registrySelect(NULL);
+
+	return wanted == held;
+}
+
+size_t syncDiff (const ObjectTree *const desired,
+                 const SyncManifest *const local,
+                 const SyncManifest *const remote,
+                 const ObjectTree *const image, SyncChange changes[const],
+                 const size_t capacity)
+{
+	size_t count = 0;
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		const SyncTableEntry *const wanted = &local->syncTable[table];
+		const SyncTableEntry *const held   = &remote->syncTable[table];
+
+		if (wanted->syncTableHash == held->syncTableHash
+		 && wanted->syncTableRows == held->syncTableRows)
+		{
+			continue;
+		}
+
+		const RegistryObject *columns[SYNC_MAX_COLUMNS];
+		const size_t          columnCount = columnsOf(table, columns);
+		const SyncRowHash    *localRows   = hashesOf(local, table);
+		const SyncRowHash    *remoteRows  = hashesOf(remote, table);
+		const size_t          rows        =
+			MIN(MIN(wanted->syncTableRows, held->syncTableRows),
+			    remote->capacity[table]);
+
+		for (size_t row = 0; row < rows; row++)
+		{
+			const uint32_t hash = remoteRows[row].syncRowHash;
+
+			if (localRows[row].syncRowHash == hash)
+			{
+				continue;
+			}
+
+			const bool current = image
+			                  && syncRowHash(image, table, row) == hash;
+
+			for (size_t column = 0; column < columnCount; column++)
+			{
+				if (current && equal(desired, image, columns[column], row))
+				{
+					continue;
+				}
+
+				if (count < capacity)
+				{
+					changes[count] = (SyncChange)
+					{
+						.object = columns[column],
+						.row    = row
+					};
+				}
+
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+bool syncSessionInit (SyncSession *const session,
+                      const DatabaseLimits *const limits)
+{
+	memset(session, 0, sizeof(*session));
+
+	if (!syncManifestInit(&session->local, limits)
+	 || !syncManifestInit(&session->remote, limits))
+	{
+		return false;
+	}
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		const RegistryObject *columns[SYNC_MAX_COLUMNS];
+
+		session->capacity += session->local.capacity[table]
+		                   * columnsOf(table, columns);
+	}
+
+	session->changes = calloc(MAX(session->capacity, 1),
+	                          sizeof(session->changes[0]));
+
+	return session->changes != NULL;
+}
+
+void syncSessionFree (SyncSession *const session)
+{
+	syncManifestFree(&session->local);
+	syncManifestFree(&session->remote);
+	free(session->changes);
+	session->changes = NULL;
+}
+
+static void finish (SyncSession *const session, const SyncState state)
+{
+	session->state = state;
+
+	if (session->callback)
+	{
+		session->callback(session, session->context);
+	}
+}
+
+static bool succeeded (const SNMPPDU *const response)
+{
+	return response && response->errorStatus == SNMP_NO_ERROR;
+}
+
+/* Steps of a session. Those returning bool fail if the request could not be
+ * sent; the others end the session themselves.
+ */
+static bool readTables (SyncSession *session);
+static bool readRows (SyncSession *session);
+static bool command (SyncSession *session, int64_t value,
+                     ManagerCallback callback);
+static bool await (SyncSession *session);
+static void push (SyncSession *session);
+static void verify (SyncSession *session);
+static void conclude (SyncSession *session);
+
+static void onTables (ManagerDevice *const device,
+                      const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	if (!succeeded(response))
+	{
+		finish(session, SYNC_FAILED);
+		return;
+	}
+
+	for (size_t index = 0; index < response->count; index++)
+	{
+		syncManifestStore(&session->remote, &response->varbinds[index]);
+	}
+
+	session->state  = SYNC_ROWS;
+	session->table  = 0;
+	session->cursor = rowHashes;
+	oidAppend(&session->cursor, 1);
+
+	if (!readRows(session))
+	{
+		finish(session, SYNC_FAILED);
+	}
+}
+
+static bool readTables (SyncSession *const session)
+{
+	OID names[2 * SYNC_TABLE_COUNT];
+
+	for (SyncTable table = 0; table < SYNC_TABLE_COUNT; table++)
+	{
+		names[2 * table]     = tableEntry;
+		names[2 * table + 1] = tableEntry;
+
+		oidAppend(&names[2 * table], 2);
+		oidAppend(&names[2 * table], table + 1);
+		oidAppend(&names[2 * table + 1], 3);
+		oidAppend(&names[2 * table + 1], table + 1);
+	}
+
+	session->requests++;
+
+	return managerGet(session->manager, session->device, names,
+	                  2 * SYNC_TABLE_COUNT, onTables, session);
+}
+
+static void onOpen (ManagerDevice *const device,
+                    const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	if (!succeeded(response))
+	{
+		session->failed = true;
+		conclude(session);
+		return;
+	}
+
+	session->state = SYNC_PUSH;
+	push(session);
+}
+
+/* Compares the manifests once every differing table has been read. */
+static void compare (SyncSession *const session)
+{
+	session->count = MIN(syncDiff(session->desired, &session->local,
+	                              &session->remote, &session->device->tree,
+	                              session->changes, session->capacity),
+	                     session->capacity);
+	session->next  = 0;
+
+	if (session->count == 0)
+	{
+		finish(session, SYNC_DONE);
+		return;
+	}
+
+	session->state = SYNC_OPEN;
+
+	if (!command(session, TRANSACTION, onOpen))
+	{
+		finish(session, SYNC_FAILED);
+	}
+}
+
+static void onRows (ManagerDevice *const device,
+                    const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+	OID               column   = rowHashes;
+
+	(void) device;
+
+	if (!succeeded(response))
+	{
+		finish(session, SYNC_FAILED);
+		return;
+	}
+
+	bool ended = response->count == 0;
+
+	oidAppend(&column, session->table + 1);
+
+	/* The walk ends with the last row or on leaving the column. */
+	for (size_t index = 0; index < response->count && !ended; index++)
+	{
+		const VarBind *const varbind = &response->varbinds[index];
+
+		if (!oidIsPrefix(&column, &varbind->name)
+		 || !syncManifestStore(&session->remote, varbind))
+		{
+			ended = true;
+		}
+		else
+		{
+			session->cursor = varbind->name;
+			ended           = --session->unread == 0;
+		}
+	}
+
+	if (ended)
+	{
+		session->table++;
+		session->cursor = rowHashes;
+		oidAppend(&session->cursor, session->table + 1);
+	}
+
+	if (!readRows(session))
+	{
+		finish(session, SYNC_FAILED);
+	}
+}
+
+/* Reads on through the row hashes of the current table, skipping tables
+ * whose hash matches, and compares once none is left.
+ */
+static bool readRows (SyncSession *const session)
+{
+	while (session->table < SYNC_TABLE_COUNT)
+	{
+		const SyncTableEntry *const wanted =
+			&session->local.syncTable[session->table];
+		const SyncTableEntry *const held   =
+			&session->remote.syncTable[session->table];
+
+		if (wanted->syncTableHash != held->syncTableHash
+		 || wanted->syncTableRows != held->syncTableRows)
+		{
+			break;
+		}
+
+		session->table++;
+		session->cursor = rowHashes;
+		oidAppend(&session->cursor, session->table + 1);
+	}
+
+	if (session->table == SYNC_TABLE_COUNT)
+	{
+		compare(session);
+		return true;
+	}
+
+	if (session->cursor.length == rowHashes.length + 1)
+	{
+		session->unread =
+			MIN(session->remote.syncTable[session->table].syncTableRows,
+			    (uint32_t) session->remote.capacity[session->table]);
+	}
+
+	session->requests++;
+
+	return managerGetBulk(session->manager, session->device,
+	                      &session->cursor, 1, 0,
+	                      MAX(MIN(session->unread, 64u), 1u), onRows, session);
+}
+
+/* Fills session->message with as many changes from session->next on as fit
+ * in SYNC_MAX_MESSAGE. Returns how many.
+ */
+static size_t pack (SyncSession *const session)
+{
+	SNMPMessage *const message = &session->message;
+	size_t             count   = 0;
+
+	message->version         = SNMP_VERSION_2C;
+	message->community       = (const uint8_t *) session->device->community;
+	message->communityLength = strlen(session->device->community);
+	message->pdu.type        = SNMP_SET_REQUEST;
+	message->pdu.requestID   = INT32_MAX;
+	message->pdu.errorStatus = 0;
+	message->pdu.errorIndex  = 0;
+
+	registrySelect(session->desired);
+
+	while (session->next + count < session->count
+	    && count < SNMP_MAX_VARBINDS)
+	{
+		const SyncChange *const change  = &session->changes[session->next
+		                                                    + count];
+		VarBind          *const varbind = &message->pdu.varbinds[count];
+
+		registryName(change->object, change->row, &varbind->name);
+		registryGet(change->object, change->row, varbind);
+
+		message->pdu.count = count + 1;
+
+		if (snmpEncode(message, session->scratch,
+		               sizeof(session->scratch)) == 0)
+		{
+			break;
+		}
+
+		count++;
+	}
+
+	registrySelect(NULL);
+
+	message->pdu.count = count;
+
+	return count;
+}
+
+static void onPush (ManagerDevice *const device,
+                    const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	session->pending--;
+	session->failed |= !succeeded(response);
+
+	if (!session->failed)
+	{
+		push(session);
+	}
+
+	if (session->pending != 0)
+	{
+		return;
+	}
+
+	if (session->failed)
+	{
+		conclude(session);
+	}
+	else if (session->next == session->count)
+	{
+		verify(session);
+	}
+}
+
+/* Keeps the window of the device full of SETs. The buffer is only applied
+ * as a whole, so the order in which they arrive does not matter.
+ */
+static void push (SyncSession *const session)
+{
+	while (session->next < session->count)
+	{
+		const size_t count = pack(session);
+
+		if (count == 0
+		 || !managerSet(session->manager, session->device,
+		                session->message.pdu.varbinds, count, onPush,
+		                session))
+		{
+			break;
+		}
+
+		session->next += count;
+		session->pending++;
+		session->requests++;
+	}
+
+	if (session->pending == 0 && session->next < session->count)
+	{
+		session->failed = true;
+		conclude(session);
+	}
+}
+
+static bool command (SyncSession *const session, const int64_t value,
+                     const ManagerCallback callback)
+{
+	const VarBind varbind =
+	{
+		.name          = createTransaction,
+		.type          = BER_INTEGER,
+		.value.integer = value
+	};
+
+	session->requests++;
+
+	return managerSet(session->manager, session->device, &varbind, 1,
+	                  callback, session);
+}
+
+static void onPoll (ManagerDevice *const device,
+                    const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	if (!succeeded(response) || response->count != 2
+	 || response->varbinds[0].type != BER_INTEGER
+	 || response->varbinds[1].type != BER_INTEGER)
+	{
+		session->failed = true;
+		conclude(session);
+		return;
+	}
+
+	if (response->varbinds[0].value.integer == DONE)
+	{
+		session->verified =
+			response->varbinds[1].value.integer == doneWithNoError;
+		conclude(session);
+	}
+	else if (++session->polls >= SYNC_MAX_POLLS || !await(session))
+	{
+		session->failed = true;
+		conclude(session);
+	}
+}
+
+static bool await (SyncSession *const session)
+{
+	const OID names[] = { createTransaction, verifyStatus };
+
+	session->requests++;
+
+	return managerGet(session->manager, session->device, names, 2, onPoll,
+	                  session);
+}
+
+static void onVerify (ManagerDevice *const device,
+                      const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	if (!succeeded(response) || !await(session))
+	{
+		session->failed = true;
+		conclude(session);
+	}
+}
+
+static void verify (SyncSession *const session)
+{
+	session->state = SYNC_VERIFY;
+	session->polls = 0;
+
+	if (!command(session, VERIFY, onVerify))
+	{
+		session->failed = true;
+		conclude(session);
+	}
+}
+
+static void onClose (ManagerDevice *const device,
+                     const SNMPPDU *const response, void *const context)
+{
+	SyncSession *const session = context;
+
+	(void) device;
+
+	finish(session, succeeded(response) && session->verified
+	                && !session->failed ? SYNC_DONE : SYNC_FAILED);
+}
+
+/* NORMAL applies a verified buffer and discards any other, so it also ends
+ * a transaction that failed part way.
+ */
+static void conclude (SyncSession *const session)
+{
+	session->state = SYNC_CLOSE;
+
+	if (!command(session, NORMAL, onClose))
+	{
+		finish(session, SYNC_FAILED);
+	}
+}
+
+bool syncStart (SyncSession *const session, Manager *const manager,
+                ManagerDevice *const device, const ObjectTree *const desired,
+                const SyncCallback callback, void *const context)
+{
+	session->manager  = manager;
+	session->device   = device;
+	session->desired  = desired;
+	session->callback = callback;
+	session->context  = context;
+	session->state    = SYNC_TABLES;
+	session->failed   = false;
+	session->verified = false;
+	session->count    = 0;
+	session->next     = 0;
+	session->pending  = 0;
+	session->requests = 0;
+
+	memset(session->remote.syncTable, 0, sizeof(session->remote.syncTable));
+	syncManifestBuild(&session->local, desired);
+
+	/* Row hashes are matched by position, so both ends must number day plan
+	 * events alike.
+	 */
+	session->remote.dayPlanEvents = session->local.dayPlanEvents;
+
+	return readTables(session);
+}
@@ -0,0 +1,169 @@
+#include <Tick.h>
+#include <Database.h>
+#include <Metrics.h>
+
+TickStatus tickStatus = { .tickRealTime = 2 };
+
+static TickHook    hooks[TICK_MAX_HOOKS];
+static size_t      hookCount;
+static thrd_t      thread;
+static atomic_bool running;
+
+bool tickRegister (const TickHook hook)
+{
+	if (hookCount == TICK_MAX_HOOKS)
+	{
+		return false;
+	}
+
+	hooks[hookCount++] = hook;
+
+	return true;
+}
+
+static struct timespec timespecOf (const uint64_t nanoseconds)
+{
+	return (struct timespec)
+	{
+		.tv_sec  = (time_t) (nanoseconds / NANOSECONDS_PER_SECOND),
+		.tv_nsec = (long) (nanoseconds % NANOSECONDS_PER_SECOND)
+	};
+}
+
+static void monitor (const uint64_t deadline, const uint64_t start,
+                     const uint64_t end)
+{
+	const uint32_t lateness =
+		(uint32_t) MIN(start > deadline ? start - deadline : 0,
+		               (uint64_t) UINT32_MAX);
+
+	tickStatus.tickCount++;
+	tickStatus.tickLastLateness = lateness;
+
+	if (lateness > tickStatus.tickWorstLateness)
+	{
+		tickStatus.tickWorstLateness = lateness;
+	}
+
+	if (end > deadline + TICK_PERIOD)
+	{
+		tickStatus.tickOverruns++;
+	}
+
+	metricsRecord(METRIC_LATENESS, lateness);
+	metricsRecord(METRIC_TICK, end - start);
+}
+
+static int run (void *const argument)
+{
+	(void) argument;
+
+	uint64_t deadline = clockMonotonic() + TICK_PERIOD;
+
+	while (atomic_load_explicit(&running, memory_order_relaxed))
+	{
+		/* Sleeping until an absolute deadline, rather than for a period,
+		 * keeps the time spent in the hooks from accumulating as drift.
+		 */
+		const struct timespec wake = timespecOf(deadline);
+
+		if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0)
+		{
+			continue;
+		}
+
+		const uint64_t now = clockMonotonic();
+
+		/* The hooks see the configuration between SETs, never in one. */
+		databaseLock();
+
+		for (size_t index = 0; index < hookCount; index++)
+		{
+			hooks[index](deadline, now);
+		}
+
+		databaseUnlock();
+
+		monitor(deadline, now, clockMonotonic());
+
+		deadline += TICK_PERIOD;
+	}
+
+	return 0;
+}
+
+/* Applies the real-time settings to the tick thread. thrd_t is the pthread_t
+ * of the thread on glibc and musl.
+ */
+static bool schedule (const TickConfig *const config)
+{
+	const pthread_t handle = (pthread_t) thread;
+
+	if (config->cpu >= 0)
+	{
+		cpu_set_t cpus;
+
+		CPU_ZERO(&cpus);
+		CPU_SET(config->cpu, &cpus);
+
+		if (pthread_setaffinity_np(handle, sizeof(cpus), &cpus) != 0)
+		{
+			return false;
+		}
+	}
+
+	if (config->realTime)
+	{
+		const struct sched_param parameter =
+		{
+			.sched_priority = config->priority
+		};
+
+		if (pthread_setschedparam(handle, SCHED_FIFO, &parameter) != 0)
+		{
+			return false;
+		}
+
+		tickStatus.tickRealTime = 1;
+	}
+
+	return true;
+}
+
+bool tickStart (const TickConfig *const config)
+{
+	/* Locking before the thread exists also locks its stack, so that no
+	 * tick takes a page fault.
+	 */
+	if (config->realTime && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+	{
+		return false;
+	}
+
+	atomic_store(&running, true);
+
+	if (thrd_create(&thread, run, NULL) != thrd_success)
+	{
+		atomic_store(&running, false);
+		return false;
+	}
+
+	/* The first tick is a period away, so the settings are in place before
+	 * any hook runs.
+	 */
+	if (!schedule(config))
+	{
+		tickStop();
+		return false;
+	}
+
+	return true;
+}
+
+void tickStop (void)
+{
+	if (atomic_exchange(&running, false))
+	{
+		thrd_join(thread, NULL);
+	}
+}
@@ -0,0 +1,332 @@
+#include <Transaction.h>
+#include <Change.h>
+#include <MIB.h>
+#include <Metrics.h>
+
+static Global           bufferGlobal;
+static ASC              bufferASC;
+static DMS              bufferDMS;
+static ESS              bufferESS;
+static TSS              bufferTSS;
+static RSU              bufferRSU;
+static RMC              bufferRMC;
+static const ObjectTree buffer =
+{
+	.global = &bufferGlobal, .asc = &bufferASC, .dms = &bufferDMS,
+	.ess    = &bufferESS,    .tss = &bufferTSS, .rsu = &bufferRSU,
+	.rmc    = &bufferRMC
+};
+static bool             buffered;
+
+/* Group that opened the open transaction, if any. */
+static const AccessGroup *owner;
+
+/* Text of dbVerifyError after a failed consistency check. */
+static char verifyError[64];
+
+static_assert(sizeof(verifyError) <= sizeof(((OctetText *) 0)->octets),
+              "dbVerifyError must hold every text of the check");
+
+static const OID command = GLOBAL_OID(2, 1);
+
+bool transactionInit (const DatabaseLimits *const limits)
+{
+	buffered = databaseInitTree(&buffer, limits);
+
+	return buffered;
+}
+
+void transactionFree (void)
+{
+	if (buffered)
+	{
+		databaseFreeTree(&buffer);
+		buffered = false;
+	}
+}
+
+bool transactionIsCommand (const RegistryObject *const object)
+{
+	return oidCompare(&object->oid, &command) == 0;
+}
+
+static GlobalDatabaseManagement *management (void)
+{
+	return &global.globalDBManagement;
+}
+
+SNMPError transactionCheck (const int64_t value,
+                            const AccessGroup *const group)
+{
+	const GlobalDatabaseManagement *const state = management();
+
+	if (state->dbCreateTransaction != NORMAL && group != owner
+	 && !group->administrator)
+	{
+		return SNMP_GEN_ERR;
+	}
+
+	switch (state->dbCreateTransaction)
+	{
+		case NORMAL:
+			if (value != TRANSACTION)
+			{
+				return SNMP_WRONG_VALUE;
+			}
+
+			return buffered ? SNMP_NO_ERROR : SNMP_GEN_ERR;
+
+		case TRANSACTION:
+			return value == VERIFY || value == NORMAL ? SNMP_NO_ERROR
+			                                          : SNMP_WRONG_VALUE;
+
+		case DONE:
+			return value == TRANSACTION || value == NORMAL ? SNMP_NO_ERROR
+			                                               : SNMP_WRONG_VALUE;
+
+		default:
+			return SNMP_WRONG_VALUE;
+	}
+}
+
+/* Records the first inconsistency found in dbVerifyError. */
+static bool fail (const char *const object, const size_t row,
+                  const char *const limit)
+{
+	snprintf(verifyError, sizeof(verifyError), "%s.%zu exceeds %s", object,
+	         row + 1, limit);
+
+	return false;
+}
+
+/* Whether every octet of a phase list names a phase, from 1 to maximum. */
+static bool phasesWithin (const OctetText *const list, const size_t maximum)
+{
+	const uint8_t *const phases = list->octets;
+
+	for (size_t index = 0; index < list->length; index++)
+	{
+		if (phases[index] == 0 || phases[index] > maximum)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Cross-object checks of the buffer that the range of each object alone
+ * cannot express.
+ */
+static bool consistent (void)
+{
+	const Phase    *const phase    = &bufferASC.phase;
+	const Detector *const detector = &bufferASC.detector;
+	const Timebase *const timebase =
+		&bufferGlobal.globalTimeManagement.timebase;
+	const Coord       *const coord       = &bufferASC.coord;
+	const TimebaseAsc *const timebaseAsc = &bufferASC.timebaseAsc;
+	const Preempt     *const preempt     = &bufferASC.preempt;
+
+	for (size_t row = 0; row < phase->maxPhases; row++)
+	{
+		const PhaseEntry *const entry = &phase->phaseTable[row];
+
+		if ((entry->phaseOptions & 1) && entry->phaseRing == 0)
+		{
+			return fail("phaseRing", row, "an enabled phase");
+		}
+
+		if ((entry->phaseOptions & 1)
+		 && entry->phaseMaximum1 < entry->phaseMinimumGreen)
+		{
+			return fail("phaseMinimumGreen", row, "phaseMaximum1");
+		}
+
+		if (!phasesWithin(&entry->phaseConcurrency, phase->maxPhases))
+		{
+			return fail("phaseConcurrency", row, "maxPhases");
+		}
+	}
+
+	for (size_t row = 0; row < detector->maxVehicleDetectors; row++)
+	{
+		const VehicleDetectorEntry *const entry =
+			&detector->vehicleDetectorTable[row];
+
+		if (entry->vehicleDetectorCallPhase > phase->maxPhases)
+		{
+			return fail("vehicleDetectorCallPhase", row, "maxPhases");
+		}
+
+		if (entry->vehicleDetectorSwitchPhase > phase->maxPhases)
+		{
+			return fail("vehicleDetectorSwitchPhase", row, "maxPhases");
+		}
+	}
+
+	for (size_t row = 0; row < detector->maxPedestrianDetectors; row++)
+	{
+		if (detector->pedestrianDetectorTable[row].pedestrianDetectorCallPhase
+		    > phase->maxPhases)
+		{
+			return fail("pedestrianDetectorCallPhase", row, "maxPhases");
+		}
+	}
+
+	for (size_t row = 0; row < timebase->maxTimeBaseScheduleEntries; row++)
+	{
+		if (timebase->timeBaseScheduleTable[row].timeBaseScheduleDayPlan
+		    > timebase->maxDayPlans)
+		{
+			return fail("timeBaseScheduleDayPlan", row, "maxDayPlans");
+		}
+	}
+
+	const size_t dayPlanRows = (size_t) timebase->maxDayPlans
+	                         * timebase->maxDayPlanEvents;
+
+	for (size_t row = 0; row < dayPlanRows; row++)
+	{
+		if (timebase->timeBaseDayPlanTable[row].dayPlanActionNumberOID
+		    > timebaseAsc->maxTimebaseAscActions)
+		{
+			return fail("dayPlanActionNumberOID", row,
+			            "maxTimebaseAscActions");
+		}
+	}
+
+	for (size_t row = 0; row < coord->maxPatterns; row++)
+	{
+		const PatternEntry *const entry = &coord->patternTable[row];
+
+		if (entry->patternSplitNumber > coord->maxSplits)
+		{
+			return fail("patternSplitNumber", row, "maxSplits");
+		}
+
+		if (entry->patternCycleTime != 0
+		 && entry->patternOffsetTime >= entry->patternCycleTime)
+		{
+			return fail("patternOffsetTime", row, "patternCycleTime");
+		}
+	}
+
+	for (size_t row = 0; row < preempt->maxPreempts; row++)
+	{
+		const PreemptEntry *const entry = &preempt->preemptTable[row];
+
+		if (entry->preemptLink > preempt->maxPreempts)
+		{
+			return fail("preemptLink", row, "maxPreempts");
+		}
+
+		if (entry->preemptExitPhase > phase->maxPhases)
+		{
+			return fail("preemptExitPhase", row, "maxPhases");
+		}
+
+		if (!phasesWithin(&entry->preemptTrackPhase, phase->maxPhases))
+		{
+			return fail("preemptTrackPhase", row, "maxPhases");
+		}
+
+		if (!phasesWithin(&entry->preemptDwellPhase, phase->maxPhases))
+		{
+			return fail("preemptDwellPhase", row, "maxPhases");
+		}
+
+		if (!phasesWithin(&entry->preemptDwellPed, phase->maxPhases))
+		{
+			return fail("preemptDwellPed", row, "maxPhases");
+		}
+	}
+
+	for (size_t row = 0; row < timebaseAsc->maxTimebaseAscActions; row++)
+	{
+		const uint8_t pattern =
+			timebaseAsc->timebaseAscActionTable[row].timebaseAscPattern;
+
+		if (pattern > coord->maxPatterns && pattern < PATTERN_FREE)
+		{
+			return fail("timebaseAscPattern", row, "maxPatterns");
+		}
+	}
+
+	verifyError[0] = '\0';
+
+	return true;
+}
+
+/* The check runs to completion within the SET that starts it, so the VERIFY
+ * state is never observed and the response already reports DONE.
+ */
+static void verify (GlobalDatabaseManagement *const state)
+{
+	const uint64_t start = clockMonotonic();
+
+	state->dbVerifyStatus      = consistent() ? doneWithNoError
+	                                          : doneWithError;
+	state->dbCreateTransaction = DONE;
+
+	state->dbVerifyError.length = (uint16_t) strlen(verifyError);
+	memcpy(state->dbVerifyError.octets, verifyError,
+	       state->dbVerifyError.length);
+
+	metricsRecord(METRIC_VERIFY, clockMonotonic() - start);
+}
+
+void transactionCommand (const int64_t value, const AccessGroup *const group)
+{
+	GlobalDatabaseManagement *const state = management();
+
+	switch (value)
+	{
+		case TRANSACTION:
+			/* Reentering from DONE keeps the buffer as it is. */
+			if (state->dbCreateTransaction == NORMAL)
+			{
+				registryCopy(&database, &buffer);
+				changeDiscard();
+				owner = group;
+			}
+
+			state->dbCreateTransaction = TRANSACTION;
+			break;
+
+		case VERIFY:
+			verify(state);
+			break;
+
+		case NORMAL:
+			if (state->dbCreateTransaction == DONE
+			 && state->dbVerifyStatus == doneWithNoError)
+			{
+				registryCopy(&buffer, &database);
+				changeCommit();
+			}
+			else
+			{
+				changeDiscard();
+			}
+
+			state->dbCreateTransaction = NORMAL;
+			owner                      = NULL;
+			break;
+	}
+}
+
+const ObjectTree *transactionTarget (const AccessGroup *const group)
+{
+	switch (management()->dbCreateTransaction)
+	{
+		case NORMAL:
+			return &database;
+
+		case TRANSACTION:
+			return group == owner ? &buffer : NULL;
+
+		default:
+			return NULL;
+	}
+}
@@ -0,0 +1,578 @@
+#include <USM.h>
+#include <Clock.h>
+#include <MIB.h>
+
+/* Octets the password to key algorithm hashes (RFC 3414 A.2.2). */
+#define PASSWORD_OCTETS (1024 * 1024)
+
+/* Shortest password RFC 3414 allows. */
+#define MIN_PASSWORD 8
+
+/* Engine boots count seconds from 2020-01-01T00:00:00Z. */
+#define BOOTS_EPOCH 1577836800
+
+USMStatistics usmStatistics;
+
+static struct
+{
+	USMEngine engine;
+	uint8_t   engineID[USM_MAX_ENGINE_ID];
+	uint8_t   engineIDLength;
+	uint64_t  start; /* Monotonic time snmpEngineTime counts from. */
+	uint64_t  salt;  /* Of the next message enciphered. */
+	USMUser   users[USM_MAX_USERS];
+	size_t    userCount;
+} usm;
+
+static const uint8_t zeros[USM_DIGEST_OCTETS];
+
+void usmInit (void)
+{
+	char            host[64] = { 0 };
+	struct timespec wall;
+
+	if (gethostname(host, sizeof(host) - 1) != 0 || host[0] == '\0')
+	{
+		strcpy(host, "ntcip");
+	}
+
+	/* Text format: the enterprise with the high bit set, 4, then up to 27
+	 * octets of text.
+	 */
+	const size_t text = MIN(strlen(host), (size_t) USM_MAX_ENGINE_ID - 5);
+
+	usm.engineID[0] = (uint8_t) (0x80 | PRIVATE_ENTERPRISE >> 24);
+	usm.engineID[1] = (uint8_t) (PRIVATE_ENTERPRISE >> 16);
+	usm.engineID[2] = (uint8_t) (PRIVATE_ENTERPRISE >> 8);
+	usm.engineID[3] = (uint8_t) PRIVATE_ENTERPRISE;
+	usm.engineID[4] = 4;
+	memcpy(usm.engineID + 5, host, text);
+	usm.engineIDLength = (uint8_t) (5 + text);
+
+	clock_gettime(CLOCK_REALTIME, &wall);
+
+	const int64_t boots = (int64_t) wall.tv_sec - BOOTS_EPOCH;
+
+	(void) octetStringSet(&usm.engine.snmpEngineID, usm.engineID,
+	                      usm.engineIDLength);
+	usm.engine.snmpEngineBoots          = (int32_t) MIN(MAX(boots, 1),
+	                                                    INT32_MAX - 1);
+	usm.engine.snmpEngineTime           = 0;
+	usm.engine.snmpEngineMaxMessageSize = SNMP_MAX_MESSAGE;
+	usm.start                           = clockMonotonic();
+
+	if (getrandom(&usm.salt, sizeof(usm.salt), 0) < 0)
+	{
+		usm.salt = usm.start;
+	}
+}
+
+USMEngine *usmEngine (void)
+{
+	usm.engine.snmpEngineTime =
+		(int32_t) ((clockMonotonic() - usm.start) / NANOSECONDS_PER_SECOND);
+
+	return &usm.engine;
+}
+
+/* The password to key algorithm: the password repeated over a megabyte,
+ * hashed.
+ */
+static void passwordToKey (const char *const password,
+                           uint8_t key[const SHA1_DIGEST_OCTETS])
+{
+	const size_t length = strlen(password);
+	uint8_t      block[SHA1_BLOCK_OCTETS];
+	size_t       index = 0;
+	SHA1         sha;
+
+	sha1Init(&sha);
+
+	for (size_t count = 0; count < PASSWORD_OCTETS; count += sizeof(block))
+	{
+		for (size_t octet = 0; octet < sizeof(block); octet++)
+		{
+			block[octet] = (uint8_t) password[index++ % length];
+		}
+
+		sha1Update(&sha, block, sizeof(block));
+	}
+
+	sha1Final(&sha, key);
+}
+
+/* Kul = H(Ku || engineID || Ku) */
+static void localize (const uint8_t key[const SHA1_DIGEST_OCTETS],
+                      const uint8_t *const engineID, const size_t length,
+                      uint8_t local[const SHA1_DIGEST_OCTETS])
+{
+	SHA1 sha;
+
+	sha1Init(&sha);
+	sha1Update(&sha, key, SHA1_DIGEST_OCTETS);
+	sha1Update(&sha, engineID, length);
+	sha1Update(&sha, key, SHA1_DIGEST_OCTETS);
+	sha1Final(&sha, local);
+}
+
+const USMKeys *usmLocalize (USMUser *const user,
+                            const uint8_t *const engineID,
+                            const size_t length)
+{
+	uint8_t local[SHA1_DIGEST_OCTETS];
+
+	for (size_t index = 0; index < user->cached; index++)
+	{
+		const USMKeys *const keys = &user->keys[index];
+
+		if (keys->engineIDLength == length
+		 && memcmp(keys->engineID, engineID, length) == 0)
+		{
+			return keys;
+		}
+	}
+
+	if (length > USM_MAX_ENGINE_ID)
+	{
+		return NULL;
+	}
+
+	USMKeys *const keys = &user->keys[user->next];
+
+	user->next   = (uint8_t) ((user->next + 1) % USM_KEY_CACHE);
+	user->cached = (uint8_t) MIN(user->cached + 1, USM_KEY_CACHE);
+
+	memcpy(keys->engineID, engineID, length);
+	keys->engineIDLength = (uint8_t) length;
+
+	localize(user->authKey, engineID, length, local);
+	hmacKey(&keys->auth, local, sizeof(local));
+
+	/* AES-128 takes the first 16 octets of the localized key. */
+	if (user->privacy)
+	{
+		localize(user->privKey, engineID, length, local);
+		aesKey(&keys->priv, local);
+	}
+
+	return keys;
+}
+
+USMUser *usmFind (const uint8_t *const name, const size_t length)
+{
+	for (size_t index = 0; index < usm.userCount; index++)
+	{
+		USMUser *const user = &usm.users[index];
+
+		if (user->nameLength == length
+		 && memcmp(user->name, name, length) == 0)
+		{
+			return user;
+		}
+	}
+
+	return NULL;
+}
+
+bool usmAddUser (const char *const name, const char *const auth,
+                 const char *const priv)
+{
+	const size_t length = strlen(name);
+
+	if (usm.userCount == USM_MAX_USERS || length == 0
+	 || length > USM_MAX_USER_NAME || usmFind((const uint8_t *) name, length)
+	 || strlen(auth) < MIN_PASSWORD || (priv && strlen(priv) < MIN_PASSWORD))
+	{
+		return false;
+	}
+
+	USMUser *const user = &usm.users[usm.userCount++];
+
+	*user = (USMUser)
+	{
+		.nameLength = (uint8_t) length,
+		.privacy    = priv != NULL
+	};
+
+	memcpy(user->name, name, length);
+	passwordToKey(auth, user->authKey);
+
+	if (priv)
+	{
+		passwordToKey(priv, user->privKey);
+	}
+
+	(void) usmLocalize(user, usm.engineID, usm.engineIDLength);
+
+	return true;
+}
+
+/* Counter of each error, in the order of the usmStats group. */
+static uint32_t *const counters[] =
+{
+	[USM_UNSUPPORTED_SEC_LEVELS] = &usmStatistics.usmStatsUnsupportedSecLevels,
+	[USM_NOT_IN_TIME_WINDOWS]    = &usmStatistics.usmStatsNotInTimeWindows,
+	[USM_UNKNOWN_USER_NAMES]     = &usmStatistics.usmStatsUnknownUserNames,
+	[USM_UNKNOWN_ENGINE_IDS]     = &usmStatistics.usmStatsUnknownEngineIDs,
+	[USM_WRONG_DIGESTS]          = &usmStatistics.usmStatsWrongDigests,
+	[USM_DECRYPTION_ERRORS]      = &usmStatistics.usmStatsDecryptionErrors
+};
+
+static USMStatus fail (const USMStatus status)
+{
+	(*counters[status])++;
+
+	return status;
+}
+
+/* HMAC-SHA-96 of a message whose authentication parameters, at offset, are
+ * taken as zeros.
+ */
+static void digest (const USMKeys *const keys, const uint8_t *const data,
+                    const size_t length, const size_t offset,
+                    uint8_t result[const SHA1_DIGEST_OCTETS])
+{
+	SHA1 inner = keys->auth.inner;
+
+	sha1Update(&inner, data, offset);
+	sha1Update(&inner, zeros, USM_DIGEST_OCTETS);
+	sha1Update(&inner, data + offset + USM_DIGEST_OCTETS,
+	           length - offset - USM_DIGEST_OCTETS);
+	hmacFinal(&keys->auth, &inner, result);
+}
+
+/* IV = snmpEngineBoots || snmpEngineTime || salt, big endian (RFC 3826). */
+static void initialVector (const int32_t boots, const int32_t time,
+                           const uint8_t salt[const USM_SALT_OCTETS],
+                           uint8_t iv[const AES_BLOCK_OCTETS])
+{
+	for (size_t index = 0; index < 4; index++)
+	{
+		iv[index]     = (uint8_t) ((uint32_t) boots >> (24 - 8 * index));
+		iv[index + 4] = (uint8_t) ((uint32_t) time >> (24 - 8 * index));
+	}
+
+	memcpy(iv + 8, salt, USM_SALT_OCTETS);
+}
+
+static bool decodeScoped (const uint8_t *const data, const size_t length,
+                          SNMPMessage *const message)
+{
+	SNMPSecurity *const security = &message->security;
+	BERReader           reader, scoped;
+
+	berReaderInit(&reader, data, length);
+
+	return berEnter(&reader, BER_SEQUENCE, &scoped)
+	    && berReadOctetString(&scoped, &security->contextEngineID,
+	                          &security->contextEngineIDLength)
+	    && berReadOctetString(&scoped, &security->contextName,
+	                          &security->contextNameLength)
+	    && snmpDecodePDU(&scoped, &message->pdu);
+}
+
+static bool readInteger32 (BERReader *const reader, const int64_t minimum,
+                           int32_t *const value)
+{
+	int64_t wide;
+
+	if (!berReadInteger(reader, BER_INTEGER, &wide)
+	 || wide < minimum || wide > INT32_MAX)
+	{
+		return false;
+	}
+
+	*value = (int32_t) wide;
+
+	return true;
+}
+
+USMStatus usmDecode (const uint8_t *const data, const size_t length,
+                     uint8_t *const plain, SNMPMessage *const message,
+                     USMUser **const user)
+{
+	SNMPSecurity *const security = &message->security;
+	BERReader           reader, contents, header, parameters, fields;
+	int64_t             version, model;
+	const uint8_t      *flags, *encoded, *scoped;
+	size_t              flagsLength, encodedLength, scopedLength;
+
+	*user = NULL;
+
+	/* What a report takes from a message that fails before its scoped PDU
+	 * is decoded.
+	 */
+	message->version                = SNMP_VERSION_3;
+	message->pdu.requestID          = 0;
+	message->pdu.count              = 0;
+	security->contextEngineID       = data;
+	security->contextEngineIDLength = 0;
+	security->contextName           = data;
+	security->contextNameLength     = 0;
+
+	berReaderInit(&reader, data, length);
+
+	if (!berEnter(&reader, BER_SEQUENCE, &contents)
+	 || !berReadInteger(&contents, BER_INTEGER, &version)
+	 || version != SNMP_VERSION_3
+	 || !berEnter(&contents, BER_SEQUENCE, &header)
+	 || !readInteger32(&header, 0, &security->msgID)
+	 || !readInteger32(&header, 484, &security->maxSize)
+	 || !berReadOctetString(&header, &flags, &flagsLength)
+	 || !berReadInteger(&header, BER_INTEGER, &model)
+	 || !berReadOctetString(&contents, &encoded, &encodedLength))
+	{
+		return USM_PARSE_ERROR;
+	}
+
+	/* Privacy without authentication is not a level. */
+	if (flagsLength != 1 || model != SNMP_SECURITY_MODEL_USM
+	 || (flags[0] & (SNMP_FLAG_AUTH | SNMP_FLAG_PRIV)) == SNMP_FLAG_PRIV)
+	{
+		return USM_PARSE_ERROR;
+	}
+
+	security->flags = flags[0];
+
+	berReaderInit(&parameters, encoded, encodedLength);
+
+	if (!berEnter(&parameters, BER_SEQUENCE, &fields)
+	 || !berReadOctetString(&fields, &security->engineID,
+	                        &security->engineIDLength)
+	 || !readInteger32(&fields, 0, &security->engineBoots)
+	 || !readInteger32(&fields, 0, &security->engineTime)
+	 || !berReadOctetString(&fields, &security->userName,
+	                        &security->userNameLength)
+	 || !berReadOctetString(&fields, &security->authParameters,
+	                        &security->authLength)
+	 || !berReadOctetString(&fields, &security->privParameters,
+	                        &security->privLength))
+	{
+		return USM_PARSE_ERROR;
+	}
+
+	security->authOffset = (size_t) (security->authParameters - data);
+
+	const bool authenticated = security->flags & SNMP_FLAG_AUTH;
+	const bool enciphered    = security->flags & SNMP_FLAG_PRIV;
+
+	/* A scoped PDU in the clear is decoded at once, so that a report can
+	 * carry its request-id.
+	 */
+	if (enciphered)
+	{
+		if (!berReadOctetString(&contents, &scoped, &scopedLength))
+		{
+			return USM_PARSE_ERROR;
+		}
+	}
+	else if (!decodeScoped(contents.data + contents.offset,
+	                       contents.length - contents.offset, message))
+	{
+		return USM_PARSE_ERROR;
+	}
+
+	/* The checks of RFC 3414 3.2, in its order. */
+	if (security->engineIDLength != usm.engineIDLength
+	 || memcmp(security->engineID, usm.engineID, usm.engineIDLength) != 0)
+	{
+		return fail(USM_UNKNOWN_ENGINE_IDS);
+	}
+
+	*user = usmFind(security->userName, security->userNameLength);
+
+	if (!*user)
+	{
+		return fail(USM_UNKNOWN_USER_NAMES);
+	}
+
+	if (enciphered && !(*user)->privacy)
+	{
+		return fail(USM_UNSUPPORTED_SEC_LEVELS);
+	}
+
+	if (!authenticated)
+	{
+		return USM_OK;
+	}
+
+	const USMKeys *const keys =
+		usmLocalize(*user, usm.engineID, usm.engineIDLength);
+	uint8_t result[SHA1_DIGEST_OCTETS];
+	uint8_t difference = 0;
+
+	if (security->authLength != USM_DIGEST_OCTETS)
+	{
+		return fail(USM_WRONG_DIGESTS);
+	}
+
+	digest(keys, data, length, security->authOffset, result);
+
+	for (size_t index = 0; index < USM_DIGEST_OCTETS; index++)
+	{
+		difference |= result[index] ^ security->authParameters[index];
+	}
+
+	if (difference != 0)
+	{
+		return fail(USM_WRONG_DIGESTS);
+	}
+
+	const USMEngine *const engine = usmEngine();
+
+	if (engine->snmpEngineBoots == INT32_MAX
+	 || security->engineBoots != engine->snmpEngineBoots
+	 || abs(security->engineTime - engine->snmpEngineTime) > USM_TIME_WINDOW)
+	{
+		return fail(USM_NOT_IN_TIME_WINDOWS);
+	}
+
+	if (!enciphered)
+	{
+		return USM_OK;
+	}
+
+	uint8_t iv[AES_BLOCK_OCTETS];
+
+	if (security->privLength != USM_SALT_OCTETS
+	 || scopedLength > SNMP_MAX_MESSAGE)
+	{
+		return fail(USM_DECRYPTION_ERRORS);
+	}
+
+	initialVector(security->engineBoots, security->engineTime,
+	              security->privParameters, iv);
+	memcpy(plain, scoped, scopedLength);
+	aesDecryptCFB(&keys->priv, iv, plain, scopedLength);
+
+	if (!decodeScoped(plain, scopedLength, message))
+	{
+		return fail(USM_DECRYPTION_ERRORS);
+	}
+
+	return USM_OK;
+}
+
+size_t usmEncode (const SNMPMessage *const message, USMUser *const user,
+                  uint8_t *const buffer, const size_t capacity)
+{
+	const SNMPSecurity *const security = &message->security;
+	const bool authenticated = security->flags & SNMP_FLAG_AUTH;
+	const bool enciphered    = security->flags & SNMP_FLAG_PRIV;
+	const USMKeys *const keys = authenticated
+		? usmLocalize(user, security->engineID, security->engineIDLength)
+		: NULL;
+	uint8_t   salt[USM_SALT_OCTETS] = { 0 };
+	BERWriter writer;
+
+	if (authenticated && !keys)
+	{
+		return 0;
+	}
+
+	berWriterInit(&writer, buffer, capacity);
+	snmpWritePDU(&writer, &message->pdu);
+	berWriteOctetString(&writer, security->contextName,
+	                    security->contextNameLength);
+	berWriteOctetString(&writer, security->contextEngineID,
+	                    security->contextEngineIDLength);
+	berWriteConstructed(&writer, BER_SEQUENCE, 0);
+
+	/* The scoped PDU is enciphered where it was encoded, and wrapped in an
+	 * OCTET STRING.
+	 */
+	if (enciphered)
+	{
+		uint8_t iv[AES_BLOCK_OCTETS];
+
+		if (writer.overflow)
+		{
+			return 0;
+		}
+
+		for (size_t index = 0; index < USM_SALT_OCTETS; index++)
+		{
+			salt[index] = (uint8_t) (usm.salt >> (56 - 8 * index));
+		}
+
+		usm.salt++;
+
+		initialVector(security->engineBoots, security->engineTime, salt, iv);
+		aesEncryptCFB(&keys->priv, iv, buffer + writer.cursor,
+		              berWriterLength(&writer));
+		berWriteHeader(&writer, BER_OCTET_STRING, berWriterLength(&writer));
+	}
+
+	const size_t parameters = berWriterLength(&writer);
+
+	berWriteOctetString(&writer, salt, enciphered ? USM_SALT_OCTETS : 0);
+	berWriteBytes(&writer, zeros, authenticated ? USM_DIGEST_OCTETS : 0);
+
+	/* Octets from the authentication parameters to the end. */
+	const size_t authMark = berWriterLength(&writer);
+
+	berWriteHeader(&writer, BER_OCTET_STRING,
+	               authenticated ? USM_DIGEST_OCTETS : 0);
+	berWriteOctetString(&writer, security->userName,
+	                    security->userNameLength);
+	berWriteInteger(&writer, BER_INTEGER, security->engineTime);
+	berWriteInteger(&writer, BER_INTEGER, security->engineBoots);
+	berWriteOctetString(&writer, security->engineID,
+	                    security->engineIDLength);
+	berWriteConstructed(&writer, BER_SEQUENCE, parameters);
+	berWriteConstructed(&writer, BER_OCTET_STRING, parameters);
+
+	const size_t header = berWriterLength(&writer);
+
+	berWriteInteger(&writer, BER_INTEGER, SNMP_SECURITY_MODEL_USM);
+	berWriteOctetString(&writer, &security->flags, 1);
+	berWriteInteger(&writer, BER_INTEGER, security->maxSize);
+	berWriteInteger(&writer, BER_INTEGER, security->msgID);
+	berWriteConstructed(&writer, BER_SEQUENCE, header);
+	berWriteInteger(&writer, BER_INTEGER, SNMP_VERSION_3);
+	berWriteConstructed(&writer, BER_SEQUENCE, 0);
+
+	if (writer.overflow)
+	{
+		return 0;
+	}
+
+	const size_t length = berWriterLength(&writer);
+
+	memmove(buffer, berWriterData(&writer), length);
+
+	if (authenticated)
+	{
+		uint8_t result[SHA1_DIGEST_OCTETS];
+
+		digest(keys, buffer, length, length - authMark, result);
+		memcpy(buffer + length - authMark, result, USM_DIGEST_OCTETS);
+	}
+
+	return length;
+}
+
+void usmReport (const USMStatus status, SNMPPDU *const pdu)
+{
+	static const OID names[] =
+	{
+		[USM_UNSUPPORTED_SEC_LEVELS] = USM_STATS_OID(1, 0),
+		[USM_NOT_IN_TIME_WINDOWS]    = USM_STATS_OID(2, 0),
+		[USM_UNKNOWN_USER_NAMES]     = USM_STATS_OID(3, 0),
+		[USM_UNKNOWN_ENGINE_IDS]     = USM_STATS_OID(4, 0),
+		[USM_WRONG_DIGESTS]          = USM_STATS_OID(5, 0),
+		[USM_DECRYPTION_ERRORS]      = USM_STATS_OID(6, 0)
+	};
+
+	pdu->type        = SNMP_REPORT;
+	pdu->errorStatus = SNMP_NO_ERROR;
+	pdu->errorIndex  = 0;
+	pdu->count       = 1;
+
+	pdu->varbinds[0] = (VarBind)
+	{
+		.name          = names[status],
+		.type          = BER_COUNTER32,
+		.value.counter = *counters[status]
+	};
+}
@@ -0,0 +1,520 @@
+#include <Weather.h>
+#include <Clock.h>
+#include <Device.h>
+#include <MIB.h>
+
+/* The gust is a second window over the samples of the wind speed. */
+#define CHANNEL_GUST WEATHER_CHANNEL_COUNT
+
+/* Aggregates of the station as a whole come first, then those of the
+ * sensors of the tables.
+ */
+enum
+{
+	SLOT_PRESSURE       = 0,
+	SLOT_WIND_DIRECTION = 1,
+	SLOT_WIND_SPEED     = 2,
+	SLOT_WIND_GUST      = 3,
+	SLOT_HUMIDITY       = 4,
+	SLOT_VISIBILITY     = 5,
+	SLOT_SENSORS        = 6
+};
+
+#define SLOTS                                                                  \
+	(SLOT_SENSORS + CONFIG_MAX_TEMPERATURE_SENSORS                             \
+	 + 2 * CONFIG_MAX_PAVEMENT_SENSORS)
+
+#define SECONDS_PER_HOUR 3600
+
+/* Seconds of the window of each channel. */
+static const uint32_t windows[WEATHER_CHANNEL_COUNT + 1] =
+{
+	[WEATHER_PRESSURE]             = 3 * SECONDS_PER_HOUR,
+	[WEATHER_WIND_DIRECTION]       = 120,
+	[WEATHER_WIND_SPEED]           = 120,
+	[WEATHER_HUMIDITY]             = 600,
+	[WEATHER_VISIBILITY]           = 600,
+	[WEATHER_AIR_TEMPERATURE]      = 24 * SECONDS_PER_HOUR,
+	[WEATHER_SURFACE_TEMPERATURE]  = SECONDS_PER_HOUR,
+	[WEATHER_PAVEMENT_TEMPERATURE] = SECONDS_PER_HOUR,
+	[CHANNEL_GUST]                 = 600
+};
+
+typedef struct Bucket
+{
+	int64_t  sum;
+	int32_t  minimum;
+	int32_t  maximum;
+	int32_t  companion; /* Of the sample at the maximum. */
+	uint32_t count;
+} Bucket;
+
+typedef struct Aggregate
+{
+	Bucket   buckets[WEATHER_BUCKETS];
+	Bucket   closed;    /* Every bucket but the open one, combined. */
+	uint64_t span;      /* Nanoseconds of a bucket. */
+	uint64_t epoch;     /* Bucket of the clock the open one is. */
+	int64_t  unwrapped; /* Last direction, counted on across north. */
+	int32_t  latest;
+	uint8_t  channel;
+	uint8_t  sensor;    /* Row of the table, counted from zero. */
+} Aggregate;
+
+static struct
+{
+	OBJECT_TABLE(Aggregate, aggregates, SLOTS);
+	size_t count;
+
+	uint8_t temperatureSensors;
+	uint8_t pavementSensors;
+} station;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void setUp (Aggregate *const aggregate, const uint8_t channel,
+                   const uint8_t sensor)
+{
+	*aggregate = (Aggregate)
+	{
+		.span    = windows[channel] * NANOSECONDS_PER_SECOND
+		         / WEATHER_BUCKETS,
+		.channel = channel,
+		.sensor  = sensor
+	};
+}
+
+bool weatherInit (const DatabaseLimits *const limits)
+{
+	station.temperatureSensors = limits->essNumTemperatureSensors;
+	station.pavementSensors    = limits->numEssPavementSensors;
+	station.count              = SLOT_SENSORS + station.temperatureSensors
+	                           + 2 * station.pavementSensors;
+
+	if (!PROVIDE(station.aggregates, station.count))
+	{
+		return false;
+	}
+
+	Aggregate *const aggregates = station.aggregates;
+	Aggregate       *next       = &aggregates[SLOT_SENSORS];
+
+	setUp(&aggregates[SLOT_PRESSURE], WEATHER_PRESSURE, 0);
+	setUp(&aggregates[SLOT_WIND_DIRECTION], WEATHER_WIND_DIRECTION, 0);
+	setUp(&aggregates[SLOT_WIND_SPEED], WEATHER_WIND_SPEED, 0);
+	setUp(&aggregates[SLOT_WIND_GUST], CHANNEL_GUST, 0);
+	setUp(&aggregates[SLOT_HUMIDITY], WEATHER_HUMIDITY, 0);
+	setUp(&aggregates[SLOT_VISIBILITY], WEATHER_VISIBILITY, 0);
+
+	for (uint8_t sensor = 0; sensor < station.temperatureSensors; sensor++)
+	{
+		setUp(next++, WEATHER_AIR_TEMPERATURE, sensor);
+	}
+
+	for (uint8_t sensor = 0; sensor < station.pavementSensors; sensor++)
+	{
+		setUp(next++, WEATHER_SURFACE_TEMPERATURE, sensor);
+		setUp(next++, WEATHER_PAVEMENT_TEMPERATURE, sensor);
+	}
+
+	return true;
+}
+
+void weatherFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(station.aggregates);
+
+	station.aggregates = NULL;
+#endif
+}
+
+/* The aggregate of a sensor, or NULL if the station has no such sensor. */
+static Aggregate *find (const WeatherChannel channel, const uint8_t sensor)
+{
+	const size_t temperatures = SLOT_SENSORS + station.temperatureSensors;
+	size_t       slot;
+
+	switch (channel)
+	{
+		case WEATHER_PRESSURE:       slot = SLOT_PRESSURE;       break;
+		case WEATHER_WIND_DIRECTION: slot = SLOT_WIND_DIRECTION; break;
+		case WEATHER_WIND_SPEED:     slot = SLOT_WIND_SPEED;     break;
+		case WEATHER_HUMIDITY:       slot = SLOT_HUMIDITY;       break;
+		case WEATHER_VISIBILITY:     slot = SLOT_VISIBILITY;     break;
+
+		case WEATHER_AIR_TEMPERATURE:
+			if (sensor == 0 || sensor > station.temperatureSensors)
+			{
+				return NULL;
+			}
+
+			return &station.aggregates[SLOT_SENSORS + sensor - 1];
+
+		case WEATHER_SURFACE_TEMPERATURE:
+		case WEATHER_PAVEMENT_TEMPERATURE:
+			if (sensor == 0 || sensor > station.pavementSensors)
+			{
+				return NULL;
+			}
+
+			return &station.aggregates[temperatures + (sensor - 1) * 2
+			                           + (channel
+			                              == WEATHER_PAVEMENT_TEMPERATURE)];
+
+		default:
+			return NULL;
+	}
+
+	return sensor == 0 ? &station.aggregates[slot] : NULL;
+}
+
+static void combine (Bucket *const into, const Bucket *const bucket)
+{
+	if (bucket->count == 0)
+	{
+		return;
+	}
+
+	if (into->count == 0 || bucket->minimum < into->minimum)
+	{
+		into->minimum = bucket->minimum;
+	}
+
+	if (into->count == 0 || bucket->maximum > into->maximum)
+	{
+		into->maximum   = bucket->maximum;
+		into->companion = bucket->companion;
+	}
+
+	into->sum   += bucket->sum;
+	into->count += bucket->count;
+}
+
+/* Opens the bucket now falls in, emptying those the window left behind.
+ * Returns true if the window moved.
+ */
+static bool slide (Aggregate *const aggregate, const uint64_t now)
+{
+	const uint64_t epoch = now / aggregate->span;
+
+	if (epoch <= aggregate->epoch)
+	{
+		return false;
+	}
+
+	const uint64_t steps = MIN(epoch - aggregate->epoch,
+	                           (uint64_t) WEATHER_BUCKETS);
+
+	for (uint64_t step = 1; step <= steps; step++)
+	{
+		aggregate->buckets[(aggregate->epoch + step) % WEATHER_BUCKETS] =
+			(Bucket) { 0 };
+	}
+
+	aggregate->epoch  = epoch;
+	aggregate->closed = (Bucket) { 0 };
+
+	for (size_t index = 0; index < WEATHER_BUCKETS; index++)
+	{
+		if (index != epoch % WEATHER_BUCKETS)
+		{
+			combine(&aggregate->closed, &aggregate->buckets[index]);
+		}
+	}
+
+	return true;
+}
+
+/* The whole window, the open bucket with the closed ones. */
+static Bucket window (const Aggregate *const aggregate)
+{
+	Bucket whole = aggregate->closed;
+
+	combine(&whole, &aggregate->buckets[aggregate->epoch % WEATHER_BUCKETS]);
+
+	return whole;
+}
+
+static int64_t average (const Bucket *const bucket)
+{
+	return bucket->sum / (int64_t) bucket->count;
+}
+
+/* Directions are averaged as counted on across north, then brought back
+ * into a turn.
+ */
+static int32_t mean (const Aggregate *const aggregate,
+                     const Bucket *const bucket)
+{
+	const int64_t value = average(bucket);
+
+	return (int32_t) (aggregate->channel == WEATHER_WIND_DIRECTION
+	                ? (value % 360 + 360) % 360
+	                : value);
+}
+
+static int32_t clamp (const int64_t value, const int32_t minimum,
+                      const int32_t maximum)
+{
+	return (int32_t) MIN(MAX(value, (int64_t) minimum), (int64_t) maximum);
+}
+
+static int16_t temperature (const bool missing, const int32_t value)
+{
+	return (int16_t) (missing ? ESS_TEMPERATURE_MISSING
+	                          : clamp(value, -1000, 1000));
+}
+
+/* Writes the objects an aggregate reports. */
+static void publish (const Aggregate *const aggregate)
+{
+	EssAtmosphere *const atmosphere = &ess.essAtmosphere;
+	const Bucket         whole      = window(aggregate);
+	const bool           missing    = whole.count == 0;
+	const uint8_t        sensor     = aggregate->sensor;
+
+	switch (aggregate->channel)
+	{
+		case WEATHER_PRESSURE:
+			atmosphere->essAtmosphericPressure = missing
+				? ESS_PRESSURE_MISSING
+				: (uint16_t) clamp(aggregate->latest, 0, UINT16_MAX - 1);
+			break;
+
+		case WEATHER_WIND_DIRECTION:
+			atmosphere->essSpotWindDirection = missing
+				? ESS_DIRECTION_MISSING
+				: (uint16_t) aggregate->latest;
+			atmosphere->essAvgWindDirection  = missing
+				? ESS_DIRECTION_MISSING
+				: (uint16_t) mean(aggregate, &whole);
+			break;
+
+		case WEATHER_WIND_SPEED:
+			atmosphere->essSpotWindSpeed = missing
+				? ESS_SPEED_MISSING
+				: (uint16_t) clamp(aggregate->latest, 0, UINT16_MAX - 1);
+			atmosphere->essAvgWindSpeed  = missing
+				? ESS_SPEED_MISSING
+				: (uint16_t) clamp(mean(aggregate, &whole), 0,
+				                   UINT16_MAX - 1);
+			break;
+
+		case CHANNEL_GUST:
+			atmosphere->essMaxWindGustSpeed = missing
+				? ESS_SPEED_MISSING
+				: (uint16_t) clamp(whole.maximum, 0, UINT16_MAX - 1);
+			atmosphere->essMaxWindGustDir   = missing
+				? ESS_DIRECTION_MISSING
+				: (uint16_t) whole.companion;
+			break;
+
+		case WEATHER_HUMIDITY:
+			atmosphere->essRelativeHumidity = missing
+				? ESS_HUMIDITY_MISSING
+				: (uint8_t) clamp(aggregate->latest, 0, 100);
+			break;
+
+		case WEATHER_VISIBILITY:
+			atmosphere->essVisibility = missing
+				? ESS_VISIBILITY_MISSING
+				: (uint32_t) clamp(aggregate->latest, 0,
+				                   ESS_VISIBILITY_MISSING - 1);
+			break;
+
+		case WEATHER_AIR_TEMPERATURE:
+			ess.essTemperature.essTemperatureSensorTable[sensor]
+				.essAirTemperature = temperature(missing, aggregate->latest);
+
+			if (sensor == 0)
+			{
+				atmosphere->essMaxTemp = temperature(missing, whole.maximum);
+				atmosphere->essMinTemp = temperature(missing, whole.minimum);
+			}
+			break;
+
+		case WEATHER_SURFACE_TEMPERATURE:
+			ess.essPavement.essPavementSensorTable[sensor]
+				.essSurfaceTemperature =
+				temperature(missing, aggregate->latest);
+			break;
+
+		case WEATHER_PAVEMENT_TEMPERATURE:
+			ess.essPavement.essPavementSensorTable[sensor]
+				.essPavementTemperature =
+				temperature(missing, aggregate->latest);
+			break;
+	}
+}
+
+static void add (Aggregate *const aggregate, const int64_t value,
+                 const int32_t latest, const int32_t companion,
+                 const uint64_t now)
+{
+	slide(aggregate, now);
+
+	Bucket *const bucket =
+		&aggregate->buckets[aggregate->epoch % WEATHER_BUCKETS];
+	const Bucket  sample =
+	{
+		.sum       = value,
+		.minimum   = (int32_t) value,
+		.maximum   = (int32_t) value,
+		.companion = companion,
+		.count     = 1
+	};
+
+	combine(bucket, &sample);
+	aggregate->latest = latest;
+
+	publish(aggregate);
+}
+
+bool weatherSample (const WeatherChannel channel, const uint8_t sensor,
+                    const int32_t value, const uint64_t now)
+{
+	Aggregate *const aggregate = find(channel, sensor);
+
+	if (!aggregate)
+	{
+		return false;
+	}
+
+	pthread_mutex_lock(&lock);
+
+	if (channel == WEATHER_WIND_DIRECTION)
+	{
+		const int32_t direction = (value % 360 + 360) % 360;
+		const Bucket  whole     = window(aggregate);
+
+		/* The shorter way round from the last direction. */
+		if (whole.count == 0)
+		{
+			aggregate->unwrapped = direction;
+		}
+		else
+		{
+			const int64_t last = (aggregate->unwrapped % 360 + 360) % 360;
+
+			aggregate->unwrapped += (direction - last + 540) % 360 - 180;
+		}
+
+		add(aggregate, aggregate->unwrapped, direction, 0, now);
+	}
+	else
+	{
+		add(aggregate, value, value, 0, now);
+	}
+
+	/* The gust keeps the direction of the wind at its strongest. */
+	if (channel == WEATHER_WIND_SPEED)
+	{
+		const Aggregate *const direction =
+			&station.aggregates[SLOT_WIND_DIRECTION];
+
+		add(&station.aggregates[SLOT_WIND_GUST], value, value,
+		    window(direction).count != 0 ? direction->latest
+		                                 : ESS_DIRECTION_MISSING,
+		    now);
+	}
+
+	pthread_mutex_unlock(&lock);
+
+	return true;
+}
+
+bool weatherSummary (const WeatherChannel channel, const uint8_t sensor,
+                     const uint64_t now, WeatherSummary *const summary)
+{
+	Aggregate *const aggregate = find(channel, sensor);
+
+	if (!aggregate)
+	{
+		return false;
+	}
+
+	pthread_mutex_lock(&lock);
+
+	if (slide(aggregate, now))
+	{
+		publish(aggregate);
+	}
+
+	const Bucket whole = window(aggregate);
+
+	*summary = (WeatherSummary) { .samples = whole.count };
+
+	if (whole.count != 0)
+	{
+		summary->latest  = aggregate->latest;
+		summary->minimum = whole.minimum;
+		summary->maximum = whole.maximum;
+		summary->mean    = mean(aggregate, &whole);
+
+		/* From the mean of the oldest bucket with samples to that of the
+		 * newest.
+		 */
+		const Bucket *first = NULL;
+		const Bucket *last  = NULL;
+		uint64_t      from  = 0;
+		uint64_t      to    = 0;
+
+		for (uint64_t step = WEATHER_BUCKETS; step-- > 0;)
+		{
+			const uint64_t      epoch  = aggregate->epoch - step;
+			const Bucket *const bucket =
+				&aggregate->buckets[epoch % WEATHER_BUCKETS];
+
+			if (step <= aggregate->epoch && bucket->count != 0)
+			{
+				first = first ? first : bucket;
+				from  = first == bucket ? epoch : from;
+				last  = bucket;
+				to    = epoch;
+			}
+		}
+
+		if (to > from)
+		{
+			const int64_t change = average(last) - average(first);
+			const uint64_t span  = (to - from) * aggregate->span;
+
+			summary->rate = (int32_t) (change * SECONDS_PER_HOUR
+			                           * (int64_t) NANOSECONDS_PER_SECOND
+			                           / (int64_t) span);
+		}
+	}
+
+	pthread_mutex_unlock(&lock);
+
+	return true;
+}
+
+void weatherTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	pthread_mutex_lock(&lock);
+
+	for (size_t slot = 0; slot < station.count; slot++)
+	{
+		Aggregate *const aggregate = &station.aggregates[slot];
+
+		if (slide(aggregate, now))
+		{
+			publish(aggregate);
+		}
+	}
+
+	pthread_mutex_unlock(&lock);
+}
+
+const Device essDevice =
+{
+	.name    = "ess",
+	.subtree = ESS_OID(),
+	.init    = weatherInit,
+	.free    = weatherFree,
+	.ticks   = { weatherTick }
+};
@@ -0,0 +1,208 @@
+#include <Zone.h>
+#include <Clock.h>
+#include <Device.h>
+#include <MIB.h>
+#include <Period.h>
+
+#define NANOSECONDS_PER_MICROSECOND 1000
+
+#define CLASS_ROWS (CONFIG_MAX_SENSOR_ZONES * CONFIG_MAX_VEHICLE_CLASSES)
+
+static struct
+{
+	/* One counter per zone in each; the class volumes are by zone, then
+	 * class, like the zoneClassTable.
+	 */
+	OBJECT_TABLE(uint32_t, volumes,      CONFIG_MAX_SENSOR_ZONES);
+	OBJECT_TABLE(uint64_t, occupied,     CONFIG_MAX_SENSOR_ZONES);
+	OBJECT_TABLE(uint32_t, speeds,       CONFIG_MAX_SENSOR_ZONES);
+	OBJECT_TABLE(uint32_t, timed,        CONFIG_MAX_SENSOR_ZONES);
+	OBJECT_TABLE(uint32_t, classVolumes, CLASS_ROWS);
+	size_t zones;
+	size_t classes;
+
+	Period   period;
+	uint64_t started; /* Monotonic start of the period. */
+} pipeline;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void clear (void)
+{
+	const size_t zones = pipeline.zones;
+
+	memset(pipeline.volumes,  0, zones * sizeof(pipeline.volumes[0]));
+	memset(pipeline.occupied, 0, zones * sizeof(pipeline.occupied[0]));
+	memset(pipeline.speeds,   0, zones * sizeof(pipeline.speeds[0]));
+	memset(pipeline.timed,    0, zones * sizeof(pipeline.timed[0]));
+	memset(pipeline.classVolumes, 0,
+	       zones * pipeline.classes * sizeof(pipeline.classVolumes[0]));
+}
+
+bool zoneInit (const DatabaseLimits *const limits)
+{
+	pipeline.zones   = limits->numSensorZones;
+	pipeline.classes = limits->numVehicleClasses;
+	pipeline.period  = (Period) { 0 };
+
+	if (!PROVIDE(pipeline.volumes, pipeline.zones)
+	 || !PROVIDE(pipeline.occupied, pipeline.zones)
+	 || !PROVIDE(pipeline.speeds, pipeline.zones)
+	 || !PROVIDE(pipeline.timed, pipeline.zones)
+	 || !PROVIDE(pipeline.classVolumes, pipeline.zones * pipeline.classes))
+	{
+		return false;
+	}
+
+	clear();
+
+	return true;
+}
+
+void zoneFree (void)
+{
+#ifndef STATIC_STORAGE
+	free(pipeline.volumes);
+	free(pipeline.occupied);
+	free(pipeline.speeds);
+	free(pipeline.timed);
+	free(pipeline.classVolumes);
+
+	pipeline.volumes      = NULL;
+	pipeline.occupied     = NULL;
+	pipeline.speeds       = NULL;
+	pipeline.timed        = NULL;
+	pipeline.classVolumes = NULL;
+#endif
+}
+
+size_t zoneIngest (const ZoneSample samples[const], const size_t count)
+{
+	const SensorZoneEntry *const enabled = tss.sensorZones.sensorZoneTable;
+	const size_t                 zones   = pipeline.zones;
+	const size_t                 classes = pipeline.classes;
+	size_t                       taken   = 0;
+
+	pthread_mutex_lock(&lock);
+
+	if (pipeline.period.length == 0)
+	{
+		pthread_mutex_unlock(&lock);
+		return 0;
+	}
+
+	for (size_t index = 0; index < count; index++)
+	{
+		const ZoneSample *const sample = &samples[index];
+		const size_t            zone   = (size_t) sample->zone - 1;
+
+		if (zone >= zones || !enabled[zone].sensorZoneEnable)
+		{
+			continue;
+		}
+
+		pipeline.volumes[zone]++;
+		pipeline.occupied[zone] += sample->occupancy;
+
+		if (sample->speed != 0)
+		{
+			pipeline.speeds[zone] += sample->speed;
+			pipeline.timed[zone]++;
+		}
+
+		if (sample->vehicleClass != 0 && sample->vehicleClass <= classes)
+		{
+			pipeline.classVolumes[zone * classes + sample->vehicleClass - 1]++;
+		}
+
+		taken++;
+	}
+
+	pthread_mutex_unlock(&lock);
+
+	return taken;
+}
+
+void zoneStep (const int64_t step)
+{
+	(void) step;
+
+	periodStep(&pipeline.period);
+}
+
+static void publish (const uint64_t now)
+{
+	SampleData *const samples = &tss.sampleData;
+	const uint64_t    elapsed = (now - pipeline.started)
+	                          / NANOSECONDS_PER_MICROSECOND;
+	const size_t      zones   = pipeline.zones;
+
+	for (size_t zone = 0; zone < zones; zone++)
+	{
+		ZoneSampleEntry *const entry = &samples->zoneSampleTable[zone];
+
+		entry->zoneSampleVolume    = (uint16_t)
+			MIN(pipeline.volumes[zone], (uint32_t) UINT16_MAX);
+		entry->zoneSampleOccupancy = (uint16_t) (elapsed != 0
+			? MIN(pipeline.occupied[zone] * TSS_OCCUPANCY_FULL / elapsed,
+			      (uint64_t) TSS_OCCUPANCY_FULL)
+			: 0);
+		entry->zoneSampleSpeed     = (uint8_t) (pipeline.timed[zone] != 0
+			? MIN(pipeline.speeds[zone] / pipeline.timed[zone],
+			      (uint32_t) TSS_SPEED_MISSING - 1)
+			: TSS_SPEED_MISSING);
+	}
+
+	for (size_t row = 0; row < zones * pipeline.classes; row++)
+	{
+		samples->zoneClassTable[row].zoneClassVolume = (uint16_t)
+			MIN(pipeline.classVolumes[row], (uint32_t) UINT16_MAX);
+	}
+
+	samples->sampleSequence++;
+
+	clear();
+	pipeline.started = now;
+}
+
+void zoneTick (const uint64_t deadline, const uint64_t now)
+{
+	(void) deadline;
+
+	const CalendarTime *const date = calendarNow();
+
+	pthread_mutex_lock(&lock);
+
+	switch (periodBegin(&pipeline.period, tss.sampleData.samplePeriod, date))
+	{
+		case PERIOD_STOPPED:
+		case PERIOD_RUNNING:
+			break;
+
+		case PERIOD_STARTED:
+			clear();
+			pipeline.started = now;
+			break;
+
+		case PERIOD_ENDED:
+			publish(now);
+			break;
+	}
+
+	if (periodEnd(&pipeline.period, date))
+	{
+		publish(now);
+	}
+
+	pthread_mutex_unlock(&lock);
+}
+
+const Device tssDevice =
+{
+	.name    = "tss",
+	.subtree = TSS_OID(),
+	.init    = zoneInit,
+	.free    = zoneFree,
+	.ticks   = { zoneTick },
+	.steps   = { zoneStep }
+};